@@ -0,0 +1,56 @@
+// Compares constructing an SDK engine, which layers an empty overlay over the
+// shared built-in registry, against registering the built-in surface from
+// scratch as every engine used to.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_engine_startup_benchmark
+//   build/bin/aleph3_engine_startup_benchmark [engines]
+
+#include "sdk/Engine.hpp"
+#include "evaluator/BuiltInFunctions.hpp"
+#include "kernel/FunctionRegistry.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Make>
+double time_constructions(int count, Make&& make) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        make();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / count;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int engines = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    // The first engine pays for the shared registry.
+    const auto first_start = std::chrono::steady_clock::now();
+    Engine first;
+    const auto first_elapsed = std::chrono::steady_clock::now() - first_start;
+
+    std::vector<Engine> kept;
+    kept.reserve(engines);
+    const double engine_us = time_constructions(engines, [&] { kept.emplace_back(); });
+    const double full_registry_us = time_constructions(engines, [] {
+        kernel::FunctionRegistry registry;
+        register_built_in_functions(registry);
+    });
+
+    std::cout << "engines: " << engines << "\n";
+    std::cout << "first engine:          "
+              << std::chrono::duration<double, std::micro>(first_elapsed).count() << " us\n";
+    std::cout << "engine construction:   " << engine_us << " us/engine\n";
+    std::cout << "full registry rebuild: " << full_registry_us << " us/registry\n";
+    return 0;
+}
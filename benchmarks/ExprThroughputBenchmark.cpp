@@ -0,0 +1,67 @@
+// Evaluates a fixed corpus of expressions drawn from the symbolic tests over
+// and over, as a throughput probe for changes to expression ownership.
+// Configure once with ALEPH3_ATOMIC_EXPR_REFCOUNT=ON and once with OFF to
+// compare atomic and plain reference counts.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_expr_throughput_benchmark
+//   build/bin/aleph3_expr_throughput_benchmark [rounds]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "parser/Parser.hpp"
+#include "transforms/Transforms.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+const std::vector<std::string> corpus = {
+    "Expand[(x + 1) * (x + 2) * (x + 3) * (y + 1) * (y - 2)]",
+    "Factor[x^4 - 1]",
+    "Collect[a*x^2 + b*x^2 + c*x + d*x + 1, x]",
+    "x + 2*x + 1/3*x + y*y*y",
+    "Sin[0.5] + Cos[0] + Sqrt[16] + Gamma[5]",
+    "{1, 2, 3, 4, 5} * {5, 4, 3, 2, 1} + 2^{1, 2, 3, 4, 5}",
+    "ReplaceRepeated[f[f[f[f[x]]]], f[a_] -> g[a]]",
+    "Replace[h[1, 2, 3], h[a_, b_, c_] -> a + b + c]",
+    "If[3 > 2, StringJoin[\"a\", \"b\", \"c\"], 0]",
+    "Refine[Abs[x] + Sqrt[x^2], x > 0]",
+    "GCD[x^2 - 1, x^2 - 2*x + 1]",
+    "PolynomialQuotient[x^3 - 1, x - 1, x]",
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int rounds = argc > 1 ? std::atoi(argv[1]) : 300;
+
+    std::vector<ExprPtr> exprs;
+    for (const auto& source : corpus) {
+        exprs.push_back(parse_expression(source));
+    }
+
+    std::size_t evaluations = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        EvaluationContext ctx;
+        evaluate(parse_expression("fib[n_] := If[n < 2, n, fib[n - 1] + fib[n - 2]]"), ctx);
+        evaluate(parse_expression("fib[12]"), ctx);
+        for (const auto& expr : exprs) {
+            simplify(evaluate(expr, ctx));
+        }
+        evaluations += exprs.size() + 2;
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "atomic reference counts: " << (expr_refcount_is_atomic ? "yes" : "no") << "\n";
+    std::cout << "rounds: " << rounds << ", evaluations: " << evaluations << "\n";
+    std::cout << "throughput: " << evaluations / elapsed << " evaluations/s\n";
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Load test for Engine::evaluate_scheduled: a few tenants issue short
+// formulas while one tenant keeps long formulas running, on an engine with
+// fewer slots than tenants. Reports the short formulas' latency with time
+// slicing off (each evaluation runs to the end once started) and on.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_fair_scheduling_benchmark
+//   build/bin/aleph3_fair_scheduling_benchmark [seconds]
+
+#include "sdk/Engine.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+constexpr int kShortTenants = 4;
+constexpr int kLongThreads = 2;
+constexpr int kLongFetches = 200;
+constexpr auto kFetchCost = std::chrono::microseconds(250);
+
+// Stands in for a host lookup: spins for kFetchCost and returns its argument.
+EvaluationResult fetch(std::span<const Value> args) {
+    const auto until = std::chrono::steady_clock::now() + kFetchCost;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    EvaluationResult result;
+    result.value = args[0];
+    return result;
+}
+
+struct LoadReport {
+    QuantileSketch short_latency_ms;
+    std::size_t long_evaluations = 0;
+    SchedulerMetrics metrics;
+};
+
+LoadReport run_load(std::size_t slice_steps, double seconds) {
+    EngineOptions options;
+    options.scheduling.concurrency = 1;
+    options.scheduling.slice_steps = slice_steps;
+    Engine engine(options);
+
+    HostFunctionSpec spec;
+    spec.name = "Fetch";
+    spec.arity = FunctionArity::exact(1);
+    spec.parameters = {{"key", ValueType::number, true}};
+    spec.return_type = ValueType::number;
+    spec.purity = HostFunctionPurity::impure;
+    spec.callback = fetch;
+    engine.register_function(spec);
+
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_function({"Fetch", FunctionArity::exact(1), {ValueType::number}, ValueType::number, true});
+    Policy policy = Policy::default_policy();
+    policy.budget().max_ast_depth = 1024;
+    policy.budget().max_node_count = 4096;
+
+    // Each long formula makes kLongFetches lookups in a chain of Ifs, one
+    // nested in the next, so the work is spread over the evaluation's steps.
+    std::string chain = "x";
+    for (int term = kLongFetches - 1; term >= 0; --term) {
+        chain = "If[Fetch[x + " + std::to_string(term) + "] > 0, " + chain + ", 0]";
+    }
+    const auto long_formula = engine.compile(chain, schema, policy);
+    const auto short_formula = engine.compile("x * x + 1", schema, policy);
+    if (!long_formula.ok() || !short_formula.ok()) {
+        const auto& failed = long_formula.ok() ? short_formula : long_formula;
+        std::cerr << "compile failed: " << failed.diagnostics.front().message << "\n";
+        std::exit(1);
+    }
+
+    LoadReport report;
+    std::mutex report_mutex;
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> long_evaluations{0};
+    std::vector<std::thread> threads;
+
+    for (int index = 0; index < kLongThreads; ++index) {
+        threads.emplace_back([&] {
+            while (!stop) {
+                (void)engine.evaluate_scheduled(*long_formula.formula, {{"x", Value(1.0)}}, {"bulk", PriorityClass::batch});
+                ++long_evaluations;
+            }
+        });
+    }
+    for (int index = 0; index < kShortTenants; ++index) {
+        threads.emplace_back([&, index] {
+            const std::string tenant = "tenant" + std::to_string(index);
+            QuantileSketch latencies;
+            while (!stop) {
+                const auto start = std::chrono::steady_clock::now();
+                (void)engine.evaluate_scheduled(*short_formula.formula, {{"x", Value(2.0)}}, {tenant});
+                const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+                latencies.add(elapsed.count());
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::lock_guard<std::mutex> lock(report_mutex);
+            report.short_latency_ms.merge(latencies);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    report.long_evaluations = long_evaluations;
+    report.metrics = engine.scheduler_metrics();
+    return report;
+}
+
+void print(const char* label, const LoadReport& report) {
+    std::cout << label << "\n"
+              << "  short formulas: " << report.short_latency_ms.count() << ", latency p50 "
+              << report.short_latency_ms.quantile(0.5) << " ms, p99 " << report.short_latency_ms.quantile(0.99)
+              << " ms, max " << report.short_latency_ms.quantile(1.0) << " ms\n"
+              << "  long formulas:  " << report.long_evaluations << "\n"
+              << "  queue delay:    mean " << report.metrics.mean_queue_delay_ms << " ms, p99 "
+              << report.metrics.p99_queue_delay_ms << " ms; " << report.metrics.yields << " yields\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 3.0;
+    print("run to completion", run_load(0, seconds));
+    print("sliced every 64 steps", run_load(64, seconds));
+    return 0;
+}
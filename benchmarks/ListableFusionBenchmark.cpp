@@ -0,0 +1,61 @@
+// Times chains of listable numeric builtins over long numeric lists. Each chain
+// is evaluated as one expression, so fused evaluation makes a single pass.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_listable_fusion_benchmark
+//   build/bin/aleph3_listable_fusion_benchmark [elements]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+ExprPtr make_numeric_list(std::size_t size, double offset) {
+    std::vector<ExprPtr> elements;
+    elements.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        elements.push_back(make_expr<Number>(offset + static_cast<double>(i % 1000) / 1000.0));
+    }
+    return make_expr_node(List{std::move(elements)});
+}
+
+double time_ms(const std::string& source, EvaluationContext& ctx) {
+    auto expr = parse_expression(source);
+    const auto start = std::chrono::steady_clock::now();
+    evaluate(expr, ctx);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t elements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    EvaluationContext ctx;
+    ctx.symbol_values.set("x", make_numeric_list(elements, 1.0));
+    ctx.symbol_values.set("y", make_numeric_list(elements, 2.0));
+
+    const std::vector<std::string> chains = {
+        "Sqrt[x]",
+        "Sqrt[x^2 + y^2]",
+        "Sqrt[x^2 + y^2] * Exp[-x]",
+        "Log[Sqrt[x^2 + y^2] * Exp[-x] + Sin[y] * Cos[x]]",
+        "Log[Sqrt[x^2 + y^2] * Exp[-x] + Sin[y] * Cos[x]] / (1 + Tanh[x - y])^2",
+    };
+
+    std::cout << "elements: " << elements << "\n";
+    for (const auto& chain : chains) {
+        std::cout << time_ms(chain, ctx) << " ms  " << chain << "\n";
+    }
+    return 0;
+}
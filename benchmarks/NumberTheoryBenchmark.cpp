@@ -0,0 +1,107 @@
+// Times the number-theory pack's integer primitives on 64-bit inputs:
+// binary GCD against std::gcd, Montgomery PowerMod against 128-bit remainder
+// multiplication, Miller-Rabin PrimeQ, and Pollard-Brent FactorInteger on
+// products of two 32-bit primes.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_number_theory_benchmark
+//   build/bin/aleph3_number_theory_benchmark [count]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "numbertheory/IntegerArithmetic.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+uint64_t power_mod_by_remainder(uint64_t base, uint64_t exponent, uint64_t modulus) {
+    uint64_t result = 1;
+    base %= modulus;
+    while (exponent != 0) {
+        if (exponent & 1) {
+            result = static_cast<uint64_t>(static_cast<unsigned __int128>(result) * base % modulus);
+        }
+        base = static_cast<uint64_t>(static_cast<unsigned __int128>(base) * base % modulus);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+uint64_t next_prime(uint64_t value) {
+    while (!is_prime(value)) {
+        ++value;
+    }
+    return value;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+
+    std::mt19937_64 random(42);
+    std::vector<uint64_t> left(count);
+    std::vector<uint64_t> right(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        left[i] = random();
+        right[i] = random() | 1;
+    }
+
+    uint64_t sink = 0;
+    std::cout << "inputs: " << count << " random 64-bit values\n";
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < count; ++i) sink += std::gcd(left[i], right[i]);
+    }) << " ms  std::gcd\n";
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < count; ++i) sink += integer_gcd(left[i], right[i]);
+    }) << " ms  binary integer_gcd\n";
+
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < count; ++i) sink += power_mod_by_remainder(left[i], left[i] ^ right[i], right[i]);
+    }) << " ms  PowerMod with 128-bit remainders\n";
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < count; ++i) sink += power_mod(left[i], left[i] ^ right[i], right[i]);
+    }) << " ms  PowerMod with Montgomery multiplication\n";
+
+    std::size_t primes = 0;
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < count; ++i) primes += is_prime(right[i]) ? 1 : 0;
+    }) << " ms  PrimeQ (" << primes << " primes)\n";
+
+    const std::size_t semiprime_count = std::max<std::size_t>(count / 1000, 10);
+    std::vector<uint64_t> semiprimes;
+    for (std::size_t i = 0; i < semiprime_count; ++i) {
+        semiprimes.push_back(next_prime((random() >> 32) | (uint64_t{1} << 31)) *
+                             next_prime((random() >> 32) | (uint64_t{1} << 31)));
+    }
+    std::cout << time_ms([&] {
+        for (const auto value : semiprimes) sink += factor_integer(value).size();
+    }) << " ms  FactorInteger on " << semiprime_count << " products of two 32-bit primes\n";
+
+    // Through the evaluator; kernel integers are doubles, so inputs stay
+    // below 2^53 here.
+    EvaluationContext ctx;
+    auto gcd = parse_expression("GCD[12345678987654, 98765432123456]");
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < 1000; ++i) evaluate(gcd, ctx);
+    }) << " ms  1000 evaluations of GCD[12345678987654, 98765432123456]\n";
+
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+// Measures what lazy pack loading costs and saves for the algebra pack:
+// registering its manifest versus its handlers, and the first call to a pack
+// symbol (which loads the pack) versus later calls.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_pack_load_benchmark
+//   build/bin/aleph3_pack_load_benchmark [registries]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "kernel/PackManifest.hpp"
+#include "packs/AlgebraPack.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace aleph3;
+
+namespace {
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int registries = argc > 1 ? std::atoi(argv[1]) : 2000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < registries; ++i) {
+        kernel::FunctionRegistry registry;
+        packs::register_algebra_pack(registry);
+    }
+    const double eager_us = elapsed_us(start) / registries;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < registries; ++i) {
+        kernel::FunctionRegistry registry;
+        (void)kernel::register_lazy_pack(registry, packs::algebra_pack_manifest());
+    }
+    const double manifest_us = elapsed_us(start) / registries;
+
+    const auto call = parse_expression("Expand[(x + 1) * (x + 2)]");
+    double first_call_us = 0.0;
+    double load_us = 0.0;
+    double later_call_us = 0.0;
+    for (int i = 0; i < registries; ++i) {
+        kernel::FunctionRegistry registry;
+        auto pack = kernel::register_lazy_pack(registry, packs::algebra_pack_manifest());
+        EvaluationContext ctx(registry);
+
+        start = std::chrono::steady_clock::now();
+        evaluate(call, ctx);
+        first_call_us += elapsed_us(start);
+        load_us += std::chrono::duration<double, std::micro>(pack->load_duration()).count();
+
+        start = std::chrono::steady_clock::now();
+        evaluate(call, ctx);
+        later_call_us += elapsed_us(start);
+    }
+
+    std::cout << "registries: " << registries << "\n";
+    std::cout << "eager pack registration:    " << eager_us << " us\n";
+    std::cout << "manifest registration:      " << manifest_us << " us\n";
+    std::cout << "first call (loads pack):    " << first_call_us / registries << " us\n";
+    std::cout << "  of which pack load:       " << load_us / registries << " us\n";
+    std::cout << "later call:                 " << later_call_us / registries << " us\n";
+    return 0;
+}
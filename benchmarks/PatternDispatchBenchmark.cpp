@@ -0,0 +1,67 @@
+// Compares indexed pattern-definition dispatch against the equivalent chain of
+// If tests in a single plain definition.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_pattern_dispatch_benchmark
+//   build/bin/aleph3_pattern_dispatch_benchmark [cases] [calls]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+std::string if_chain(int cases) {
+    std::string body = "-1";
+    for (int i = cases - 1; i >= 0; --i) {
+        body = "If[n == " + std::to_string(i) + ", " + std::to_string(i * i) + ", " + body + "]";
+    }
+    return "g[n_] := " + body;
+}
+
+double time_calls(const std::string& head, int cases, int calls, EvaluationContext& ctx) {
+    std::vector<ExprPtr> exprs;
+    exprs.reserve(calls);
+    for (int i = 0; i < calls; ++i) {
+        exprs.push_back(parse_expression(head + "[" + std::to_string(i % (cases + 1)) + "]"));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto& expr : exprs) {
+        evaluate(expr, ctx);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count() / calls;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const int cases = argc > 1 ? std::atoi(argv[1]) : 64;
+    const int calls = argc > 2 ? std::atoi(argv[2]) : 20000;
+
+    EvaluationContext patterns;
+    for (int i = 0; i < cases; ++i) {
+        evaluate(parse_expression("f[" + std::to_string(i) + "] := " + std::to_string(i * i)), patterns);
+    }
+    evaluate(parse_expression("f[n_] := -1"), patterns);
+
+    EvaluationContext chain;
+    evaluate(parse_expression(if_chain(cases)), chain);
+
+    const double pattern_us = time_calls("f", cases, calls, patterns);
+    const double chain_us = time_calls("g", cases, calls, chain);
+
+    std::cout << "cases: " << cases << ", calls: " << calls << "\n";
+    std::cout << "pattern definitions: " << pattern_us << " us/call\n";
+    std::cout << "If chain:            " << chain_us << " us/call\n";
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Times random generation: a host RNG called once per sample through a host
+// function against RandomReal filling one buffer from a Philox stream, and the
+// kernel stream itself drawn one value at a time against its batched fills.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_random_fill_benchmark
+//   build/bin/aleph3_random_fill_benchmark [count]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "kernel/CounterRandom.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const auto n = std::to_string(count);
+
+    Bindings bindings;
+    Bindings constants;
+    kernel::HostFunctionRegistry host_functions;
+    std::mt19937_64 host_random(42);
+    std::uniform_real_distribution<double> unit;
+    HostFunctionSpec rng;
+    rng.name = "rng";
+    rng.callback = [&](std::span<const Value>) -> EvaluationResult {
+        return EvaluationResult{Value(unit(host_random)), std::nullopt};
+    };
+    host_functions.emplace("rng", rng);
+    Policy policy = Policy::default_policy();
+    policy.set_random_seed(42);
+
+    EvaluationContext ctx(bindings, constants, host_functions, policy);
+    ctx.set_parallel_thread_count(1);
+    std::cout << "samples: " << count << "\n";
+    std::cout << time_ms([&] {
+        evaluate(parse_expression("ParallelTable[rng[], {i, " + n + "}]"), ctx);
+    }) << " ms  host rng[] per sample\n";
+    std::cout << time_ms([&] {
+        evaluate(parse_expression("RandomReal[1, " + n + "]"), ctx);
+    }) << " ms  RandomReal[1, n], one thread\n";
+    ctx.set_parallel_thread_count(0);
+    std::cout << time_ms([&] {
+        evaluate(parse_expression("RandomReal[1, " + n + "]"), ctx);
+    }) << " ms  RandomReal[1, n], all threads\n";
+
+    const kernel::RandomStream stream(42, 0);
+    std::vector<double> values(count * 10);
+    double sink = 0.0;
+    std::cout << time_ms([&] {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<double>(stream.bits(i) >> 11) * 0x1.0p-53;
+        }
+    }) << " ms  " << values.size() << " Philox draws one at a time\n";
+    sink += values.back();
+    std::cout << time_ms([&] { stream.fill_uniform(values, 0, 1); }) << " ms  fill_uniform, one thread\n";
+    sink += values.back();
+    std::cout << time_ms([&] { stream.fill_uniform(values, 0, 0); }) << " ms  fill_uniform, all threads\n";
+    sink += values.back();
+    std::cout << time_ms([&] { stream.fill_normal(values, 0, 1); }) << " ms  fill_normal, one thread\n";
+    sink += values.back();
+
+    return sink == 0.0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+// Times summing many exact rationals: reducing after every addition against
+// RationalAccumulator, which reduces once, plus a Plus expression with the
+// same terms going through the kernel's bucketing.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_rational_sum_benchmark
+//   build/bin/aleph3_rational_sum_benchmark [terms]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "expr/RationalAccumulator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    // Denominators cycle through 1..24, so the exact sum stays in int64.
+    std::vector<std::pair<int64_t, int64_t>> terms;
+    terms.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        terms.emplace_back(static_cast<int64_t>(i % 7) - 3, static_cast<int64_t>(i % 24) + 1);
+    }
+
+    std::pair<int64_t, int64_t> eager{0, 1};
+    const auto eager_ms = time_ms([&] {
+        for (const auto& [num, den] : terms) {
+            eager = normalize_rational(eager.first * den + num * eager.second, eager.second * den);
+        }
+    });
+
+    std::pair<int64_t, int64_t> lazy{0, 1};
+    const auto lazy_ms = time_ms([&] {
+        RationalAccumulator sum;
+        for (const auto& [num, den] : terms) {
+            if (!sum.add(num, den)) {
+                std::cerr << "overflow\n";
+                std::exit(1);
+            }
+        }
+        lazy = sum.reduced();
+    });
+
+    std::vector<ExprPtr> args;
+    args.reserve(count);
+    for (const auto& [num, den] : terms) {
+        auto [n, d] = normalize_rational(num, den);
+        args.push_back(d == 1 ? make_expr<Number>(static_cast<double>(n)) : make_expr<Rational>(n, d));
+    }
+    auto plus = make_expr<FunctionCall>("Plus", std::move(args));
+    EvaluationContext ctx;
+    ExprPtr evaluated;
+    const auto plus_ms = time_ms([&] { evaluated = evaluate(plus, ctx); });
+
+    std::cout << "terms: " << count << ", sum: " << lazy.first << "/" << lazy.second << "\n";
+    std::cout << eager_ms << " ms  reduce after every addition\n";
+    std::cout << lazy_ms << " ms  RationalAccumulator\n";
+    std::cout << plus_ms << " ms  Plus[...] through the evaluator\n";
+    return eager == lazy ? 0 : 1;
+}
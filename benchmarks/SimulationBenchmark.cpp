@@ -0,0 +1,71 @@
+// Times a Monte Carlo run of one formula: a host loop drawing samples and
+// calling Engine::evaluate per row, against Engine::simulate with one thread
+// and with every hardware thread.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_simulation_benchmark
+//   build/bin/aleph3_simulation_benchmark [samples]
+
+#include "sdk/Engine.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_variable({"y", ValueType::number, true});
+    const auto compiled = engine.compile("3 * x * x + 2 * y - x / 4", schema);
+    if (!compiled.ok()) {
+        std::cerr << "compile failed\n";
+        return 1;
+    }
+    const auto& formula = *compiled.formula;
+
+    RunningMoments row_moments;
+    const double rows = time_ms([&] {
+        std::mt19937_64 engine_rng(42);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::normal_distribution<double> normal(1.0, 2.0);
+        for (std::size_t i = 0; i < samples; ++i) {
+            const auto result = engine.evaluate(formula, {{"x", Value(uniform(engine_rng))}, {"y", Value(normal(engine_rng))}});
+            row_moments.add(*result.value->as_number());
+        }
+    });
+
+    const Distributions distributions{
+        {"x", Distribution::uniform(0.0, 1.0)},
+        {"y", Distribution::normal(1.0, 2.0)}};
+    SimulationOptions options;
+    SimulationResult simulated;
+    options.thread_count = 1;
+    const double single = time_ms([&] { simulated = engine.simulate(formula, distributions, samples, 42, options); });
+    options.thread_count = 0;
+    const double parallel = time_ms([&] { simulated = engine.simulate(formula, distributions, samples, 42, options); });
+
+    std::cout << samples << " samples\n"
+              << "  evaluate per row:      " << rows << " ms (mean " << row_moments.mean() << ")\n"
+              << "  simulate, 1 thread:    " << single << " ms\n"
+              << "  simulate, all threads: " << parallel << " ms (mean " << simulated.summary->moments.mean()
+              << ", median " << simulated.summary->quantiles.quantile(0.5) << ")\n";
+    return 0;
+}
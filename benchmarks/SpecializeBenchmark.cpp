@@ -0,0 +1,90 @@
+// Times evaluating a formula per row with every binding supplied, against
+// specializing it once for the bindings that stay fixed and evaluating the
+// residual with the rest.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_specialize_benchmark
+//   build/bin/aleph3_specialize_benchmark [rows]
+
+#include "sdk/Engine.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace aleph3;
+
+namespace {
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+
+    Engine engine;
+    HostFunctionSpec curve;
+    curve.name = "Curve";
+    curve.arity = FunctionArity::exact(2);
+    curve.parameters = {{"rate", ValueType::number, true}, {"years", ValueType::number, true}};
+    curve.return_type = ValueType::number;
+    curve.callback = [](std::span<const Value> args) {
+        EvaluationResult result;
+        result.value = Value(std::pow(1.0 + *args[0].as_number(), *args[1].as_number()));
+        return result;
+    };
+    engine.register_function(curve);
+
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_variable({"rate", ValueType::number, true});
+    schema.allow_variable({"years", ValueType::number, true});
+    schema.allow_variable({"tier", ValueType::number, true});
+    schema.allow_function({"Curve", FunctionArity::exact(2), {ValueType::number, ValueType::number}, ValueType::number, true});
+    Policy policy = Policy::default_policy();
+    policy.set_enable_optional_builtins(true);
+    const auto compiled = engine.compile(
+        "If[tier > 2, x * Curve[rate, years] - Max[rate * 100, years], x / Curve[rate, years + 1] + Min[tier, 3]]",
+        schema,
+        policy);
+    if (!compiled.ok()) {
+        std::cerr << "compile failed\n";
+        return 1;
+    }
+    const auto& formula = *compiled.formula;
+    const Bindings fixed{{"rate", Value(0.05)}, {"years", Value(10.0)}, {"tier", Value(3.0)}};
+
+    double full_sum = 0.0;
+    const double full = time_ms([&] {
+        auto bindings = fixed;
+        for (std::size_t i = 0; i < rows; ++i) {
+            bindings["x"] = Value(static_cast<double>(i));
+            full_sum += *engine.evaluate(formula, bindings).value->as_number();
+        }
+    });
+
+    CompiledFormula residual;
+    const double specialize = time_ms([&] { residual = engine.specialize(formula, fixed); });
+    double residual_sum = 0.0;
+    const double specialized = time_ms([&] {
+        Bindings bindings;
+        for (std::size_t i = 0; i < rows; ++i) {
+            bindings["x"] = Value(static_cast<double>(i));
+            residual_sum += *engine.evaluate(residual, bindings).value->as_number();
+        }
+    });
+
+    std::cout << rows << " rows\n"
+              << "  unspecialized:  " << full << " ms (sum " << full_sum << ")\n"
+              << "  specialize:     " << specialize << " ms\n"
+              << "  specialized:    " << specialized << " ms (sum " << residual_sum << ")\n";
+    return 0;
+}
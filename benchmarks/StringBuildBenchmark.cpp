@@ -0,0 +1,45 @@
+// Times a formula that grows a string one StringJoin at a time. With shared,
+// rope-backed string storage each step costs about the same however long the
+// string already is; with copied storage the total grows quadratically.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_string_build_benchmark
+//   build/bin/aleph3_string_build_benchmark [steps]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "parser/Parser.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace aleph3;
+
+namespace {
+
+double time_ms(std::size_t steps) {
+    EvaluationContext ctx;
+    evaluate(parse_expression("s = \"\""), ctx);
+    auto step = parse_expression("s = s <> \"token-\"");
+    auto length = parse_expression("StringLength[s]");
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < steps; ++i) {
+        evaluate(step, ctx);
+        evaluate(length, ctx);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t steps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+
+    for (const auto count : {steps / 4, steps / 2, steps}) {
+        std::cout << time_ms(count) << " ms  " << count << " appends (" << count * 6 << " bytes)\n";
+    }
+    return 0;
+}
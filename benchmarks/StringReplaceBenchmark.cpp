@@ -0,0 +1,94 @@
+// Times StringReplace with a list of literal rules over a long string, against
+// applying the same rules one at a time with an in-place find/replace loop.
+//
+//   cmake -S . -B build -DALEPH3_BUILD_BENCHMARKS=ON
+//   cmake --build build --target aleph3_string_replace_benchmark
+//   build/bin/aleph3_string_replace_benchmark [kilobytes] [rules]
+
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace aleph3;
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> make_rules(std::size_t count) {
+    std::vector<std::pair<std::string, std::string>> rules;
+    rules.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        rules.emplace_back("w" + std::to_string(i) + ";", "<" + std::to_string(i) + ">");
+    }
+    return rules;
+}
+
+std::string make_text(std::size_t bytes, std::size_t rule_count) {
+    std::string text;
+    text.reserve(bytes + 16);
+    for (std::size_t i = 0; text.size() < bytes; ++i) {
+        text += i % 3 == 0 ? "plain " : "w" + std::to_string(i % (rule_count + 5)) + "; ";
+    }
+    return text;
+}
+
+// The previous StringReplace loop, chained once per rule.
+std::string replace_sequentially(std::string text, const std::vector<std::pair<std::string, std::string>>& rules) {
+    for (const auto& [pattern, replacement] : rules) {
+        std::size_t pos = 0;
+        while ((pos = text.find(pattern, pos)) != std::string::npos) {
+            text.replace(pos, pattern.size(), replacement);
+            pos += replacement.size();
+        }
+    }
+    return text;
+}
+
+template <typename Work>
+double time_ms(const Work& work) {
+    const auto start = std::chrono::steady_clock::now();
+    work();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t kilobytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    const std::size_t rule_count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 40;
+
+    const auto rules = make_rules(rule_count);
+    const auto text = make_text(kilobytes * 1024, rule_count);
+
+    std::vector<ExprPtr> rule_exprs;
+    rule_exprs.reserve(rules.size());
+    for (const auto& [pattern, replacement] : rules) {
+        rule_exprs.push_back(make_expr<Rule>(make_expr<String>(pattern), make_expr<String>(replacement)));
+    }
+    auto call = make_expr<FunctionCall>(
+        "StringReplace",
+        std::vector<ExprPtr>{make_expr<String>(text), make_expr_node(List{std::move(rule_exprs)})});
+
+    EvaluationContext ctx;
+    std::string sequential;
+    std::string compiled;
+    const auto sequential_ms = time_ms([&] { sequential = replace_sequentially(text, rules); });
+    const auto first_ms = time_ms([&] { compiled = std::get<String>(*evaluate(call, ctx)).value; });
+    const auto cached_ms = time_ms([&] { compiled = std::get<String>(*evaluate(call, ctx)).value; });
+
+    std::cout << "input: " << text.size() << " bytes, rules: " << rule_count << "\n";
+    std::cout << sequential_ms << " ms  one find/replace loop per rule\n";
+    std::cout << first_ms << " ms  StringReplace, first call (compiles the rule list)\n";
+    std::cout << cached_ms << " ms  StringReplace, cached rule list\n";
+    if (sequential != compiled) {
+        std::cerr << "outputs differ\n";
+        return 1;
+    }
+    return 0;
+}
@@ -15,6 +15,7 @@
 
 #include "algebra/Polynomial.hpp"
 #include "expr/ExprUtils.hpp"
+#include "expr/RationalAccumulator.hpp"
 
 namespace aleph3 {
 
@@ -142,9 +143,11 @@ inline ExactPolynomial operator-(const ExactPolynomial& left, const ExactPolynom
     return result;
 }
 
+// Coefficients of each product monomial are summed unreduced and reduced once
+// at the end. If an unreduced sum would overflow, that monomial falls back to
+// reducing after each addition.
 inline ExactPolynomial operator*(const ExactPolynomial& left, const ExactPolynomial& right) {
-    ExactPolynomial result;
-    result.terms.clear();
+    std::map<Monomial, RationalAccumulator> sums;
     for (const auto& [left_mono, left_coeff] : left.terms) {
         if (left_coeff.is_zero()) {
             continue;
@@ -157,9 +160,23 @@ inline ExactPolynomial operator*(const ExactPolynomial& left, const ExactPolynom
             for (const auto& [var, exponent] : right_mono) {
                 mono[var] += exponent;
             }
-            result.terms[mono] = result.terms[mono] + (left_coeff * right_coeff);
+            auto& sum = sums[mono];
+            if (!sum.add_product(
+                    left_coeff.numerator, left_coeff.denominator,
+                    right_coeff.numerator, right_coeff.denominator)) {
+                auto [num, den] = sum.reduced();
+                const auto reduced = ExactCoefficient(num, den) + (left_coeff * right_coeff);
+                sum = RationalAccumulator(reduced.numerator, reduced.denominator);
+            }
         }
     }
+
+    ExactPolynomial result;
+    result.terms.clear();
+    for (const auto& [mono, sum] : sums) {
+        auto [num, den] = sum.reduced();
+        result.terms.emplace_hint(result.terms.end(), mono, ExactCoefficient(num, den));
+    }
     result.normalize();
     return result;
 }
@@ -14,5 +14,10 @@ namespace aleph3 {
 void register_built_in_functions(kernel::FunctionRegistry& registry);
 void register_builtin_rewrite_specs(kernel::FunctionRegistry& registry);
 void register_builtin_evaluator_execution_specs(kernel::FunctionRegistry& registry);
+void register_parallel_builtins(kernel::FunctionRegistry& registry);
+void register_random_builtins(kernel::FunctionRegistry& registry);
+void register_association_builtins(kernel::FunctionRegistry& registry);
+void register_list_set_builtins(kernel::FunctionRegistry& registry);
+void register_structure_builtins(kernel::FunctionRegistry& registry);
 
 }  // namespace aleph3
@@ -11,4 +11,12 @@ ExprPtr evaluate_user_defined_function(const FunctionCall& func, EvaluationConte
 
 ExprPtr register_user_defined_function(const FunctionDefinition& def, EvaluationContext& ctx);
 
+// `lhs := rhs` (delayed) or `lhs = rhs` where lhs is a call such as f[0] or
+// f[g[x_], y_]. Returns Null for delayed definitions and the value otherwise.
+ExprPtr register_pattern_definition(
+    const FunctionCall& lhs,
+    const ExprPtr& rhs,
+    bool delayed,
+    EvaluationContext& ctx);
+
 }  // namespace aleph3
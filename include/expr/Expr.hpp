@@ -3,11 +3,12 @@
  * -----------------------
  * This header defines the core expression data structures for Aleph3, a modern C++20-based computer algebra system.
  * The Expr type is a tagged union (std::variant) representing all supported symbolic and numeric objects,
- * including numbers, rationals, booleans, symbols, strings, lists, function calls, assignments, rules, and more.
+ * including numbers, rationals, booleans, symbols, strings, lists, associations, function calls, assignments,
+ * rules, and more.
  *
  * Features:
  * - Unified variant type (Expr) for all mathematical and symbolic objects
- * - Smart pointer management for expression trees (ExprPtr)
+ * - Intrusively reference-counted handles for expression trees (ExprPtr)
  * - Factory functions for constructing expressions
  * - Type-safe representation of mathematical constructs for parsing, evaluation, and transformation
  *
@@ -15,13 +16,28 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <iostream>
 #include <cstdint>
 
+#include "expr/SharedString.hpp"
+
+// Expression nodes count their handles atomically by default, so trees can be
+// shared across threads (ParallelMap and friends). Single-threaded builds can
+// configure with -DALEPH3_ATOMIC_EXPR_REFCOUNT=OFF to use plain counts; the
+// parallel builtins then run serially.
+#ifndef ALEPH3_ATOMIC_EXPR_REFCOUNT
+#define ALEPH3_ATOMIC_EXPR_REFCOUNT 1
+#endif
+
 namespace aleph3 {
 
 // Forward declarations
@@ -36,20 +52,63 @@ struct FunctionDefinition;
 struct Assignment;
 struct Rule;
 struct List;
+struct Association;
 struct Infinity;
 struct ComplexInfinity;
 struct Indeterminate;
 
 // Core Expression type: variant of all expression types
-using Expr = std::variant < Symbol, Number, Complex, Rational, Boolean, String, FunctionCall, FunctionDefinition, Assignment, Rule, List, Infinity, ComplexInfinity, Indeterminate > ;
+using Expr = std::variant < Symbol, Number, Complex, Rational, Boolean, String, FunctionCall, FunctionDefinition, Assignment, Rule, List, Association, Infinity, ComplexInfinity, Indeterminate > ;
+
+inline constexpr bool expr_refcount_is_atomic = ALEPH3_ATOMIC_EXPR_REFCOUNT != 0;
+
+struct ExprNode;
+
+// Shared handle to an expression node. The count lives in the node itself, so
+// a handle is one pointer and copying it touches no separate control block.
+// Mirrors the parts of std::shared_ptr the kernel uses.
+class ExprPtr {
+public:
+    ExprPtr() noexcept = default;
+    ExprPtr(std::nullptr_t) noexcept {}
+    ExprPtr(const ExprPtr& other) noexcept;
+    ExprPtr(ExprPtr&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+    ~ExprPtr();
+
+    ExprPtr& operator=(const ExprPtr& other) noexcept;
+    ExprPtr& operator=(ExprPtr&& other) noexcept;
+    ExprPtr& operator=(std::nullptr_t) noexcept;
+
+    [[nodiscard]] Expr* get() const noexcept;
+    Expr& operator*() const noexcept;
+    Expr* operator->() const noexcept { return get(); }
+    explicit operator bool() const noexcept { return node_ != nullptr; }
+
+    [[nodiscard]] std::size_t use_count() const noexcept;
+    void reset() noexcept { *this = nullptr; }
+    void swap(ExprPtr& other) noexcept { std::swap(node_, other.node_); }
 
-// Smart pointer to expressions
-using ExprPtr = std::shared_ptr<Expr>;
+    friend bool operator==(const ExprPtr& left, const ExprPtr& right) noexcept { return left.node_ == right.node_; }
+    friend bool operator==(const ExprPtr& ptr, std::nullptr_t) noexcept { return ptr.node_ == nullptr; }
+
+private:
+    template <typename Value>
+    friend ExprPtr make_expr_node(Value&& value);
+
+    // Takes over a freshly allocated node whose count is already one.
+    explicit ExprPtr(ExprNode* node) noexcept : node_(node) {}
+
+    ExprNode* node_ = nullptr;
+};
+
+// Wraps an expression value (an Expr or one of its alternatives) in a new node.
+template <typename Value>
+ExprPtr make_expr_node(Value&& value);
 
 // Factory function to make an ExprPtr
 template <typename T, typename... Args>
 ExprPtr make_expr(Args&&... args) {
-    return std::make_shared<Expr>(T{std::forward<Args>(args)...});
+    return make_expr_node(T{std::forward<Args>(args)...});
 }
 
 // Expression types
@@ -60,10 +119,11 @@ struct Symbol {
     Symbol(const std::string& n) : name(n) {}
 };
 
+// Copies share one immutable buffer; see SharedString.hpp.
 struct String {
-    std::string value;
+    SharedString value;
 
-    String(const std::string& v) : value(v) {}
+    String(SharedString v) : value(std::move(v)) {}
 };
 
 struct Number {
@@ -90,13 +150,46 @@ struct Boolean {
     Boolean(bool v) : value(v) {}
 };
 
+// Marks a compound node as the output of an evaluation that nothing has
+// invalidated since. Copies start unstamped, so a node rebuilt from an
+// evaluated one is evaluated again.
+struct EvaluationStamp {
+    std::uint64_t modification_count = 0;
+    std::uint64_t context_lineage = 0;
+
+    EvaluationStamp() = default;
+    EvaluationStamp(const EvaluationStamp&) noexcept {}
+    EvaluationStamp& operator=(const EvaluationStamp&) noexcept { return *this; }
+};
+
+// Holds a compound node's ExprSummary (see ExprSummary.hpp) once it has
+// been computed. Threads sharing a tree may fill it at the same time; they
+// all store the same words, and `shape` is published last. Copies and
+// assignments start empty, like EvaluationStamp.
+struct SummaryCache {
+    std::atomic<std::uint64_t> symbols{0};
+    std::atomic<std::uint64_t> heads{0};
+    std::atomic<std::uint64_t> shape{0};  // zero until filled
+
+    SummaryCache() = default;
+    SummaryCache(const SummaryCache&) noexcept {}
+    SummaryCache& operator=(const SummaryCache&) noexcept {
+        shape.store(0, std::memory_order_relaxed);
+        return *this;
+    }
+};
+
 struct List {
     std::vector<ExprPtr> elements;
+    mutable EvaluationStamp evaluation_stamp;
+    mutable SummaryCache summary;
 };
 
 struct FunctionCall {
     std::string head;            // Like "Plus", "Times", "Sin"
     std::vector<ExprPtr> args;    // Arguments
+    mutable EvaluationStamp evaluation_stamp;
+    mutable SummaryCache summary;
 
     FunctionCall(std::string h, const std::vector<ExprPtr>& a)
         : head(h), args(a) {}
@@ -139,6 +232,48 @@ struct Rule {
     Rule(const ExprPtr& lhs, const ExprPtr& rhs) : lhs(lhs), rhs(rhs) {}
 };
 
+// Insertion-ordered map from expressions to expressions, compared by
+// structure. Values are persistent: insert and erase return a new map that
+// shares the old one's storage. Entries live in an open-addressing table over
+// structural hashes; an update records its change in a small overlay table on
+// top of the shared one, and overlays longer than about sqrt(size) entries are
+// compacted into a fresh table. Lookups probe the overlay, then the base.
+class AssociationMap {
+public:
+    AssociationMap() = default;
+
+    // Later entries for an existing key replace its value in place.
+    [[nodiscard]] static AssociationMap from_entries(const std::vector<std::pair<ExprPtr, ExprPtr>>& entries);
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    // The value stored under `key`, or nullptr.
+    [[nodiscard]] const ExprPtr* find(const ExprPtr& key) const;
+
+    // A new key goes last; an existing key keeps its position.
+    [[nodiscard]] AssociationMap insert(const ExprPtr& key, const ExprPtr& value) const;
+    [[nodiscard]] AssociationMap erase(const ExprPtr& key) const;
+
+    // Entries in insertion order.
+    void for_each(const std::function<void(const ExprPtr& key, const ExprPtr& value)>& visit) const;
+    [[nodiscard]] std::vector<std::pair<ExprPtr, ExprPtr>> entries() const;
+
+    class Table;
+
+private:
+    AssociationMap(std::shared_ptr<const Table> base, std::shared_ptr<const Table> overlay, std::size_t size) noexcept
+        : base_(std::move(base)), overlay_(std::move(overlay)), size_(size) {}
+
+    std::shared_ptr<const Table> base_;
+    std::shared_ptr<const Table> overlay_;
+    std::size_t size_ = 0;
+};
+
+struct Association {
+    AssociationMap map;
+};
+
 struct Infinity {};
 
 struct ComplexInfinity {};
@@ -166,4 +301,99 @@ inline std::string to_string_raw(const ExprPtr& expr_ptr) {
     return to_string_raw(*expr_ptr);
 }
 
+// ExprPtr implementation; needs the complete Expr.
+
+struct ExprNode {
+#if ALEPH3_ATOMIC_EXPR_REFCOUNT
+    using RefCount = std::atomic<std::size_t>;
+#else
+    using RefCount = std::size_t;
+#endif
+
+    template <typename Value>
+    explicit ExprNode(Value&& initial) : value(std::forward<Value>(initial)) {}
+
+    Expr value;
+    RefCount references{1};
+
+    void retain() noexcept {
+#if ALEPH3_ATOMIC_EXPR_REFCOUNT
+        references.fetch_add(1, std::memory_order_relaxed);
+#else
+        ++references;
+#endif
+    }
+
+    // True when this dropped the last reference.
+    [[nodiscard]] bool release() noexcept {
+#if ALEPH3_ATOMIC_EXPR_REFCOUNT
+        return references.fetch_sub(1, std::memory_order_acq_rel) == 1;
+#else
+        return --references == 0;
+#endif
+    }
+};
+
+template <typename Value>
+ExprPtr make_expr_node(Value&& value) {
+    return ExprPtr(new ExprNode(std::forward<Value>(value)));
+}
+
+inline ExprPtr::ExprPtr(const ExprPtr& other) noexcept : node_(other.node_) {
+    if (node_ != nullptr) {
+        node_->retain();
+    }
+}
+
+// Out of line so the recursive variant destructor is not inlined at every
+// handle destruction site.
+void destroy_expr_node(ExprNode* node) noexcept;
+
+inline ExprPtr::~ExprPtr() {
+    if (node_ != nullptr && node_->release()) {
+        destroy_expr_node(node_);
+    }
+}
+
+inline ExprPtr& ExprPtr::operator=(const ExprPtr& other) noexcept {
+    ExprPtr(other).swap(*this);
+    return *this;
 }
+
+inline ExprPtr& ExprPtr::operator=(ExprPtr&& other) noexcept {
+    ExprPtr(std::move(other)).swap(*this);
+    return *this;
+}
+
+inline ExprPtr& ExprPtr::operator=(std::nullptr_t) noexcept {
+    ExprPtr().swap(*this);
+    return *this;
+}
+
+inline Expr* ExprPtr::get() const noexcept {
+    return node_ == nullptr ? nullptr : &node_->value;
+}
+
+inline Expr& ExprPtr::operator*() const noexcept {
+    return node_->value;
+}
+
+inline std::size_t ExprPtr::use_count() const noexcept {
+    if (node_ == nullptr) {
+        return 0;
+    }
+#if ALEPH3_ATOMIC_EXPR_REFCOUNT
+    return node_->references.load(std::memory_order_relaxed);
+#else
+    return node_->references;
+#endif
+}
+
+}
+
+template <>
+struct std::hash<aleph3::ExprPtr> {
+    std::size_t operator()(const aleph3::ExprPtr& ptr) const noexcept {
+        return std::hash<const aleph3::Expr*>{}(ptr.get());
+    }
+};
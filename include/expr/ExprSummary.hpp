@@ -0,0 +1,52 @@
+/*
+ * Expression Summaries
+ * --------------------
+ * Facts about a whole subtree that answer "can this part of the tree matter?"
+ * without walking it: which symbols and heads may occur, how many leaves it
+ * has, how deep it goes and what kinds of numbers it holds.
+ *
+ * A summary is computed once per List or FunctionCall node and kept in the
+ * node, so asking again, or asking about a tree that shares the node, costs
+ * one load. Other nodes are cheap to summarize from their parts.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "expr/Expr.hpp"
+
+namespace aleph3 {
+
+struct ExprSummary {
+    // One bit per name, from name_bloom_bit. A clear bit proves the name does
+    // not occur; a set bit only says it may.
+    std::uint64_t symbols = 0;  // Symbol leaves, assigned and defined names
+    std::uint64_t heads = 0;    // FunctionCall heads, and List, Rule, etc.
+
+    // As Mathematica counts them in FullForm: every atom and every head is a
+    // leaf, and Rational and Complex numbers count three. Saturates at 2^32 - 1.
+    std::uint64_t leaf_count = 1;
+    // 1 for an atom (numbers included), otherwise one more than the deepest
+    // part, heads not counted.
+    std::uint64_t depth = 1;
+
+    bool has_symbols = false;
+    // An atom other than Number, Rational or Complex.
+    bool has_non_numeric_leaf = false;
+    // A Number that is not a finite integer.
+    bool has_fractional_number = false;
+};
+
+[[nodiscard]] std::uint64_t name_bloom_bit(std::string_view name) noexcept;
+
+[[nodiscard]] ExprSummary expr_summary(const ExprPtr& expr);
+
+// False only when `name` certainly occurs nowhere in the subtree, as a
+// symbol or as a head.
+[[nodiscard]] inline bool may_contain_name(const ExprSummary& summary, std::string_view name) noexcept {
+    return ((summary.symbols | summary.heads) & name_bloom_bit(name)) != 0;
+}
+
+}  // namespace aleph3
@@ -145,6 +145,6 @@ namespace aleph3 {
     }
 
     inline ExprPtr make_expr(const Indeterminate&) {
-        return std::make_shared<Expr>(Indeterminate{});
+        return make_expr_node(Indeterminate{});
     }
 }
@@ -72,6 +72,16 @@ inline std::string to_fullform(const ExprPtr& expr) {
             }
             out << "]";
         }
+        void operator()(const Association& a) {
+            out << "Association[";
+            bool first = true;
+            a.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                if (!first) out << ", ";
+                first = false;
+                out << "Rule[" << to_fullform(key) << ", " << to_fullform(value) << "]";
+            });
+            out << "]";
+        }
         void operator()(const Infinity&) {
             out << "Infinity";
         }
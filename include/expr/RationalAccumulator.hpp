@@ -0,0 +1,128 @@
+/*
+ * RationalAccumulator.hpp
+ * -----------------------
+ * Sums exact rationals without reducing after every addition. Terms whose
+ * denominator divides the running denominator are scaled onto it; other
+ * terms multiply the denominators together. The gcd runs only when the
+ * result is read, or when an unreduced step would overflow int64.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+#include "expr/ExprUtils.hpp"
+
+namespace aleph3 {
+
+class RationalAccumulator {
+public:
+    RationalAccumulator() = default;
+    RationalAccumulator(int64_t num, int64_t den) : numerator_(num), denominator_(den) {}
+
+    // Adds num/den (den != 0). Returns false, leaving the sum unchanged, when
+    // the exact sum does not fit in int64 even after reducing.
+    [[nodiscard]] bool add(int64_t num, int64_t den) {
+        if (try_add(num, den)) {
+            return true;
+        }
+        reduce();
+        auto [reduced_num, reduced_den] = normalize_rational(num, den);
+        return try_add_over_lcm(reduced_num, reduced_den);
+    }
+
+    [[nodiscard]] bool add_integer(int64_t value) {
+        return add(value, 1);
+    }
+
+    // Adds (num1/den1) * (num2/den2), cross-reducing the factors only if
+    // their plain product would overflow.
+    [[nodiscard]] bool add_product(int64_t num1, int64_t den1, int64_t num2, int64_t den2) {
+        int64_t num = 0;
+        int64_t den = 0;
+        if (checked_mul(num1, num2, num) && checked_mul(den1, den2, den)) {
+            return add(num, den);
+        }
+        const int64_t g1 = std::gcd(num1, den2);
+        const int64_t g2 = std::gcd(num2, den1);
+        if (!checked_mul(num1 / g1, num2 / g2, num) || !checked_mul(den1 / g2, den2 / g1, den)) {
+            return false;
+        }
+        return add(num, den);
+    }
+
+    [[nodiscard]] bool is_zero() const {
+        return numerator_ == 0;
+    }
+
+    [[nodiscard]] bool is_one() const {
+        return numerator_ == denominator_;
+    }
+
+    [[nodiscard]] double approximate() const {
+        return static_cast<double>(numerator_) / static_cast<double>(denominator_);
+    }
+
+    // Lowest terms, denominator positive.
+    [[nodiscard]] std::pair<int64_t, int64_t> reduced() const {
+        return normalize_rational(numerator_, denominator_);
+    }
+
+private:
+    static bool checked_mul(int64_t a, int64_t b, int64_t& out) {
+        return !__builtin_mul_overflow(a, b, &out);
+    }
+
+    static bool checked_add(int64_t a, int64_t b, int64_t& out) {
+        return !__builtin_add_overflow(a, b, &out);
+    }
+
+    void reduce() {
+        std::tie(numerator_, denominator_) = reduced();
+    }
+
+    bool try_add(int64_t num, int64_t den) {
+        int64_t scaled = 0;
+        int64_t sum = 0;
+        if (denominator_ % den == 0) {
+            if (!checked_mul(num, denominator_ / den, scaled) || !checked_add(numerator_, scaled, sum)) {
+                return false;
+            }
+            numerator_ = sum;
+            return true;
+        }
+
+        int64_t cross = 0;
+        int64_t product = 0;
+        if (!checked_mul(numerator_, den, cross) || !checked_mul(num, denominator_, scaled) ||
+            !checked_add(cross, scaled, sum) || !checked_mul(denominator_, den, product)) {
+            return false;
+        }
+        numerator_ = sum;
+        denominator_ = product;
+        return true;
+    }
+
+    bool try_add_over_lcm(int64_t num, int64_t den) {
+        const int64_t g = std::gcd(denominator_, den);
+        int64_t common = 0;
+        int64_t left = 0;
+        int64_t right = 0;
+        int64_t sum = 0;
+        if (!checked_mul(denominator_ / g, den, common) || !checked_mul(numerator_, den / g, left) ||
+            !checked_mul(num, denominator_ / g, right) || !checked_add(left, right, sum)) {
+            return false;
+        }
+        numerator_ = sum;
+        denominator_ = common;
+        return true;
+    }
+
+    int64_t numerator_ = 0;
+    int64_t denominator_ = 1;
+};
+
+}  // namespace aleph3
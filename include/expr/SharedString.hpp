@@ -0,0 +1,71 @@
+/*
+ * Shared String Storage
+ * ---------------------
+ * Immutable, reference-counted UTF-8 storage for the kernel String type.
+ * Copying a SharedString shares its buffer, so evaluation and normalization
+ * pass strings along without copying their bytes.
+ *
+ * Concatenations above a small size become rope nodes that keep their parts
+ * and flatten once, on the first request for contiguous text, after which the
+ * parts are released. Leaves are only
+ * ever whole inputs or joins of whole inputs, so a rope never splits a UTF-8
+ * sequence.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aleph3 {
+
+class SharedString {
+public:
+    // Joins at or below this many bytes are copied into one flat buffer.
+    static constexpr std::size_t flat_join_limit = 512;
+
+    SharedString();
+    SharedString(std::string text);
+    SharedString(const char* text) : SharedString(std::string(text)) {}
+
+    [[nodiscard]] static SharedString concat(const SharedString& left, const SharedString& right);
+    [[nodiscard]] static SharedString join(const std::vector<SharedString>& parts);
+
+    // Contiguous text. Flattens a rope on first use and keeps only the result.
+    [[nodiscard]] const std::string& str() const;
+    operator const std::string&() const { return str(); }
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    [[nodiscard]] bool is_rope() const noexcept;
+    [[nodiscard]] std::string substr(std::size_t pos, std::size_t count = std::string::npos) const {
+        return str().substr(pos, count);
+    }
+
+    // True when both share one buffer, so equality needs no comparison.
+    [[nodiscard]] bool shares_storage_with(const SharedString& other) const noexcept {
+        return node_ == other.node_;
+    }
+
+    friend bool operator==(const SharedString& lhs, const SharedString& rhs) {
+        return lhs.shares_storage_with(rhs) || (lhs.size() == rhs.size() && lhs.str() == rhs.str());
+    }
+    friend bool operator==(const SharedString& lhs, const std::string& rhs) { return lhs.str() == rhs; }
+    friend bool operator==(const SharedString& lhs, std::string_view rhs) { return lhs.str() == rhs; }
+    friend bool operator==(const SharedString& lhs, const char* rhs) { return lhs.str() == rhs; }
+
+    friend std::ostream& operator<<(std::ostream& out, const SharedString& text) { return out << text.str(); }
+
+    struct Node;
+
+private:
+    explicit SharedString(std::shared_ptr<const Node> node) : node_(std::move(node)) {}
+
+    std::shared_ptr<const Node> node_;
+};
+
+}  // namespace aleph3
@@ -72,6 +72,17 @@ namespace aleph3 {
             {"MatchQ", "MatchQ[expr, pattern]: Test whether expr matches a supported symbolic pattern", "Symbolic"},
             {"Assuming", "Assuming[assumptions, expr]: Evaluate expr using temporary boolean, sign, or domain facts", "Symbolic"},
             {"Refine", "Refine[expr, assumptions]: Simplify expr using temporary boolean, sign, or domain facts", "Symbolic"},
+            {"SetAttributes", "SetAttributes[f, Memoize]: Cache results of the user-defined function f by argument value", "Symbolic"},
+            {"ClearAttributes", "ClearAttributes[f, Memoize]: Stop caching results of f and drop its cached values", "Symbolic"},
+            {"SetDelayed", "SetDelayed[f[pattern], body]: Define f for calls matching pattern; written f[pattern] := body", "Symbolic"},
+            {"Set", "Set[f[pattern], value]: Define f for calls matching pattern with value evaluated now; written f[pattern] = value", "Symbolic"},
+            {"ParallelMap", "ParallelMap[f, list]: Apply f to each element of list across worker threads", "Symbolic"},
+            {"ParallelTable", "ParallelTable[expr, {i, min, max, step}]: Evaluate expr for each i across worker threads", "Symbolic"},
+            {"ParallelSum", "ParallelSum[expr, {i, min, max, step}]: Sum expr over i, evaluating terms across worker threads", "Symbolic"},
+            {"RandomReal", "RandomReal[{min, max}, n]: Uniform reals in [min, max); omit n for one value or give {n1, n2, ...}", "Symbolic"},
+            {"RandomInteger", "RandomInteger[{min, max}, n]: Uniform integers in [min, max]; omit n for one value or give {n1, n2, ...}", "Symbolic"},
+            {"RandomVariate", "RandomVariate[dist, n]: Samples of a Uniform, DiscreteUniform, Normal, LogNormal or Exponential distribution", "Symbolic"},
+            {"SeedRandom", "SeedRandom[n]: Reseed the random builtins so later calls replay the same values", "Symbolic"},
             {"Positive", "Positive[x]: Test whether x is known to be greater than zero", "Symbolic"},
             {"Negative", "Negative[x]: Test whether x is known to be less than zero", "Symbolic"},
             {"NonNegative", "NonNegative[x]: Test whether x is known to be greater than or equal to zero", "Symbolic"},
@@ -81,6 +92,10 @@ namespace aleph3 {
             {"IntegerQ", "IntegerQ[x]: Test whether x is known to be an integer", "Symbolic"},
             {"RationalQ", "RationalQ[x]: Test whether x is known to be an exact rational", "Symbolic"},
             {"RealQ", "RealQ[x]: Test whether x is known to be a real quantity", "Symbolic"},
+            {"FreeQ", "FreeQ[expr, form]: True if no part or head of expr matches form", "Symbolic"},
+            {"Variables", "Variables[expr]: Sorted list of the distinct symbols in expr, other than Pi, E and Degree", "Symbolic"},
+            {"LeafCount", "LeafCount[expr]: Number of atoms and heads in the FullForm of expr", "Symbolic"},
+            {"Depth", "Depth[expr]: 1 for an atom, else one more than the depth of the deepest part", "Symbolic"},
 
             // Polynomial manipulation
             {"Expand", "Expand[expr]: Expand out products and powers in a polynomial expression", "Polynomial"},
@@ -88,6 +103,11 @@ namespace aleph3 {
             {"Collect", "Collect[expr, x]: Collect terms in expr by powers of x", "Polynomial"},
             {"GCD", "GCD[a, b]: Greatest common divisor of two polynomials or integers", "Polynomial"},
             {"PolynomialQuotient", "PolynomialQuotient[a, b, x]: Quotient of a divided by b with respect to variable x", "Polynomial"},
+
+            // Number theory
+            {"PowerMod", "PowerMod[a, b, m]: a^b mod m for integers; a negative b uses the inverse of a", "NumberTheory"},
+            {"PrimeQ", "PrimeQ[n]: True if n is a prime integer", "NumberTheory"},
+            {"FactorInteger", "FactorInteger[n]: List of {prime, exponent} pairs for an integer or rational", "NumberTheory"},
             
             // Logical
             {"And", "And[a, b, ...]: Logical AND (True if all arguments are True)", "Logical"},
@@ -96,11 +116,28 @@ namespace aleph3 {
             // String functions
             {"StringJoin", "StringJoin[str1, str2, ...]: Concatenate strings", "String"},
             {"StringLength", "StringLength[str]: Length of a string", "String"},
-            {"StringReplace", "StringReplace[str, rule]: Replace substrings using a rule", "String"},
+            {"StringReplace", "StringReplace[str, rule | {rules...}]: Replace substrings; at each position the first matching rule wins", "String"},
             {"StringTake", "StringTake[str, n or {start, end}]: Take substring by count or range", "String"},
 
             // List functions
-            {"Length", "Length[list]: Number of elements in a list", "List"},
+            {"Length", "Length[list]: Number of elements in a list or entries in an association", "List"},
+            {"Append", "Append[list, elem]: list with elem added at the end; Append[assoc, key -> value] adds or replaces an entry", "List"},
+            {"Sort", "Sort[list]: Elements in canonical order (numbers, strings, symbols, then compound expressions)", "List"},
+            {"Ordering", "Ordering[list]: Positions that put list in canonical order", "List"},
+            {"Union", "Union[list1, list2, ...]: Sorted list of the distinct elements of all lists", "List"},
+            {"DeleteDuplicates", "DeleteDuplicates[list]: list without repeated elements, keeping first occurrences", "List"},
+            {"Tally", "Tally[list]: {element, count} pairs in order of first occurrence", "List"},
+            {"GatherBy", "GatherBy[list, f]: Sublists of elements with equal f[element], in order of first occurrence", "List"},
+            {"CountsBy", "CountsBy[list, f]: Association from each distinct f[element] to its count", "List"},
+
+            // Associations
+            {"Association", "Association[key -> value, ...]: Insertion-ordered map; later rules for a key replace earlier ones", "Association"},
+            {"Lookup", "Lookup[assoc, key, default]: Value stored under key, else default (or Missing[\"KeyAbsent\", key])", "Association"},
+            {"KeyExistsQ", "KeyExistsQ[assoc, key]: True if assoc has an entry for key", "Association"},
+            {"Keys", "Keys[assoc]: List of keys in insertion order", "Association"},
+            {"Values", "Values[assoc]: List of values in insertion order", "Association"},
+            {"KeyDrop", "KeyDrop[assoc, key | {keys...}]: assoc without the given keys", "Association"},
+            {"Normal", "Normal[assoc]: List of key -> value rules in insertion order", "Association"},
 
             // Numeric
             {"N", "N[expr]: Evaluate numerically", "Numeric"},
@@ -2,40 +2,89 @@
  * Kernel Assumptions Contract
  * ---------------------------
  * Stores temporary assumption facts used by symbolic evaluation and refinement.
- * This header owns the narrow sign, boolean, and symbol-domain fact model
+ * This header owns the sign/interval, boolean, and symbol-domain fact model
  * behind Assuming and Refine, along with lookup helpers that other kernel
  * code can reuse.
+ *
+ * Symbol facts are kept as a three-point sign lattice ({negative, zero,
+ * positive}) plus a numeric interval. Derived facts for compound expressions
+ * are cached by expression identity and by structure, and the caches are
+ * dropped whenever a new assumption is recorded.
+ *
+ * Scoped callers such as Assuming and Refine open a frame, record facts into
+ * the same store, and pop the frame on exit. Popping replays an undo trail,
+ * so a scope costs time proportional to the facts it added.
  */
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "expr/Expr.hpp"
+#include "kernel/Rewrite.hpp"
 
 namespace aleph3::kernel {
 
+inline constexpr unsigned kPositiveSign = 1u;
+inline constexpr unsigned kZeroSign = 2u;
+inline constexpr unsigned kNegativeSign = 4u;
+inline constexpr unsigned kAnySign = kPositiveSign | kZeroSign | kNegativeSign;
+
+// Real interval with independently open or closed ends. Infinite ends are
+// always open; an interval whose ends cross is empty.
+struct NumericInterval {
+    double lower = -std::numeric_limits<double>::infinity();
+    double upper = std::numeric_limits<double>::infinity();
+    bool lower_closed = false;
+    bool upper_closed = false;
+
+    [[nodiscard]] static NumericInterval whole();
+    [[nodiscard]] static NumericInterval point(double value);
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] bool contains(double value) const;
+    [[nodiscard]] unsigned sign_mask() const;
+    [[nodiscard]] NumericInterval intersect(const NumericInterval& other) const;
+};
+
 struct SymbolAssumptionFacts {
     std::optional<bool> boolean_value;
-    bool nonnegative = false;
-    bool positive = false;
-    bool nonpositive = false;
-    bool negative = false;
-    bool zero = false;
-    bool nonzero = false;
+    unsigned signs = kAnySign;
+    NumericInterval interval;
+    bool integer = false;
+    bool rational = false;
+    bool real = false;
+};
+
+// Facts derived for an arbitrary expression. `signs` already folds in the
+// interval, so callers only need to read one of the two.
+struct DerivedAssumptionFacts {
+    unsigned signs = kAnySign;
+    NumericInterval interval;
     bool integer = false;
     bool rational = false;
     bool real = false;
+
+    [[nodiscard]] bool unknown() const { return signs == kAnySign && !real; }
 };
 
 class AssumptionStore {
 public:
     void assume(const ExprPtr& expr);
 
+    void push_frame();
+    void pop_frame();
+    [[nodiscard]] std::size_t frame_depth() const;
+
     [[nodiscard]] std::optional<bool> find_boolean_value(std::string_view symbol_name) const;
     [[nodiscard]] std::optional<bool> evaluate_predicate(
         std::string_view predicate_name,
@@ -45,14 +94,59 @@ public:
         const ExprPtr& left,
         const ExprPtr& right) const;
     [[nodiscard]] const SymbolAssumptionFacts* find_symbol_facts(std::string_view symbol_name) const;
+    [[nodiscard]] DerivedAssumptionFacts derive_facts(const ExprPtr& expr) const;
+    [[nodiscard]] std::size_t cached_derivation_count() const;
+    // Derivations, compound subterms included, answered from the caches.
+    [[nodiscard]] std::size_t derivation_cache_hits() const;
 
 private:
     void assume_boolean_symbol(std::string name, bool value);
     void assume_comparison(const FunctionCall& comparison);
     void assume_sign_fact(std::string symbol_name, const std::string& head);
+    void assume_bound(const std::string& symbol_name, const std::string& head, const ExprPtr& bound);
+    void clear_derivation_caches();
+    SymbolAssumptionFacts& mutable_symbol_facts(const std::string& symbol_name);
+    void insert_exact_true_form(ExprPtr form);
+
+    // One undo step: either a symbol's facts before the frame touched them
+    // (nullopt when the symbol had none) or an exact form to forget.
+    struct TrailEntry {
+        std::string symbol_name;
+        std::optional<SymbolAssumptionFacts> previous_facts;
+        ExprPtr exact_form;
+    };
 
     std::unordered_map<std::string, SymbolAssumptionFacts> symbol_facts_;
-    std::unordered_set<std::string> exact_true_forms_;
+    std::unordered_set<ExprPtr, StructuralExprHash, StructuralExprEqual> exact_true_forms_;
+    // Union of the name blooms of exact_true_forms_ (see ExprSummary.hpp);
+    // a comparison naming anything outside it cannot be one of them.
+    std::uint64_t exact_form_names_ = 0;
+    std::vector<TrailEntry> trail_;
+    std::vector<std::size_t> frame_marks_;
+
+    // The identity cache pins the expression it is keyed by so a recycled
+    // address can never alias a stale entry.
+    mutable std::unordered_map<const Expr*, std::pair<ExprPtr, DerivedAssumptionFacts>>
+        identity_cache_;
+    mutable std::unordered_map<ExprPtr, DerivedAssumptionFacts, StructuralExprHash, StructuralExprEqual>
+        structural_cache_;
+    mutable std::size_t derivation_cache_hits_ = 0;
+};
+
+// Opens an assumption frame for the lifetime of the guard and pops it on
+// scope exit, including when evaluation inside the scope throws.
+class ScopedAssumptionFrame {
+public:
+    explicit ScopedAssumptionFrame(AssumptionStore& assumptions) : assumptions_(assumptions) {
+        assumptions_.push_frame();
+    }
+    ~ScopedAssumptionFrame() { assumptions_.pop_frame(); }
+
+    ScopedAssumptionFrame(const ScopedAssumptionFrame&) = delete;
+    ScopedAssumptionFrame& operator=(const ScopedAssumptionFrame&) = delete;
+
+private:
+    AssumptionStore& assumptions_;
 };
 
 ExprPtr refine_expr_with_assumptions(const ExprPtr& expr, const AssumptionStore& assumptions);
@@ -0,0 +1,88 @@
+/*
+ * Kernel Counter-Based Random Numbers
+ * -----------------------------------
+ * Philox4x32-10 streams for the random builtins. Draw i of a stream is a pure
+ * function of (seed, stream, i), so any range of draws can be produced on any
+ * thread, in any order, and come out the same as a sequential run.
+ *
+ * A Philox block holds four 32-bit words; each draw takes two of them, so
+ * block j yields draws 2j and 2j+1. Bulk fills work on several blocks at a
+ * time in separate word arrays, which the compiler vectorizes.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "sdk/Types.hpp"
+
+namespace aleph3::kernel {
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+// Ten Philox4x32 rounds over one counter block.
+[[nodiscard]] PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) noexcept;
+
+// A well-mixed stream number for item `index` of the stream `parent`, used
+// to give every parallel work item an independent stream.
+[[nodiscard]] constexpr std::uint64_t derive_random_stream(std::uint64_t parent, std::uint64_t index) noexcept {
+    // splitmix64 finalizer over the pair.
+    std::uint64_t z = parent ^ (index + 0x9E3779B97F4A7C15ULL) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// A seed from the system entropy source, for contexts that were not seeded.
+[[nodiscard]] std::uint64_t entropy_random_seed();
+
+class RandomStream {
+public:
+    RandomStream(std::uint64_t seed, std::uint64_t stream) noexcept;
+
+    // 64 random bits for draw `index`.
+    [[nodiscard]] std::uint64_t bits(std::uint64_t index) const noexcept;
+
+    // Each fill writes draws [first, first + out.size()). Fills of more than
+    // one chunk are split across `thread_count` threads (0 means one per
+    // hardware thread); the output does not depend on the split.
+
+    // Uniform in [0, 1), 53 bits per value.
+    void fill_uniform(std::span<double> out, std::uint64_t first = 0, std::size_t thread_count = 1) const;
+
+    // Standard normal by Box-Muller; draws 2j and 2j+1 share block j.
+    void fill_normal(std::span<double> out, std::uint64_t first = 0, std::size_t thread_count = 1) const;
+
+    // Integers in [low, low + width - 1], width >= 1, by 128-bit
+    // multiply-shift. The bias is below width / 2^64.
+    void fill_integers(
+        std::span<double> out,
+        std::int64_t low,
+        std::uint64_t width,
+        std::uint64_t first = 0,
+        std::size_t thread_count = 1) const;
+
+private:
+    PhiloxKey key_;
+    std::uint32_t stream_low_;
+    std::uint32_t stream_high_;
+};
+
+// What makes the parameters of a distribution invalid, e.g. "requires a
+// positive rate"; nullptr when they are valid.
+[[nodiscard]] const char* invalid_distribution_reason(const Distribution& distribution) noexcept;
+
+// Draws [first, first + out.size()) of the stream, transformed to follow the
+// distribution, which must be valid.
+void fill_distribution(
+    const RandomStream& stream,
+    const Distribution& distribution,
+    std::span<double> out,
+    std::uint64_t first = 0,
+    std::size_t thread_count = 1);
+
+}  // namespace aleph3::kernel
@@ -37,6 +37,7 @@ enum class ErrorCode {
     invalid_host_result,
     unknown_function,
     step_budget_exhausted,
+    list_limit_exceeded,
     empty_ir,
     empty_node,
     unsupported_node,
@@ -79,6 +80,8 @@ enum class ErrorCode {
             return "kernel.unknown_function";
         case ErrorCode::step_budget_exhausted:
             return "kernel.step_budget_exhausted";
+        case ErrorCode::list_limit_exceeded:
+            return "kernel.list_limit_exceeded";
         case ErrorCode::empty_ir:
             return "kernel.empty_ir";
         case ErrorCode::empty_node:
@@ -127,6 +130,8 @@ enum class ErrorCode {
             return "runtime.unknown_function";
         case ErrorCode::step_budget_exhausted:
             return "runtime.step_budget_exhausted";
+        case ErrorCode::list_limit_exceeded:
+            return "runtime.list_limit_exceeded";
         case ErrorCode::empty_ir:
             return "runtime.empty_ir";
         case ErrorCode::empty_node:
@@ -8,13 +8,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
 #include "kernel/Assumptions.hpp"
+#include "kernel/CounterRandom.hpp"
 #include "kernel/Diagnostics.hpp"
+#include "kernel/FunctionMemo.hpp"
 #include "kernel/FunctionRegistry.hpp"
+#include "kernel/PatternDefinitions.hpp"
 #include "expr/Expr.hpp"
 #include "sdk/Policy.hpp"
 #include "sdk/Types.hpp"
@@ -22,19 +29,50 @@
 
 namespace aleph3::kernel {
 
+// Lets a scheduler time-slice strict evaluations. While one is installed on
+// a thread, strict contexts created there call `yield` once every `length`
+// evaluation steps; it may block until the evaluation is given another slice.
+struct StepSlice {
+    std::size_t length = 0;
+    std::function<void()> yield;
+    // Steps counted so far, and steps left before the next yield.
+    std::size_t steps = 0;
+    std::size_t remaining = 0;
+};
+
+inline thread_local StepSlice* active_step_slice = nullptr;
+
+// Installs a slice on this thread for the lifetime of the scope.
+class ScopedStepSlice {
+public:
+    explicit ScopedStepSlice(StepSlice& slice) noexcept : previous_(active_step_slice) {
+        slice.remaining = slice.length;
+        active_step_slice = slice.length > 0 && slice.yield ? &slice : nullptr;
+    }
+    ~ScopedStepSlice() { active_step_slice = previous_; }
+
+    ScopedStepSlice(const ScopedStepSlice&) = delete;
+    ScopedStepSlice& operator=(const ScopedStepSlice&) = delete;
+
+private:
+    StepSlice* previous_;
+};
+
 class EvaluationContext {
 public:
     EvaluationContext()
         : runtime_state_(std::make_shared<RuntimeSemanticsState>()),
+          function_memo_(std::make_shared<FunctionMemoStore>()),
           function_registry_ptr_(&default_function_registry()),
-          variables(symbol_values.entries()),
-          user_functions(function_definitions.entries()) {}
+          variables(symbol_values.unobserved_entries()),
+          user_functions(function_definitions.unobserved_entries()) {}
 
     explicit EvaluationContext(const FunctionRegistry& function_registry)
         : runtime_state_(std::make_shared<RuntimeSemanticsState>()),
+          function_memo_(std::make_shared<FunctionMemoStore>()),
           function_registry_ptr_(&function_registry),
-          variables(symbol_values.entries()),
-          user_functions(function_definitions.entries()) {}
+          variables(symbol_values.unobserved_entries()),
+          user_functions(function_definitions.unobserved_entries()) {}
 
     EvaluationContext(
         const Bindings& bindings,
@@ -43,9 +81,10 @@ public:
         const Policy& policy,
         const FunctionRegistry& function_registry = default_function_registry())
         : runtime_state_(std::make_shared<RuntimeSemanticsState>()),
+          function_memo_(std::make_shared<FunctionMemoStore>()),
           function_registry_ptr_(&function_registry),
-          variables(symbol_values.entries()),
-          user_functions(function_definitions.entries()),
+          variables(symbol_values.unobserved_entries()),
+          user_functions(function_definitions.unobserved_entries()),
           bindings_ptr_(&bindings),
           constants_ptr_(&constants),
           host_functions_ptr_(&host_functions),
@@ -57,14 +96,16 @@ public:
           assumptions(other.assumptions),
           definition_records(other.definition_records),
           function_definitions(other.function_definitions),
+          pattern_definitions(other.pattern_definitions),
           owned_bindings_(other.owned_bindings_),
           owned_constants_(other.owned_constants_),
           owned_host_functions_(other.owned_host_functions_),
           owned_policy_(other.owned_policy_),
           runtime_state_(other.runtime_state_),
+          function_memo_(other.function_memo_),
           function_registry_ptr_(other.function_registry_ptr_),
-          variables(symbol_values.entries()),
-          user_functions(function_definitions.entries()) {
+          variables(symbol_values.unobserved_entries()),
+          user_functions(function_definitions.unobserved_entries()) {
         copy_runtime_sources(other);
     }
 
@@ -74,14 +115,16 @@ public:
           assumptions(std::move(other.assumptions)),
           definition_records(std::move(other.definition_records)),
           function_definitions(std::move(other.function_definitions)),
+          pattern_definitions(std::move(other.pattern_definitions)),
           owned_bindings_(std::move(other.owned_bindings_)),
           owned_constants_(std::move(other.owned_constants_)),
           owned_host_functions_(std::move(other.owned_host_functions_)),
           owned_policy_(std::move(other.owned_policy_)),
           runtime_state_(std::move(other.runtime_state_)),
+          function_memo_(std::move(other.function_memo_)),
           function_registry_ptr_(other.function_registry_ptr_),
-          variables(symbol_values.entries()),
-          user_functions(function_definitions.entries()) {
+          variables(symbol_values.unobserved_entries()),
+          user_functions(function_definitions.unobserved_entries()) {
         move_runtime_sources(other);
     }
 
@@ -92,11 +135,13 @@ public:
             assumptions = other.assumptions;
             definition_records = other.definition_records;
             function_definitions = other.function_definitions;
+            pattern_definitions = other.pattern_definitions;
             owned_bindings_ = other.owned_bindings_;
             owned_constants_ = other.owned_constants_;
             owned_host_functions_ = other.owned_host_functions_;
             owned_policy_ = other.owned_policy_;
             runtime_state_ = other.runtime_state_;
+            function_memo_ = other.function_memo_;
             function_registry_ptr_ = other.function_registry_ptr_;
             copy_runtime_sources(other);
         }
@@ -110,11 +155,13 @@ public:
             assumptions = std::move(other.assumptions);
             definition_records = std::move(other.definition_records);
             function_definitions = std::move(other.function_definitions);
+            pattern_definitions = std::move(other.pattern_definitions);
             owned_bindings_ = std::move(other.owned_bindings_);
             owned_constants_ = std::move(other.owned_constants_);
             owned_host_functions_ = std::move(other.owned_host_functions_);
             owned_policy_ = std::move(other.owned_policy_);
             runtime_state_ = std::move(other.runtime_state_);
+            function_memo_ = std::move(other.function_memo_);
             function_registry_ptr_ = other.function_registry_ptr_;
             move_runtime_sources(other);
         }
@@ -143,12 +190,20 @@ public:
 
     void enable_runtime_strict_semantics(bool enabled = true) {
         runtime_state_->strict_runtime_semantics = enabled;
+        runtime_state_->step_slice = enabled ? active_step_slice : nullptr;
+        symbols::advance_modification_count();
     }
 
     [[nodiscard]] bool strict_runtime_semantics() const noexcept {
         return runtime_state_->strict_runtime_semantics;
     }
 
+    // Identifies this context and its copies in evaluation stamps, so a node
+    // evaluated against one root context is never trusted by another.
+    [[nodiscard]] std::uint64_t evaluation_lineage() const noexcept {
+        return runtime_state_->lineage;
+    }
+
     void reset_runtime_step_counter() noexcept {
         runtime_state_->evaluation_steps_used = 0;
     }
@@ -157,12 +212,151 @@ public:
         if (!runtime_state_->strict_runtime_semantics) {
             return;
         }
-        ++runtime_state_->evaluation_steps_used;
-        if (runtime_state_->evaluation_steps_used > policy().budget().max_evaluation_steps) {
+        count_evaluation_steps(1);
+        check_step_budget();
+        advance_step_slice(1);
+    }
+
+    // The same, for a caller instantiated for EvaluationTraits that match
+    // this context; unbudgeted traits compile it to nothing.
+    template <typename Traits>
+    void consume_evaluation_step(Traits) {
+        if constexpr (Traits::budgeted) {
+            count_evaluation_steps(1);
+            check_step_budget();
+            advance_step_slice(1);
+        }
+    }
+
+    // Under strict runtime semantics, fails for a list longer than the
+    // policy's max_list_elements.
+    void check_list_length(std::size_t length) const {
+        if (runtime_state_->strict_runtime_semantics && length > policy().budget().max_list_elements) {
             throw_runtime_error(
-                ErrorCode::step_budget_exhausted,
-                "Evaluation exceeded the configured step budget.");
+                ErrorCode::list_limit_exceeded,
+                "List exceeded the configured element limit.");
+        }
+    }
+
+    [[nodiscard]] std::size_t evaluation_steps_used() const noexcept {
+        return runtime_state_->evaluation_steps_used;
+    }
+
+    // Adds steps that were counted by forked workers, failing the same way
+    // consume_evaluation_step does once the budget is crossed. A worker's
+    // shared counter already holds them, so only its own count grows.
+    void charge_evaluation_steps(std::size_t steps) {
+        if (!runtime_state_->strict_runtime_semantics || steps == 0) {
+            return;
+        }
+        runtime_state_->evaluation_steps_used += steps;
+        check_step_budget();
+        advance_step_slice(steps);
+    }
+
+    // Steps taken by all the workers of one Parallel* call, so that together
+    // they stop once the parent's remaining budget is spent.
+    using SharedStepCounter = std::shared_ptr<std::atomic<std::uint64_t>>;
+
+    // The counter for the workers of a new Parallel* call. Workers forked
+    // from a worker keep charging the counter of the call they belong to.
+    [[nodiscard]] SharedStepCounter parallel_step_counter() const {
+        if (runtime_state_->shared_steps) {
+            return runtime_state_->shared_steps;
+        }
+        return std::make_shared<std::atomic<std::uint64_t>>(0);
+    }
+
+    // A context for one parallel work item. It sees the same values,
+    // definitions and assumptions, but memoizes on its own and drops
+    // anything it assigns. Its budget is what the parent has left: given a
+    // shared counter, that budget is spent by every worker holding the
+    // counter, otherwise by this worker alone. Its random streams are
+    // derived from the item index, not from the thread.
+    [[nodiscard]] EvaluationContext fork_parallel_worker(
+        std::size_t item_index = 0,
+        SharedStepCounter shared_steps = nullptr) const {
+        EvaluationContext worker(*this);
+        auto state = std::make_shared<RuntimeSemanticsState>(*runtime_state_);
+        // A nested fork on the same counter keeps the call's starting usage:
+        // the steps this worker took since are already on the counter.
+        if (!shared_steps || shared_steps != runtime_state_->shared_steps) {
+            state->steps_used_before_fork =
+                runtime_state_->steps_used_before_fork + runtime_state_->evaluation_steps_used;
+        }
+        state->shared_steps = std::move(shared_steps);
+        state->evaluation_steps_used = 0;
+        state->parallel_worker = true;
+        // Workers may run on other threads; only the root yields.
+        state->step_slice = nullptr;
+        state->random_stream_parent = derive_random_stream(
+            derive_random_stream(runtime_state_->random_stream_parent, runtime_state_->random_streams_used),
+            item_index);
+        state->random_streams_used = 0;
+        worker.runtime_state_ = std::move(state);
+        worker.function_memo_ = std::make_shared<FunctionMemoStore>();
+        worker.function_memo_->set_policy(function_memo_->policy());
+        return worker;
+    }
+
+    [[nodiscard]] bool is_parallel_worker() const noexcept {
+        return runtime_state_->parallel_worker;
+    }
+
+    // Threads used by the Parallel* builtins; 0 means one per hardware thread.
+    void set_parallel_thread_count(std::size_t count) noexcept {
+        runtime_state_->parallel_thread_count = count;
+    }
+
+    [[nodiscard]] std::size_t parallel_thread_count() const noexcept {
+        return runtime_state_->parallel_thread_count;
+    }
+
+    // Seed of the random builtins: the last SeedRandom, else the policy's
+    // seed, else a fresh one drawn on first use.
+    [[nodiscard]] std::uint64_t random_seed() const {
+        if (!runtime_state_->random_seed) {
+            runtime_state_->random_seed = policy().random_seed() ? *policy().random_seed() : entropy_random_seed();
         }
+        return *runtime_state_->random_seed;
+    }
+
+    void seed_random(std::uint64_t seed) noexcept {
+        runtime_state_->random_seed = seed;
+        runtime_state_->random_stream_parent = 0;
+        runtime_state_->random_streams_used = 0;
+    }
+
+    // Every random builtin call takes its own stream, so successive calls
+    // differ and a given seed replays the same sequence of calls.
+    [[nodiscard]] RandomStream next_random_stream() const {
+        const auto stream =
+            derive_random_stream(runtime_state_->random_stream_parent, runtime_state_->random_streams_used++);
+        return RandomStream(random_seed(), stream);
+    }
+
+    // Skips the stream a parallel call hands out to its items, so the next
+    // call does not reuse it.
+    void advance_random_stream() noexcept {
+        ++runtime_state_->random_streams_used;
+    }
+
+    // Memoized user-function results. Shared with copies of this context so
+    // values computed inside a call frame outlive that frame.
+    [[nodiscard]] FunctionMemoStore& function_memo() noexcept {
+        return *function_memo_;
+    }
+
+    [[nodiscard]] const FunctionMemoStore& function_memo() const noexcept {
+        return *function_memo_;
+    }
+
+    void set_memo_policy(MemoPolicy policy) {
+        function_memo_->set_policy(policy);
+    }
+
+    [[nodiscard]] const MemoPolicy& memo_policy() const noexcept {
+        return function_memo_->policy();
     }
 
     symbols::SymbolValueTable symbol_values;
@@ -170,7 +364,12 @@ public:
     AssumptionStore assumptions;
     symbols::SymbolDefinitionTable definition_records;
     symbols::FunctionDefinitionTable function_definitions;
+    PatternDefinitionTable pattern_definitions;
 
+    // Aliases of the two tables above. Binding them is not a write, so
+    // building or copying a context leaves evaluation stamps valid; writing
+    // through them directly should be followed by
+    // symbols::advance_modification_count().
     std::unordered_map<std::string, ExprPtr>& variables;
     std::unordered_map<std::string, FunctionDefinition>& user_functions;
 
@@ -178,8 +377,56 @@ private:
     struct RuntimeSemanticsState {
         bool strict_runtime_semantics = false;
         std::size_t evaluation_steps_used = 0;
+        std::uint64_t lineage = next_lineage();
+        // Set on forked workers: the parent's usage when the fork was taken.
+        std::size_t steps_used_before_fork = 0;
+        // Set on workers of a Parallel* call: the steps all of them took.
+        SharedStepCounter shared_steps;
+        bool parallel_worker = false;
+        std::size_t parallel_thread_count = 0;
+        std::optional<std::uint64_t> random_seed;
+        std::uint64_t random_stream_parent = 0;
+        std::uint64_t random_streams_used = 0;
+        StepSlice* step_slice = nullptr;
     };
 
+    void advance_step_slice(std::size_t steps) {
+        auto* slice = runtime_state_->step_slice;
+        if (slice == nullptr) {
+            return;
+        }
+        slice->steps += steps;
+        if (steps < slice->remaining) {
+            slice->remaining -= steps;
+            return;
+        }
+        slice->remaining = slice->length;
+        slice->yield();
+    }
+
+    void count_evaluation_steps(std::size_t steps) noexcept {
+        runtime_state_->evaluation_steps_used += steps;
+        if (runtime_state_->shared_steps) {
+            runtime_state_->shared_steps->fetch_add(steps, std::memory_order_relaxed);
+        }
+    }
+
+    void check_step_budget() const {
+        const std::uint64_t used = runtime_state_->shared_steps
+            ? runtime_state_->shared_steps->load(std::memory_order_relaxed)
+            : runtime_state_->evaluation_steps_used;
+        if (runtime_state_->steps_used_before_fork + used > policy().budget().max_evaluation_steps) {
+            throw_runtime_error(
+                ErrorCode::step_budget_exhausted,
+                "Evaluation exceeded the configured step budget.");
+        }
+    }
+
+    static std::uint64_t next_lineage() noexcept {
+        static std::atomic<std::uint64_t> counter{1};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
     void copy_runtime_sources(const EvaluationContext& other) noexcept {
         bindings_ptr_ = other.bindings_ptr_ == &other.owned_bindings_ ? &owned_bindings_ : other.bindings_ptr_;
         constants_ptr_ = other.constants_ptr_ == &other.owned_constants_ ? &owned_constants_ : other.constants_ptr_;
@@ -201,6 +448,7 @@ private:
     std::unordered_map<std::string, HostFunctionSpec> owned_host_functions_;
     Policy owned_policy_ = Policy::default_policy();
     std::shared_ptr<RuntimeSemanticsState> runtime_state_;
+    std::shared_ptr<FunctionMemoStore> function_memo_;
 
     const Bindings* bindings_ptr_ = &owned_bindings_;
     const Bindings* constants_ptr_ = &owned_constants_;
@@ -209,4 +457,42 @@ private:
     const FunctionRegistry* function_registry_ptr_ = nullptr;
 };
 
+// Scopes Assuming and Refine: assumption facts, symbol values, and user
+// definitions and attributes recorded inside the guard are rolled back on
+// scope exit, including when evaluation inside the scope throws. Nothing is
+// copied up front; each table keeps an undo trail of what the scope
+// overwrote. Memoized results of every head whose definitions or attributes
+// were rolled back are dropped, since they were computed from the scoped ones.
+class ScopedEvaluationFrame {
+public:
+    explicit ScopedEvaluationFrame(EvaluationContext& ctx) : ctx_(ctx) {
+        ctx_.assumptions.push_frame();
+        ctx_.symbol_values.push_frame();
+        ctx_.symbol_metadata.push_frame();
+        ctx_.definition_records.push_frame();
+        ctx_.function_definitions.push_frame();
+        ctx_.pattern_definitions.push_frame();
+    }
+    ~ScopedEvaluationFrame() {
+        std::vector<std::string> heads = ctx_.pattern_definitions.pop_frame();
+        const auto append = [&heads](std::vector<std::string> names) {
+            heads.insert(heads.end(), names.begin(), names.end());
+        };
+        append(ctx_.function_definitions.pop_frame());
+        append(ctx_.definition_records.pop_frame());
+        append(ctx_.symbol_metadata.pop_frame());
+        ctx_.symbol_values.pop_frame();
+        ctx_.assumptions.pop_frame();
+        for (const auto& head : heads) {
+            ctx_.function_memo().clear(head);
+        }
+    }
+
+    ScopedEvaluationFrame(const ScopedEvaluationFrame&) = delete;
+    ScopedEvaluationFrame& operator=(const ScopedEvaluationFrame&) = delete;
+
+private:
+    EvaluationContext& ctx_;
+};
+
 }  // namespace aleph3::kernel
@@ -0,0 +1,52 @@
+/*
+ * Kernel Evaluation Traits
+ * ------------------------
+ * Compile-time descriptions of how an evaluation runs, so hot evaluator code
+ * can be instantiated once per kind of evaluation instead of testing the
+ * context's runtime flags on every step and every numeric operation. The
+ * traits are read from the context once, at an entry point, and passed down
+ * as a type.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include "kernel/EvaluationContext.hpp"
+
+namespace aleph3::kernel {
+
+// Logging is compiled in under the same condition as ALEPH3_LOG.
+#ifdef _DEBUG
+inline constexpr bool kTraceEvaluations = true;
+#else
+inline constexpr bool kTraceEvaluations = false;
+#endif
+
+template <bool Budgeted, bool Strict, bool Tracing>
+struct EvaluationTraits {
+    // Counts evaluation steps against the policy budget and any step slice.
+    static constexpr bool budgeted = Budgeted;
+    // Applies the runtime checks: bound variables, finite numbers, numeric
+    // domains and operand types.
+    static constexpr bool strict = Strict;
+    static constexpr bool tracing = Tracing;
+};
+
+// The symbolic kernel: no budget, unevaluated forms for anything it cannot
+// reduce.
+using LenientEvaluation = EvaluationTraits<false, false, kTraceEvaluations>;
+// The SDK runtime: every step is budgeted and every check applies.
+using StrictEvaluation = EvaluationTraits<true, true, kTraceEvaluations>;
+
+// Calls visit with the traits matching the context's runtime semantics. Only
+// strict contexts count steps, so these are the two kinds in use.
+template <typename Visit>
+decltype(auto) with_evaluation_traits(const EvaluationContext& ctx, Visit&& visit) {
+    if (ctx.strict_runtime_semantics()) {
+        return std::forward<Visit>(visit)(StrictEvaluation{});
+    }
+    return std::forward<Visit>(visit)(LenientEvaluation{});
+}
+
+}  // namespace aleph3::kernel
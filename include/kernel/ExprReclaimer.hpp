@@ -0,0 +1,68 @@
+/*
+ * Kernel Expression Reclaimer
+ * ---------------------------
+ * Frees large dead expression trees on a background thread, so the thread
+ * that produced one can hand it off and return at once. Small trees, and
+ * trees that something else still references, are freed in place.
+ *
+ * Hand-offs need atomically counted nodes: a queued tree may share parts
+ * with trees other threads are still using. Builds with plain counts free
+ * every tree in place.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "expr/Expr.hpp"
+#include "sdk/Types.hpp"
+
+namespace aleph3::kernel {
+
+class ExprReclaimer {
+public:
+    // Trees with fewer nodes cost less to free than to queue.
+    static constexpr std::size_t kDefaultMinNodes = 4096;
+
+    explicit ExprReclaimer(std::size_t min_nodes = kDefaultMinNodes);
+    // Frees whatever is still queued before returning.
+    ~ExprReclaimer();
+
+    ExprReclaimer(const ExprReclaimer&) = delete;
+    ExprReclaimer& operator=(const ExprReclaimer&) = delete;
+
+    // Takes the tree and queues it if `tree` holds the last reference to a
+    // root with at least min_nodes nodes below it; otherwise drops it here.
+    // True when it was queued.
+    bool retire(ExprPtr tree);
+
+    // Returns once every tree queued so far has been freed.
+    void drain();
+
+    [[nodiscard]] ReclamationMetrics metrics() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+
+    std::size_t min_nodes_;
+    mutable std::mutex mutex_;
+    std::condition_variable queued_;
+    std::condition_variable drained_;
+    std::deque<std::pair<ExprPtr, Clock::time_point>> queue_;
+    // Trees taken off the queue and still being freed.
+    std::size_t in_flight_ = 0;
+    bool stopping_ = false;
+    ReclamationMetrics metrics_;
+    // Started by the first hand-off.
+    std::thread worker_;
+};
+
+}  // namespace aleph3::kernel
@@ -0,0 +1,100 @@
+/*
+ * Kernel Fair Scheduler
+ * ---------------------
+ * Shares a fixed number of run slots among evaluations from many tenants.
+ * An evaluation holds a slot while it runs. At the end of each step slice it
+ * hands the slot to the waiter that is owed it most: a higher priority class
+ * first, then the tenant that has had the fewest steps for its weight, then
+ * the earliest arrival. The evaluation may be that waiter and keep running.
+ *
+ * Evaluations run on the threads that submit them. One that gives up its
+ * slot parks its thread at a step boundary until the slot comes back, so the
+ * evaluator needs no resumable state of its own.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdk/Types.hpp"
+
+namespace aleph3::kernel {
+
+class FairScheduler {
+public:
+    struct RunStats {
+        // Time spent waiting for a slot, first and after each hand-off.
+        std::chrono::nanoseconds queue_delay{0};
+        // Times the evaluation gave its slot to another.
+        std::size_t yields = 0;
+    };
+
+    struct Load {
+        std::size_t running = 0;
+        std::size_t waiting = 0;
+        std::size_t completed = 0;
+        std::size_t yields = 0;
+    };
+
+    // A slice_steps of 0 never takes a slot back from a running evaluation.
+    FairScheduler(std::size_t slots, std::size_t slice_steps);
+
+    FairScheduler(const FairScheduler&) = delete;
+    FairScheduler& operator=(const FairScheduler&) = delete;
+
+    // Tenants not given a weight have weight 1.
+    void set_tenant_weight(const std::string& tenant, double weight);
+
+    // Calls `work` on this thread once it holds a slot. Strict evaluations it
+    // runs yield at slice boundaries. An exception from `work` is rethrown
+    // after the slot is released.
+    RunStats run(const std::string& tenant, PriorityClass priority, const std::function<void()>& work);
+
+    [[nodiscard]] Load load() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Tenant {
+        double weight = 1.0;
+        // Steps received over weight. A tenant that was idle restarts at the
+        // scheduler's clock, so idling earns no credit.
+        double virtual_time = 0.0;
+    };
+
+    struct Waiter {
+        Tenant* tenant = nullptr;
+        PriorityClass priority = PriorityClass::standard;
+        std::uint64_t arrival = 0;
+        bool granted = false;
+        std::condition_variable wake;
+    };
+
+    // Queues `waiter` and returns, with the lock held, once it has a slot;
+    // true when it had to wait, which is added to `stats`.
+    bool acquire(std::unique_lock<std::mutex>& lock, Waiter& waiter, RunStats& stats);
+    void charge(Tenant& tenant, std::size_t steps);
+    // Grants free slots to the waiters owed them most.
+    void dispatch();
+
+    std::size_t slots_;
+    std::size_t slice_steps_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Tenant> tenants_;
+    std::vector<Waiter*> waiting_;
+    std::size_t running_ = 0;
+    std::size_t completed_ = 0;
+    std::size_t yields_ = 0;
+    std::uint64_t next_arrival_ = 0;
+    double virtual_clock_ = 0.0;
+};
+
+}  // namespace aleph3::kernel
@@ -0,0 +1,77 @@
+/*
+ * Kernel Function Memo
+ * --------------------
+ * Bounded result caches for user-defined functions that carry the Memoize
+ * attribute. Entries are keyed by the structure of the evaluated argument
+ * list, so equal arguments hit regardless of which tree produced them.
+ *
+ * One FunctionMemoStore is shared by an EvaluationContext and its copies; the
+ * eviction policy is configured on that context.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "expr/Expr.hpp"
+#include "kernel/Rewrite.hpp"
+
+namespace aleph3::kernel {
+
+enum class MemoEvictionPolicy {
+    // Drop the entry that was looked up or stored least recently.
+    least_recently_used,
+    // Drop the oldest stored entry regardless of later hits.
+    first_in_first_out,
+    // Forget the whole function cache once it is full.
+    clear_when_full
+};
+
+struct MemoPolicy {
+    std::size_t max_entries_per_function = 4096;
+    MemoEvictionPolicy eviction = MemoEvictionPolicy::least_recently_used;
+};
+
+class FunctionMemoTable {
+public:
+    [[nodiscard]] ExprPtr lookup(const ExprPtr& arguments, MemoEvictionPolicy eviction);
+    void store(ExprPtr arguments, ExprPtr value, const MemoPolicy& policy);
+
+    [[nodiscard]] std::size_t size() const { return index_.size(); }
+    void clear();
+
+private:
+    struct Entry {
+        ExprPtr arguments;
+        ExprPtr value;
+    };
+
+    // Front is the next entry to evict under the ordered policies.
+    std::list<Entry> order_;
+    std::unordered_map<ExprPtr, std::list<Entry>::iterator, StructuralExprHash, StructuralExprEqual>
+        index_;
+};
+
+class FunctionMemoStore {
+public:
+    // Arguments are the already evaluated, default-filled argument list.
+    [[nodiscard]] ExprPtr lookup(const std::string& name, const std::vector<ExprPtr>& arguments);
+    void store(const std::string& name, const std::vector<ExprPtr>& arguments, ExprPtr value);
+
+    void clear(const std::string& name);
+    void clear();
+    [[nodiscard]] std::size_t entry_count(const std::string& name) const;
+
+    [[nodiscard]] const MemoPolicy& policy() const noexcept { return policy_; }
+    void set_policy(MemoPolicy policy);
+
+private:
+    std::unordered_map<std::string, FunctionMemoTable> tables_;
+    MemoPolicy policy_;
+};
+
+}  // namespace aleph3::kernel
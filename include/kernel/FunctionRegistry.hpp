@@ -3,12 +3,17 @@
  * ------------------------
  * Shared registration catalog for symbolic handlers, builtin execution specs,
  * and rewrite handlers for one engine, session, or test environment.
+ *
+ * A registry can be layered over a frozen base registry: lookups fall through
+ * to the base, and registrations stay in the overlay. The built-in surface is
+ * built once per process and shared this way by every default registry.
  */
 
 #pragma once
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -68,6 +73,12 @@ struct HeadRewriteSpec {
 
 class FunctionRegistry {
 public:
+    FunctionRegistry() = default;
+
+    // An empty overlay over `base`, which must not change afterwards.
+    explicit FunctionRegistry(std::shared_ptr<const FunctionRegistry> base)
+        : base_(std::move(base)) {}
+
     static FunctionRegistry& instance() {
         static FunctionRegistry registry;
         return registry;
@@ -141,7 +152,15 @@ public:
     }
 
     void register_head_rewrite(HeadRewriteSpec spec) {
-        auto& specs = head_rewrites_[spec.metadata.name];
+        auto [entry, inserted] = head_rewrites_.try_emplace(spec.metadata.name);
+        auto& specs = entry->second;
+        // The overlay's list replaces the base's for this head, so it starts
+        // as a copy of it.
+        if (inserted && base_ != nullptr) {
+            if (const auto* inherited = base_->find_head_rewrites(spec.metadata.name)) {
+                specs = *inherited;
+            }
+        }
         for (auto& existing : specs) {
             if (existing.rewrite_name == spec.rewrite_name &&
                 existing.stage == spec.stage) {
@@ -173,7 +192,7 @@ public:
     }
 
     [[nodiscard]] bool has_symbolic_function(const std::string& name) const {
-        return symbolic_functions_.find(name) != symbolic_functions_.end();
+        return find_symbolic_function_spec(name) != nullptr;
     }
 
     [[nodiscard]] bool has_function(const std::string& name) const {
@@ -181,12 +200,12 @@ public:
     }
 
     [[nodiscard]] bool has_builtin_function(const std::string& name) const {
-        return builtin_functions_.find(name) != builtin_functions_.end();
+        return find_builtin_function_spec(name) != nullptr;
     }
 
     [[nodiscard]] bool has_head_rewrites(const std::string& name) const {
-        auto it = head_rewrites_.find(name);
-        return it != head_rewrites_.end() && !it->second.empty();
+        const auto* specs = find_head_rewrites(name);
+        return specs != nullptr && !specs->empty();
     }
 
     [[nodiscard]] const SymbolicFunctionHandler* find_symbolic_function(const std::string& name) const {
@@ -223,17 +242,35 @@ public:
 
     [[nodiscard]] const SymbolicFunctionSpec* find_symbolic_function_spec(const std::string& name) const {
         auto it = symbolic_functions_.find(name);
-        return it == symbolic_functions_.end() ? nullptr : &it->second;
+        if (it != symbolic_functions_.end()) {
+            return &it->second;
+        }
+        return base_ == nullptr ? nullptr : base_->find_symbolic_function_spec(name);
     }
 
     [[nodiscard]] const BuiltinFunctionSpec* find_builtin_function_spec(const std::string& name) const {
         auto it = builtin_functions_.find(name);
-        return it == builtin_functions_.end() ? nullptr : &it->second;
+        if (it != builtin_functions_.end()) {
+            return &it->second;
+        }
+        return base_ == nullptr ? nullptr : base_->find_builtin_function_spec(name);
     }
 
     [[nodiscard]] const std::vector<HeadRewriteSpec>* find_head_rewrites(const std::string& name) const {
         auto it = head_rewrites_.find(name);
-        return it == head_rewrites_.end() ? nullptr : &it->second;
+        if (it != head_rewrites_.end()) {
+            return &it->second;
+        }
+        return base_ == nullptr ? nullptr : base_->find_head_rewrites(name);
+    }
+
+    [[nodiscard]] const std::shared_ptr<const FunctionRegistry>& base() const noexcept {
+        return base_;
+    }
+
+    // Registrations held by this registry itself, not counting its base.
+    [[nodiscard]] std::size_t local_registration_count() const noexcept {
+        return symbolic_functions_.size() + builtin_functions_.size() + head_rewrites_.size();
     }
 
     static void register_host_function(HostFunctionRegistry& registry, HostFunctionSpec spec) {
@@ -257,12 +294,16 @@ private:
             });
     }
 
+    std::shared_ptr<const FunctionRegistry> base_;
     std::unordered_map<std::string, SymbolicFunctionSpec> symbolic_functions_;
     std::unordered_map<std::string, BuiltinFunctionSpec> builtin_functions_;
     std::unordered_map<std::string, std::vector<HeadRewriteSpec>> head_rewrites_;
 };
 
-[[nodiscard]] FunctionRegistry create_default_function_registry();
+// The built-in surface, registered once per process and never modified.
+[[nodiscard]] const std::shared_ptr<const FunctionRegistry>& shared_default_function_registry();
 [[nodiscard]] const FunctionRegistry& default_function_registry();
+// An empty overlay over the shared built-in surface, so this is cheap.
+[[nodiscard]] FunctionRegistry create_default_function_registry();
 
 }  // namespace aleph3::kernel
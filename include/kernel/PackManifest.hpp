@@ -0,0 +1,70 @@
+/*
+ * Kernel Pack Manifests
+ * ---------------------
+ * A pack manifest names a pack's symbols and their registry metadata without
+ * touching the pack's handlers. Registering a manifest is cheap: each symbol
+ * gets a forwarding handler, and the pack's real registration runs once, on
+ * the first call to any of its symbols.
+ *
+ * Metadata lookups (owning package, documentation, attributes) answer from
+ * the manifest and never load the pack.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "kernel/FunctionRegistry.hpp"
+
+namespace aleph3::kernel {
+
+struct PackSymbolManifest {
+    std::string name;
+    std::string documentation;
+    bool rewrite_safe = false;
+    std::vector<symbols::SymbolAttribute> attributes;
+};
+
+struct PackManifest {
+    std::string package_name;
+    std::vector<PackSymbolManifest> symbols;
+    // Registers the pack's handlers for every manifest symbol, building any
+    // tables they need. Runs at most once per LazyPack.
+    std::function<void(FunctionRegistry&)> load;
+};
+
+class LazyPack {
+public:
+    explicit LazyPack(PackManifest manifest);
+
+    // Loads the pack if needed, then runs the handler of manifest symbol
+    // `symbol_index`. Safe to call from several threads.
+    ExprPtr dispatch(std::size_t symbol_index, const FunctionCall& call, EvaluationContext& ctx);
+
+    [[nodiscard]] const PackManifest& manifest() const noexcept { return manifest_; }
+    [[nodiscard]] bool loaded() const noexcept { return loaded_.load(std::memory_order_acquire); }
+    // Time spent in the pack's load callback; zero until loaded.
+    [[nodiscard]] std::chrono::nanoseconds load_duration() const noexcept;
+
+private:
+    void load();
+
+    PackManifest manifest_;
+    std::once_flag load_once_;
+    std::atomic<bool> loaded_{false};
+    std::vector<SymbolicFunctionHandler> handlers_;
+    std::chrono::nanoseconds load_duration_{0};
+};
+
+// Registers every manifest symbol with a handler that loads the pack on first
+// dispatch. The returned pack is also kept alive by those handlers.
+std::shared_ptr<LazyPack> register_lazy_pack(FunctionRegistry& registry, PackManifest manifest);
+
+}  // namespace aleph3::kernel
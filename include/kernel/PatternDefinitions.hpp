@@ -0,0 +1,95 @@
+/*
+ * Kernel Pattern Definitions
+ * --------------------------
+ * Pattern-based user definitions such as `f[0] := 1` or `f[g[x_], y_] := ...`
+ * that can coexist for one head, alongside the single plain definition kept
+ * in symbols::FunctionDefinitionTable.
+ *
+ * Definitions for a head are ordered by specificity (literal arguments before
+ * compound patterns before blanks, compared left to right) and indexed by
+ * argument count plus the first argument's literal value or head, so a call
+ * only tries definitions that can possibly match it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "expr/Expr.hpp"
+#include "kernel/Rewrite.hpp"
+#include "symbols/SymbolState.hpp"
+
+namespace aleph3::kernel {
+
+struct PatternDefinition {
+    std::vector<ExprPtr> arguments;
+    ExprPtr body;
+    bool delayed = true;
+};
+
+struct PatternDefinitionMatch {
+    const PatternDefinition* definition = nullptr;
+    PatternBindingMap bindings;
+};
+
+class PatternDefinitionSet {
+public:
+    // Replaces a definition with a structurally identical argument list.
+    void add(PatternDefinition definition);
+
+    [[nodiscard]] std::optional<PatternDefinitionMatch> match(const std::vector<ExprPtr>& arguments) const;
+    [[nodiscard]] std::size_t candidate_count(const std::vector<ExprPtr>& arguments) const;
+    // In the order they were first added.
+    [[nodiscard]] const std::vector<PatternDefinition>& definitions() const noexcept { return definitions_; }
+
+private:
+    // Positions into definitions_, ordered by specificity and then by the
+    // order the definitions were added.
+    struct ArityIndex {
+        std::unordered_map<ExprPtr, std::vector<std::size_t>, StructuralExprHash, StructuralExprEqual> literals;
+        std::unordered_map<std::string, std::vector<std::size_t>> heads;
+        std::vector<std::size_t> blanks;
+    };
+
+    template <typename Visitor>
+    bool visit_candidates(const std::vector<ExprPtr>& arguments, Visitor&& visitor) const;
+    std::vector<std::size_t>& bucket_for(const std::vector<ExprPtr>& arguments);
+
+    std::vector<PatternDefinition> definitions_;
+    std::unordered_map<std::size_t, ArityIndex> index_;
+};
+
+class PatternDefinitionTable {
+public:
+    [[nodiscard]] bool contains(const std::string& name) const {
+        return sets_.find(name) != sets_.end();
+    }
+
+    [[nodiscard]] const PatternDefinitionSet* lookup(const std::string& name) const {
+        auto it = sets_.find(name);
+        return it == sets_.end() ? nullptr : &it->second;
+    }
+
+    void add(const std::string& name, PatternDefinition definition) {
+        trail_.record(sets_, name);
+        sets_[name].add(std::move(definition));
+        symbols::advance_modification_count();
+    }
+
+    // Definitions added while a frame is open are rolled back when it is popped.
+    void push_frame() { trail_.push_frame(); }
+    std::vector<std::string> pop_frame() { return trail_.pop_frame(sets_); }
+
+private:
+    using MapType = std::unordered_map<std::string, PatternDefinitionSet>;
+
+    MapType sets_;
+    symbols::TableUndoTrail<MapType> trail_;
+};
+
+}  // namespace aleph3::kernel
@@ -9,6 +9,9 @@
 
 #include <cstddef>
 #include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "expr/Expr.hpp"
 
@@ -23,8 +26,40 @@ struct RewriteResult {
 };
 
 [[nodiscard]] bool structurally_equal(const ExprPtr& left, const ExprPtr& right);
+[[nodiscard]] std::size_t structural_hash(const ExprPtr& expr);
 [[nodiscard]] bool matches_pattern(const ExprPtr& pattern, const ExprPtr& expr);
 
+// Canonical order for Sort and Union: numbers by value, then strings, then
+// symbols and other atoms by name, then compound expressions by head, length
+// and parts. Negative, zero or positive like strcmp; zero exactly when the
+// trees are structurally equal, except that NaNs order last and compare
+// equal to each other.
+[[nodiscard]] int canonical_compare(const ExprPtr& left, const ExprPtr& right);
+
+// Pattern variables are symbols whose name ends in `_` (`x_`), or `_` alone.
+using PatternBindingMap = std::unordered_map<std::string, ExprPtr>;
+
+[[nodiscard]] bool match_pattern_arguments(
+    const std::vector<ExprPtr>& patterns,
+    const std::vector<ExprPtr>& exprs,
+    PatternBindingMap& bindings);
+[[nodiscard]] bool contains_pattern_variable(const ExprPtr& expr);
+void collect_pattern_variable_names(const ExprPtr& expr, std::vector<std::string>& names);
+
+// Hash/equality functors that key unordered containers by expression
+// structure instead of pointer identity. Equal trees always hash equally.
+struct StructuralExprHash {
+    [[nodiscard]] std::size_t operator()(const ExprPtr& expr) const {
+        return structural_hash(expr);
+    }
+};
+
+struct StructuralExprEqual {
+    [[nodiscard]] bool operator()(const ExprPtr& left, const ExprPtr& right) const {
+        return structurally_equal(left, right);
+    }
+};
+
 [[nodiscard]] RewriteResult rewrite_once(const ExprPtr& expr, const Rule& rule);
 
 [[nodiscard]] RewriteResult rewrite_repeated(
@@ -0,0 +1,65 @@
+/*
+ * Kernel String Replacement
+ * -------------------------
+ * Literal multi-rule replacement for StringReplace. A rule list is compiled
+ * once into an Aho-Corasick automaton and applied in a single left-to-right
+ * pass: at each position the first rule, in list order, whose pattern starts
+ * there wins; its replacement is emitted and scanning resumes after the
+ * match. Text the rules do not touch is copied through unchanged.
+ *
+ * Matching is bytewise. UTF-8 is self-synchronizing, so a valid UTF-8
+ * pattern only ever matches at character boundaries of valid UTF-8 text.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aleph3::kernel {
+
+struct StringReplacementRule {
+    std::string pattern;
+    std::string replacement;
+
+    bool operator==(const StringReplacementRule&) const = default;
+};
+
+class StringReplacer {
+public:
+    // Rules with an empty pattern never match.
+    explicit StringReplacer(std::vector<StringReplacementRule> rules);
+
+    [[nodiscard]] std::string apply(std::string_view input) const;
+
+    [[nodiscard]] const std::vector<StringReplacementRule>& rules() const noexcept { return rules_; }
+    [[nodiscard]] std::size_t state_count() const noexcept { return terminal_rule_.size(); }
+
+private:
+    static constexpr std::int32_t no_rule = -1;
+    static constexpr std::size_t alphabet_size = 256;
+
+    [[nodiscard]] std::int32_t next_state(std::int32_t state, unsigned char byte) const {
+        return transitions_[static_cast<std::size_t>(state) * alphabet_size + byte];
+    }
+
+    std::vector<StringReplacementRule> rules_;
+    // Dense goto function with failure transitions folded in, so the scan
+    // takes exactly one lookup per input byte.
+    std::vector<std::int32_t> transitions_;
+    // Lowest rule index whose pattern ends exactly at a state, or no_rule.
+    std::vector<std::int32_t> terminal_rule_;
+    // Nearest proper suffix state that ends some pattern, or -1.
+    std::vector<std::int32_t> output_link_;
+};
+
+// Compiled replacers shared by every StringReplace call with the same rule
+// list. Safe to call from several threads.
+[[nodiscard]] std::shared_ptr<const StringReplacer> cached_string_replacer(
+    const std::vector<StringReplacementRule>& rules);
+
+}  // namespace aleph3::kernel
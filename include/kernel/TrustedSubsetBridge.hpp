@@ -8,8 +8,14 @@
 
 #pragma once
 
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
 #include "expr/Expr.hpp"
 #include "ir/Node.hpp"
+#include "kernel/ExprReclaimer.hpp"
 #include "kernel/FunctionRegistry.hpp"
 #include "kernel/Lowering.hpp"
 #include "sdk/Policy.hpp"
@@ -28,13 +34,34 @@ struct StagedTrustedSubsetFormula {
 
 [[nodiscard]] StagedTrustedSubsetFormula stage_trusted_subset_formula(const ir::NodePtr& root);
 
+// A lowered formula up to variable names and the order of Plus and Times
+// operands: operands are sorted by shape with the normalizer's term order,
+// then variables are renamed to the slots $1, $2, ... in order of first
+// occurrence. Formulas with structurally equal bodies compute the same thing
+// once each one's slots are bound to its own variables.
+struct CanonicalTrustedSubsetFormula {
+    ExprPtr body;
+    // slots[i] is the variable that slot $(i+1) stands for.
+    std::vector<std::string> slots;
+};
+
+[[nodiscard]] CanonicalTrustedSubsetFormula canonicalize_trusted_subset_formula(const ExprPtr& kernel_expr);
+
+// The functions below take the slots of a canonical body, and then look each
+// slot up in bindings and constants under its variable's name. With no slots
+// a symbol is looked up under its own name.
+
+// With a reclaimer, the result tree is handed to it once its value has been
+// read out, instead of being freed before returning.
 [[nodiscard]] EvaluationResult evaluate_trusted_subset_formula(
     const ExprPtr& kernel_expr,
     const Bindings& bindings,
     const Bindings& constants,
     const HostFunctionRegistry& host_functions,
     const FunctionRegistry& function_registry,
-    const Policy& policy);
+    const Policy& policy,
+    ExprReclaimer* reclaimer = nullptr,
+    std::span<const std::string> slots = {});
 
 [[nodiscard]] EvaluationResult evaluate_trusted_subset_formula(
     const ExprPtr& kernel_expr,
@@ -43,4 +70,58 @@ struct StagedTrustedSubsetFormula {
     const HostFunctionRegistry& host_functions,
     const Policy& policy);
 
+// One column of sampled values per variable, all of one length.
+struct TrustedSubsetSampleColumns {
+    std::vector<std::string> variables;
+    std::vector<std::span<const double>> columns;
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return columns.empty() ? 0 : columns.front().size();
+    }
+};
+
+struct TrustedSubsetBatchResult {
+    // Results of the rows before the first failure, in row order.
+    std::vector<double> values;
+    // Why row values.size() failed, if one did.
+    std::optional<RuntimeError> error;
+};
+
+// Evaluates the formula once per row of samples, with the same result and
+// errors as evaluate_trusted_subset_formula given that row bound over
+// `bindings`. Results must be numbers. Formulas built only from listable
+// numeric builtins are first evaluated over whole columns at once. Safe to
+// call from several threads on one formula.
+[[nodiscard]] TrustedSubsetBatchResult evaluate_trusted_subset_batch(
+    const ExprPtr& kernel_expr,
+    const TrustedSubsetSampleColumns& samples,
+    const Bindings& bindings,
+    const Bindings& constants,
+    const HostFunctionRegistry& host_functions,
+    const FunctionRegistry& function_registry,
+    const Policy& policy,
+    std::span<const std::string> slots = {});
+
+// The formula with `fixed_bindings` and `constants` substituted and every
+// part that then depends only on values worked out: If takes the branch its
+// condition selects, and a call whose arguments are all values is replaced by
+// its result, a host call only when the function is declared pure. A call
+// that fails is kept as it is, so the residual formula fails where the
+// original would. Evaluating the residual with the remaining bindings gives
+// what evaluating the original with both would, in fewer steps.
+[[nodiscard]] ExprPtr specialize_trusted_subset_formula(
+    const ExprPtr& kernel_expr,
+    const Bindings& fixed_bindings,
+    const Bindings& constants,
+    const HostFunctionRegistry& host_functions,
+    const FunctionRegistry& function_registry,
+    const Policy& policy,
+    std::span<const std::string> slots = {});
+
+// The variables the formula reads that `constants` does not define, sorted.
+[[nodiscard]] std::vector<std::string> trusted_subset_formula_variables(
+    const ExprPtr& kernel_expr,
+    const Bindings& constants,
+    std::span<const std::string> slots = {});
+
 }  // namespace aleph3::kernel
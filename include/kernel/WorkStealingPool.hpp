@@ -0,0 +1,30 @@
+/*
+ * Kernel Work-Stealing Pool
+ * -------------------------
+ * Runs a fixed set of index-addressed tasks across a few threads. Each thread
+ * starts with a contiguous share of chunks, works it from the back, and steals
+ * from the front of other threads' shares once its own runs dry.
+ *
+ * Tasks own their result slot by index, so the output never depends on which
+ * thread ran which task. The calling thread takes part as worker zero.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace aleph3::kernel {
+
+[[nodiscard]] std::size_t hardware_thread_count() noexcept;
+
+// Calls `task(index)` exactly once for every index in [0, task_count) and
+// returns once all calls finished. A thread_count of 0 means one thread per
+// hardware thread; 1 runs everything inline. Tasks should report their own
+// failures; an exception escaping a task is rethrown here after the join.
+void run_work_stealing(
+    std::size_t task_count,
+    std::size_t thread_count,
+    const std::function<void(std::size_t)>& task);
+
+}  // namespace aleph3::kernel
@@ -1,5 +1,6 @@
 #pragma once
 #include "expr/Expr.hpp"
+#include "expr/ExprSummary.hpp"
 #include "expr/ExprUtils.hpp"
 #include "evaluator/EvaluatorSemantics.hpp"
 #include "util/Overloaded.hpp"
@@ -38,7 +39,8 @@ inline NormalizedSortClass normalized_sort_class(const ExprPtr& expr) {
             std::holds_alternative<Number>(*call->args[1])) {
             return NormalizedSortClass::algebraic;
         }
-        if (call->head == "Times") {
+        // Every algebraic product has a symbol somewhere.
+        if (call->head == "Times" && expr_summary(expr).has_symbols) {
             bool saw_symbolic_factor = false;
             for (const auto& arg : call->args) {
                 if (is_numeric_constant(arg)) {
@@ -408,7 +410,15 @@ inline ExprPtr normalize_expr(const ExprPtr& expr) {
             for (const auto& elem : list.elements) {
                 norm_elems.push_back(normalize_expr(elem));
             }
-            return std::make_shared<Expr>(List{norm_elems});
+            return make_expr_node(List{norm_elems});
+        },
+        [](const Association& assoc) -> ExprPtr {
+            std::vector<std::pair<ExprPtr, ExprPtr>> norm_entries;
+            norm_entries.reserve(assoc.map.size());
+            assoc.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                norm_entries.emplace_back(normalize_expr(key), normalize_expr(value));
+            });
+            return make_expr_node(Association{AssociationMap::from_entries(norm_entries)});
         },
         [](const FunctionDefinition& def) -> ExprPtr {
             std::vector<Parameter> normalized_params;
@@ -0,0 +1,69 @@
+/*
+ * IntegerArithmetic.hpp
+ * ---------------------
+ * Machine-word number theory for the number-theory pack: binary GCD,
+ * Montgomery modular exponentiation, deterministic Miller-Rabin primality
+ * and Pollard-Brent factorization, all exact over unsigned 64-bit integers.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+// Arithmetic modulo a fixed odd modulus in Montgomery form (R = 2^64).
+class MontgomeryModulus {
+public:
+    explicit MontgomeryModulus(uint64_t modulus);
+
+    [[nodiscard]] uint64_t modulus() const noexcept { return modulus_; }
+    [[nodiscard]] uint64_t one() const noexcept { return one_; }
+
+    [[nodiscard]] uint64_t to_montgomery(uint64_t value) const noexcept {
+        return reduce(static_cast<unsigned __int128>(value % modulus_) * r_squared_);
+    }
+    [[nodiscard]] uint64_t from_montgomery(uint64_t value) const noexcept {
+        return reduce(value);
+    }
+    [[nodiscard]] uint64_t multiply(uint64_t left, uint64_t right) const noexcept {
+        return reduce(static_cast<unsigned __int128>(left) * right);
+    }
+    [[nodiscard]] uint64_t add(uint64_t left, uint64_t right) const noexcept {
+        return left >= modulus_ - right ? left - (modulus_ - right) : left + right;
+    }
+    // base and the result are in Montgomery form.
+    [[nodiscard]] uint64_t power(uint64_t base, uint64_t exponent) const noexcept;
+
+private:
+    [[nodiscard]] uint64_t reduce(unsigned __int128 value) const noexcept {
+        const auto low = static_cast<uint64_t>(value);
+        const auto high = static_cast<uint64_t>(value >> 64);
+        const uint64_t m = low * inverse_;
+        const auto mn_high = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * modulus_) >> 64);
+        return high >= mn_high ? high - mn_high : high - mn_high + modulus_;
+    }
+
+    uint64_t modulus_;
+    uint64_t inverse_;    // modulus^-1 mod 2^64
+    uint64_t one_;        // R mod modulus
+    uint64_t r_squared_;  // R^2 mod modulus
+};
+
+[[nodiscard]] uint64_t integer_gcd(uint64_t left, uint64_t right) noexcept;
+
+// base^exponent mod modulus; modulus must be nonzero.
+[[nodiscard]] uint64_t power_mod(uint64_t base, uint64_t exponent, uint64_t modulus);
+
+// x with value * x == 1 (mod modulus), if gcd(value, modulus) == 1.
+[[nodiscard]] bool inverse_mod(uint64_t value, uint64_t modulus, uint64_t& inverse) noexcept;
+
+[[nodiscard]] bool is_prime(uint64_t value) noexcept;
+
+// Prime factors in increasing order with their multiplicities. Empty for
+// 0 and 1.
+[[nodiscard]] std::vector<std::pair<uint64_t, unsigned>> factor_integer(uint64_t value);
+
+}  // namespace aleph3
@@ -2,15 +2,18 @@
  * Algebra Pack Registration
  * -------------------------
  * Declares the first concrete pack-owned symbolic surface so callers can load
- * polynomial algebra handlers into a kernel function registry.
+ * polynomial algebra handlers into a kernel function registry, either eagerly
+ * or through its manifest on first use.
  */
 
 #pragma once
 
 #include "kernel/FunctionRegistry.hpp"
+#include "kernel/PackManifest.hpp"
 
 namespace aleph3::packs {
 
 void register_algebra_pack(kernel::FunctionRegistry& registry);
+[[nodiscard]] kernel::PackManifest algebra_pack_manifest();
 
 }  // namespace aleph3::packs
@@ -0,0 +1,30 @@
+/*
+ * Number Theory Pack Registration
+ * -------------------------------
+ * Declares the integer number-theory surface (PowerMod, PrimeQ,
+ * FactorInteger) so callers can load its handlers into a kernel function
+ * registry, either eagerly or through its manifest on first use.
+ */
+
+#pragma once
+
+#include "kernel/FunctionRegistry.hpp"
+#include "kernel/PackManifest.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace aleph3::packs {
+
+// An exact integer argument: an integral Number below 2^64 in magnitude.
+struct IntegerArgument {
+    bool negative = false;
+    uint64_t magnitude = 0;
+};
+
+[[nodiscard]] std::optional<IntegerArgument> integer_argument(const ExprPtr& expr);
+
+void register_number_theory_pack(kernel::FunctionRegistry& registry);
+[[nodiscard]] kernel::PackManifest number_theory_pack_manifest();
+
+}  // namespace aleph3::packs
@@ -108,6 +108,7 @@ namespace aleph3 {
 
                 // If it's followed by '[', maybe it's a definition
                 if (match('[')) {
+                    size_t args_start = pos;
                     std::vector<Parameter> params;
                     bool is_def = true;
 
@@ -149,6 +150,9 @@ namespace aleph3 {
                         auto body = parse_expression();
                         return make_expr<FunctionDefinition>(name, params, body, delayed);
                     }
+                    else if (auto pattern_definition = try_parse_pattern_definition(name, args_start)) {
+                        return pattern_definition;
+                    }
                     else {
                         // Not a definition; reset and fall through to expression
                         pos = backup;
@@ -169,6 +173,36 @@ namespace aleph3 {
         size_t pos;
         int paren_depth;
 
+        // Definitions whose arguments are not all plain `x_` parameters, such as
+        // `f[0] := 1` or `f[g[x_], y_] := ...`, become SetDelayed/Set calls.
+        // Returns nullptr (position unspecified) when the input is not one.
+        ExprPtr try_parse_pattern_definition(const std::string& name, size_t args_start) {
+            pos = args_start;
+            std::vector<ExprPtr> args;
+            try {
+                skip_whitespace();
+                if (!match(']')) {
+                    while (true) {
+                        args.push_back(parse_expression());
+                        skip_whitespace();
+                        if (match(']')) break;
+                        if (!match(',')) return nullptr;
+                    }
+                }
+                skip_whitespace();
+                bool delayed = match_string(":=");
+                if (!delayed && (peek_string(2) == "==" || !match('='))) {
+                    return nullptr;
+                }
+                auto body = parse_expression();
+                auto lhs = make_expr<FunctionCall>(name, args);
+                return make_expr<FunctionCall>(delayed ? "SetDelayed" : "Set", std::vector<ExprPtr>{lhs, body});
+            }
+            catch (const std::exception&) {
+                return nullptr;
+            }
+        }
+
         // Pratt/precedence climbing parser
         ExprPtr parse_expression(int min_precedence = 1) {
             auto left = parse_factor();
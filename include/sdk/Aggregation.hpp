@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sdk/Statistics.hpp"
+#include "sdk/Types.hpp"
+
+namespace aleph3 {
+
+struct AggregationOptions {
+    // Track distinct values and quantiles per group; both use fixed space.
+    bool distinct_count = true;
+    bool quantiles = true;
+    unsigned distinct_precision = 12;
+    double quantile_accuracy = 0.01;
+    // Keep the top_k largest values per group; 0 keeps none.
+    std::size_t top_k = 0;
+};
+
+// Everything kept about one group: the values themselves are not.
+struct GroupAggregate {
+    Value key;
+    RunningMoments moments;
+    std::optional<DistinctCounter> distinct;
+    std::optional<QuantileSketch> quantiles;
+    std::optional<TopValues> top;
+};
+
+// Per-group summaries of a stream of numbers. Memory grows with the number
+// of groups, never with the number of values. Sinks merge, so partial sinks
+// built on separate threads combine into the sink of the whole stream.
+class AggregationSink {
+public:
+    explicit AggregationSink(AggregationOptions options = {});
+
+    [[nodiscard]] const AggregationOptions& options() const noexcept { return options_; }
+
+    // Keys are numbers, booleans or strings; the null Value is the group of
+    // ungrouped values.
+    void add(const Value& key, double value);
+    // Appends other's new groups after this sink's, in other's order. Both
+    // sinks must have the same options.
+    void merge(const AggregationSink& other);
+
+    // In order of first appearance.
+    [[nodiscard]] const std::vector<GroupAggregate>& groups() const noexcept { return groups_; }
+    [[nodiscard]] const GroupAggregate* find(const Value& key) const;
+
+    // Whether `key` may be used as a group key.
+    [[nodiscard]] static bool is_valid_key(const Value& key) noexcept;
+
+private:
+    GroupAggregate& group_for(const Value& key, const std::string& canonical_key);
+
+    AggregationOptions options_;
+    std::vector<GroupAggregate> groups_;
+    std::unordered_map<std::string, std::size_t> index_;
+};
+
+struct AggregationEvaluationOptions {
+    // Computes each row's group key; without it every row joins one group.
+    std::optional<CompiledFormula> group_by;
+    // Worker threads; 0 means one per hardware thread. The sink ends up the
+    // same for any value.
+    std::size_t thread_count = 0;
+};
+
+struct AggregationReport {
+    // Rows added to the sink; on error, the rows before the failing one.
+    std::size_t rows_aggregated = 0;
+    std::optional<RuntimeError> error;
+    // Index of the failing row within the batch.
+    std::optional<std::size_t> failed_row;
+
+    [[nodiscard]] bool ok() const noexcept { return !error.has_value(); }
+};
+
+}  // namespace aleph3
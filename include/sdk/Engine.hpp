@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
 #include <string_view>
 
+#include "sdk/Aggregation.hpp"
 #include "sdk/Policy.hpp"
 #include "sdk/Schema.hpp"
 #include "sdk/Types.hpp"
@@ -29,6 +34,56 @@ public:
         const CompiledFormula& formula,
         const Bindings& bindings) const;
 
+    // Evaluates like evaluate, taking turns with the engine's other scheduled
+    // evaluations (EngineOptions::scheduling). A long evaluation gives way
+    // every slice to waiting ones of a higher class or of a tenant that has
+    // had less than its share, then resumes where it stopped.
+    [[nodiscard]] EvaluationResult evaluate_scheduled(
+        const CompiledFormula& formula,
+        const Bindings& bindings,
+        const ScheduledEvaluationOptions& options) const;
+
+    // Tenants not given a weight have weight 1. Throws std::invalid_argument
+    // unless the weight is positive and finite.
+    void set_tenant_weight(const std::string& tenant, double weight);
+
+    [[nodiscard]] SchedulerMetrics scheduler_metrics() const;
+
+    // A formula with the variables in `fixed_bindings` held at those values;
+    // evaluating it with the rest gives what evaluating `formula` with both
+    // would, and bindings for the fixed variables are then ignored. Work that
+    // depends only on fixed values, If conditions and calls to pure host
+    // functions among it, is done here once. Empty for an empty formula.
+    [[nodiscard]] CompiledFormula specialize(
+        const CompiledFormula& formula,
+        const Bindings& fixed_bindings) const;
+
+    // Evaluates the formula for every row and adds each numeric result to
+    // the sink under the row's group key, without keeping per-row results.
+    // Calling it once per batch of a stream aggregates the whole stream. Rows
+    // are spread over threads; the sink ends up as if they were added in
+    // order. Stops at the first failing row.
+    AggregationReport evaluate_into(
+        AggregationSink& sink,
+        const CompiledFormula& formula,
+        std::span<const Bindings> rows,
+        const AggregationEvaluationOptions& options = {}) const;
+
+    // Evaluates the formula for n_samples draws of the variables in
+    // `distributions` and summarizes the results as they stream past. Draw i
+    // of a variable depends only on the seed, its name and i, so the result
+    // is the same for any thread count. Stops at the first failing sample.
+    [[nodiscard]] SimulationResult simulate(
+        const CompiledFormula& formula,
+        const Distributions& distributions,
+        std::size_t n_samples,
+        std::uint64_t seed,
+        const SimulationOptions& options = {}) const;
+
+    // What background reclamation (EngineOptions::background_reclamation)
+    // has done so far.
+    [[nodiscard]] ReclamationMetrics reclamation_metrics() const;
+
 private:
     struct State;
     std::shared_ptr<State> state_;
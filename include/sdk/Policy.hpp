@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <optional>
 
 namespace aleph3 {
 
@@ -43,6 +45,9 @@ public:
     [[nodiscard]] bool allow_user_defined_functions() const noexcept { return allow_user_defined_functions_; }
     [[nodiscard]] bool allow_implicit_multiplication() const noexcept { return allow_implicit_multiplication_; }
     [[nodiscard]] bool allow_chained_comparisons() const noexcept { return allow_chained_comparisons_; }
+    // Seed for RandomReal, RandomInteger and RandomVariate. Without one, each
+    // evaluation context draws a fresh seed on first use.
+    [[nodiscard]] const std::optional<std::uint64_t>& random_seed() const noexcept { return random_seed_; }
 
     void set_enable_arithmetic(bool enable) noexcept { enable_arithmetic_ = enable; }
     void set_enable_comparisons(bool enable) noexcept { enable_comparisons_ = enable; }
@@ -55,6 +60,7 @@ public:
     void set_allow_user_defined_functions(bool allow) noexcept { allow_user_defined_functions_ = allow; }
     void set_allow_implicit_multiplication(bool allow) noexcept { allow_implicit_multiplication_ = allow; }
     void set_allow_chained_comparisons(bool allow) noexcept { allow_chained_comparisons_ = allow; }
+    void set_random_seed(std::optional<std::uint64_t> seed) noexcept { random_seed_ = seed; }
 
 private:
     EvaluationBudget budget_;
@@ -69,6 +75,7 @@ private:
     bool allow_user_defined_functions_ = false;
     bool allow_implicit_multiplication_ = false;
     bool allow_chained_comparisons_ = false;
+    std::optional<std::uint64_t> random_seed_;
 };
 
 }  // namespace aleph3
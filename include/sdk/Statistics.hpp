@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace aleph3 {
+
+// Count, sum, mean, variance and range of a stream of numbers in constant space.
+// Two summaries merge into the summary of the concatenated streams, so
+// partial results can be combined in any fixed order.
+class RunningMoments {
+public:
+    void add(double value) noexcept;
+    void merge(const RunningMoments& other) noexcept;
+
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+    // Compensated, so it stays accurate over long streams of mixed magnitude.
+    [[nodiscard]] double sum() const noexcept { return sum_ + sum_compensation_; }
+    [[nodiscard]] double mean() const noexcept { return mean_; }
+    // Sample variance; 0 for fewer than two values.
+    [[nodiscard]] double variance() const noexcept;
+    [[nodiscard]] double min() const noexcept { return min_; }
+    [[nodiscard]] double max() const noexcept { return max_; }
+
+private:
+    std::size_t count_ = 0;
+    double mean_ = 0.0;
+    double sum_squared_deviations_ = 0.0;
+    double sum_ = 0.0;
+    double sum_compensation_ = 0.0;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+// Quantiles of a stream of numbers within a relative error, in space
+// logarithmic in the range of the values. Values fall into geometric buckets
+// whose bounds differ by a factor of (1 + accuracy) / (1 - accuracy); merging
+// adds bucket counts, so the result is the same in any merge order.
+class QuantileSketch {
+public:
+    explicit QuantileSketch(double relative_accuracy = 0.01);
+
+    void add(double value);
+    // Both sketches must have the same relative accuracy.
+    void merge(const QuantileSketch& other);
+
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+    [[nodiscard]] double relative_accuracy() const noexcept { return relative_accuracy_; }
+    [[nodiscard]] std::size_t bucket_count() const noexcept { return positive_.size() + negative_.size(); }
+
+    // The value at rank q * (count - 1), q in [0, 1]; exact at the ends, NaN
+    // when empty.
+    [[nodiscard]] double quantile(double q) const;
+
+private:
+    [[nodiscard]] int bucket_key(double magnitude) const;
+    [[nodiscard]] double bucket_value(int key) const;
+
+    double relative_accuracy_;
+    double gamma_;
+    double log_gamma_;
+    std::size_t count_ = 0;
+    std::uint64_t zero_count_ = 0;
+    // Keyed by the bucket of |value|.
+    std::map<int, std::uint64_t> positive_;
+    std::map<int, std::uint64_t> negative_;
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+};
+
+// HyperLogLog estimate of the number of distinct values, in 2^p one-byte
+// registers for precision p; the standard error is about 1.04 / sqrt(2^p).
+// Merging takes the register-wise maximum, so it is order-independent.
+class DistinctCounter {
+public:
+    // p between 4 and 16.
+    explicit DistinctCounter(unsigned precision = 12);
+
+    void add(double value) noexcept;
+    // Adds a value that is already a well-mixed 64-bit hash.
+    void add_hash(std::uint64_t hash) noexcept;
+    // Both counters must have the same precision.
+    void merge(const DistinctCounter& other);
+
+    [[nodiscard]] unsigned precision() const noexcept { return precision_; }
+    [[nodiscard]] double estimate() const noexcept;
+
+private:
+    unsigned precision_;
+    std::vector<std::uint8_t> registers_;
+};
+
+// The k largest values of a stream in space O(k), kept in a min-heap whose
+// front is the smallest value still in. Merging keeps the k largest of both,
+// so the result is the same in any merge order.
+class TopValues {
+public:
+    // k of at least 1.
+    explicit TopValues(std::size_t capacity = 10);
+
+    // NaN has no rank and is not kept.
+    void add(double value);
+    // Both must have the same capacity.
+    void merge(const TopValues& other);
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] std::size_t size() const noexcept { return heap_.size(); }
+    // Largest first; fewer than k until k values have been added.
+    [[nodiscard]] std::vector<double> values() const;
+
+private:
+    std::size_t capacity_;
+    std::vector<double> heap_;
+};
+
+}  // namespace aleph3
@@ -13,6 +13,8 @@
 #include <variant>
 #include <vector>
 
+#include "sdk/Statistics.hpp"
+
 namespace aleph3 {
 
 struct SourceSpan {
@@ -42,7 +44,10 @@ struct Diagnostic {
 class Value {
 public:
     using List = std::vector<Value>;
-    using Storage = std::variant<std::monostate, double, bool, std::string, List>;
+    // Key-value pairs in insertion order; a later pair for an equal key
+    // replaces the earlier value when the association reaches the kernel.
+    using Association = std::vector<std::pair<Value, Value>>;
+    using Storage = std::variant<std::monostate, double, bool, std::string, List, Association>;
 
     Value() = default;
     Value(double number) : storage_(number) {}
@@ -50,17 +55,20 @@ public:
     Value(std::string string) : storage_(std::move(string)) {}
     Value(const char* string) : storage_(std::string(string)) {}
     Value(List list) : storage_(std::move(list)) {}
+    Value(Association association) : storage_(std::move(association)) {}
 
     [[nodiscard]] bool is_null() const noexcept { return std::holds_alternative<std::monostate>(storage_); }
     [[nodiscard]] bool is_number() const noexcept { return std::holds_alternative<double>(storage_); }
     [[nodiscard]] bool is_boolean() const noexcept { return std::holds_alternative<bool>(storage_); }
     [[nodiscard]] bool is_string() const noexcept { return std::holds_alternative<std::string>(storage_); }
     [[nodiscard]] bool is_list() const noexcept { return std::holds_alternative<List>(storage_); }
+    [[nodiscard]] bool is_association() const noexcept { return std::holds_alternative<Association>(storage_); }
 
     [[nodiscard]] const double* as_number() const noexcept { return std::get_if<double>(&storage_); }
     [[nodiscard]] const bool* as_boolean() const noexcept { return std::get_if<bool>(&storage_); }
     [[nodiscard]] const std::string* as_string() const noexcept { return std::get_if<std::string>(&storage_); }
     [[nodiscard]] const List* as_list() const noexcept { return std::get_if<List>(&storage_); }
+    [[nodiscard]] const Association* as_association() const noexcept { return std::get_if<Association>(&storage_); }
 
     [[nodiscard]] const Storage& storage() const noexcept { return storage_; }
 
@@ -76,12 +84,40 @@ struct RuntimeError {
     std::optional<SourceSpan> span;
 };
 
+// How Engine::evaluate_scheduled shares the engine among evaluations.
+struct SchedulingOptions {
+    // Scheduled evaluations that run at once; 0 means one per hardware
+    // thread. The rest wait their turn.
+    std::size_t concurrency = 0;
+    // Evaluation steps a scheduled evaluation runs before a waiting one that
+    // is owed more may take over; 0 lets each run to the end.
+    std::size_t slice_steps = 1024;
+};
+
 struct EngineOptions {
     bool enable_strings = true;
     bool enable_lists = false;
     bool simplify_before_evaluate = false;
     bool enable_optional_builtins = false;
     bool retain_source_text = true;
+    // Hands large result trees to a background thread to be freed, so
+    // evaluate returns without waiting for their destruction.
+    bool background_reclamation = false;
+    SchedulingOptions scheduling;
+};
+
+// Waiting scheduled evaluations are served by class first, in this order.
+enum class PriorityClass {
+    interactive,
+    standard,
+    batch,
+};
+
+// Whom a scheduled evaluation runs for. Within a priority class, tenants
+// share the engine's steps in proportion to their weights.
+struct ScheduledEvaluationOptions {
+    std::string tenant;
+    PriorityClass priority = PriorityClass::standard;
 };
 
 struct ValidationResult {
@@ -100,6 +136,18 @@ public:
     [[nodiscard]] bool empty() const noexcept { return !state_; }
     [[nodiscard]] explicit operator bool() const noexcept { return static_cast<bool>(state_); }
 
+    // The variables evaluation reads from bindings, sorted; empty for an
+    // empty formula.
+    [[nodiscard]] std::vector<std::string> variables() const;
+
+    // Hash of the canonical form: the same for formulas that differ only in
+    // variable names or in the order of the operands of + and *.
+    [[nodiscard]] std::uint64_t fingerprint() const;
+
+    // True when both formulas run one shared body, as formulas of the same
+    // canonical form compiled by one engine do.
+    [[nodiscard]] bool shares_body_with(const CompiledFormula& other) const noexcept;
+
 private:
     friend class Engine;
 
@@ -127,12 +175,100 @@ struct EvaluationResult {
     }
 };
 
+enum class DistributionKind {
+    uniform,
+    discrete_uniform,
+    normal,
+    log_normal,
+    exponential
+};
+
+// A sampling distribution for one simulated variable. The meaning of the two
+// parameters depends on the kind; use the factories.
+struct Distribution {
+    DistributionKind kind = DistributionKind::uniform;
+    double first = 0.0;
+    double second = 1.0;
+
+    // Reals in [low, high).
+    [[nodiscard]] static constexpr Distribution uniform(double low = 0.0, double high = 1.0) noexcept {
+        return Distribution{DistributionKind::uniform, low, high};
+    }
+    // Integers in [low, high].
+    [[nodiscard]] static constexpr Distribution discrete_uniform(double low, double high) noexcept {
+        return Distribution{DistributionKind::discrete_uniform, low, high};
+    }
+    [[nodiscard]] static constexpr Distribution normal(double mean = 0.0, double deviation = 1.0) noexcept {
+        return Distribution{DistributionKind::normal, mean, deviation};
+    }
+    // exp of a normal with the given mean and deviation.
+    [[nodiscard]] static constexpr Distribution log_normal(double mean, double deviation) noexcept {
+        return Distribution{DistributionKind::log_normal, mean, deviation};
+    }
+    [[nodiscard]] static constexpr Distribution exponential(double rate) noexcept {
+        return Distribution{DistributionKind::exponential, rate, 0.0};
+    }
+};
+
+using Distributions = std::unordered_map<std::string, Distribution>;
+
+struct SimulationOptions {
+    // Values for formula variables that are not sampled.
+    Bindings bindings;
+    // Worker threads; 0 means one per hardware thread. The result does not
+    // depend on it.
+    std::size_t thread_count = 0;
+    double quantile_accuracy = 0.01;
+};
+
+struct SimulationSummary {
+    RunningMoments moments;
+    QuantileSketch quantiles;
+};
+
+struct SimulationResult {
+    std::optional<SimulationSummary> summary;
+    std::optional<RuntimeError> error;
+    // Sample at which the error was raised, counted from 0.
+    std::optional<std::size_t> failed_sample;
+
+    [[nodiscard]] bool ok() const noexcept {
+        return summary.has_value() && !error.has_value();
+    }
+};
+
+// Activity of an engine's background reclamation; all zero when it is off.
+struct ReclamationMetrics {
+    std::size_t trees_queued = 0;
+    // Queued and not yet freed.
+    std::size_t queue_depth = 0;
+    std::size_t max_queue_depth = 0;
+    std::size_t trees_freed = 0;
+    // Milliseconds from hand-off until a tree was freed, over freed trees.
+    double mean_latency_ms = 0.0;
+    double max_latency_ms = 0.0;
+};
+
+// Activity of the engine's evaluation scheduler.
+struct SchedulerMetrics {
+    std::size_t running = 0;
+    std::size_t waiting = 0;
+    std::size_t completed = 0;
+    // Times a running evaluation gave way to a waiting one.
+    std::size_t yields = 0;
+    // Milliseconds a completed evaluation spent waiting for its turns.
+    double mean_queue_delay_ms = 0.0;
+    double p99_queue_delay_ms = 0.0;
+    double max_queue_delay_ms = 0.0;
+};
+
 enum class ValueType {
     any,
     number,
     boolean,
     string,
-    list
+    list,
+    association
 };
 
 struct FunctionArity {
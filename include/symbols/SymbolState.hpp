@@ -2,20 +2,104 @@
 
 #include "expr/Expr.hpp"
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace aleph3::symbols {
 
+namespace detail {
+inline std::atomic<std::uint64_t> modification_count{1};
+}  // namespace detail
+
+// Advanced by every write that can change what an expression evaluates to:
+// symbol values, function definitions, and assumptions. Evaluated nodes carry
+// the count they were produced at and are only trusted while it is current.
+[[nodiscard]] inline std::uint64_t modification_count() noexcept {
+    return detail::modification_count.load(std::memory_order_acquire);
+}
+
+inline void advance_modification_count() noexcept {
+    detail::modification_count.fetch_add(1, std::memory_order_acq_rel);
+}
+
+// Undo trail for one name-keyed table. While a frame is open, the first
+// write to each name records the entry it replaces (nullopt when there was
+// none); later writes to that name in the same frame record nothing. Popping
+// the frame puts those entries back in reverse order and returns the names it
+// restored.
+template <typename Map>
+class TableUndoTrail {
+public:
+    void push_frame() {
+        frame_marks_.push_back(trail_.size());
+        recorded_names_.emplace_back();
+    }
+
+    void record(const Map& map, const std::string& name) {
+        if (frame_marks_.empty() || !recorded_names_.back().insert(name).second) {
+            return;
+        }
+        auto it = map.find(name);
+        trail_.push_back({
+            name,
+            it == map.end() ? std::nullopt : std::optional<typename Map::mapped_type>(it->second)});
+    }
+
+    std::vector<std::string> pop_frame(Map& map) {
+        std::vector<std::string> restored;
+        if (frame_marks_.empty()) {
+            return restored;
+        }
+        const std::size_t mark = frame_marks_.back();
+        frame_marks_.pop_back();
+        recorded_names_.pop_back();
+        if (trail_.size() > mark) {
+            advance_modification_count();
+        }
+        while (trail_.size() > mark) {
+            auto& entry = trail_.back();
+            restored.push_back(entry.name);
+            if (entry.previous.has_value()) {
+                map.insert_or_assign(std::move(entry.name), std::move(*entry.previous));
+            } else {
+                map.erase(entry.name);
+            }
+            trail_.pop_back();
+        }
+        return restored;
+    }
+
+    [[nodiscard]] std::size_t frame_depth() const noexcept {
+        return frame_marks_.size();
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::optional<typename Map::mapped_type> previous;
+    };
+
+    std::vector<Entry> trail_;
+    std::vector<std::size_t> frame_marks_;
+    // Names already recorded in each open frame.
+    std::vector<std::unordered_set<std::string>> recorded_names_;
+};
+
 enum class SymbolAttribute {
     hold_all,
     hold_first,
     hold_rest,
     listable,
     numeric_function,
-    protected_symbol
+    protected_symbol,
+    memoize
 };
 
 enum class DefinitionOrigin {
@@ -66,10 +150,25 @@ public:
     }
 
     void set(std::string name, ExprPtr value) {
+        trail_.record(values_, name);
         values_[std::move(name)] = std::move(value);
+        advance_modification_count();
     }
 
+    // Values set while a frame is open are rolled back when it is popped.
+    void push_frame() { trail_.push_frame(); }
+    void pop_frame() { (void)trail_.pop_frame(values_); }
+
+    // Counts as a write: evaluated nodes stamped before the call are no
+    // longer trusted.
     [[nodiscard]] MapType& entries() {
+        advance_modification_count();
+        return values_;
+    }
+
+    // The mutable map without counting a write, for binding long-lived
+    // aliases. Whoever writes through it advances the modification count.
+    [[nodiscard]] MapType& unobserved_entries() noexcept {
         return values_;
     }
 
@@ -79,6 +178,7 @@ public:
 
 private:
     MapType values_;
+    TableUndoTrail<MapType> trail_;
 };
 
 class SymbolMetadataTable {
@@ -89,9 +189,15 @@ public:
         return metadata_.find(name) != metadata_.end();
     }
 
+    // Callers write through the returned pointer, so an open frame records
+    // the entry first.
     [[nodiscard]] SymbolMetadata* lookup(const std::string& name) {
         auto it = metadata_.find(name);
-        return it == metadata_.end() ? nullptr : &it->second;
+        if (it == metadata_.end()) {
+            return nullptr;
+        }
+        trail_.record(metadata_, name);
+        return &it->second;
     }
 
     [[nodiscard]] const SymbolMetadata* lookup(const std::string& name) const {
@@ -100,13 +206,21 @@ public:
     }
 
     void set(std::string name, SymbolMetadata metadata) {
+        trail_.record(metadata_, name);
         metadata_[std::move(name)] = std::move(metadata);
     }
 
     void ensure(std::string name, SymbolMetadata metadata) {
-        metadata_.try_emplace(std::move(name), std::move(metadata));
+        if (metadata_.find(name) == metadata_.end()) {
+            trail_.record(metadata_, name);
+            metadata_.emplace(std::move(name), std::move(metadata));
+        }
     }
 
+    // Metadata written while a frame is open is rolled back when it is popped.
+    void push_frame() { trail_.push_frame(); }
+    std::vector<std::string> pop_frame() { return trail_.pop_frame(metadata_); }
+
     [[nodiscard]] bool has_attribute(const std::string& name, SymbolAttribute attribute) const {
         const auto* metadata = lookup(name);
         if (metadata == nullptr) {
@@ -130,6 +244,7 @@ public:
 
 private:
     MapType metadata_;
+    TableUndoTrail<MapType> trail_;
 };
 
 class SymbolDefinitionTable {
@@ -142,7 +257,11 @@ public:
 
     [[nodiscard]] std::vector<SymbolDefinitionRecord>* lookup(const std::string& name) {
         auto it = definitions_.find(name);
-        return it == definitions_.end() ? nullptr : &it->second;
+        if (it == definitions_.end()) {
+            return nullptr;
+        }
+        trail_.record(definitions_, name);
+        return &it->second;
     }
 
     [[nodiscard]] const std::vector<SymbolDefinitionRecord>* lookup(const std::string& name) const {
@@ -206,6 +325,7 @@ public:
     }
 
     void add(std::string name, SymbolDefinitionRecord record) {
+        trail_.record(definitions_, name);
         definitions_[std::move(name)].push_back(std::move(record));
     }
 
@@ -213,9 +333,13 @@ public:
         if (contains(name, record.kind, record.origin, record.provider)) {
             return;
         }
+        trail_.record(definitions_, name);
         definitions_[std::move(name)].push_back(std::move(record));
     }
 
+    void push_frame() { trail_.push_frame(); }
+    std::vector<std::string> pop_frame() { return trail_.pop_frame(definitions_); }
+
     [[nodiscard]] MapType& entries() {
         return definitions_;
     }
@@ -226,6 +350,7 @@ public:
 
 private:
     MapType definitions_;
+    TableUndoTrail<MapType> trail_;
 };
 
 class FunctionDefinitionTable {
@@ -247,10 +372,21 @@ public:
     }
 
     void set(std::string name, FunctionDefinition definition) {
+        trail_.record(definitions_, name);
         definitions_[std::move(name)] = std::move(definition);
+        advance_modification_count();
     }
 
+    void push_frame() { trail_.push_frame(); }
+    std::vector<std::string> pop_frame() { return trail_.pop_frame(definitions_); }
+
+    // Counts as a definition change, as for SymbolValueTable::entries.
     [[nodiscard]] MapType& entries() {
+        advance_modification_count();
+        return definitions_;
+    }
+
+    [[nodiscard]] MapType& unobserved_entries() noexcept {
         return definitions_;
     }
 
@@ -260,6 +396,7 @@ public:
 
 private:
     MapType definitions_;
+    TableUndoTrail<MapType> trail_;
 };
 
 }  // namespace aleph3::symbols
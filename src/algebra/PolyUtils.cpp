@@ -2,6 +2,7 @@
 #include "algebra/Polynomial.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
 #include "expr/Expr.hpp"
+#include "expr/ExprSummary.hpp"
 #include "expr/ExprUtils.hpp"
 #include <utility>
 #include <set>
@@ -52,7 +53,7 @@ namespace aleph3 {
     std::vector<std::string> infer_variables(const ExprPtr& expr) {
         std::set<std::string> vars;
         std::function<void(const ExprPtr&)> visit = [&](const ExprPtr& e) {
-            if (!e) return;
+            if (!e || !expr_summary(e).has_symbols) return;
             if (auto sym = std::get_if<Symbol>(&(*e))) {
                 vars.insert(sym->name);
             }
@@ -146,6 +147,10 @@ namespace aleph3 {
 
     bool is_exact_polynomial_candidate(const ExprPtr& expr) {
         if (!expr) return false;
+        // Only a fractional Number can disqualify the tree.
+        if (!expr_summary(expr).has_fractional_number) {
+            return true;
+        }
         if (const auto* number = std::get_if<Number>(&(*expr))) {
             return is_near_integer(number->value);
         }
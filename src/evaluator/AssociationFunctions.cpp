@@ -0,0 +1,198 @@
+#include "evaluator/BuiltInFunctions.hpp"
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+namespace {
+
+const std::vector<ExprPtr>* list_parts(const ExprPtr& expr) {
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        return &list->elements;
+    }
+    if (const auto* call = std::get_if<FunctionCall>(&*expr); call != nullptr && call->head == "List") {
+        return &call->args;
+    }
+    return nullptr;
+}
+
+// Appends the entries of a rule, a list of rules, or an association; false
+// when the argument is none of these.
+bool append_entries(const ExprPtr& arg, std::vector<std::pair<ExprPtr, ExprPtr>>& entries) {
+    if (const auto* rule = std::get_if<Rule>(&*arg)) {
+        entries.emplace_back(rule->lhs, rule->rhs);
+        return true;
+    }
+    if (const auto* assoc = std::get_if<Association>(&*arg)) {
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            entries.emplace_back(key, value);
+        });
+        return true;
+    }
+    if (const auto* parts = list_parts(arg)) {
+        for (const auto& part : *parts) {
+            if (!append_entries(part, entries)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+const Association& require_association(const ExprPtr& expr, const std::string& head) {
+    if (const auto* assoc = std::get_if<Association>(&*expr)) {
+        return *assoc;
+    }
+    throw_invalid_form(head + " expects an association as the first argument");
+}
+
+ExprPtr missing_key(const ExprPtr& key) {
+    return make_expr<FunctionCall>(
+        "Missing", std::vector<ExprPtr>{make_expr<String>("KeyAbsent"), key});
+}
+
+std::vector<ExprPtr> evaluate_arguments(const FunctionCall& func, EvaluationContext& ctx) {
+    std::vector<ExprPtr> args;
+    args.reserve(func.args.size());
+    for (const auto& arg : func.args) {
+        args.push_back(evaluate(arg, ctx));
+    }
+    return args;
+}
+
+}  // namespace
+
+void register_association_builtins(kernel::FunctionRegistry& registry) {
+    registry.register_function(
+        "Association",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            const auto args = evaluate_arguments(func, ctx);
+            std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+            for (const auto& arg : args) {
+                if (!append_entries(arg, entries)) {
+                    throw_invalid_form("Association expects rules, lists of rules, or associations");
+                }
+            }
+            return make_expr<Association>(AssociationMap::from_entries(entries));
+        });
+
+    registry.register_function(
+        "Lookup",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() < 2 || func.args.size() > 3) {
+                throw_invalid_arity_between("Lookup", 2, 3);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            if (const auto* value = require_association(args[0], "Lookup").map.find(args[1])) {
+                return *value;
+            }
+            return args.size() == 3 ? args[2] : missing_key(args[1]);
+        });
+
+    registry.register_function(
+        "KeyExistsQ",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("KeyExistsQ", 2);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            return make_expr<Boolean>(require_association(args[0], "KeyExistsQ").map.find(args[1]) != nullptr);
+        });
+
+    registry.register_function(
+        "Keys",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Keys", 1);
+            }
+            const auto assoc = evaluate(func.args[0], ctx);
+            const auto& map = require_association(assoc, "Keys").map;
+            std::vector<ExprPtr> keys;
+            keys.reserve(map.size());
+            map.for_each([&](const ExprPtr& key, const ExprPtr&) { keys.push_back(key); });
+            return make_expr<List>(std::move(keys));
+        });
+
+    registry.register_function(
+        "Values",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Values", 1);
+            }
+            const auto assoc = evaluate(func.args[0], ctx);
+            const auto& map = require_association(assoc, "Values").map;
+            std::vector<ExprPtr> values;
+            values.reserve(map.size());
+            map.for_each([&](const ExprPtr&, const ExprPtr& value) { values.push_back(value); });
+            return make_expr<List>(std::move(values));
+        });
+
+    registry.register_function(
+        "Normal",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Normal", 1);
+            }
+            auto arg = evaluate(func.args[0], ctx);
+            const auto* assoc = std::get_if<Association>(&*arg);
+            if (assoc == nullptr) {
+                return arg;
+            }
+            std::vector<ExprPtr> rules;
+            rules.reserve(assoc->map.size());
+            assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                rules.push_back(make_expr<Rule>(key, value));
+            });
+            return make_expr<List>(std::move(rules));
+        });
+
+    // Updates share storage with the original association, which is unchanged.
+    registry.register_function(
+        "Append",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("Append", 2);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            if (const auto* parts = list_parts(args[0])) {
+                auto elements = *parts;
+                elements.push_back(args[1]);
+                return make_expr<List>(std::move(elements));
+            }
+            auto map = require_association(args[0], "Append").map;
+            std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+            if (!append_entries(args[1], entries)) {
+                throw_invalid_form("Append expects a rule or a list of rules to add to an association");
+            }
+            for (const auto& [key, value] : entries) {
+                map = map.insert(key, value);
+            }
+            return make_expr<Association>(std::move(map));
+        });
+
+    registry.register_function(
+        "KeyDrop",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("KeyDrop", 2);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            auto map = require_association(args[0], "KeyDrop").map;
+            if (const auto* keys = list_parts(args[1])) {
+                for (const auto& key : *keys) {
+                    map = map.erase(key);
+                }
+            } else {
+                map = map.erase(args[1]);
+            }
+            return make_expr<Association>(std::move(map));
+        });
+}
+
+}  // namespace aleph3
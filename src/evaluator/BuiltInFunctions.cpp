@@ -1,14 +1,23 @@
+#include "evaluator/BuiltInFunctions.hpp"
 #include "evaluator/Evaluator.hpp"
 #include "evaluator/EvaluatorBuiltins.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
+#include "evaluator/EvaluatorFunctions.hpp"
 #include "kernel/Assumptions.hpp"
 #include "kernel/FunctionRegistry.hpp"
+#include "kernel/PackManifest.hpp"
 #include "kernel/Rewrite.hpp"
+#include "kernel/StringReplacement.hpp"
+#include "kernel/SymbolAttributes.hpp"
 #include "packs/AlgebraPack.hpp"
+#include "packs/NumberTheoryPack.hpp"
 #include "expr/ExprUtils.hpp"
 #include "util/Overloaded.hpp"
 #include "Constants.hpp"
+#include <algorithm>
 #include <cmath>
+#include <optional>
+#include <vector>
 
 namespace aleph3 {
 
@@ -16,6 +25,37 @@ namespace aleph3 {
 
     constexpr std::size_t REPLACE_REPEATED_MAX_REWRITES = 16;
 
+    // "a" -> "b" or a list of such rules; nullopt if any rule is not a
+    // string-to-string rule.
+    std::optional<std::vector<kernel::StringReplacementRule>> string_replacement_rules(const ExprPtr& rules_arg) {
+        std::vector<kernel::StringReplacementRule> rules;
+        auto append_rule = [&rules](const ExprPtr& candidate) {
+            const auto* rule = std::get_if<Rule>(&*candidate);
+            if (rule == nullptr) {
+                return false;
+            }
+            const auto* lhs = std::get_if<String>(&*rule->lhs);
+            const auto* rhs = std::get_if<String>(&*rule->rhs);
+            if (lhs == nullptr || rhs == nullptr) {
+                return false;
+            }
+            rules.push_back({lhs->value, rhs->value});
+            return true;
+        };
+
+        if (const auto* list = std::get_if<List>(&*rules_arg)) {
+            rules.reserve(list->elements.size());
+            for (const auto& element : list->elements) {
+                if (!append_rule(element)) {
+                    return std::nullopt;
+                }
+            }
+        } else if (!append_rule(rules_arg)) {
+            return std::nullopt;
+        }
+        return rules;
+    }
+
     // Helper for numeric evaluation of constants and expressions
     inline ExprPtr numeric_eval(const ExprPtr& expr) {
         return std::visit(overloaded{
@@ -47,7 +87,16 @@ namespace aleph3 {
                 for (const auto& elem : list.elements) {
                     evaluated.push_back(numeric_eval(elem));
                 }
-                return std::make_shared<Expr>(List{evaluated});
+                return make_expr_node(List{evaluated});
+            },
+            [](const Association& assoc) -> ExprPtr {
+                // Keys stay exact so lookups by the original keys still match.
+                std::vector<std::pair<ExprPtr, ExprPtr>> evaluated;
+                evaluated.reserve(assoc.map.size());
+                assoc.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    evaluated.emplace_back(key, numeric_eval(value));
+                });
+                return make_expr_node(Association{AssociationMap::from_entries(evaluated)});
             },
             [](const FunctionDefinition& def) -> ExprPtr {
                 return make_expr<FunctionDefinition>(def.name, def.params, def.body, def.delayed);
@@ -75,11 +124,6 @@ namespace aleph3 {
         throw_invalid_form(name + " expects the second argument to be a Rule");
     }
 
-    EvaluationContext with_added_assumptions(EvaluationContext ctx, const ExprPtr& assumptions) {
-        ctx.assumptions.assume(assumptions);
-        return ctx;
-    }
-
     ExprPtr evaluate_assumption_predicate(
         const std::string& name,
         const FunctionCall& func,
@@ -96,6 +140,43 @@ namespace aleph3 {
         return make_expr<FunctionCall>(name, std::vector<ExprPtr>{arg});
     }
 
+    const std::string& require_attribute_target(const std::string& name, const ExprPtr& expr) {
+        if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+            return symbol->name;
+        }
+        throw_invalid_form(name + " expects a symbol as the first argument");
+    }
+
+    const FunctionCall& require_definition_target(const std::string& name, const ExprPtr& expr) {
+        if (const auto* call = std::get_if<FunctionCall>(&*expr)) {
+            return *call;
+        }
+        throw_invalid_form(name + " expects a call such as f[0] as the left-hand side");
+    }
+
+    symbols::SymbolAttribute user_settable_attribute(const std::string& name, const ExprPtr& expr) {
+        if (const auto* symbol = std::get_if<Symbol>(&*expr); symbol != nullptr && symbol->name == "Memoize") {
+            return symbols::SymbolAttribute::memoize;
+        }
+        throw_invalid_form(name + " currently supports only the Memoize attribute");
+    }
+
+    std::vector<symbols::SymbolAttribute> user_settable_attributes(const std::string& name, const ExprPtr& expr) {
+        std::vector<symbols::SymbolAttribute> attributes;
+        if (const auto* list = std::get_if<FunctionCall>(&*expr); list != nullptr && list->head == "List") {
+            for (const auto& item : list->args) {
+                attributes.push_back(user_settable_attribute(name, item));
+            }
+        } else if (const auto* list = std::get_if<List>(&*expr)) {
+            for (const auto& item : list->elements) {
+                attributes.push_back(user_settable_attribute(name, item));
+            }
+        } else {
+            attributes.push_back(user_settable_attribute(name, expr));
+        }
+        return attributes;
+    }
+
     }  // namespace
 
     void register_builtin_rewrite_specs(kernel::FunctionRegistry& registry) {
@@ -134,17 +215,18 @@ namespace aleph3 {
     void register_symbolic_builtins(kernel::FunctionRegistry& registry) {
         // String functions
         registry.register_function("StringJoin", [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
-            std::string result;
+            std::vector<SharedString> parts;
+            parts.reserve(func.args.size());
             for (const auto& arg : func.args) {
                 auto evaluated_arg = evaluate(arg, ctx);
                 if (std::holds_alternative<String>(*evaluated_arg)) {
-                    result += std::get<String>(*evaluated_arg).value;
+                    parts.push_back(std::get<String>(*evaluated_arg).value);
                 }
                 else {
                     throw_invalid_form("StringJoin expects string arguments");
                 }
             }
-            return make_expr<String>(result);
+            return make_expr<String>(SharedString::join(parts));
             });
 
         registry.register_function("StringLength", [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
@@ -169,20 +251,10 @@ namespace aleph3 {
 
             if (std::holds_alternative<String>(*str_arg)) {
                 const auto& str = std::get<String>(*str_arg).value;
-                if (auto* rule = std::get_if<Rule>(&(*rule_arg))) {
-                    auto* lhs = std::get_if<String>(&(*rule->lhs));
-                    auto* rhs = std::get_if<String>(&(*rule->rhs));
-                    if (lhs && rhs) {
-                        std::string result = str;
-                        size_t pos = 0;
-                        while ((pos = result.find(lhs->value, pos)) != std::string::npos) {
-                            result.replace(pos, lhs->value.size(), rhs->value);
-                            pos += rhs->value.size(); // Move past the replacement
-                        }
-                        return make_expr<String>(result);
-                    }
+                if (auto rules = string_replacement_rules(rule_arg)) {
+                    return make_expr<String>(kernel::cached_string_replacer(*rules)->apply(str.str()));
                 }
-                // If not a rule, return the original string unchanged (Mathematica behavior)
+                // If not string rules, return the original string unchanged (Mathematica behavior)
                 return make_expr<String>(str);
             }
             // If not a string, return unevaluated
@@ -245,7 +317,10 @@ namespace aleph3 {
                 const auto& list = std::get<List>(*arg);
                 return make_expr<Number>(static_cast<double>(list.elements.size()));
             }
-            throw_invalid_form("Length expects a list argument");
+            if (const auto* assoc = std::get_if<Association>(&*arg)) {
+                return make_expr<Number>(static_cast<double>(assoc->map.size()));
+            }
+            throw_invalid_form("Length expects a list or association argument");
             });
 
         registry.register_function("N", [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
@@ -331,11 +406,71 @@ namespace aleph3 {
                 if (func.args.size() != 2) {
                     throw_invalid_arity_exact("Assuming", 2);
                 }
-                auto scoped_ctx = with_added_assumptions(ctx, func.args[0]);
-                return evaluate(func.args[1], scoped_ctx);
+                kernel::ScopedEvaluationFrame frame(ctx);
+                ctx.assumptions.assume(func.args[0]);
+                return evaluate(func.args[1], ctx);
             },
             {symbols::SymbolAttribute::hold_first});
 
+        registry.register_function(
+            "SetAttributes",
+            [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+                if (func.args.size() != 2) {
+                    throw_invalid_arity_exact("SetAttributes", 2);
+                }
+                const auto& target = require_attribute_target("SetAttributes", func.args[0]);
+                const auto attributes = user_settable_attributes("SetAttributes", func.args[1]);
+                kernel::sync_symbol_attribute_metadata(
+                    ctx,
+                    target,
+                    symbols::DefinitionOrigin::user,
+                    {},
+                    attributes);
+                ctx.function_memo().clear(target);
+                return make_expr<Symbol>("Null");
+            },
+            {symbols::SymbolAttribute::hold_all});
+
+        registry.register_function(
+            "ClearAttributes",
+            [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+                if (func.args.size() != 2) {
+                    throw_invalid_arity_exact("ClearAttributes", 2);
+                }
+                const auto& target = require_attribute_target("ClearAttributes", func.args[0]);
+                const auto attributes = user_settable_attributes("ClearAttributes", func.args[1]);
+                if (auto* metadata = ctx.symbol_metadata.lookup(target)) {
+                    std::erase_if(metadata->attributes, [&](symbols::SymbolAttribute attribute) {
+                        return std::find(attributes.begin(), attributes.end(), attribute) != attributes.end();
+                    });
+                }
+                ctx.function_memo().clear(target);
+                return make_expr<Symbol>("Null");
+            },
+            {symbols::SymbolAttribute::hold_all});
+
+        registry.register_function(
+            "SetDelayed",
+            [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+                if (func.args.size() != 2) {
+                    throw_invalid_arity_exact("SetDelayed", 2);
+                }
+                const auto& lhs = require_definition_target("SetDelayed", func.args[0]);
+                return register_pattern_definition(lhs, func.args[1], true, ctx);
+            },
+            {symbols::SymbolAttribute::hold_all});
+
+        registry.register_function(
+            "Set",
+            [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+                if (func.args.size() != 2) {
+                    throw_invalid_arity_exact("Set", 2);
+                }
+                const auto& lhs = require_definition_target("Set", func.args[0]);
+                return register_pattern_definition(lhs, func.args[1], false, ctx);
+            },
+            {symbols::SymbolAttribute::hold_all});
+
         registry.register_function(
             "Refine",
             [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
@@ -343,13 +478,13 @@ namespace aleph3 {
                     throw_invalid_arity_between("Refine", 1, 2);
                 }
 
-                EvaluationContext scoped_ctx = ctx;
+                kernel::ScopedEvaluationFrame frame(ctx);
                 if (func.args.size() == 2) {
-                    scoped_ctx = with_added_assumptions(std::move(scoped_ctx), func.args[1]);
+                    ctx.assumptions.assume(func.args[1]);
                 }
 
-                auto evaluated = evaluate(func.args[0], scoped_ctx);
-                return kernel::refine_expr_with_assumptions(evaluated, scoped_ctx.assumptions);
+                auto evaluated = evaluate(func.args[0], ctx);
+                return kernel::refine_expr_with_assumptions(evaluated, ctx.assumptions);
             },
             {symbols::SymbolAttribute::hold_rest});
     }
@@ -357,21 +492,34 @@ namespace aleph3 {
 void register_built_in_functions(kernel::FunctionRegistry& registry) {
     register_builtin_rewrite_specs(registry);
     register_symbolic_builtins(registry);
-    packs::register_algebra_pack(registry);
+    register_parallel_builtins(registry);
+    register_random_builtins(registry);
+    register_association_builtins(registry);
+    register_list_set_builtins(registry);
+    register_structure_builtins(registry);
+    // Packs load their handlers on first use; only the manifest is registered here.
+    kernel::register_lazy_pack(registry, packs::algebra_pack_manifest());
+    kernel::register_lazy_pack(registry, packs::number_theory_pack_manifest());
     register_builtin_evaluator_execution_specs(registry);
 }
 
 namespace kernel {
 
-FunctionRegistry create_default_function_registry() {
-    FunctionRegistry registry;
-    ::aleph3::register_built_in_functions(registry);
+const std::shared_ptr<const FunctionRegistry>& shared_default_function_registry() {
+    static const std::shared_ptr<const FunctionRegistry> registry = [] {
+        auto built_ins = std::make_shared<FunctionRegistry>();
+        ::aleph3::register_built_in_functions(*built_ins);
+        return std::shared_ptr<const FunctionRegistry>(std::move(built_ins));
+    }();
     return registry;
 }
 
 const FunctionRegistry& default_function_registry() {
-    static const FunctionRegistry registry = create_default_function_registry();
-    return registry;
+    return *shared_default_function_registry();
+}
+
+FunctionRegistry create_default_function_registry() {
+    return FunctionRegistry(shared_default_function_registry());
 }
 
 }  // namespace kernel
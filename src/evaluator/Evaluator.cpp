@@ -6,6 +6,7 @@
 #include "evaluator/EvaluatorSemantics.hpp"
 #include "evaluator/EvaluatorSpecialForms.hpp"
 #include "kernel/Diagnostics.hpp"
+#include "kernel/EvaluationTraits.hpp"
 #include "kernel/FunctionRegistry.hpp"
 #include "kernel/SymbolAttributes.hpp"
 #include "expr/ExprUtils.hpp"
@@ -21,6 +22,7 @@ namespace aleph3 {
 
 namespace {
 
+template <typename Traits>
 ExprPtr evaluate_impl(const ExprPtr& expr, EvaluationContext& ctx, std::unordered_set<std::string>& visited);
 
 enum class FunctionDispatchOwner {
@@ -200,6 +202,8 @@ bool matches_value_type(const Value& value, ValueType expected) noexcept {
             return value.is_string();
         case ValueType::list:
             return value.is_list();
+        case ValueType::association:
+            return value.is_association();
     }
     return false;
 }
@@ -216,6 +220,8 @@ std::string value_type_name(ValueType type) {
             return "string";
         case ValueType::list:
             return "list";
+        case ValueType::association:
+            return "association";
     }
     return "any";
 }
@@ -233,6 +239,9 @@ std::string value_type_name(const Value& value) {
     if (value.is_list()) {
         return "list";
     }
+    if (value.is_association()) {
+        return "association";
+    }
     return "null";
 }
 
@@ -255,7 +264,7 @@ std::optional<Value> expr_to_sdk_value(const ExprPtr& expr) {
         return Value(boolean->value);
     }
     if (const auto* string = std::get_if<String>(&*expr)) {
-        return Value(string->value);
+        return Value(string->value.str());
     }
     if (const auto* list = std::get_if<List>(&*expr)) {
         Value::List values;
@@ -269,6 +278,24 @@ std::optional<Value> expr_to_sdk_value(const ExprPtr& expr) {
         }
         return Value(std::move(values));
     }
+    if (const auto* assoc = std::get_if<Association>(&*expr)) {
+        Value::Association entries;
+        entries.reserve(assoc->map.size());
+        bool convertible = true;
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            auto converted_key = convertible ? expr_to_sdk_value(key) : std::nullopt;
+            auto converted_value = converted_key ? expr_to_sdk_value(value) : std::nullopt;
+            if (!converted_value) {
+                convertible = false;
+                return;
+            }
+            entries.emplace_back(std::move(*converted_key), std::move(*converted_value));
+        });
+        if (!convertible) {
+            return std::nullopt;
+        }
+        return Value(std::move(entries));
+    }
 
     return std::nullopt;
 }
@@ -289,7 +316,16 @@ ExprPtr sdk_value_to_expr(const Value& value) {
         for (const auto& element : *list) {
             elements.push_back(sdk_value_to_expr(element));
         }
-        return std::make_shared<Expr>(List{elements});
+        return make_expr_node(List{elements});
+    }
+    if (const auto* association = value.as_association()) {
+        // Straight into the kernel's hash table; no rule list in between.
+        std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+        entries.reserve(association->size());
+        for (const auto& [key, entry] : *association) {
+            entries.emplace_back(sdk_value_to_expr(key), sdk_value_to_expr(entry));
+        }
+        return make_expr<Association>(AssociationMap::from_entries(entries));
     }
     return make_expr<Indeterminate>();
 }
@@ -452,6 +488,7 @@ ExprPtr evaluate_general_function(const FunctionCall& func, EvaluationContext& c
     return unresolved_symbolic_fallback(func);
 }
 
+template <typename Traits>
 ExprPtr resolve_symbol_value(const Symbol& sym, EvaluationContext& ctx, std::unordered_set<std::string>& visited) {
     if (visited.count(sym.name)) {
         return make_expr<Symbol>(sym.name);
@@ -462,7 +499,7 @@ ExprPtr resolve_symbol_value(const Symbol& sym, EvaluationContext& ctx, std::uno
         if (auto assumed_value = ctx.assumptions.find_boolean_value(sym.name); assumed_value.has_value()) {
             return make_expr<Boolean>(*assumed_value);
         }
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             kernel::throw_runtime_error(
                 kernel::ErrorCode::unknown_binding,
                 "No binding was provided for variable `" + sym.name + "`.");
@@ -471,14 +508,17 @@ ExprPtr resolve_symbol_value(const Symbol& sym, EvaluationContext& ctx, std::uno
     }
 
     visited.insert(sym.name);
-    auto result = evaluate_impl(*value, ctx, visited);
+    auto result = evaluate_impl<Traits>(*value, ctx, visited);
     visited.erase(sym.name);
     return result;
 }
 
+template <typename Traits>
 ExprPtr evaluate_impl(const ExprPtr& expr, EvaluationContext& ctx, std::unordered_set<std::string>& visited) {
-    ctx.consume_evaluation_step();
-    ALEPH3_LOG("evaluate: input = " << to_string_raw(expr));
+    ctx.consume_evaluation_step(Traits{});
+    if constexpr (Traits::tracing) {
+        ALEPH3_LOG("evaluate: input = " << to_string_raw(expr));
+    }
 
     auto result = std::visit(overloaded{
         [](const Number& num) -> ExprPtr {
@@ -498,7 +538,7 @@ ExprPtr evaluate_impl(const ExprPtr& expr, EvaluationContext& ctx, std::unordere
             return make_expr<String>(str.value);
         },
         [&](const Symbol& sym) -> ExprPtr {
-            return resolve_symbol_value(sym, ctx, visited);
+            return resolve_symbol_value<Traits>(sym, ctx, visited);
         },
         [&](const FunctionCall& func) -> ExprPtr {
             if (is_structural_function(func.head)) {
@@ -531,12 +571,16 @@ ExprPtr evaluate_impl(const ExprPtr& expr, EvaluationContext& ctx, std::unordere
             return make_expr<Symbol>(assign.name);
         },
         [&](const Rule& rule) -> ExprPtr {
-            auto lhs = evaluate_impl(rule.lhs, ctx, visited);
-            auto rhs = evaluate_impl(rule.rhs, ctx, visited);
+            auto lhs = evaluate_impl<Traits>(rule.lhs, ctx, visited);
+            auto rhs = evaluate_impl<Traits>(rule.rhs, ctx, visited);
             return make_expr<Rule>(lhs, rhs);
         },
         [](const List& list) -> ExprPtr {
-            return std::make_shared<Expr>(list);
+            return make_expr_node(list);
+        },
+        // Values are evaluated once, when the association is built.
+        [](const Association& assoc) -> ExprPtr {
+            return make_expr_node(assoc);
         },
         [](const Infinity&) -> ExprPtr {
             return make_expr<Infinity>();
@@ -549,16 +593,58 @@ ExprPtr evaluate_impl(const ExprPtr& expr, EvaluationContext& ctx, std::unordere
         }
     }, *expr);
 
-    ALEPH3_LOG("evaluate: result = " << to_string_raw(result));
+    if constexpr (Traits::tracing) {
+        ALEPH3_LOG("evaluate: result = " << to_string_raw(result));
+    }
     return result;
 }
 
+EvaluationStamp* find_evaluation_stamp(const Expr& expr) {
+    if (const auto* func = std::get_if<FunctionCall>(&expr)) {
+        return &func->evaluation_stamp;
+    }
+    if (const auto* list = std::get_if<List>(&expr)) {
+        return &list->evaluation_stamp;
+    }
+    return nullptr;
+}
+
+bool has_current_evaluation_stamp(const Expr& expr, const EvaluationContext& ctx) {
+    const auto* stamp = find_evaluation_stamp(expr);
+    return stamp != nullptr &&
+        stamp->modification_count == symbols::modification_count() &&
+        stamp->context_lineage == ctx.evaluation_lineage();
+}
+
+void stamp_evaluated(const Expr& expr, std::uint64_t modification_count, const EvaluationContext& ctx) {
+    if (auto* stamp = find_evaluation_stamp(expr)) {
+        stamp->modification_count = modification_count;
+        stamp->context_lineage = ctx.evaluation_lineage();
+    }
+}
+
 }  // namespace
 
 ExprPtr evaluate(const ExprPtr& expr, EvaluationContext& ctx) {
+    // Outputs of an earlier evaluation are fixed points until a symbol value,
+    // definition, or assumption changes.
+    if (has_current_evaluation_stamp(*expr, ctx)) {
+        return expr;
+    }
+
+    const auto modification_count = symbols::modification_count();
     ExprPtr norm = normalize_expr(expr);
     std::unordered_set<std::string> visited;
-    return evaluate_impl(norm, ctx, visited);
+    auto result = kernel::with_evaluation_traits(ctx, [&](auto traits) {
+        return evaluate_impl<decltype(traits)>(norm, ctx, visited);
+    });
+    // Anything written during this evaluation may have been read before the
+    // write, so only an undisturbed evaluation yields a trusted fixed point.
+    // Parallel workers share nodes across threads and only read stamps.
+    if (!ctx.is_parallel_worker() && symbols::modification_count() == modification_count) {
+        stamp_evaluated(*result, modification_count, ctx);
+    }
+    return result;
 }
 
 std::string expr_to_key(const ExprPtr& expr) {
@@ -9,6 +9,7 @@
 #include "evaluator/SimplificationRules.hpp"
 #include "expr/ExprUtils.hpp"
 #include "kernel/Diagnostics.hpp"
+#include "kernel/EvaluationTraits.hpp"
 #include "kernel/FunctionRegistry.hpp"
 #include "util/Logging.hpp"
 
@@ -237,7 +238,7 @@ ExprPtr evaluate_elementwise_binary(
         for (size_t i = 0; i < l1.size(); ++i) {
             result.push_back(evaluate(make_fcall(op, {l1[i], l2[i]}), ctx));
         }
-        return std::make_shared<Expr>(List{result});
+        return make_expr_node(List{result});
     }
     if (std::holds_alternative<List>(*a)) {
         const auto& l1 = std::get<List>(*a).elements;
@@ -245,7 +246,7 @@ ExprPtr evaluate_elementwise_binary(
         for (const auto& elem : l1) {
             result.push_back(evaluate(make_fcall(op, {elem, b}), ctx));
         }
-        return std::make_shared<Expr>(List{result});
+        return make_expr_node(List{result});
     }
     if (std::holds_alternative<List>(*b)) {
         const auto& l2 = std::get<List>(*b).elements;
@@ -253,11 +254,12 @@ ExprPtr evaluate_elementwise_binary(
         for (const auto& elem : l2) {
             result.push_back(evaluate(make_fcall(op, {a, elem}), ctx));
         }
-        return std::make_shared<Expr>(List{result});
+        return make_expr_node(List{result});
     }
     return nullptr;
 }
 
+template <typename Traits>
 ExprPtr evaluate_builtin_unary(const FunctionCall& func, EvaluationContext& ctx) {
     const auto& unary = unary_functions();
     auto it = unary.find(func.head);
@@ -301,13 +303,13 @@ ExprPtr evaluate_builtin_unary(const FunctionCall& func, EvaluationContext& ctx)
 
     if (std::holds_alternative<Number>(*arg_eval)) {
         double arg = get_number_value(arg_eval);
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             ensure_finite_number(arg);
         }
         const auto& domains = unary_real_domains();
         auto domain_it = domains.find(func.head);
         if (domain_it != domains.end() && !domain_it->second(arg)) {
-            if (ctx.strict_runtime_semantics()) {
+            if constexpr (Traits::strict) {
                 kernel::throw_runtime_error(
                     kernel::ErrorCode::invalid_numeric_domain,
                     func.head + " is undefined for the given numeric input.");
@@ -315,7 +317,7 @@ ExprPtr evaluate_builtin_unary(const FunctionCall& func, EvaluationContext& ctx)
             return make_fcall(func.head, {arg_eval});
         }
         double result = it->second(arg);
-        if (ctx.strict_runtime_semantics() && !is_finite_number(result)) {
+        if (Traits::strict && !is_finite_number(result)) {
             kernel::throw_runtime_error(
                 kernel::ErrorCode::invalid_numeric_result,
                 "Numeric evaluation produced a non-finite result.");
@@ -330,12 +332,13 @@ ExprPtr evaluate_builtin_unary(const FunctionCall& func, EvaluationContext& ctx)
         for (const auto& element : elements) {
             result.push_back(evaluate(make_fcall(func.head, {element}), ctx));
         }
-        return std::make_shared<Expr>(List{result});
+        return make_expr_node(List{result});
     }
 
     return make_fcall(func.head, {arg_eval});
 }
 
+template <typename Traits>
 ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx) {
     const auto& binary = binary_functions();
     auto it = binary.find(func.head);
@@ -455,7 +458,7 @@ ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx
     if (std::holds_alternative<Number>(*left) && std::holds_alternative<Number>(*right)) {
         double a = get_number_value(left);
         double b = get_number_value(right);
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             ensure_finite_number(a);
             ensure_finite_number(b);
             if (func.head == "Divide" && b == 0.0) {
@@ -479,7 +482,7 @@ ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx
         const auto& domains = binary_real_domains();
         auto domain_it = domains.find(func.head);
         if (domain_it != domains.end() && !domain_it->second(a, b)) {
-            if (ctx.strict_runtime_semantics()) {
+            if constexpr (Traits::strict) {
                 if (func.head == "Power") {
                     kernel::throw_runtime_error(
                         kernel::ErrorCode::invalid_power_domain,
@@ -492,7 +495,7 @@ ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx
             return make_fcall(func.head, {left, right});
         }
         double result = it->second(a, b);
-        if (ctx.strict_runtime_semantics() && !is_finite_number(result)) {
+        if (Traits::strict && !is_finite_number(result)) {
             kernel::throw_runtime_error(
                 kernel::ErrorCode::invalid_numeric_result,
                 "Numeric evaluation produced a non-finite result.");
@@ -500,7 +503,7 @@ ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx
         return make_expr<Number>(result);
     }
 
-    if (ctx.strict_runtime_semantics()) {
+    if constexpr (Traits::strict) {
         throw_runtime_type_mismatch("Arithmetic operators require numeric values.");
     }
 
@@ -520,6 +523,7 @@ ExprPtr evaluate_builtin_binary(const FunctionCall& func, EvaluationContext& ctx
     return make_fcall(func.head, {left, right});
 }
 
+template <typename Traits>
 ExprPtr evaluate_builtin_comparison(const FunctionCall& func, EvaluationContext& ctx) {
     const auto& cmp = comparison_functions();
     auto it = cmp.find(func.head);
@@ -532,7 +536,7 @@ ExprPtr evaluate_builtin_comparison(const FunctionCall& func, EvaluationContext&
     if (std::holds_alternative<Number>(*left) && std::holds_alternative<Number>(*right)) {
         double arg1 = get_number_value(left);
         double arg2 = get_number_value(right);
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             ensure_finite_number(arg1);
             ensure_finite_number(arg2);
         }
@@ -564,7 +568,7 @@ ExprPtr evaluate_builtin_comparison(const FunctionCall& func, EvaluationContext&
         double a = std::get<Number>(*left).value;
         const auto& b = std::get<Rational>(*right);
         double b_val = static_cast<double>(b.numerator) / b.denominator;
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             ensure_finite_number(a);
         }
         return make_expr<Boolean>(it->second(a, b_val));
@@ -579,10 +583,10 @@ ExprPtr evaluate_builtin_comparison(const FunctionCall& func, EvaluationContext&
             const bool result = std::get<String>(*left).value == std::get<String>(*right).value;
             return make_expr<Boolean>(func.head == "Equal" ? result : !result);
         }
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             throw_runtime_type_mismatch("Equality comparisons require comparable value types.");
         }
-    } else if (ctx.strict_runtime_semantics()) {
+    } else if constexpr (Traits::strict) {
         throw_runtime_type_mismatch("Comparison operators require numeric values.");
     }
 
@@ -616,9 +620,10 @@ ExprPtr evaluate_builtin_negate(const FunctionCall& func, EvaluationContext& ctx
     return make_fcall("Times", {make_expr<Number>(-1), arg});
 }
 
+template <typename Traits>
 ExprPtr evaluate_builtin_clamp(const FunctionCall& func, EvaluationContext& ctx) {
     if (func.args.size() != 3) {
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             throw_runtime_invalid_call("Clamp expects three numeric arguments.");
         }
         throw_invalid_arity_exact("Clamp", 3);
@@ -630,7 +635,7 @@ ExprPtr evaluate_builtin_clamp(const FunctionCall& func, EvaluationContext& ctx)
     if (!std::holds_alternative<Number>(*value) ||
         !std::holds_alternative<Number>(*low) ||
         !std::holds_alternative<Number>(*high)) {
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             throw_runtime_invalid_call("Clamp expects three numeric arguments.");
         }
         return make_fcall("Clamp", {value, low, high});
@@ -639,13 +644,13 @@ ExprPtr evaluate_builtin_clamp(const FunctionCall& func, EvaluationContext& ctx)
     const double numeric_value = std::get<Number>(*value).value;
     const double numeric_low = std::get<Number>(*low).value;
     const double numeric_high = std::get<Number>(*high).value;
-    if (ctx.strict_runtime_semantics()) {
+    if constexpr (Traits::strict) {
         ensure_finite_number(numeric_value);
         ensure_finite_number(numeric_low);
         ensure_finite_number(numeric_high);
     }
     if (numeric_low > numeric_high) {
-        if (ctx.strict_runtime_semantics()) {
+        if constexpr (Traits::strict) {
             kernel::throw_runtime_error(
                 kernel::ErrorCode::invalid_numeric_domain,
                 "Clamp requires the lower bound to be less than or equal to the upper bound.");
@@ -655,27 +660,233 @@ ExprPtr evaluate_builtin_clamp(const FunctionCall& func, EvaluationContext& ctx)
     return make_expr<Number>(std::clamp(numeric_value, numeric_low, numeric_high));
 }
 
+// Evaluates a tree of listable numeric builtins over numeric lists in one
+// element-wise pass, e.g. Sqrt[x^2 + y^2] for list-valued x and y, instead of
+// building an intermediate List and a FunctionCall per element for every
+// operator. Only the cases whose element-wise result is a plain finite Number
+// are fused; anything else (symbolic leaves, domain failures, poles) falls
+// back to the regular path, so results are unchanged. Strict evaluations,
+// whose checks it does not apply, never plan one.
+class FusedListableKernel {
+public:
+    static std::optional<FusedListableKernel> plan(const FunctionCall& root, const EvaluationContext& ctx) {
+        FusedListableKernel kernel;
+        if (!kernel.add_call(root, ctx) || kernel.length_ == 0) {
+            return std::nullopt;
+        }
+        return kernel;
+    }
+
+    // Returns nullptr when an element leaves the fused fast path.
+    [[nodiscard]] ExprPtr run() const {
+        std::vector<double> registers(nodes_.size());
+        std::vector<ExprPtr> output(length_);
+        for (size_t i = 0; i < length_; ++i) {
+            for (size_t n = 0; n < nodes_.size(); ++n) {
+                const auto& node = nodes_[n];
+                double value = 0.0;
+                switch (node.kind) {
+                    case NodeKind::scalar:
+                        value = node.scalar;
+                        break;
+                    case NodeKind::vector:
+                        value = std::get<Number>(*(*node.elements)[i]).value;
+                        break;
+                    case NodeKind::unary: {
+                        const double arg = registers[node.left];
+                        if (node.unary_domain != nullptr && !(*node.unary_domain)(arg)) {
+                            return nullptr;
+                        }
+                        value = (*node.unary)(arg);
+                        break;
+                    }
+                    case NodeKind::binary: {
+                        const double left = registers[node.left];
+                        const double right = registers[node.right];
+                        if (node.binary_domain != nullptr && !(*node.binary_domain)(left, right)) {
+                            return nullptr;
+                        }
+                        value = (*node.binary)(left, right);
+                        break;
+                    }
+                }
+                if (!is_finite_number(value)) {
+                    return nullptr;
+                }
+                registers[n] = value;
+            }
+            output[i] = make_expr<Number>(registers.back());
+        }
+        return make_expr_node(List{std::move(output)});
+    }
+
+private:
+    enum class NodeKind {
+        scalar,
+        vector,
+        unary,
+        binary
+    };
+
+    // Nodes are stored in post-order, so operands precede their operator and
+    // the root is last.
+    struct Node {
+        NodeKind kind = NodeKind::scalar;
+        double scalar = 0.0;
+        const std::vector<ExprPtr>* elements = nullptr;
+        const std::function<double(double)>* unary = nullptr;
+        const std::function<double(double, double)>* binary = nullptr;
+        const std::function<bool(double)>* unary_domain = nullptr;
+        const std::function<bool(double, double)>* binary_domain = nullptr;
+        size_t left = 0;
+        size_t right = 0;
+    };
+
+    static bool all_numbers(const std::vector<ExprPtr>& elements) {
+        return std::all_of(elements.begin(), elements.end(), [](const ExprPtr& element) {
+            return std::holds_alternative<Number>(*element);
+        });
+    }
+
+    bool add_vector(const std::vector<ExprPtr>& elements) {
+        if (elements.empty() || !all_numbers(elements)) {
+            return false;
+        }
+        if (length_ != 0 && length_ != elements.size()) {
+            return false;
+        }
+        length_ = elements.size();
+        Node node;
+        node.kind = NodeKind::vector;
+        node.elements = &elements;
+        nodes_.push_back(node);
+        return true;
+    }
+
+    bool add_scalar(double value) {
+        Node node;
+        node.scalar = value;
+        nodes_.push_back(node);
+        return true;
+    }
+
+    bool add_value(const ExprPtr& value) {
+        if (const auto* number = std::get_if<Number>(value.get())) {
+            return add_scalar(number->value);
+        }
+        if (const auto* list = std::get_if<List>(value.get())) {
+            return add_vector(list->elements);
+        }
+        if (const auto* call = std::get_if<FunctionCall>(value.get()); call != nullptr && call->head == "List") {
+            return add_vector(call->args);
+        }
+        return false;
+    }
+
+    bool add_operand(const ExprPtr& expr, const EvaluationContext& ctx) {
+        if (const auto* symbol = std::get_if<Symbol>(expr.get())) {
+            // Stored values are already evaluated; anything that is not a
+            // number or numeric list leaves the fused path.
+            const ExprPtr* value = ctx.symbol_values.lookup(symbol->name);
+            return value != nullptr && add_value(*value);
+        }
+        if (const auto* call = std::get_if<FunctionCall>(expr.get()); call != nullptr && call->head != "List") {
+            return add_call(*call, ctx);
+        }
+        return add_value(expr);
+    }
+
+    bool add_call(const FunctionCall& call, const EvaluationContext& ctx) {
+        if (!is_listable_function(call.head) || call.head == "Gamma") {
+            return false;
+        }
+
+        if (call.args.size() == 1) {
+            const auto& unary = unary_functions();
+            auto it = unary.find(call.head);
+            if (it == unary.end() || !add_operand(call.args[0], ctx)) {
+                return false;
+            }
+            Node node;
+            node.kind = NodeKind::unary;
+            node.unary = &it->second;
+            const auto& domains = unary_real_domains();
+            if (auto domain = domains.find(call.head); domain != domains.end()) {
+                node.unary_domain = &domain->second;
+            }
+            node.left = nodes_.size() - 1;
+            nodes_.push_back(node);
+            return true;
+        }
+
+        // Flat heads such as Plus and Times fold left over any number of
+        // arguments, e.g. 3 * x * x after flattening.
+        if (call.args.size() == 2 || (call.args.size() > 2 && is_flat_function(call.head))) {
+            const auto& binary = binary_functions();
+            auto it = binary.find(call.head);
+            if (it == binary.end() || !add_operand(call.args[0], ctx)) {
+                return false;
+            }
+            const auto& domains = binary_real_domains();
+            const auto domain = domains.find(call.head);
+            size_t left = nodes_.size() - 1;
+            for (size_t arg = 1; arg < call.args.size(); ++arg) {
+                if (!add_operand(call.args[arg], ctx)) {
+                    return false;
+                }
+                Node node;
+                node.kind = NodeKind::binary;
+                node.binary = &it->second;
+                if (domain != domains.end()) {
+                    node.binary_domain = &domain->second;
+                }
+                node.left = left;
+                node.right = nodes_.size() - 1;
+                nodes_.push_back(node);
+                left = nodes_.size() - 1;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    std::vector<Node> nodes_;
+    size_t length_ = 0;
+};
+
+template <typename Traits>
 ExprPtr evaluate_builtin_numeric_or_comparison(const FunctionCall& func, EvaluationContext& ctx) {
+    if constexpr (!Traits::strict) {
+        if (is_numeric_function(func.head)) {
+            if (auto kernel = FusedListableKernel::plan(func, ctx)) {
+                if (auto fused = kernel->run()) {
+                    return fused;
+                }
+            }
+        }
+    }
+
     if (is_comparison_function(func.head)) {
-        if (auto comparison = evaluate_builtin_comparison(func, ctx)) {
+        if (auto comparison = evaluate_builtin_comparison<Traits>(func, ctx)) {
             return comparison;
         }
     }
 
     if (is_numeric_function(func.head)) {
         if (func.args.size() == 1) {
-            if (auto unary = evaluate_builtin_unary(func, ctx)) {
+            if (auto unary = evaluate_builtin_unary<Traits>(func, ctx)) {
                 return unary;
             }
         }
         if (func.args.size() == 2) {
-            if (auto binary = evaluate_builtin_binary(func, ctx)) {
+            if (auto binary = evaluate_builtin_binary<Traits>(func, ctx)) {
                 return binary;
             }
         }
     }
 
-    if (auto comparison = evaluate_builtin_comparison(func, ctx)) {
+    if (auto comparison = evaluate_builtin_comparison<Traits>(func, ctx)) {
         return comparison;
     }
 
@@ -693,13 +904,21 @@ ExprPtr evaluate_builtin_numeric_or_comparison(const FunctionCall& func, Evaluat
 
 void register_builtin_evaluator_execution_specs_impl(kernel::FunctionRegistry& registry) {
     registry.register_builtin_function("Negate", evaluate_builtin_negate);
-    registry.register_builtin_function("Clamp", evaluate_builtin_clamp);
+    registry.register_builtin_function(
+        "Clamp",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            return kernel::with_evaluation_traits(ctx, [&](auto traits) {
+                return evaluate_builtin_clamp<decltype(traits)>(func, ctx);
+            });
+        });
 
     const auto register_family_handler = [&registry](std::string_view name) {
         registry.register_builtin_function(
             std::string(name),
             [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
-                return evaluate_builtin_numeric_or_comparison(func, ctx);
+                return kernel::with_evaluation_traits(ctx, [&](auto traits) {
+                    return evaluate_builtin_numeric_or_comparison<decltype(traits)>(func, ctx);
+                });
             });
     };
 
@@ -2,6 +2,9 @@
 
 #include "evaluator/EvaluatorErrors.hpp"
 #include "evaluator/Evaluator.hpp"
+#include "kernel/Rewrite.hpp"
+
+#include <utility>
 
 namespace aleph3 {
 
@@ -16,62 +19,115 @@ void ensure_user_symbol_metadata(const std::string& name, EvaluationContext& ctx
         {}});
 }
 
+void ensure_user_function_record(const std::string& name, EvaluationContext& ctx) {
+    ensure_user_symbol_metadata(name, ctx);
+    ctx.definition_records.add_unique(name, symbols::SymbolDefinitionRecord{
+        symbols::SymbolDefinitionKind::user_function,
+        symbols::DefinitionOrigin::user,
+        {}});
+    ctx.function_memo().clear(name);
+}
+
+// Provided arguments are already evaluated; defaults are evaluated here so
+// nothing is evaluated twice.
 std::vector<ExprPtr> bind_user_function_arguments(
     const FunctionDefinition& def,
-    const FunctionCall& func) {
+    const std::string& head,
+    std::vector<ExprPtr> provided_args,
+    EvaluationContext& ctx) {
     const size_t param_count = def.params.size();
-    const size_t arg_count = func.args.size();
-    std::vector<ExprPtr> final_args;
-    final_args.reserve(param_count);
-
-    for (size_t i = 0; i < param_count; ++i) {
-        if (i < arg_count) {
-            final_args.push_back(func.args[i]);
-            continue;
-        }
-
-        if (def.params[i].default_value != nullptr) {
-            final_args.push_back(def.params[i].default_value);
-            continue;
-        }
-
-        throw_invalid_arity_at_least("Function " + func.head, i + 1, arg_count);
+    const size_t arg_count = provided_args.size();
+    if (arg_count > param_count) {
+        throw_invalid_arity_at_most("Function " + head, param_count, arg_count);
     }
 
-    if (arg_count > param_count) {
-        throw_invalid_arity_at_most("Function " + func.head, param_count, arg_count);
+    std::vector<ExprPtr> final_args = std::move(provided_args);
+    final_args.reserve(param_count);
+    for (size_t i = arg_count; i < param_count; ++i) {
+        if (def.params[i].default_value == nullptr) {
+            throw_invalid_arity_at_least("Function " + head, i + 1, arg_count);
+        }
+        final_args.push_back(evaluate(def.params[i].default_value, ctx));
     }
 
     return final_args;
 }
 
+ExprPtr evaluate_memoized(
+    const std::string& head,
+    const std::vector<ExprPtr>& args,
+    const ExprPtr& body,
+    EvaluationContext& local_ctx,
+    EvaluationContext& ctx,
+    bool memoize) {
+    auto result = evaluate(body, local_ctx);
+    if (memoize) {
+        ctx.function_memo().store(head, args, result);
+    }
+    return result;
+}
+
 }  // namespace
 
 bool is_user_defined_function(const std::string& name, const EvaluationContext& ctx) {
-    return ctx.function_definitions.contains(name);
+    return ctx.function_definitions.contains(name) || ctx.pattern_definitions.contains(name);
 }
 
 ExprPtr evaluate_user_defined_function(const FunctionCall& func, EvaluationContext& ctx) {
     const FunctionDefinition* def = ctx.function_definitions.lookup(func.head);
-    if (def == nullptr) {
+    const kernel::PatternDefinitionSet* patterns = ctx.pattern_definitions.lookup(func.head);
+    if (def == nullptr && patterns == nullptr) {
         throw_unsupported_construct("Unknown user-defined function: " + func.head);
     }
-    auto final_args = bind_user_function_arguments(*def, func);
+
+    std::vector<ExprPtr> args;
+    args.reserve(func.args.size());
+    for (const auto& arg : func.args) {
+        args.push_back(evaluate(arg, ctx));
+    }
+
+    // Cached results are keyed by arguments alone, but inside Assuming or
+    // Refine a result can depend on the scoped facts, so the cache is
+    // neither read nor filled there.
+    const bool memoize = ctx.assumptions.frame_depth() == 0 &&
+        ctx.symbol_metadata.has_attribute(func.head, symbols::SymbolAttribute::memoize);
+    if (memoize) {
+        if (auto cached = ctx.function_memo().lookup(func.head, args)) {
+            return cached;
+        }
+    }
+
+    // Pattern definitions are more specific than the plain `f[x_, ...]` form,
+    // so they are tried first.
+    if (patterns != nullptr) {
+        if (auto match = patterns->match(args)) {
+            EvaluationContext local_ctx = ctx;
+            for (const auto& [name, value] : match->bindings) {
+                local_ctx.symbol_values.set(name, value);
+            }
+            return evaluate_memoized(func.head, args, match->definition->body, local_ctx, ctx, memoize);
+        }
+        if (def == nullptr) {
+            return make_expr<FunctionCall>(func.head, args);
+        }
+    }
+
+    auto final_args = bind_user_function_arguments(*def, func.head, std::move(args), ctx);
+    if (memoize && final_args.size() != func.args.size()) {
+        if (auto cached = ctx.function_memo().lookup(func.head, final_args)) {
+            return cached;
+        }
+    }
 
     EvaluationContext local_ctx = ctx;
     for (size_t i = 0; i < def->params.size(); ++i) {
-        local_ctx.symbol_values.set(def->params[i].name, evaluate(final_args[i], ctx));
+        local_ctx.symbol_values.set(def->params[i].name, final_args[i]);
     }
-
-    return evaluate(def->body, local_ctx);
+    return evaluate_memoized(func.head, final_args, def->body, local_ctx, ctx, memoize);
 }
 
 ExprPtr register_user_defined_function(const FunctionDefinition& def, EvaluationContext& ctx) {
-    ensure_user_symbol_metadata(def.name, ctx);
-    ctx.definition_records.add_unique(def.name, symbols::SymbolDefinitionRecord{
-        symbols::SymbolDefinitionKind::user_function,
-        symbols::DefinitionOrigin::user,
-        {}});
+    ensure_user_function_record(def.name, ctx);
 
     if (def.delayed) {
         ctx.function_definitions.set(def.name, def);
@@ -90,4 +146,30 @@ ExprPtr register_user_defined_function(const FunctionDefinition& def, Evaluation
     return evaluated_body;
 }
 
+ExprPtr register_pattern_definition(
+    const FunctionCall& lhs,
+    const ExprPtr& rhs,
+    bool delayed,
+    EvaluationContext& ctx) {
+    ensure_user_function_record(lhs.head, ctx);
+
+    if (delayed) {
+        ctx.pattern_definitions.add(lhs.head, kernel::PatternDefinition{lhs.args, rhs, true});
+        return make_expr<Symbol>("Null");
+    }
+
+    std::vector<std::string> pattern_names;
+    for (const auto& arg : lhs.args) {
+        kernel::collect_pattern_variable_names(arg, pattern_names);
+    }
+    EvaluationContext local_ctx = ctx;
+    for (const auto& name : pattern_names) {
+        local_ctx.symbol_values.set(name, make_expr<Symbol>(name));
+    }
+
+    auto value = evaluate(rhs, local_ctx);
+    ctx.pattern_definitions.add(lhs.head, kernel::PatternDefinition{lhs.args, value, false});
+    return value;
+}
+
 }  // namespace aleph3
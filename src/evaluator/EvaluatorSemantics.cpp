@@ -65,6 +65,39 @@ const std::unordered_map<std::string, FunctionSemantics>& function_semantics_reg
         {"Or", arity_range_semantics(EvaluationMode::HoldAll, DispatchKind::SpecialForm, true, false, false, false, false, false, 0, std::numeric_limits<size_t>::max())},
         {"Assuming", exact_arity_semantics(EvaluationMode::HoldFirst, DispatchKind::Default, false, false, false, false, false, false, 2)},
         {"Refine", arity_range_semantics(EvaluationMode::HoldRest, DispatchKind::Default, false, false, false, false, false, false, 1, 2)},
+        {"SetAttributes", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"ClearAttributes", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"SetDelayed", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"Set", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"ParallelMap", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"ParallelTable", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"ParallelSum", exact_arity_semantics(EvaluationMode::HoldAll, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"RandomReal", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 0, 2)},
+        {"RandomInteger", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 0, 2)},
+        {"RandomVariate", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1, 2)},
+        {"SeedRandom", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 0, 1)},
+
+        {"Association", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 0, std::numeric_limits<size_t>::max())},
+        {"Lookup", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2, 3)},
+        {"KeyExistsQ", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"Keys", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Values", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Normal", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Append", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"KeyDrop", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+
+        {"Sort", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Ordering", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Union", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 0, std::numeric_limits<size_t>::max())},
+        {"DeleteDuplicates", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Tally", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"GatherBy", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"CountsBy", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+
+        {"FreeQ", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2)},
+        {"Variables", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"LeafCount", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
+        {"Depth", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
 
         {"Expand", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
         {"Factor", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 1)},
@@ -72,6 +105,10 @@ const std::unordered_map<std::string, FunctionSemantics>& function_semantics_reg
         {"GCD", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2, 3)},
         {"PolynomialQuotient", arity_range_semantics(EvaluationMode::Eager, DispatchKind::Default, false, false, false, false, false, false, 2, 3)},
 
+        {"PowerMod", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, false, false, false, 3)},
+        {"PrimeQ", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, false, false, false, 1)},
+        {"FactorInteger", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, false, false, false, 1)},
+
         {"Sin", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, true, false, false, 1)},
         {"Cos", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, true, false, false, 1)},
         {"Tan", exact_arity_semantics(EvaluationMode::Eager, DispatchKind::Default, false, true, false, true, false, false, 1)},
@@ -0,0 +1,398 @@
+#include "evaluator/BuiltInFunctions.hpp"
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+#include "kernel/Rewrite.hpp"
+#include "kernel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+namespace {
+
+// Shorter numeric lists are sorted by comparison; radix passes cost more
+// than they save there.
+constexpr std::size_t kRadixSortMinimum = 256;
+constexpr unsigned kRadixBits = 8;
+constexpr std::size_t kRadixBuckets = std::size_t{1} << kRadixBits;
+
+// Elements per chunk when a sort is split across threads.
+constexpr std::size_t kSortChunk = std::size_t{1} << 14;
+
+enum class PackedKind { mixed, numbers, strings };
+
+const std::vector<ExprPtr>& require_list(const ExprPtr& expr, const std::string& head, EvaluationContext& ctx) {
+    const std::vector<ExprPtr>* elements = nullptr;
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        elements = &list->elements;
+    } else if (const auto* call = std::get_if<FunctionCall>(&*expr); call != nullptr && call->head == "List") {
+        elements = &call->args;
+    } else {
+        throw_invalid_form(head + " expects a list argument");
+    }
+    ctx.check_list_length(elements->size());
+    return *elements;
+}
+
+// Lists made only of machine numbers or only of strings take the fast paths.
+PackedKind packed_kind(const std::vector<ExprPtr>& elements) {
+    if (elements.empty()) {
+        return PackedKind::mixed;
+    }
+    if (std::all_of(elements.begin(), elements.end(), [](const ExprPtr& e) { return std::holds_alternative<Number>(*e); })) {
+        return PackedKind::numbers;
+    }
+    if (std::all_of(elements.begin(), elements.end(), [](const ExprPtr& e) { return std::holds_alternative<String>(*e); })) {
+        return PackedKind::strings;
+    }
+    return PackedKind::mixed;
+}
+
+double number_of(const ExprPtr& expr) {
+    return std::get<Number>(*expr).value;
+}
+
+const std::string& string_of(const ExprPtr& expr) {
+    return std::get<String>(*expr).value.str();
+}
+
+// Unsigned keys in the canonical order of the numbers: -0 joins 0 and every
+// NaN sorts last, as in kernel::canonical_compare.
+std::uint64_t radix_key(double value) {
+    if (std::isnan(value)) {
+        return ~std::uint64_t{0};
+    }
+    const auto bits = std::bit_cast<std::uint64_t>(value == 0.0 ? 0.0 : value);
+    return (bits >> 63) != 0 ? ~bits : bits | (std::uint64_t{1} << 63);
+}
+
+// Stable LSD radix sort over the keys; passes whose digit is the same for
+// every key are skipped, so small integers take only a few.
+std::vector<std::size_t> radix_sort_order(const std::vector<std::uint64_t>& keys) {
+    struct Item {
+        std::uint64_t key;
+        std::size_t index;
+    };
+    std::vector<Item> items(keys.size());
+    for (std::size_t index = 0; index < keys.size(); ++index) {
+        items[index] = {keys[index], index};
+    }
+    std::vector<Item> scratch(items.size());
+    for (unsigned shift = 0; shift < 64; shift += kRadixBits) {
+        std::array<std::size_t, kRadixBuckets> offsets{};
+        for (const auto& item : items) {
+            ++offsets[(item.key >> shift) & (kRadixBuckets - 1)];
+        }
+        if (std::find(offsets.begin(), offsets.end(), items.size()) != offsets.end()) {
+            continue;
+        }
+        std::size_t next = 0;
+        for (auto& offset : offsets) {
+            next += std::exchange(offset, next);
+        }
+        for (const auto& item : items) {
+            scratch[offsets[(item.key >> shift) & (kRadixBuckets - 1)]++] = item;
+        }
+        items.swap(scratch);
+    }
+    std::vector<std::size_t> order(items.size());
+    for (std::size_t position = 0; position < items.size(); ++position) {
+        order[position] = items[position].index;
+    }
+    return order;
+}
+
+// Stable sort of positions. Long inputs are sorted in chunks on up to
+// thread_count threads and merged pairwise; both steps are stable, so the
+// result does not depend on the split.
+template <typename Less>
+std::vector<std::size_t> stable_sort_order(std::size_t count, const Less& less, std::size_t thread_count) {
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    const std::size_t chunk_count = (count + kSortChunk - 1) / kSortChunk;
+    if (chunk_count <= 1 || thread_count == 1) {
+        std::stable_sort(order.begin(), order.end(), less);
+        return order;
+    }
+    const auto at = [&](std::size_t position) {
+        return order.begin() + static_cast<std::ptrdiff_t>(std::min(position, count));
+    };
+    kernel::run_work_stealing(chunk_count, thread_count, [&](std::size_t chunk) {
+        std::stable_sort(at(chunk * kSortChunk), at((chunk + 1) * kSortChunk), less);
+    });
+    for (std::size_t width = kSortChunk; width < count; width *= 2) {
+        const std::size_t pair_count = (count + 2 * width - 1) / (2 * width);
+        kernel::run_work_stealing(pair_count, thread_count, [&](std::size_t pair) {
+            const std::size_t begin = pair * 2 * width;
+            std::inplace_merge(at(begin), at(begin + width), at(begin + 2 * width), less);
+        });
+    }
+    return order;
+}
+
+// Positions of the elements in canonical order; equal elements keep their
+// relative order.
+std::vector<std::size_t> canonical_sort_order(const std::vector<ExprPtr>& elements, const EvaluationContext& ctx) {
+    switch (packed_kind(elements)) {
+        case PackedKind::numbers: {
+            std::vector<std::uint64_t> keys(elements.size());
+            for (std::size_t index = 0; index < elements.size(); ++index) {
+                keys[index] = radix_key(number_of(elements[index]));
+            }
+            if (keys.size() >= kRadixSortMinimum) {
+                return radix_sort_order(keys);
+            }
+            return stable_sort_order(
+                keys.size(), [&](std::size_t left, std::size_t right) { return keys[left] < keys[right]; }, 1);
+        }
+        case PackedKind::strings: {
+            // Sorting positions over plain strings touches no reference
+            // counts, so it may run on several threads in any build.
+            std::vector<const std::string*> strings(elements.size());
+            for (std::size_t index = 0; index < elements.size(); ++index) {
+                strings[index] = &string_of(elements[index]);
+            }
+            const auto thread_count = ctx.is_parallel_worker() ? 1 : ctx.parallel_thread_count();
+            return stable_sort_order(
+                strings.size(),
+                [&](std::size_t left, std::size_t right) { return *strings[left] < *strings[right]; },
+                thread_count);
+        }
+        case PackedKind::mixed:
+            break;
+    }
+    return stable_sort_order(
+        elements.size(),
+        [&](std::size_t left, std::size_t right) {
+            return kernel::canonical_compare(elements[left], elements[right]) < 0;
+        },
+        1);
+}
+
+// Classes of structurally equal items, numbered in order of first appearance.
+struct DistinctGroups {
+    std::vector<std::size_t> group_of;
+    std::vector<std::size_t> first_index;
+};
+
+DistinctGroups group_distinct(const std::vector<ExprPtr>& items) {
+    DistinctGroups groups;
+    groups.group_of.reserve(items.size());
+    auto assign = [&](auto& index, auto&& key, std::size_t position) {
+        const auto [it, inserted] = index.try_emplace(std::forward<decltype(key)>(key), groups.first_index.size());
+        if (inserted) {
+            groups.first_index.push_back(position);
+        }
+        groups.group_of.push_back(it->second);
+    };
+
+    switch (packed_kind(items)) {
+        case PackedKind::numbers: {
+            std::unordered_map<std::uint64_t, std::size_t> index;
+            index.reserve(items.size());
+            for (std::size_t position = 0; position < items.size(); ++position) {
+                const double value = number_of(items[position]);
+                if (std::isnan(value)) {
+                    // NaN is not structurally equal to anything.
+                    groups.group_of.push_back(groups.first_index.size());
+                    groups.first_index.push_back(position);
+                    continue;
+                }
+                assign(index, radix_key(value), position);
+            }
+            return groups;
+        }
+        case PackedKind::strings: {
+            std::unordered_map<std::string_view, std::size_t> index;
+            index.reserve(items.size());
+            for (std::size_t position = 0; position < items.size(); ++position) {
+                assign(index, std::string_view(string_of(items[position])), position);
+            }
+            return groups;
+        }
+        case PackedKind::mixed:
+            break;
+    }
+    std::unordered_map<ExprPtr, std::size_t, kernel::StructuralExprHash, kernel::StructuralExprEqual> index;
+    index.reserve(items.size());
+    for (std::size_t position = 0; position < items.size(); ++position) {
+        assign(index, items[position], position);
+    }
+    return groups;
+}
+
+// f[element] for each element; f must name a function, as in ParallelMap.
+std::vector<ExprPtr> apply_to_each(
+    const std::string& head,
+    const ExprPtr& function,
+    const std::vector<ExprPtr>& elements,
+    EvaluationContext& ctx) {
+    const auto* name = std::get_if<Symbol>(&*function);
+    if (name == nullptr) {
+        throw_invalid_form(head + " expects a function name as its second argument");
+    }
+    std::vector<ExprPtr> results;
+    results.reserve(elements.size());
+    for (const auto& element : elements) {
+        results.push_back(evaluate(make_expr<FunctionCall>(name->name, std::vector<ExprPtr>{element}), ctx));
+    }
+    return results;
+}
+
+std::vector<ExprPtr> evaluate_arguments(const FunctionCall& func, EvaluationContext& ctx) {
+    std::vector<ExprPtr> args;
+    args.reserve(func.args.size());
+    for (const auto& arg : func.args) {
+        args.push_back(evaluate(arg, ctx));
+    }
+    return args;
+}
+
+}  // namespace
+
+void register_list_set_builtins(kernel::FunctionRegistry& registry) {
+    registry.register_function(
+        "Sort",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Sort", 1);
+            }
+            const auto list = evaluate(func.args[0], ctx);
+            const auto& elements = require_list(list, "Sort", ctx);
+            std::vector<ExprPtr> sorted;
+            sorted.reserve(elements.size());
+            for (const auto position : canonical_sort_order(elements, ctx)) {
+                sorted.push_back(elements[position]);
+            }
+            return make_expr<List>(std::move(sorted));
+        });
+
+    registry.register_function(
+        "Ordering",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Ordering", 1);
+            }
+            const auto list = evaluate(func.args[0], ctx);
+            const auto& elements = require_list(list, "Ordering", ctx);
+            std::vector<ExprPtr> positions;
+            positions.reserve(elements.size());
+            for (const auto position : canonical_sort_order(elements, ctx)) {
+                positions.push_back(make_expr<Number>(static_cast<double>(position + 1)));
+            }
+            return make_expr<List>(std::move(positions));
+        });
+
+    registry.register_function(
+        "Union",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            const auto args = evaluate_arguments(func, ctx);
+            std::vector<ExprPtr> joined;
+            for (const auto& arg : args) {
+                const auto& elements = require_list(arg, "Union", ctx);
+                joined.insert(joined.end(), elements.begin(), elements.end());
+            }
+            ctx.check_list_length(joined.size());
+            std::vector<ExprPtr> distinct;
+            for (const auto position : canonical_sort_order(joined, ctx)) {
+                if (distinct.empty() || !kernel::structurally_equal(distinct.back(), joined[position])) {
+                    distinct.push_back(joined[position]);
+                }
+            }
+            return make_expr<List>(std::move(distinct));
+        });
+
+    registry.register_function(
+        "DeleteDuplicates",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("DeleteDuplicates", 1);
+            }
+            const auto list = evaluate(func.args[0], ctx);
+            const auto& elements = require_list(list, "DeleteDuplicates", ctx);
+            std::vector<ExprPtr> distinct;
+            for (const auto position : group_distinct(elements).first_index) {
+                distinct.push_back(elements[position]);
+            }
+            return make_expr<List>(std::move(distinct));
+        });
+
+    registry.register_function(
+        "Tally",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 1) {
+                throw_invalid_arity_exact("Tally", 1);
+            }
+            const auto list = evaluate(func.args[0], ctx);
+            const auto& elements = require_list(list, "Tally", ctx);
+            const auto groups = group_distinct(elements);
+            std::vector<std::size_t> counts(groups.first_index.size());
+            for (const auto group : groups.group_of) {
+                ++counts[group];
+            }
+            std::vector<ExprPtr> tally;
+            tally.reserve(counts.size());
+            for (std::size_t group = 0; group < counts.size(); ++group) {
+                tally.push_back(make_expr<List>(std::vector<ExprPtr>{
+                    elements[groups.first_index[group]], make_expr<Number>(static_cast<double>(counts[group]))}));
+            }
+            return make_expr<List>(std::move(tally));
+        });
+
+    registry.register_function(
+        "GatherBy",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("GatherBy", 2);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            const auto& elements = require_list(args[0], "GatherBy", ctx);
+            const auto groups = group_distinct(apply_to_each("GatherBy", args[1], elements, ctx));
+            std::vector<std::vector<ExprPtr>> gathered(groups.first_index.size());
+            for (std::size_t position = 0; position < elements.size(); ++position) {
+                gathered[groups.group_of[position]].push_back(elements[position]);
+            }
+            std::vector<ExprPtr> result;
+            result.reserve(gathered.size());
+            for (auto& group : gathered) {
+                result.push_back(make_expr<List>(std::move(group)));
+            }
+            return make_expr<List>(std::move(result));
+        });
+
+    registry.register_function(
+        "CountsBy",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("CountsBy", 2);
+            }
+            const auto args = evaluate_arguments(func, ctx);
+            const auto& elements = require_list(args[0], "CountsBy", ctx);
+            const auto keys = apply_to_each("CountsBy", args[1], elements, ctx);
+            const auto groups = group_distinct(keys);
+            std::vector<std::size_t> counts(groups.first_index.size());
+            for (const auto group : groups.group_of) {
+                ++counts[group];
+            }
+            std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+            entries.reserve(counts.size());
+            for (std::size_t group = 0; group < counts.size(); ++group) {
+                entries.emplace_back(keys[groups.first_index[group]], make_expr<Number>(static_cast<double>(counts[group])));
+            }
+            return make_expr<Association>(AssociationMap::from_entries(entries));
+        });
+}
+
+}  // namespace aleph3
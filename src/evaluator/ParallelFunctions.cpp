@@ -0,0 +1,207 @@
+#include "evaluator/BuiltInFunctions.hpp"
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+#include "kernel/WorkStealingPool.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+namespace {
+
+// Per-item outcome. Every item runs in its own forked context, so the value,
+// the steps it took, and the error it raised depend only on the item and on
+// the context at the time of the call, never on the thread that ran it. The
+// one exception is a call that runs out of steps: which items get cut short
+// then depends on timing, but the call fails either way.
+struct ParallelItemResult {
+    ExprPtr value;
+    std::size_t steps = 0;
+    std::exception_ptr error;
+};
+
+template <typename ItemEvaluator>
+std::vector<ExprPtr> evaluate_items_in_parallel(
+    std::size_t item_count,
+    EvaluationContext& ctx,
+    const ItemEvaluator& evaluate_item) {
+    std::vector<ParallelItemResult> results(item_count);
+    // Workers only read ctx, and nested Parallel* calls run on the thread
+    // that reached them rather than spawning pools of their own. Without
+    // atomic reference counts, expression trees must stay on one thread.
+    const auto thread_count =
+        ctx.is_parallel_worker() || !expr_refcount_is_atomic ? 1 : ctx.parallel_thread_count();
+    // Settle the seed up front so forks copy it instead of each drawing one.
+    static_cast<void>(ctx.random_seed());
+    // Every worker charges this counter, so a call over budget stops all its
+    // items instead of letting each run up to the whole remaining budget.
+    const auto shared_steps = ctx.parallel_step_counter();
+    kernel::run_work_stealing(item_count, thread_count, [&](std::size_t index) {
+        auto worker = ctx.fork_parallel_worker(index, shared_steps);
+        auto& result = results[index];
+        try {
+            result.value = evaluate_item(index, worker);
+        } catch (...) {
+            result.error = std::current_exception();
+        }
+        result.steps = worker.evaluation_steps_used();
+    });
+
+    ctx.advance_random_stream();
+
+    // Merge in index order so the reported failure is the one a sequential
+    // loop would hit first, whichever thread finished first.
+    std::vector<ExprPtr> values;
+    values.reserve(item_count);
+    for (auto& result : results) {
+        ctx.charge_evaluation_steps(result.steps);
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+        values.push_back(std::move(result.value));
+    }
+    return values;
+}
+
+struct ParallelIterator {
+    std::string variable;
+    double start = 0.0;
+    double step = 1.0;
+    std::size_t count = 0;
+
+    [[nodiscard]] double value_at(std::size_t index) const {
+        return start + static_cast<double>(index) * step;
+    }
+};
+
+double require_iterator_bound(const std::string& head, const ExprPtr& bound, EvaluationContext& ctx) {
+    auto value = evaluate(bound, ctx);
+    const auto* number = std::get_if<Number>(&*value);
+    if (number == nullptr || !std::isfinite(number->value)) {
+        throw_invalid_form(head + " iterator bounds must evaluate to finite numbers");
+    }
+    return number->value;
+}
+
+// {i, max}, {i, min, max} or {i, min, max, step}, as in Table.
+ParallelIterator parse_parallel_iterator(const std::string& head, const ExprPtr& spec, EvaluationContext& ctx) {
+    const std::vector<ExprPtr>* parts = nullptr;
+    if (const auto* list = std::get_if<List>(&*spec)) {
+        parts = &list->elements;
+    } else if (const auto* call = std::get_if<FunctionCall>(&*spec); call != nullptr && call->head == "List") {
+        parts = &call->args;
+    }
+    if (parts == nullptr || parts->size() < 2 || parts->size() > 4) {
+        throw_invalid_form(head + " expects an iterator of the form {i, max}, {i, min, max} or {i, min, max, step}");
+    }
+    const auto* variable = std::get_if<Symbol>(&*parts->front());
+    if (variable == nullptr) {
+        throw_invalid_form(head + " iterator variable must be a symbol");
+    }
+
+    ParallelIterator iterator;
+    iterator.variable = variable->name;
+    double max = 0.0;
+    if (parts->size() == 2) {
+        iterator.start = 1.0;
+        max = require_iterator_bound(head, (*parts)[1], ctx);
+    } else {
+        iterator.start = require_iterator_bound(head, (*parts)[1], ctx);
+        max = require_iterator_bound(head, (*parts)[2], ctx);
+    }
+    if (parts->size() == 4) {
+        iterator.step = require_iterator_bound(head, (*parts)[3], ctx);
+        if (iterator.step == 0.0) {
+            throw_domain_violation(head + " iterator step must be nonzero");
+        }
+    }
+
+    const auto span = std::floor((max - iterator.start) / iterator.step + 1e-12);
+    iterator.count = span < 0.0 ? 0 : static_cast<std::size_t>(span) + 1;
+    return iterator;
+}
+
+std::vector<ExprPtr> evaluate_over_iterator(
+    const std::string& head,
+    const FunctionCall& func,
+    EvaluationContext& ctx) {
+    if (func.args.size() != 2) {
+        throw_invalid_arity_exact(head, 2);
+    }
+    const auto iterator = parse_parallel_iterator(head, func.args[1], ctx);
+    const auto& body = func.args[0];
+    return evaluate_items_in_parallel(iterator.count, ctx, [&](std::size_t index, EvaluationContext& worker) {
+        worker.symbol_values.set(iterator.variable, make_expr<Number>(iterator.value_at(index)));
+        return evaluate(body, worker);
+    });
+}
+
+}  // namespace
+
+void register_parallel_builtins(kernel::FunctionRegistry& registry) {
+    registry.register_function(
+        "ParallelMap",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("ParallelMap", 2);
+            }
+            auto function = evaluate(func.args[0], ctx);
+            const auto* head = std::get_if<Symbol>(&*function);
+            if (head == nullptr) {
+                throw_invalid_form("ParallelMap expects a function name as its first argument");
+            }
+            auto list = evaluate(func.args[1], ctx);
+            const auto* elements = std::get_if<List>(&*list);
+            if (elements == nullptr) {
+                throw_invalid_form("ParallelMap expects a list as its second argument");
+            }
+
+            return make_expr<List>(evaluate_items_in_parallel(
+                elements->elements.size(),
+                ctx,
+                [&](std::size_t index, EvaluationContext& worker) {
+                    return evaluate(
+                        make_expr<FunctionCall>(head->name, std::vector<ExprPtr>{elements->elements[index]}),
+                        worker);
+                }));
+        });
+
+    registry.register_function(
+        "ParallelTable",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            return make_expr<List>(evaluate_over_iterator("ParallelTable", func, ctx));
+        },
+        {symbols::SymbolAttribute::hold_all});
+
+    registry.register_function(
+        "ParallelSum",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            auto terms = evaluate_over_iterator("ParallelSum", func, ctx);
+
+            // Terms are added in index order either way, so floating-point
+            // rounding does not depend on the thread count.
+            double total = 0.0;
+            bool numeric = true;
+            for (const auto& term : terms) {
+                const auto* number = std::get_if<Number>(&*term);
+                if (number == nullptr) {
+                    numeric = false;
+                    break;
+                }
+                total += number->value;
+            }
+            if (numeric) {
+                return make_expr<Number>(total);
+            }
+            return evaluate(make_expr<FunctionCall>("Plus", std::move(terms)), ctx);
+        },
+        {symbols::SymbolAttribute::hold_all});
+}
+
+}  // namespace aleph3
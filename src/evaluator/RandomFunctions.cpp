@@ -0,0 +1,300 @@
+#include "evaluator/BuiltInFunctions.hpp"
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+#include "kernel/CounterRandom.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+namespace {
+
+// Most values one call may generate.
+constexpr std::size_t kMaxRandomValues = std::size_t{1} << 27;
+
+const std::vector<ExprPtr>* list_parts(const ExprPtr& expr) {
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        return &list->elements;
+    }
+    if (const auto* call = std::get_if<FunctionCall>(&*expr); call != nullptr && call->head == "List") {
+        return &call->args;
+    }
+    return nullptr;
+}
+
+std::optional<double> finite_number(const ExprPtr& expr) {
+    const auto* number = std::get_if<Number>(&*expr);
+    if (number == nullptr || !std::isfinite(number->value)) {
+        return std::nullopt;
+    }
+    return number->value;
+}
+
+std::optional<double> integer_number(const ExprPtr& expr) {
+    const auto value = finite_number(expr);
+    if (!value || std::floor(*value) != *value || std::fabs(*value) > 0x1.0p53) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// An integral bound of any size; checked_distribution rejects those beyond
+// what discrete_uniform can draw exactly, rather than leaving them unevaluated.
+std::optional<double> integral_bound(const ExprPtr& expr) {
+    const auto value = finite_number(expr);
+    if (!value || std::floor(*value) != *value) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// n or {n1, n2, ...}; an empty shape means a single scalar.
+std::vector<std::size_t> parse_random_shape(const std::string& head, const ExprPtr& spec) {
+    std::vector<ExprPtr> dims_exprs;
+    if (const auto* parts = list_parts(spec)) {
+        dims_exprs = *parts;
+    } else {
+        dims_exprs.push_back(spec);
+    }
+    if (dims_exprs.empty()) {
+        throw_invalid_form(head + " expects a count n or dimensions {n1, n2, ...}");
+    }
+
+    std::vector<std::size_t> dims;
+    std::size_t total = 1;
+    for (const auto& dim_expr : dims_exprs) {
+        const auto dim = integer_number(dim_expr);
+        if (!dim || *dim < 0.0) {
+            throw_invalid_form(head + " expects a count n or dimensions {n1, n2, ...} of non-negative integers");
+        }
+        const auto extent = static_cast<std::size_t>(*dim);
+        if (extent != 0 && total > kMaxRandomValues / extent) {
+            throw_domain_violation(head + " cannot generate that many values");
+        }
+        total *= extent;
+        dims.push_back(extent);
+    }
+    return dims;
+}
+
+// Nests a flat, row-major run of values into lists of the given dimensions.
+ExprPtr shape_values(const std::vector<double>& values, std::span<const std::size_t> dims, std::size_t& next) {
+    std::vector<ExprPtr> elements;
+    elements.reserve(dims.front());
+    for (std::size_t i = 0; i < dims.front(); ++i) {
+        if (dims.size() == 1) {
+            elements.push_back(make_expr<Number>(values[next++]));
+        } else {
+            elements.push_back(shape_values(values, dims.subspan(1), next));
+        }
+    }
+    return make_expr<List>(std::move(elements));
+}
+
+// Fills one buffer for the whole call from the context's next stream, then
+// builds the result. Large fills are split across the context's threads;
+// draws are addressed by index, so the values do not depend on the split.
+ExprPtr draw_random_values(const std::vector<std::size_t>& dims, const Distribution& distribution, EvaluationContext& ctx) {
+    std::size_t total = 1;
+    for (const auto extent : dims) {
+        total *= extent;
+    }
+    const auto stream = ctx.next_random_stream();
+    const auto thread_count = ctx.is_parallel_worker() ? 1 : ctx.parallel_thread_count();
+    std::vector<double> values(total);
+    kernel::fill_distribution(stream, distribution, values, 0, thread_count);
+    if (dims.empty()) {
+        return make_expr<Number>(values.front());
+    }
+    std::size_t next = 0;
+    return shape_values(values, dims, next);
+}
+
+struct RandomCallArguments {
+    std::vector<ExprPtr> args;
+    std::vector<std::size_t> dims;
+};
+
+RandomCallArguments evaluate_random_arguments(
+    const std::string& head,
+    const FunctionCall& func,
+    std::size_t max_arity,
+    EvaluationContext& ctx) {
+    if (func.args.size() > max_arity) {
+        throw_invalid_arity_at_most(head, max_arity, func.args.size());
+    }
+    RandomCallArguments call;
+    for (const auto& arg : func.args) {
+        call.args.push_back(evaluate(arg, ctx));
+    }
+    if (call.args.size() == max_arity) {
+        call.dims = parse_random_shape(head, call.args.back());
+    }
+    return call;
+}
+
+// max or {min, max}; nullopt when a bound is not a number yet.
+std::optional<std::pair<double, double>> parse_random_range(const ExprPtr& spec, double default_min, bool integral) {
+    const auto bound = integral ? integral_bound : finite_number;
+    if (const auto* parts = list_parts(spec)) {
+        if (parts->size() != 2) {
+            return std::nullopt;
+        }
+        const auto low = bound((*parts)[0]);
+        const auto high = bound((*parts)[1]);
+        if (!low || !high) {
+            return std::nullopt;
+        }
+        return std::pair{*low, *high};
+    }
+    const auto high = bound(spec);
+    if (!high) {
+        return std::nullopt;
+    }
+    return std::pair{default_min, *high};
+}
+
+// Throws for a distribution whose parameters are numbers but out of range.
+Distribution checked_distribution(const std::string& head, Distribution distribution) {
+    if (const char* reason = kernel::invalid_distribution_reason(distribution)) {
+        throw_domain_violation(head + " " + reason);
+    }
+    return distribution;
+}
+
+// Reads a supported distribution with numeric parameters; nullopt leaves the
+// call unevaluated.
+std::optional<Distribution> parse_distribution(const ExprPtr& expr) {
+    const auto* call = std::get_if<FunctionCall>(&*expr);
+    if (call == nullptr) {
+        return std::nullopt;
+    }
+    const auto& head = call->head;
+    const auto& args = call->args;
+
+    if (head == "UniformDistribution" || head == "DiscreteUniformDistribution") {
+        const bool integral = head == "DiscreteUniformDistribution";
+        if (args.empty() && !integral) {
+            return Distribution::uniform();
+        }
+        if (args.size() != 1 || list_parts(args[0]) == nullptr) {
+            return std::nullopt;
+        }
+        const auto range = parse_random_range(args[0], 0.0, integral);
+        if (!range) {
+            return std::nullopt;
+        }
+        return checked_distribution(
+            head,
+            integral ? Distribution::discrete_uniform(range->first, range->second)
+                     : Distribution::uniform(range->first, range->second));
+    }
+
+    if (head == "NormalDistribution" || head == "LogNormalDistribution") {
+        const bool normal = head == "NormalDistribution";
+        if (args.empty() && normal) {
+            return Distribution::normal();
+        }
+        if (args.size() != 2) {
+            return std::nullopt;
+        }
+        const auto mean = finite_number(args[0]);
+        const auto deviation = finite_number(args[1]);
+        if (!mean || !deviation) {
+            return std::nullopt;
+        }
+        return checked_distribution(
+            head, normal ? Distribution::normal(*mean, *deviation) : Distribution::log_normal(*mean, *deviation));
+    }
+
+    if (head == "ExponentialDistribution") {
+        if (args.size() != 1) {
+            return std::nullopt;
+        }
+        const auto rate = finite_number(args[0]);
+        if (!rate) {
+            return std::nullopt;
+        }
+        return checked_distribution(head, Distribution::exponential(*rate));
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace
+
+void register_random_builtins(kernel::FunctionRegistry& registry) {
+    registry.register_function(
+        "RandomReal",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            auto call = evaluate_random_arguments("RandomReal", func, 2, ctx);
+            std::pair<double, double> range{0.0, 1.0};
+            if (!call.args.empty()) {
+                const auto parsed = parse_random_range(call.args[0], 0.0, false);
+                if (!parsed) {
+                    return make_expr<FunctionCall>("RandomReal", std::move(call.args));
+                }
+                range = *parsed;
+            }
+            return draw_random_values(
+                call.dims, checked_distribution("RandomReal", Distribution::uniform(range.first, range.second)), ctx);
+        });
+
+    registry.register_function(
+        "RandomInteger",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            auto call = evaluate_random_arguments("RandomInteger", func, 2, ctx);
+            std::pair<double, double> range{0.0, 1.0};
+            if (!call.args.empty()) {
+                const auto parsed = parse_random_range(call.args[0], 0.0, true);
+                if (!parsed) {
+                    return make_expr<FunctionCall>("RandomInteger", std::move(call.args));
+                }
+                range = *parsed;
+            }
+            return draw_random_values(
+                call.dims, checked_distribution("RandomInteger", Distribution::discrete_uniform(range.first, range.second)), ctx);
+        });
+
+    registry.register_function(
+        "RandomVariate",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.empty()) {
+                throw_invalid_arity_between("RandomVariate", 1, 2);
+            }
+            auto call = evaluate_random_arguments("RandomVariate", func, 2, ctx);
+            const auto distribution = parse_distribution(call.args[0]);
+            if (!distribution) {
+                return make_expr<FunctionCall>("RandomVariate", std::move(call.args));
+            }
+            return draw_random_values(call.dims, *distribution, ctx);
+        });
+
+    registry.register_function(
+        "SeedRandom",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() > 1) {
+                throw_invalid_arity_at_most("SeedRandom", 1, func.args.size());
+            }
+            if (func.args.empty()) {
+                ctx.seed_random(kernel::entropy_random_seed());
+                return make_expr<Symbol>("Null");
+            }
+            const auto seed = integer_number(evaluate(func.args[0], ctx));
+            if (!seed) {
+                throw_invalid_form("SeedRandom expects an integer seed");
+            }
+            ctx.seed_random(static_cast<std::uint64_t>(static_cast<std::int64_t>(*seed)));
+            return make_expr<Symbol>("Null");
+        });
+}
+
+}  // namespace aleph3
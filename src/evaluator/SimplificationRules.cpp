@@ -117,7 +117,7 @@ namespace aleph3 {
             for (size_t i = 0; i < l1.size(); ++i) {
                 result.push_back(eval(make_fcall("Plus", { l1[i], l2[i] }), ctx));
             }
-            return std::make_shared<Expr>(List{ result });
+            return make_expr_node(List{ result });
         }
 
         // Scalar and list broadcasting (optional)
@@ -128,7 +128,7 @@ namespace aleph3 {
                 for (const auto& elem : l1) {
                     result.push_back(eval(make_fcall("Plus", { elem, flat_args[1] }), ctx));
                 }
-                return std::make_shared<Expr>(List{ result });
+                return make_expr_node(List{ result });
             }
             if (std::holds_alternative<Number>(*flat_args[0]) && std::holds_alternative<List>(*flat_args[1])) {
                 const auto& l2 = std::get<List>(*flat_args[1]).elements;
@@ -136,7 +136,7 @@ namespace aleph3 {
                 for (const auto& elem : l2) {
                     result.push_back(eval(make_fcall("Plus", { flat_args[0], elem }), ctx));
                 }
-                return std::make_shared<Expr>(List{ result });
+                return make_expr_node(List{ result });
             }
         }
 
@@ -207,7 +207,7 @@ namespace aleph3 {
             for (size_t i = 0; i < l1.size(); ++i) {
                 result.push_back(eval(make_fcall("Times", { l1[i], l2[i] }), ctx));
             }
-            return std::make_shared<Expr>(List{ result });
+            return make_expr_node(List{ result });
         }
 
         // Scalar and list broadcasting
@@ -218,7 +218,7 @@ namespace aleph3 {
                 for (const auto& elem : l1) {
                     result.push_back(eval(make_fcall("Times", { elem, flat_args[1] }), ctx));
                 }
-                return std::make_shared<Expr>(List{ result });
+                return make_expr_node(List{ result });
             }
             if (std::holds_alternative<Number>(*flat_args[0]) && std::holds_alternative<List>(*flat_args[1])) {
                 const auto& l2 = std::get<List>(*flat_args[1]).elements;
@@ -226,7 +226,7 @@ namespace aleph3 {
                 for (const auto& elem : l2) {
                     result.push_back(eval(make_fcall("Times", { flat_args[0], elem }), ctx));
                 }
-                return std::make_shared<Expr>(List{ result });
+                return make_expr_node(List{ result });
             }
         }
 
@@ -0,0 +1,218 @@
+#include "evaluator/BuiltInFunctions.hpp"
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+#include "expr/ExprSummary.hpp"
+#include "kernel/Rewrite.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace aleph3 {
+
+namespace {
+
+// The head of a compound expression as FullForm spells it; empty for atoms.
+std::string_view head_name(const Expr& expr) {
+    if (const auto* call = std::get_if<FunctionCall>(&expr)) {
+        return call->head;
+    }
+    if (std::holds_alternative<List>(expr)) {
+        return "List";
+    }
+    if (std::holds_alternative<Rule>(expr)) {
+        return "Rule";
+    }
+    if (std::holds_alternative<Association>(expr)) {
+        return "Association";
+    }
+    if (std::holds_alternative<Assignment>(expr)) {
+        return "Set";
+    }
+    if (std::holds_alternative<FunctionDefinition>(expr)) {
+        return "FunctionDefinition";
+    }
+    return {};
+}
+
+// Calls visit on each expression part of a compound, stopping at the first
+// that returns true.
+template <typename Visit>
+bool any_part(const Expr& expr, const Visit& visit) {
+    if (const auto* call = std::get_if<FunctionCall>(&expr)) {
+        return std::any_of(call->args.begin(), call->args.end(), visit);
+    }
+    if (const auto* list = std::get_if<List>(&expr)) {
+        return std::any_of(list->elements.begin(), list->elements.end(), visit);
+    }
+    if (const auto* rule = std::get_if<Rule>(&expr)) {
+        return visit(rule->lhs) || visit(rule->rhs);
+    }
+    if (const auto* assoc = std::get_if<Association>(&expr)) {
+        bool found = false;
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            found = found || visit(key) || visit(value);
+        });
+        return found;
+    }
+    if (const auto* assignment = std::get_if<Assignment>(&expr)) {
+        return visit(assignment->value);
+    }
+    if (const auto* definition = std::get_if<FunctionDefinition>(&expr)) {
+        for (const auto& param : definition->params) {
+            if (param.default_value && visit(param.default_value)) {
+                return true;
+            }
+        }
+        return visit(definition->body);
+    }
+    return false;
+}
+
+// Names every match of a form must contain. Pattern variables stand for
+// anything, so only the literal symbols and heads around them count.
+struct FormRequirement {
+    std::uint64_t symbols = 0;
+    std::uint64_t heads = 0;
+};
+
+void collect_pattern_requirement(const ExprPtr& form, FormRequirement& requirement) {
+    if (std::holds_alternative<Symbol>(*form)) {
+        if (!kernel::contains_pattern_variable(form)) {
+            requirement.symbols |= name_bloom_bit(std::get<Symbol>(*form).name);
+        }
+        return;
+    }
+    if (const auto* call = std::get_if<FunctionCall>(&*form)) {
+        requirement.heads |= name_bloom_bit(call->head);
+        for (const auto& arg : call->args) {
+            collect_pattern_requirement(arg, requirement);
+        }
+    } else if (const auto* list = std::get_if<List>(&*form)) {
+        requirement.heads |= name_bloom_bit("List");
+        for (const auto& element : list->elements) {
+            collect_pattern_requirement(element, requirement);
+        }
+    }
+}
+
+class FormSearch {
+public:
+    explicit FormSearch(const ExprPtr& form)
+        : form_(form), is_pattern_(kernel::contains_pattern_variable(form)) {
+        if (const auto* symbol = std::get_if<Symbol>(&*form); symbol != nullptr && !is_pattern_) {
+            symbol_name_ = symbol->name;
+        }
+        if (is_pattern_) {
+            collect_pattern_requirement(form, requirement_);
+        } else {
+            const auto summary = expr_summary(form);
+            requirement_ = {summary.symbols, summary.heads};
+        }
+    }
+
+    // True when the form matches expr, one of its parts, or, for a symbol
+    // form, one of its heads.
+    [[nodiscard]] bool occurs_in(const ExprPtr& expr) const {
+        const auto summary = expr_summary(expr);
+        if (!symbol_name_.empty()) {
+            if (!may_contain_name(summary, symbol_name_)) {
+                return false;
+            }
+            if (head_name(*expr) == symbol_name_) {
+                return true;
+            }
+        } else if ((summary.symbols & requirement_.symbols) != requirement_.symbols ||
+                   (summary.heads & requirement_.heads) != requirement_.heads) {
+            return false;
+        }
+        if (is_pattern_ ? kernel::matches_pattern(form_, expr) : kernel::structurally_equal(form_, expr)) {
+            return true;
+        }
+        return any_part(*expr, [this](const ExprPtr& part) { return occurs_in(part); });
+    }
+
+private:
+    ExprPtr form_;
+    bool is_pattern_;
+    std::string symbol_name_;
+    FormRequirement requirement_;
+};
+
+bool is_named_constant(const std::string& name) {
+    return name == "Pi" || name == "E" || name == "Degree";
+}
+
+void collect_variables(const ExprPtr& expr, std::vector<std::string>& names) {
+    if (!expr_summary(expr).has_symbols) {
+        return;
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        if (!is_named_constant(symbol->name)) {
+            names.push_back(symbol->name);
+        }
+        return;
+    }
+    any_part(*expr, [&](const ExprPtr& part) {
+        collect_variables(part, names);
+        return false;
+    });
+}
+
+ExprPtr evaluate_only_argument(const FunctionCall& func, const std::string& head, EvaluationContext& ctx) {
+    if (func.args.size() != 1) {
+        throw_invalid_arity_exact(head, 1);
+    }
+    return evaluate(func.args[0], ctx);
+}
+
+}  // namespace
+
+void register_structure_builtins(kernel::FunctionRegistry& registry) {
+    registry.register_function(
+        "FreeQ",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            if (func.args.size() != 2) {
+                throw_invalid_arity_exact("FreeQ", 2);
+            }
+            const auto expr = evaluate(func.args[0], ctx);
+            const auto form = evaluate(func.args[1], ctx);
+            return make_expr<Boolean>(!FormSearch(form).occurs_in(expr));
+        });
+
+    registry.register_function(
+        "Variables",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            const auto expr = evaluate_only_argument(func, "Variables", ctx);
+            std::vector<std::string> names;
+            collect_variables(expr, names);
+            std::sort(names.begin(), names.end());
+            names.erase(std::unique(names.begin(), names.end()), names.end());
+            std::vector<ExprPtr> symbols;
+            symbols.reserve(names.size());
+            for (auto& name : names) {
+                symbols.push_back(make_expr<Symbol>(std::move(name)));
+            }
+            return make_expr<List>(std::move(symbols));
+        });
+
+    registry.register_function(
+        "LeafCount",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            const auto expr = evaluate_only_argument(func, "LeafCount", ctx);
+            return make_expr<Number>(static_cast<double>(expr_summary(expr).leaf_count));
+        });
+
+    registry.register_function(
+        "Depth",
+        [](const FunctionCall& func, EvaluationContext& ctx) -> ExprPtr {
+            const auto expr = evaluate_only_argument(func, "Depth", ctx);
+            return make_expr<Number>(static_cast<double>(expr_summary(expr).depth));
+        });
+}
+
+}  // namespace aleph3
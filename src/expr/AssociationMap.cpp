@@ -0,0 +1,211 @@
+#include "expr/Expr.hpp"
+
+#include "kernel/Rewrite.hpp"
+
+#include <cmath>
+#include <cstdint>
+
+namespace aleph3 {
+
+namespace {
+
+// Overlays up to this long never trigger a compaction.
+constexpr std::size_t kMinOverlayEntries = 8;
+
+}  // namespace
+
+// Entries in insertion order plus an open-addressing index over them. A base
+// table holds only live entries. An overlay entry records one change to its
+// base: a null value erases the key, and `appended` places the entry after
+// the base entries instead of at the key's base position.
+class AssociationMap::Table {
+public:
+    struct Entry {
+        ExprPtr key;
+        ExprPtr value;
+        std::size_t hash = 0;
+        bool in_base = false;
+        bool appended = true;
+    };
+
+    std::vector<Entry> entries;
+
+    [[nodiscard]] std::ptrdiff_t find(const ExprPtr& key, std::size_t hash) const {
+        if (slots_.empty()) {
+            return -1;
+        }
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            const auto stored = slots_[slot];
+            if (stored == 0) {
+                return -1;
+            }
+            const auto& entry = entries[stored - 1];
+            if (entry.hash == hash && kernel::structurally_equal(entry.key, key)) {
+                return static_cast<std::ptrdiff_t>(stored - 1);
+            }
+        }
+    }
+
+    void append(Entry entry) {
+        entries.push_back(std::move(entry));
+        if (2 * entries.size() > slots_.size()) {
+            reindex();
+        } else {
+            place(entries.size() - 1);
+        }
+    }
+
+    void remove(std::size_t index) {
+        entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(index));
+        reindex();
+    }
+
+    // Rebuilds the index at a load factor of at most one half.
+    void reindex() {
+        std::size_t capacity = 8;
+        while (capacity < 2 * entries.size()) {
+            capacity *= 2;
+        }
+        slots_.assign(capacity, 0);
+        for (std::size_t index = 0; index < entries.size(); ++index) {
+            place(index);
+        }
+    }
+
+private:
+    void place(std::size_t index) {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t slot = entries[index].hash & mask;
+        while (slots_[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots_[slot] = static_cast<std::uint32_t>(index + 1);
+    }
+
+    // Entry index + 1; 0 marks an empty slot.
+    std::vector<std::uint32_t> slots_;
+};
+
+AssociationMap AssociationMap::from_entries(const std::vector<std::pair<ExprPtr, ExprPtr>>& entries) {
+    auto table = std::make_shared<Table>();
+    table->entries.reserve(entries.size());
+    for (const auto& [key, value] : entries) {
+        const auto hash = kernel::structural_hash(key);
+        if (const auto index = table->find(key, hash); index >= 0) {
+            table->entries[static_cast<std::size_t>(index)].value = value;
+        } else {
+            table->append({key, value, hash});
+        }
+    }
+    const auto size = table->entries.size();
+    return AssociationMap(std::move(table), nullptr, size);
+}
+
+const ExprPtr* AssociationMap::find(const ExprPtr& key) const {
+    const auto hash = kernel::structural_hash(key);
+    if (overlay_) {
+        if (const auto index = overlay_->find(key, hash); index >= 0) {
+            const auto& value = overlay_->entries[static_cast<std::size_t>(index)].value;
+            return value ? &value : nullptr;
+        }
+    }
+    if (base_) {
+        if (const auto index = base_->find(key, hash); index >= 0) {
+            return &base_->entries[static_cast<std::size_t>(index)].value;
+        }
+    }
+    return nullptr;
+}
+
+AssociationMap AssociationMap::insert(const ExprPtr& key, const ExprPtr& value) const {
+    const auto hash = kernel::structural_hash(key);
+    auto overlay = overlay_ ? std::make_shared<Table>(*overlay_) : std::make_shared<Table>();
+    std::size_t size = size_;
+
+    if (const auto index = overlay->find(key, hash); index >= 0) {
+        auto& entry = overlay->entries[static_cast<std::size_t>(index)];
+        if (entry.value) {
+            entry.value = value;
+        } else {
+            // Re-adding an erased base key places it last, like a new key.
+            overlay->remove(static_cast<std::size_t>(index));
+            overlay->append({key, value, hash, true, true});
+            ++size;
+        }
+    } else if (base_ && base_->find(key, hash) >= 0) {
+        overlay->append({key, value, hash, true, false});
+    } else {
+        overlay->append({key, value, hash, false, true});
+        ++size;
+    }
+
+    AssociationMap updated(base_, std::move(overlay), size);
+    const auto base_size = base_ ? base_->entries.size() : 0;
+    if (updated.overlay_->entries.size() > kMinOverlayEntries + static_cast<std::size_t>(std::sqrt(base_size))) {
+        return from_entries(updated.entries());
+    }
+    return updated;
+}
+
+AssociationMap AssociationMap::erase(const ExprPtr& key) const {
+    const auto hash = kernel::structural_hash(key);
+    if (overlay_) {
+        if (const auto index = overlay_->find(key, hash); index >= 0) {
+            const auto& entry = overlay_->entries[static_cast<std::size_t>(index)];
+            if (!entry.value) {
+                return *this;
+            }
+            auto overlay = std::make_shared<Table>(*overlay_);
+            if (entry.in_base) {
+                auto& erased = overlay->entries[static_cast<std::size_t>(index)];
+                erased.value = nullptr;
+                erased.appended = false;
+            } else {
+                overlay->remove(static_cast<std::size_t>(index));
+            }
+            return AssociationMap(base_, std::move(overlay), size_ - 1);
+        }
+    }
+    if (!base_ || base_->find(key, hash) < 0) {
+        return *this;
+    }
+    auto overlay = overlay_ ? std::make_shared<Table>(*overlay_) : std::make_shared<Table>();
+    overlay->append({key, nullptr, hash, true, false});
+    return AssociationMap(base_, std::move(overlay), size_ - 1);
+}
+
+void AssociationMap::for_each(const std::function<void(const ExprPtr& key, const ExprPtr& value)>& visit) const {
+    if (base_) {
+        for (const auto& entry : base_->entries) {
+            if (overlay_) {
+                if (const auto index = overlay_->find(entry.key, entry.hash); index >= 0) {
+                    const auto& change = overlay_->entries[static_cast<std::size_t>(index)];
+                    if (change.value && !change.appended) {
+                        visit(entry.key, change.value);
+                    }
+                    continue;
+                }
+            }
+            visit(entry.key, entry.value);
+        }
+    }
+    if (overlay_) {
+        for (const auto& entry : overlay_->entries) {
+            if (entry.value && entry.appended) {
+                visit(entry.key, entry.value);
+            }
+        }
+    }
+}
+
+std::vector<std::pair<ExprPtr, ExprPtr>> AssociationMap::entries() const {
+    std::vector<std::pair<ExprPtr, ExprPtr>> result;
+    result.reserve(size_);
+    for_each([&](const ExprPtr& key, const ExprPtr& value) {
+        result.emplace_back(key, value);
+    });
+    return result;
+}
+
+}  // namespace aleph3
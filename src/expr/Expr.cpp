@@ -4,8 +4,87 @@
 #include <iomanip>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 namespace aleph3 {
+
+namespace {
+
+// Node destructions one thread may nest before the parts of deeper nodes are
+// queued and released from the outermost destruction instead.
+constexpr std::size_t kMaxNestedDestroys = 256;
+
+thread_local std::size_t nested_destroys = 0;
+thread_local std::vector<ExprPtr>* deferred_parts = nullptr;
+
+bool is_atom(const Expr& expr) {
+    return !std::holds_alternative<FunctionCall>(expr) && !std::holds_alternative<List>(expr) &&
+        !std::holds_alternative<Rule>(expr) && !std::holds_alternative<Assignment>(expr) &&
+        !std::holds_alternative<FunctionDefinition>(expr) && !std::holds_alternative<Association>(expr);
+}
+
+// Moves a compound part to the deferred queue. If the queue cannot grow the
+// part stays put and is released recursively with its parent.
+void defer_part(ExprPtr& part) noexcept {
+    if (part == nullptr || is_atom(*part)) {
+        return;
+    }
+    try {
+        deferred_parts->push_back(std::move(part));
+    } catch (...) {
+    }
+}
+
+void defer_parts(Expr& expr) noexcept {
+    if (auto* call = std::get_if<FunctionCall>(&expr)) {
+        for (auto& arg : call->args) {
+            defer_part(arg);
+        }
+    } else if (auto* list = std::get_if<List>(&expr)) {
+        for (auto& element : list->elements) {
+            defer_part(element);
+        }
+    } else if (auto* rule = std::get_if<Rule>(&expr)) {
+        defer_part(rule->lhs);
+        defer_part(rule->rhs);
+    } else if (auto* assignment = std::get_if<Assignment>(&expr)) {
+        defer_part(assignment->value);
+    } else if (auto* definition = std::get_if<FunctionDefinition>(&expr)) {
+        for (auto& param : definition->params) {
+            defer_part(param.default_value);
+        }
+        defer_part(definition->body);
+    }
+    // Association entries live in shared tables and are released with them.
+}
+
+}  // namespace
+
+// Releases parts recursively up to kMaxNestedDestroys levels, then hands
+// deeper parts to a queue that the outermost call empties in a loop, so
+// arbitrarily deep trees are released in bounded stack.
+void destroy_expr_node(ExprNode* node) noexcept {
+    if (nested_destroys >= kMaxNestedDestroys) {
+        defer_parts(node->value);
+        delete node;
+        return;
+    }
+
+    ++nested_destroys;
+    if (deferred_parts != nullptr) {
+        delete node;
+    } else {
+        std::vector<ExprPtr> parts;
+        deferred_parts = &parts;
+        delete node;
+        while (!parts.empty()) {
+            auto part = std::move(parts.back());
+            parts.pop_back();
+        }
+        deferred_parts = nullptr;
+    }
+    --nested_destroys;
+}
     
     // Format numbers: show integers cleanly, floats with fixed precision
     inline std::string format_number(double value) {
@@ -128,7 +207,7 @@ namespace aleph3 {
             },
 
             [](const String& str) -> std::string { 
-                return "\"" + str.value + "\""; 
+                return "\"" + str.value.str() + "\""; 
             },
 
             [](const FunctionCall& f) -> std::string {
@@ -183,6 +262,12 @@ namespace aleph3 {
                 if (f.head == "Negate" && args.size() == 1) {
                     return "-" + to_string_with_parens(args[0], get_precedence("Negate"));
                 }
+                if (f.head == "SetDelayed" && args.size() == 2) {
+                    return to_string(args[0]) + " := " + to_string(args[1]);
+                }
+                if (f.head == "Set" && args.size() == 2) {
+                    return to_string(args[0]) + " = " + to_string(args[1]);
+                }
                 // Comparison operators
                 if (f.head == "Equal" && args.size() == 2) {
                     return to_string_with_parens(args[0], 0) + " == " + to_string_with_parens(args[1], 0);
@@ -257,6 +342,18 @@ namespace aleph3 {
                 return result;
             },
 
+            [](const Association& assoc) -> std::string {
+                std::string result = "<|";
+                bool first = true;
+                assoc.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    if (!first) result += ", ";
+                    first = false;
+                    result += to_string(key) + " -> " + to_string(value);
+                });
+                result += "|>";
+                return result;
+            },
+
             }, expr);
     }
 
@@ -283,7 +380,7 @@ namespace aleph3 {
                 return boolean.value ? "True" : "False";
             },
             [](const String& str) -> std::string {
-                return "\"" + str.value + "\"";
+                return "\"" + str.value.str() + "\"";
             },
             [](const FunctionCall& f) -> std::string {
                 // Comparison operators
@@ -353,6 +450,17 @@ namespace aleph3 {
                 }
                 result += "}";
                 return result;
+            },
+            [](const Association& assoc) -> std::string {
+                std::string result = "<|";
+                bool first = true;
+                assoc.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    if (!first) result += ",";
+                    first = false;
+                    result += to_string_raw(*key) + "->" + to_string_raw(*value);
+                });
+                result += "|>";
+                return result;
             }
             }, expr);
     }
@@ -0,0 +1,175 @@
+#include "expr/ExprSummary.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+
+namespace aleph3 {
+
+namespace {
+
+// Layout of SummaryCache::shape; kFilled keeps a filled word nonzero.
+constexpr std::uint64_t kLeafCountMask = 0xFFFFFFFFULL;
+constexpr unsigned kDepthShift = 32;
+constexpr std::uint64_t kDepthMask = 0xFFFFFFULL;
+constexpr std::uint64_t kHasSymbols = 1ULL << 56;
+constexpr std::uint64_t kHasNonNumericLeaf = 1ULL << 57;
+constexpr std::uint64_t kHasFractionalNumber = 1ULL << 58;
+constexpr std::uint64_t kFilled = 1ULL << 63;
+
+ExprSummary atom_summary() {
+    return ExprSummary{};
+}
+
+ExprSummary non_numeric_atom_summary() {
+    ExprSummary summary;
+    summary.has_non_numeric_leaf = true;
+    return summary;
+}
+
+ExprSummary symbol_summary(std::string_view name) {
+    ExprSummary summary;
+    summary.symbols = name_bloom_bit(name);
+    summary.has_symbols = true;
+    summary.has_non_numeric_leaf = true;
+    return summary;
+}
+
+// A compound whose head is the atom `head` and whose parts are added with
+// add_part.
+ExprSummary compound_summary(std::string_view head) {
+    ExprSummary summary;
+    summary.heads = name_bloom_bit(head);
+    return summary;
+}
+
+void add_part(ExprSummary& summary, const ExprSummary& part) {
+    summary.symbols |= part.symbols;
+    summary.heads |= part.heads;
+    summary.leaf_count = std::min(summary.leaf_count + part.leaf_count, kLeafCountMask);
+    summary.depth = std::max(summary.depth, std::min(part.depth + 1, kDepthMask));
+    summary.has_symbols = summary.has_symbols || part.has_symbols;
+    summary.has_non_numeric_leaf = summary.has_non_numeric_leaf || part.has_non_numeric_leaf;
+    summary.has_fractional_number = summary.has_fractional_number || part.has_fractional_number;
+}
+
+// A leaf in a compound's FullForm that is a name, e.g. the x of Set[x, 1].
+void add_name_part(ExprSummary& summary, std::string_view name) {
+    add_part(summary, symbol_summary(name));
+}
+
+void add_parts(ExprSummary& summary, const std::vector<ExprPtr>& parts) {
+    for (const auto& part : parts) {
+        add_part(summary, expr_summary(part));
+    }
+}
+
+template <typename Compute>
+ExprSummary cached_summary(SummaryCache& cache, const Compute& compute) {
+    if (const auto shape = cache.shape.load(std::memory_order_acquire); shape != 0) {
+        ExprSummary summary;
+        summary.symbols = cache.symbols.load(std::memory_order_relaxed);
+        summary.heads = cache.heads.load(std::memory_order_relaxed);
+        summary.leaf_count = shape & kLeafCountMask;
+        summary.depth = (shape >> kDepthShift) & kDepthMask;
+        summary.has_symbols = (shape & kHasSymbols) != 0;
+        summary.has_non_numeric_leaf = (shape & kHasNonNumericLeaf) != 0;
+        summary.has_fractional_number = (shape & kHasFractionalNumber) != 0;
+        return summary;
+    }
+
+    const auto summary = compute();
+    cache.symbols.store(summary.symbols, std::memory_order_relaxed);
+    cache.heads.store(summary.heads, std::memory_order_relaxed);
+    cache.shape.store(
+        summary.leaf_count | (summary.depth << kDepthShift) |
+            (summary.has_symbols ? kHasSymbols : 0) |
+            (summary.has_non_numeric_leaf ? kHasNonNumericLeaf : 0) |
+            (summary.has_fractional_number ? kHasFractionalNumber : 0) | kFilled,
+        std::memory_order_release);
+    return summary;
+}
+
+}  // namespace
+
+std::uint64_t name_bloom_bit(std::string_view name) noexcept {
+    // The top six bits of a Fibonacci-scrambled hash pick the bit.
+    const auto hash = static_cast<std::uint64_t>(std::hash<std::string_view>{}(name));
+    return 1ULL << ((hash * 0x9E3779B97F4A7C15ULL) >> 58);
+}
+
+ExprSummary expr_summary(const ExprPtr& expr) {
+    if (expr == nullptr) {
+        return atom_summary();
+    }
+    return std::visit(
+        [](const auto& node) -> ExprSummary {
+            using T = std::decay_t<decltype(node)>;
+            if constexpr (std::is_same_v<T, Symbol>) {
+                return symbol_summary(node.name);
+            } else if constexpr (std::is_same_v<T, Number>) {
+                auto summary = atom_summary();
+                summary.has_fractional_number = !std::isfinite(node.value) || std::floor(node.value) != node.value;
+                return summary;
+            } else if constexpr (std::is_same_v<T, Rational> || std::is_same_v<T, Complex>) {
+                auto summary = atom_summary();
+                summary.leaf_count = 3;
+                return summary;
+            } else if constexpr (std::is_same_v<T, FunctionCall>) {
+                return cached_summary(node.summary, [&] {
+                    auto summary = compound_summary(node.head);
+                    add_parts(summary, node.args);
+                    return summary;
+                });
+            } else if constexpr (std::is_same_v<T, List>) {
+                return cached_summary(node.summary, [&] {
+                    auto summary = compound_summary("List");
+                    add_parts(summary, node.elements);
+                    return summary;
+                });
+            } else if constexpr (std::is_same_v<T, Rule>) {
+                auto summary = compound_summary("Rule");
+                add_part(summary, expr_summary(node.lhs));
+                add_part(summary, expr_summary(node.rhs));
+                return summary;
+            } else if constexpr (std::is_same_v<T, Association>) {
+                auto summary = compound_summary("Association");
+                node.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    auto rule = compound_summary("Rule");
+                    add_part(rule, expr_summary(key));
+                    add_part(rule, expr_summary(value));
+                    add_part(summary, rule);
+                });
+                return summary;
+            } else if constexpr (std::is_same_v<T, Assignment>) {
+                auto summary = compound_summary("Set");
+                add_name_part(summary, node.name);
+                add_part(summary, expr_summary(node.value));
+                return summary;
+            } else if constexpr (std::is_same_v<T, FunctionDefinition>) {
+                // FunctionDefinition[name, List[Parameter[p, default], ...], body, delayed]
+                auto summary = compound_summary("FunctionDefinition");
+                add_name_part(summary, node.name);
+                auto params = compound_summary("List");
+                for (const auto& param : node.params) {
+                    auto parameter = compound_summary("Parameter");
+                    add_name_part(parameter, param.name);
+                    if (param.default_value) {
+                        add_part(parameter, expr_summary(param.default_value));
+                    }
+                    add_part(params, parameter);
+                }
+                add_part(summary, params);
+                add_part(summary, expr_summary(node.body));
+                add_part(summary, non_numeric_atom_summary());
+                return summary;
+            } else {
+                // Boolean, String, Infinity, ComplexInfinity, Indeterminate.
+                return non_numeric_atom_summary();
+            }
+        },
+        *expr);
+}
+
+}  // namespace aleph3
@@ -0,0 +1,258 @@
+#include "expr/SharedString.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace aleph3 {
+
+// A leaf owns its text. A concatenation owns its two parts until the first
+// request for contiguous text fills `text` and drops them; `mutex` guards the
+// parts while the node is still a rope.
+struct SharedString::Node {
+    std::size_t size = 0;
+    std::size_t depth = 0;
+    mutable std::shared_ptr<const Node> left;
+    mutable std::shared_ptr<const Node> right;
+    mutable std::string text;
+    mutable std::atomic<bool> flat{false};
+    mutable std::mutex mutex;
+
+    explicit Node(std::string leaf_text)
+        : size(leaf_text.size()), text(std::move(leaf_text)), flat(true) {}
+
+    Node(std::shared_ptr<const Node> left_part, std::shared_ptr<const Node> right_part)
+        : size(left_part->size + right_part->size),
+          depth(std::max(left_part->depth, right_part->depth) + 1),
+          left(std::move(left_part)),
+          right(std::move(right_part)) {}
+
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
+
+    // Releases the parts iteratively, so long append chains do not recurse.
+    ~Node() {
+        std::vector<std::shared_ptr<const Node>> pending;
+        pending.push_back(std::move(left));
+        pending.push_back(std::move(right));
+        while (!pending.empty()) {
+            auto node = std::move(pending.back());
+            pending.pop_back();
+            if (node && node.use_count() == 1) {
+                pending.push_back(std::move(node->left));
+                pending.push_back(std::move(node->right));
+            }
+        }
+    }
+
+    [[nodiscard]] bool is_leaf() const noexcept { return flat.load(std::memory_order_acquire); }
+};
+
+namespace {
+
+using NodePtr = std::shared_ptr<const SharedString::Node>;
+
+// Deeper ropes are rebuilt balanced from their leaves.
+constexpr std::size_t max_rope_depth = 48;
+
+struct RopeParts {
+    NodePtr left;
+    NodePtr right;
+};
+
+// The parts of a rope node, or none once it has been flattened.
+RopeParts parts_of(const SharedString::Node& node) {
+    std::lock_guard lock(node.mutex);
+    if (node.flat.load(std::memory_order_relaxed)) {
+        return {};
+    }
+    return {node.left, node.right};
+}
+
+NodePtr make_leaf(std::string text) {
+    return std::make_shared<const SharedString::Node>(std::move(text));
+}
+
+void append_leaves(const NodePtr& root, std::string& out) {
+    std::vector<NodePtr> pending{root};
+    while (!pending.empty()) {
+        auto node = std::move(pending.back());
+        pending.pop_back();
+        if (!node->is_leaf()) {
+            auto parts = parts_of(*node);
+            if (parts.left) {
+                pending.push_back(std::move(parts.right));
+                pending.push_back(std::move(parts.left));
+                continue;
+            }
+        }
+        out += node->text;
+    }
+}
+
+void collect_leaves(const NodePtr& root, std::vector<NodePtr>& leaves) {
+    std::vector<NodePtr> pending{root};
+    while (!pending.empty()) {
+        auto node = std::move(pending.back());
+        pending.pop_back();
+        if (!node->is_leaf()) {
+            auto parts = parts_of(*node);
+            if (parts.left) {
+                pending.push_back(std::move(parts.right));
+                pending.push_back(std::move(parts.left));
+                continue;
+            }
+        }
+        leaves.push_back(std::move(node));
+    }
+}
+
+NodePtr build_balanced(const std::vector<NodePtr>& pieces, std::size_t begin, std::size_t end) {
+    if (end - begin == 1) {
+        return pieces[begin];
+    }
+    const auto middle = begin + (end - begin) / 2;
+    return std::make_shared<const SharedString::Node>(
+        build_balanced(pieces, begin, middle),
+        build_balanced(pieces, middle, end));
+}
+
+NodePtr bound_depth(NodePtr node) {
+    if (node->depth <= max_rope_depth) {
+        return node;
+    }
+    std::vector<NodePtr> leaves;
+    collect_leaves(node, leaves);
+    return build_balanced(leaves, 0, leaves.size());
+}
+
+NodePtr make_concat(NodePtr left, NodePtr right) {
+    return bound_depth(std::make_shared<const SharedString::Node>(std::move(left), std::move(right)));
+}
+
+// Appending a short leaf to a rope that ends in a short leaf merges the two,
+// so building a string a few characters at a time stays shallow. Returns null
+// when the merge does not apply.
+NodePtr merge_short_tail(const NodePtr& head, const NodePtr& tail) {
+    if (head->is_leaf() || !tail->is_leaf()) {
+        return nullptr;
+    }
+    auto parts = parts_of(*head);
+    if (!parts.right || !parts.right->is_leaf() ||
+        parts.right->size + tail->size > SharedString::flat_join_limit) {
+        return nullptr;
+    }
+    return make_concat(std::move(parts.left), make_leaf(parts.right->text + tail->text));
+}
+
+const NodePtr& empty_node() {
+    static const NodePtr empty = make_leaf(std::string{});
+    return empty;
+}
+
+}  // namespace
+
+SharedString::SharedString()
+    : node_(empty_node()) {}
+
+SharedString::SharedString(std::string text)
+    : node_(text.empty() ? empty_node() : make_leaf(std::move(text))) {}
+
+SharedString SharedString::concat(const SharedString& left, const SharedString& right) {
+    if (right.empty()) {
+        return left;
+    }
+    if (left.empty()) {
+        return right;
+    }
+    if (left.size() + right.size() <= flat_join_limit) {
+        std::string text;
+        text.reserve(left.size() + right.size());
+        text += left.str();
+        text += right.str();
+        return SharedString(std::move(text));
+    }
+
+    if (auto merged = merge_short_tail(left.node_, right.node_)) {
+        return SharedString(std::move(merged));
+    }
+    return SharedString(make_concat(left.node_, right.node_));
+}
+
+SharedString SharedString::join(const std::vector<SharedString>& parts) {
+    std::size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    if (total <= flat_join_limit) {
+        std::string text;
+        text.reserve(total);
+        for (const auto& part : parts) {
+            text += part.str();
+        }
+        return SharedString(std::move(text));
+    }
+
+    // Runs of short parts become one leaf, merged into the last leaf of the
+    // rope before them when it has room; larger parts are shared as they are.
+    std::vector<NodePtr> pieces;
+    std::string run;
+    auto flush_run = [&] {
+        if (run.empty()) {
+            return;
+        }
+        auto leaf = make_leaf(std::move(run));
+        run.clear();
+        if (!pieces.empty()) {
+            if (auto merged = merge_short_tail(pieces.back(), leaf)) {
+                pieces.back() = std::move(merged);
+                return;
+            }
+        }
+        pieces.push_back(std::move(leaf));
+    };
+    for (const auto& part : parts) {
+        if (part.empty()) {
+            continue;
+        }
+        if (part.node_->is_leaf() && run.size() + part.size() <= flat_join_limit) {
+            run += part.node_->text;
+        } else {
+            flush_run();
+            pieces.push_back(part.node_);
+        }
+    }
+    flush_run();
+    return SharedString(bound_depth(build_balanced(pieces, 0, pieces.size())));
+}
+
+const std::string& SharedString::str() const {
+    if (node_->is_leaf()) {
+        return node_->text;
+    }
+    RopeParts dropped;
+    {
+        std::lock_guard lock(node_->mutex);
+        if (!node_->flat.load(std::memory_order_relaxed)) {
+            std::string text;
+            text.reserve(node_->size);
+            append_leaves(node_->left, text);
+            append_leaves(node_->right, text);
+            node_->text = std::move(text);
+            dropped = {std::move(node_->left), std::move(node_->right)};
+            node_->flat.store(true, std::memory_order_release);
+        }
+    }
+    return node_->text;
+}
+
+std::size_t SharedString::size() const noexcept {
+    return node_->size;
+}
+
+bool SharedString::is_rope() const noexcept {
+    return !node_->is_leaf();
+}
+
+}  // namespace aleph3
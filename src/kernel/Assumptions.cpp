@@ -1,8 +1,10 @@
 #include "kernel/Assumptions.hpp"
 
 #include "evaluator/EvaluatorErrors.hpp"
+#include "expr/ExprSummary.hpp"
 #include "expr/ExprUtils.hpp"
 #include "normalizer/Normalizer.hpp"
+#include "symbols/SymbolState.hpp"
 
 #include <array>
 #include <cmath>
@@ -11,9 +13,7 @@ namespace aleph3::kernel {
 
 namespace {
 
-constexpr unsigned kPositiveSign = 1u;
-constexpr unsigned kZeroSign = 2u;
-constexpr unsigned kNegativeSign = 4u;
+constexpr std::size_t kDerivationCacheLimit = 4096;
 
 bool is_integral_number_value(double value) {
     return std::floor(value) == value;
@@ -29,36 +29,26 @@ bool is_domain_predicate(std::string_view head) {
     return head == "IntegerQ" || head == "RationalQ" || head == "RealQ";
 }
 
-bool is_zero_literal(const ExprPtr& expr) {
-    if (const auto* number = std::get_if<Number>(&*expr)) {
-        return number->value == 0.0;
-    }
-    if (const auto* rational = std::get_if<Rational>(&*expr)) {
-        return rational->numerator == 0;
-    }
-    return false;
+bool is_comparison_head(std::string_view head) {
+    return head == "Equal" || head == "NotEqual" ||
+           head == "Less" || head == "LessEqual" ||
+           head == "Greater" || head == "GreaterEqual";
 }
 
-std::optional<int> compare_numeric_to_zero(const ExprPtr& expr) {
-    if (const auto* number = std::get_if<Number>(&*expr)) {
-        if (number->value > 0.0) {
-            return 1;
-        }
-        if (number->value < 0.0) {
-            return -1;
-        }
-        return 0;
+std::string mirrored_comparison_head(const std::string& head) {
+    if (head == "Greater") {
+        return "Less";
     }
-    if (const auto* rational = std::get_if<Rational>(&*expr)) {
-        if (rational->numerator > 0) {
-            return 1;
-        }
-        if (rational->numerator < 0) {
-            return -1;
-        }
-        return 0;
+    if (head == "GreaterEqual") {
+        return "LessEqual";
     }
-    return std::nullopt;
+    if (head == "Less") {
+        return "Greater";
+    }
+    if (head == "LessEqual") {
+        return "GreaterEqual";
+    }
+    return head;
 }
 
 bool is_exact_two(const ExprPtr& expr) {
@@ -134,41 +124,247 @@ std::optional<int64_t> exact_integer_value(const ExprPtr& expr) {
     return std::nullopt;
 }
 
-void apply_sign_fact(SymbolAssumptionFacts& facts, std::string_view head) {
+struct IntervalEndpoint {
+    double value;
+    bool closed;
+};
+
+NumericInterval empty_interval() {
+    NumericInterval interval;
+    interval.lower = std::numeric_limits<double>::infinity();
+    interval.upper = -std::numeric_limits<double>::infinity();
+    return interval;
+}
+
+NumericInterval make_interval(IntervalEndpoint lower, IntervalEndpoint upper) {
+    NumericInterval interval;
+    interval.lower = lower.value;
+    interval.upper = upper.value;
+    interval.lower_closed = lower.closed && std::isfinite(lower.value);
+    interval.upper_closed = upper.closed && std::isfinite(upper.value);
+    return interval;
+}
+
+bool overflowed(double left, double right, double result) {
+    return std::isfinite(left) && std::isfinite(right) && !std::isfinite(result);
+}
+
+NumericInterval interval_from_sign_mask(unsigned signs) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    switch (signs) {
+    case kPositiveSign:
+        return make_interval({0.0, false}, {inf, false});
+    case kZeroSign:
+        return NumericInterval::point(0.0);
+    case kNegativeSign:
+        return make_interval({-inf, false}, {0.0, false});
+    case kPositiveSign | kZeroSign:
+        return make_interval({0.0, true}, {inf, false});
+    case kZeroSign | kNegativeSign:
+        return make_interval({-inf, false}, {0.0, true});
+    case 0u:
+        return empty_interval();
+    default:
+        return NumericInterval::whole();
+    }
+}
+
+NumericInterval tighten_integer_interval(const NumericInterval& interval) {
+    NumericInterval result = interval;
+    if (std::isfinite(result.lower)) {
+        const double floored = std::floor(result.lower);
+        result.lower = (result.lower_closed && floored == result.lower) ? floored : floored + 1.0;
+        result.lower_closed = true;
+    }
+    if (std::isfinite(result.upper)) {
+        const double ceiled = std::ceil(result.upper);
+        result.upper = (result.upper_closed && ceiled == result.upper) ? ceiled : ceiled - 1.0;
+        result.upper_closed = true;
+    }
+    return result;
+}
+
+NumericInterval negate_interval(const NumericInterval& interval) {
+    if (interval.empty()) {
+        return empty_interval();
+    }
+    return make_interval(
+        {-interval.upper, interval.upper_closed},
+        {-interval.lower, interval.lower_closed});
+}
+
+NumericInterval add_intervals(const NumericInterval& left, const NumericInterval& right) {
+    if (left.empty() || right.empty()) {
+        return empty_interval();
+    }
+    const double lower = left.lower + right.lower;
+    const double upper = left.upper + right.upper;
+    if (overflowed(left.lower, right.lower, lower) || overflowed(left.upper, right.upper, upper)) {
+        return NumericInterval::whole();
+    }
+    return make_interval(
+        {lower, left.lower_closed && right.lower_closed},
+        {upper, left.upper_closed && right.upper_closed});
+}
+
+std::optional<IntervalEndpoint> multiply_endpoints(IntervalEndpoint left, IntervalEndpoint right) {
+    // A closed zero end annihilates anything, including an infinite partner;
+    // an open zero end only approaches zero.
+    if ((left.value == 0.0 && left.closed) || (right.value == 0.0 && right.closed)) {
+        return IntervalEndpoint{0.0, true};
+    }
+    if (left.value == 0.0 || right.value == 0.0) {
+        return IntervalEndpoint{0.0, false};
+    }
+    const double product = left.value * right.value;
+    if (overflowed(left.value, right.value, product)) {
+        return std::nullopt;
+    }
+    return IntervalEndpoint{product, left.closed && right.closed};
+}
+
+NumericInterval hull_of_endpoints(const std::array<IntervalEndpoint, 4>& candidates) {
+    IntervalEndpoint lower = candidates[0];
+    IntervalEndpoint upper = candidates[0];
+    for (const auto& candidate : candidates) {
+        if (candidate.value < lower.value) {
+            lower = candidate;
+        } else if (candidate.value == lower.value) {
+            lower.closed = lower.closed || candidate.closed;
+        }
+        if (candidate.value > upper.value) {
+            upper = candidate;
+        } else if (candidate.value == upper.value) {
+            upper.closed = upper.closed || candidate.closed;
+        }
+    }
+    return make_interval(lower, upper);
+}
+
+NumericInterval multiply_intervals(const NumericInterval& left, const NumericInterval& right) {
+    if (left.empty() || right.empty()) {
+        return empty_interval();
+    }
+
+    const std::array<IntervalEndpoint, 2> left_ends{
+        IntervalEndpoint{left.lower, left.lower_closed},
+        IntervalEndpoint{left.upper, left.upper_closed}};
+    const std::array<IntervalEndpoint, 2> right_ends{
+        IntervalEndpoint{right.lower, right.lower_closed},
+        IntervalEndpoint{right.upper, right.upper_closed}};
+
+    std::array<IntervalEndpoint, 4> candidates{};
+    std::size_t index = 0;
+    for (const auto& left_end : left_ends) {
+        for (const auto& right_end : right_ends) {
+            const auto product = multiply_endpoints(left_end, right_end);
+            if (!product.has_value()) {
+                return NumericInterval::whole();
+            }
+            candidates[index++] = *product;
+        }
+    }
+    return hull_of_endpoints(candidates);
+}
+
+NumericInterval reciprocal_interval(const NumericInterval& interval) {
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    if (interval.empty() || interval.contains(0.0)) {
+        return NumericInterval::whole();
+    }
+
+    if (interval.lower >= 0.0) {
+        return make_interval(
+            {1.0 / interval.upper, interval.upper_closed},
+            {interval.lower == 0.0 ? inf : 1.0 / interval.lower, interval.lower_closed});
+    }
+    return make_interval(
+        {interval.upper == 0.0 ? -inf : 1.0 / interval.upper, interval.upper_closed},
+        {std::isfinite(interval.lower) ? 1.0 / interval.lower : 0.0, interval.lower_closed});
+}
+
+NumericInterval power_interval(const NumericInterval& base, int64_t exponent) {
+    if (base.empty()) {
+        return empty_interval();
+    }
+
+    auto raise = [exponent](IntervalEndpoint end) -> std::optional<IntervalEndpoint> {
+        const double value = std::pow(end.value, static_cast<double>(exponent));
+        if (overflowed(end.value, 1.0, value)) {
+            return std::nullopt;
+        }
+        return IntervalEndpoint{value, end.closed};
+    };
+
+    const auto lower = raise({base.lower, base.lower_closed});
+    const auto upper = raise({base.upper, base.upper_closed});
+    if (!lower.has_value() || !upper.has_value()) {
+        return NumericInterval::whole();
+    }
+
+    if ((exponent % 2) != 0 || base.lower >= 0.0) {
+        return make_interval(*lower, *upper);
+    }
+    if (base.upper <= 0.0) {
+        return make_interval(*upper, *lower);
+    }
+
+    IntervalEndpoint top = lower->value > upper->value ? *lower : *upper;
+    if (lower->value == upper->value) {
+        top.closed = lower->closed || upper->closed;
+    }
+    return make_interval({0.0, true}, top);
+}
+
+NumericInterval sqrt_interval(const NumericInterval& interval) {
+    if (interval.empty() || interval.lower < 0.0) {
+        return NumericInterval::whole();
+    }
+    return make_interval(
+        {std::sqrt(interval.lower), interval.lower_closed},
+        {std::sqrt(interval.upper), interval.upper_closed});
+}
+
+NumericInterval abs_interval(const NumericInterval& interval) {
+    if (interval.empty()) {
+        return empty_interval();
+    }
+    if (interval.lower >= 0.0) {
+        return interval;
+    }
+    if (interval.upper <= 0.0) {
+        return negate_interval(interval);
+    }
+
+    IntervalEndpoint top{-interval.lower, interval.lower_closed};
+    if (interval.upper > top.value) {
+        top = {interval.upper, interval.upper_closed};
+    } else if (interval.upper == top.value) {
+        top.closed = top.closed || interval.upper_closed;
+    }
+    return make_interval({0.0, true}, top);
+}
+
+unsigned sign_mask_for_predicate(std::string_view head) {
     if (head == "Greater" || head == "Positive") {
-        facts.real = true;
-        facts.positive = true;
-        facts.nonnegative = true;
-        facts.nonzero = true;
-        return;
+        return kPositiveSign;
     }
     if (head == "GreaterEqual" || head == "NonNegative") {
-        facts.real = true;
-        facts.nonnegative = true;
-        return;
+        return kPositiveSign | kZeroSign;
     }
     if (head == "Less" || head == "Negative") {
-        facts.real = true;
-        facts.negative = true;
-        facts.nonpositive = true;
-        facts.nonzero = true;
-        return;
+        return kNegativeSign;
     }
     if (head == "LessEqual" || head == "NonPositive") {
-        facts.real = true;
-        facts.nonpositive = true;
-        return;
+        return kNegativeSign | kZeroSign;
     }
     if (head == "Equal" || head == "ZeroQ") {
-        facts.real = true;
-        facts.zero = true;
-        facts.nonnegative = true;
-        facts.nonpositive = true;
-        return;
+        return kZeroSign;
     }
     if (head == "NotEqual" || head == "NonZeroQ") {
-        facts.nonzero = true;
+        return kPositiveSign | kNegativeSign;
     }
+    return kAnySign;
 }
 
 void apply_domain_fact(SymbolAssumptionFacts& facts, std::string_view head) {
@@ -190,7 +386,7 @@ void apply_domain_fact(SymbolAssumptionFacts& facts, std::string_view head) {
 
 std::optional<bool> evaluate_domain_predicate_from_facts(
     std::string_view predicate_name,
-    const SymbolAssumptionFacts& facts) {
+    const DerivedAssumptionFacts& facts) {
     if (predicate_name == "IntegerQ") {
         return facts.integer ? std::optional<bool>(true) : std::nullopt;
     }
@@ -230,31 +426,6 @@ std::optional<bool> evaluate_exact_numeric_domain_predicate(
     return std::nullopt;
 }
 
-unsigned sign_mask_from_facts(const SymbolAssumptionFacts& facts) {
-    unsigned signs = kPositiveSign | kZeroSign | kNegativeSign;
-
-    if (facts.positive) {
-        signs &= kPositiveSign;
-    }
-    if (facts.negative) {
-        signs &= kNegativeSign;
-    }
-    if (facts.zero) {
-        signs &= kZeroSign;
-    }
-    if (facts.nonnegative) {
-        signs &= (kPositiveSign | kZeroSign);
-    }
-    if (facts.nonpositive) {
-        signs &= (kZeroSign | kNegativeSign);
-    }
-    if (facts.nonzero) {
-        signs &= (kPositiveSign | kNegativeSign);
-    }
-
-    return signs;
-}
-
 unsigned negate_sign_mask(unsigned signs) {
     unsigned result = 0u;
     if ((signs & kPositiveSign) != 0u) {
@@ -294,115 +465,255 @@ unsigned multiply_sign_masks(unsigned left, unsigned right) {
     return result;
 }
 
-std::optional<unsigned> derive_sign_mask(const ExprPtr& expr, const AssumptionStore& assumptions);
+unsigned add_sign_masks(unsigned left, unsigned right) {
+    unsigned result = 0u;
+    const std::array<unsigned, 3> sign_values{kNegativeSign, kZeroSign, kPositiveSign};
 
-std::optional<unsigned> derive_symbol_sign_mask(
-    const std::string& name,
-    const AssumptionStore& assumptions) {
-    const auto* facts = assumptions.find_symbol_facts(name);
-    if (facts == nullptr) {
-        return std::nullopt;
+    for (const unsigned left_sign : sign_values) {
+        if ((left & left_sign) == 0u) {
+            continue;
+        }
+        for (const unsigned right_sign : sign_values) {
+            if ((right & right_sign) == 0u) {
+                continue;
+            }
+            if (left_sign == kZeroSign) {
+                result |= right_sign;
+            } else if (right_sign == kZeroSign || left_sign == right_sign) {
+                result |= left_sign;
+            } else {
+                result |= kAnySign;
+            }
+        }
     }
 
-    const unsigned signs = sign_mask_from_facts(*facts);
-    if (signs == 0u) {
-        return std::nullopt;
+    return result;
+}
+
+// Re-establishes the invariants of a derived fact set: non-real quantities
+// carry no interval, real ones fold their sign mask and interval together.
+DerivedAssumptionFacts settle_facts(DerivedAssumptionFacts facts) {
+    if (!facts.real) {
+        facts.interval = NumericInterval::whole();
+        return facts;
     }
-    return signs;
+
+    facts.interval = facts.interval.intersect(interval_from_sign_mask(facts.signs));
+    if (facts.integer) {
+        facts.interval = tighten_integer_interval(facts.interval);
+    }
+    facts.signs &= facts.interval.sign_mask();
+    return facts;
 }
 
-std::optional<unsigned> derive_power_sign_mask(
+DerivedAssumptionFacts numeric_literal_facts(double value, bool integer, bool rational) {
+    DerivedAssumptionFacts facts;
+    if (!std::isfinite(value)) {
+        return facts;
+    }
+    facts.real = true;
+    facts.integer = integer;
+    facts.rational = rational;
+    facts.interval = NumericInterval::point(value);
+    return settle_facts(facts);
+}
+
+DerivedAssumptionFacts negate_facts(DerivedAssumptionFacts facts) {
+    facts.signs = negate_sign_mask(facts.signs);
+    facts.interval = negate_interval(facts.interval);
+    return settle_facts(facts);
+}
+
+DerivedAssumptionFacts multiply_facts(const DerivedAssumptionFacts& left, const DerivedAssumptionFacts& right) {
+    DerivedAssumptionFacts facts;
+    facts.signs = multiply_sign_masks(left.signs, right.signs);
+    facts.real = left.real && right.real;
+    facts.rational = left.rational && right.rational;
+    facts.integer = left.integer && right.integer;
+    if (facts.real) {
+        facts.interval = multiply_intervals(left.interval, right.interval);
+    }
+    return settle_facts(facts);
+}
+
+DerivedAssumptionFacts add_facts(const DerivedAssumptionFacts& left, const DerivedAssumptionFacts& right) {
+    DerivedAssumptionFacts facts;
+    facts.signs = add_sign_masks(left.signs, right.signs);
+    facts.real = left.real && right.real;
+    facts.rational = left.rational && right.rational;
+    facts.integer = left.integer && right.integer;
+    if (facts.real) {
+        facts.interval = add_intervals(left.interval, right.interval);
+    }
+    return settle_facts(facts);
+}
+
+DerivedAssumptionFacts derive_expr_facts(const ExprPtr& expr, const AssumptionStore& assumptions);
+
+DerivedAssumptionFacts derive_symbol_facts(const std::string& name, const AssumptionStore& assumptions) {
+    const auto* symbol_facts = assumptions.find_symbol_facts(name);
+    if (symbol_facts == nullptr) {
+        return {};
+    }
+
+    DerivedAssumptionFacts facts;
+    facts.signs = symbol_facts->signs;
+    facts.interval = symbol_facts->interval;
+    facts.integer = symbol_facts->integer;
+    facts.rational = symbol_facts->rational;
+    facts.real = symbol_facts->real;
+    return settle_facts(facts);
+}
+
+DerivedAssumptionFacts derive_power_facts(
     const ExprPtr& base,
     const ExprPtr& exponent,
     const AssumptionStore& assumptions) {
     const auto exact_exponent = exact_integer_value(exponent);
     if (!exact_exponent.has_value() || *exact_exponent <= 0) {
-        return std::nullopt;
+        return {};
     }
 
-    const auto base_signs = derive_sign_mask(base, assumptions);
-    if (!base_signs.has_value()) {
-        return std::nullopt;
+    const auto base_facts = assumptions.derive_facts(base);
+    if (base_facts.unknown()) {
+        return {};
     }
 
+    DerivedAssumptionFacts facts = base_facts;
     if ((*exact_exponent % 2) == 0) {
-        unsigned result = 0u;
-        if (((*base_signs) & kZeroSign) != 0u) {
-            result |= kZeroSign;
+        facts.signs = 0u;
+        if ((base_facts.signs & kZeroSign) != 0u) {
+            facts.signs |= kZeroSign;
         }
-        if (((*base_signs) & (kPositiveSign | kNegativeSign)) != 0u) {
-            result |= kPositiveSign;
+        if ((base_facts.signs & (kPositiveSign | kNegativeSign)) != 0u) {
+            facts.signs |= kPositiveSign;
         }
-        return result == 0u ? std::nullopt : std::optional<unsigned>(result);
     }
-
-    return base_signs;
-}
-
-std::optional<unsigned> derive_times_sign_mask(
-    const FunctionCall& func,
-    const AssumptionStore& assumptions) {
-    if (func.args.empty()) {
-        return std::nullopt;
+    if (facts.real) {
+        facts.interval = power_interval(base_facts.interval, *exact_exponent);
     }
+    return settle_facts(facts);
+}
 
-    unsigned combined = kPositiveSign;
-    for (const auto& arg : func.args) {
-        const auto factor_signs = derive_sign_mask(arg, assumptions);
-        if (!factor_signs.has_value()) {
-            return std::nullopt;
-        }
-        combined = multiply_sign_masks(combined, *factor_signs);
+DerivedAssumptionFacts derive_reciprocal_facts(const ExprPtr& expr, const AssumptionStore& assumptions) {
+    const auto denominator = assumptions.derive_facts(expr);
+    if (denominator.unknown() || denominator.signs == 0u || (denominator.signs & kZeroSign) != 0u) {
+        return {};
     }
 
-    if (combined == 0u) {
-        return std::nullopt;
+    DerivedAssumptionFacts facts;
+    facts.signs = denominator.signs;
+    facts.real = denominator.real;
+    facts.rational = denominator.rational;
+    if (facts.real) {
+        facts.interval = reciprocal_interval(denominator.interval);
     }
-    return combined;
+    return settle_facts(facts);
 }
 
-std::optional<unsigned> derive_sign_mask(const ExprPtr& expr, const AssumptionStore& assumptions) {
-    if (expr == nullptr) {
-        return std::nullopt;
+DerivedAssumptionFacts derive_function_facts(const FunctionCall& func, const AssumptionStore& assumptions) {
+    if (func.head == "Negate" && func.args.size() == 1) {
+        const auto inner = assumptions.derive_facts(func.args[0]);
+        return inner.unknown() ? DerivedAssumptionFacts{} : negate_facts(inner);
     }
 
-    const auto normalized = normalize_expr(expr);
-    if (const auto relation = compare_numeric_to_zero(normalized); relation.has_value()) {
-        if (*relation > 0) {
-            return kPositiveSign;
+    if ((func.head == "Times" || func.head == "Plus") && !func.args.empty()) {
+        const bool is_times = func.head == "Times";
+        auto combined = assumptions.derive_facts(func.args.front());
+        for (std::size_t index = 1; index < func.args.size() && !combined.unknown(); ++index) {
+            const auto next = assumptions.derive_facts(func.args[index]);
+            if (next.unknown()) {
+                return {};
+            }
+            combined = is_times ? multiply_facts(combined, next) : add_facts(combined, next);
         }
-        if (*relation < 0) {
-            return kNegativeSign;
+        return combined.unknown() ? DerivedAssumptionFacts{} : combined;
+    }
+
+    if (func.head == "Minus" && func.args.size() == 2) {
+        const auto left = assumptions.derive_facts(func.args[0]);
+        const auto right = assumptions.derive_facts(func.args[1]);
+        if (left.unknown() || right.unknown()) {
+            return {};
         }
-        return kZeroSign;
+        return add_facts(left, negate_facts(right));
     }
 
-    if (const auto* symbol = std::get_if<Symbol>(&*normalized)) {
-        return derive_symbol_sign_mask(symbol->name, assumptions);
+    if (func.head == "Divide" && func.args.size() == 2) {
+        const auto numerator = assumptions.derive_facts(func.args[0]);
+        const auto reciprocal = derive_reciprocal_facts(func.args[1], assumptions);
+        if (numerator.unknown() || reciprocal.unknown()) {
+            return {};
+        }
+        return multiply_facts(numerator, reciprocal);
     }
 
-    const auto* func = std::get_if<FunctionCall>(&*normalized);
-    if (func == nullptr) {
-        return std::nullopt;
+    if (func.head == "Power" && func.args.size() == 2) {
+        return derive_power_facts(func.args[0], func.args[1], assumptions);
     }
 
-    if (func->head == "Negate" && func->args.size() == 1) {
-        const auto inner_signs = derive_sign_mask(func->args[0], assumptions);
-        if (!inner_signs.has_value()) {
-            return std::nullopt;
+    if (func.head == "Sqrt" && func.args.size() == 1) {
+        const auto radicand = assumptions.derive_facts(func.args[0]);
+        if (!radicand.real || (radicand.signs & kNegativeSign) != 0u) {
+            return {};
         }
-        return negate_sign_mask(*inner_signs);
+        DerivedAssumptionFacts facts;
+        facts.signs = radicand.signs;
+        facts.real = true;
+        facts.interval = sqrt_interval(radicand.interval);
+        return settle_facts(facts);
     }
 
-    if (func->head == "Times") {
-        return derive_times_sign_mask(*func, assumptions);
+    if (func.head == "Abs" && func.args.size() == 1) {
+        const auto inner = assumptions.derive_facts(func.args[0]);
+        if (inner.unknown()) {
+            return {};
+        }
+        DerivedAssumptionFacts facts;
+        facts.signs = 0u;
+        if ((inner.signs & kZeroSign) != 0u) {
+            facts.signs |= kZeroSign;
+        }
+        if ((inner.signs & (kPositiveSign | kNegativeSign)) != 0u) {
+            facts.signs |= kPositiveSign;
+        }
+        facts.real = true;
+        if (inner.real) {
+            facts.rational = inner.rational;
+            facts.integer = inner.integer;
+            facts.interval = abs_interval(inner.interval);
+        }
+        return settle_facts(facts);
     }
 
-    if (func->head == "Power" && func->args.size() == 2) {
-        return derive_power_sign_mask(func->args[0], func->args[1], assumptions);
+    return {};
+}
+
+DerivedAssumptionFacts derive_expr_facts(const ExprPtr& expr, const AssumptionStore& assumptions) {
+    if (expr == nullptr) {
+        return {};
     }
 
-    return std::nullopt;
+    if (const auto* number = std::get_if<Number>(&*expr)) {
+        const bool integral = is_integral_number_value(number->value);
+        return numeric_literal_facts(number->value, integral, integral);
+    }
+    if (const auto* rational = std::get_if<Rational>(&*expr)) {
+        if (rational->denominator == 0) {
+            return {};
+        }
+        return numeric_literal_facts(
+            static_cast<double>(rational->numerator) / static_cast<double>(rational->denominator),
+            rational->denominator == 1,
+            true);
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        return derive_symbol_facts(symbol->name, assumptions);
+    }
+    if (const auto* func = std::get_if<FunctionCall>(&*expr)) {
+        return derive_function_facts(*func, assumptions);
+    }
+    return {};
 }
 
 std::optional<bool> evaluate_sign_predicate_from_mask(
@@ -554,32 +865,213 @@ ExprPtr refine_function_call_with_assumptions(
 
 }  // namespace
 
+NumericInterval NumericInterval::whole() {
+    return NumericInterval{};
+}
+
+NumericInterval NumericInterval::point(double value) {
+    NumericInterval interval;
+    interval.lower = value;
+    interval.upper = value;
+    interval.lower_closed = true;
+    interval.upper_closed = true;
+    return interval;
+}
+
+bool NumericInterval::empty() const {
+    if (lower > upper) {
+        return true;
+    }
+    return lower == upper && !(lower_closed && upper_closed);
+}
+
+bool NumericInterval::contains(double value) const {
+    const bool above_lower = value > lower || (lower_closed && value == lower);
+    const bool below_upper = value < upper || (upper_closed && value == upper);
+    return above_lower && below_upper;
+}
+
+unsigned NumericInterval::sign_mask() const {
+    if (empty()) {
+        return 0u;
+    }
+
+    unsigned signs = 0u;
+    if (upper > 0.0) {
+        signs |= kPositiveSign;
+    }
+    if (contains(0.0)) {
+        signs |= kZeroSign;
+    }
+    if (lower < 0.0) {
+        signs |= kNegativeSign;
+    }
+    return signs;
+}
+
+NumericInterval NumericInterval::intersect(const NumericInterval& other) const {
+    NumericInterval result = *this;
+    if (other.lower > result.lower) {
+        result.lower = other.lower;
+        result.lower_closed = other.lower_closed;
+    } else if (other.lower == result.lower) {
+        result.lower_closed = result.lower_closed && other.lower_closed;
+    }
+    if (other.upper < result.upper) {
+        result.upper = other.upper;
+        result.upper_closed = other.upper_closed;
+    } else if (other.upper == result.upper) {
+        result.upper_closed = result.upper_closed && other.upper_closed;
+    }
+    return result;
+}
+
 void AssumptionStore::assume_boolean_symbol(std::string name, bool value) {
-    symbol_facts_[std::move(name)].boolean_value = value;
+    mutable_symbol_facts(name).boolean_value = value;
 }
 
 void AssumptionStore::assume_sign_fact(std::string symbol_name, const std::string& head) {
-    auto& facts = symbol_facts_[std::move(symbol_name)];
-    apply_sign_fact(facts, head);
+    auto& facts = mutable_symbol_facts(symbol_name);
+    facts.signs &= sign_mask_for_predicate(head);
+    if (head != "NotEqual" && head != "NonZeroQ") {
+        facts.real = true;
+    }
 }
 
 void assume_domain_fact(SymbolAssumptionFacts& facts, const std::string& head) {
     apply_domain_fact(facts, head);
 }
 
+void AssumptionStore::assume_bound(
+    const std::string& symbol_name,
+    const std::string& head,
+    const ExprPtr& bound) {
+    // Subterms of the bound may be cached against the facts as they stand
+    // before this one is recorded, so the caches are dropped again.
+    const auto bound_facts = derive_expr_facts(bound, *this);
+    clear_derivation_caches();
+    if (!bound_facts.real) {
+        return;
+    }
+
+    if (head == "NotEqual") {
+        const auto& interval = bound_facts.interval;
+        if (interval.lower == 0.0 && interval.upper == 0.0 && !interval.empty()) {
+            assume_sign_fact(symbol_name, head);
+        }
+        return;
+    }
+
+    NumericInterval constraint;
+    if (head == "Greater") {
+        constraint.lower = bound_facts.interval.lower;
+    } else if (head == "GreaterEqual") {
+        constraint.lower = bound_facts.interval.lower;
+        constraint.lower_closed = bound_facts.interval.lower_closed;
+    } else if (head == "Less") {
+        constraint.upper = bound_facts.interval.upper;
+    } else if (head == "LessEqual") {
+        constraint.upper = bound_facts.interval.upper;
+        constraint.upper_closed = bound_facts.interval.upper_closed;
+    } else if (head == "Equal") {
+        constraint = bound_facts.interval;
+    } else {
+        return;
+    }
+
+    auto& facts = mutable_symbol_facts(symbol_name);
+    facts.real = true;
+    facts.interval = facts.interval.intersect(constraint);
+}
+
 void AssumptionStore::assume_comparison(const FunctionCall& comparison) {
     if (comparison.args.size() != 2) {
         throw_invalid_form("Assumptions only support binary comparisons.");
     }
 
-    exact_true_forms_.insert(to_string(make_expr<FunctionCall>(comparison.head, comparison.args)));
+    insert_exact_true_form(make_expr<FunctionCall>(comparison.head, comparison.args));
 
-    const auto* symbol = std::get_if<Symbol>(&*comparison.args[0]);
-    if (symbol == nullptr || !is_zero_literal(comparison.args[1])) {
+    if (const auto* symbol = std::get_if<Symbol>(&*comparison.args[0])) {
+        assume_bound(symbol->name, comparison.head, comparison.args[1]);
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*comparison.args[1])) {
+        assume_bound(symbol->name, mirrored_comparison_head(comparison.head), comparison.args[0]);
+    }
+}
+
+SymbolAssumptionFacts& AssumptionStore::mutable_symbol_facts(const std::string& symbol_name) {
+    symbols::advance_modification_count();
+    auto it = symbol_facts_.find(symbol_name);
+    if (!frame_marks_.empty()) {
+        TrailEntry entry;
+        entry.symbol_name = symbol_name;
+        if (it != symbol_facts_.end()) {
+            entry.previous_facts = it->second;
+        }
+        trail_.push_back(std::move(entry));
+    }
+    if (it == symbol_facts_.end()) {
+        it = symbol_facts_.emplace(symbol_name, SymbolAssumptionFacts{}).first;
+    }
+    return it->second;
+}
+
+void AssumptionStore::insert_exact_true_form(ExprPtr form) {
+    symbols::advance_modification_count();
+    const auto summary = expr_summary(form);
+    exact_form_names_ |= summary.symbols | summary.heads;
+    auto [it, inserted] = exact_true_forms_.insert(std::move(form));
+    if (inserted && !frame_marks_.empty()) {
+        TrailEntry entry;
+        entry.exact_form = *it;
+        trail_.push_back(std::move(entry));
+    }
+}
+
+void AssumptionStore::push_frame() {
+    frame_marks_.push_back(trail_.size());
+}
+
+void AssumptionStore::pop_frame() {
+    if (frame_marks_.empty()) {
         return;
     }
 
-    assume_sign_fact(symbol->name, comparison.head);
+    const std::size_t mark = frame_marks_.back();
+    frame_marks_.pop_back();
+    if (trail_.size() > mark) {
+        symbols::advance_modification_count();
+    }
+    bool erased_exact_form = false;
+    while (trail_.size() > mark) {
+        auto& entry = trail_.back();
+        if (entry.exact_form != nullptr) {
+            exact_true_forms_.erase(entry.exact_form);
+            erased_exact_form = true;
+        } else if (entry.previous_facts.has_value()) {
+            symbol_facts_[entry.symbol_name] = std::move(*entry.previous_facts);
+        } else {
+            symbol_facts_.erase(entry.symbol_name);
+        }
+        trail_.pop_back();
+    }
+    if (erased_exact_form) {
+        exact_form_names_ = 0;
+        for (const auto& form : exact_true_forms_) {
+            const auto summary = expr_summary(form);
+            exact_form_names_ |= summary.symbols | summary.heads;
+        }
+    }
+    clear_derivation_caches();
+}
+
+std::size_t AssumptionStore::frame_depth() const {
+    return frame_marks_.size();
+}
+
+void AssumptionStore::clear_derivation_caches() {
+    identity_cache_.clear();
+    structural_cache_.clear();
 }
 
 void AssumptionStore::assume(const ExprPtr& expr) {
@@ -587,6 +1079,8 @@ void AssumptionStore::assume(const ExprPtr& expr) {
         throw_invalid_form("Assumptions cannot be empty.");
     }
 
+    clear_derivation_caches();
+
     if (const auto* boolean = std::get_if<Boolean>(&*expr)) {
         if (boolean->value) {
             return;
@@ -650,14 +1144,11 @@ void AssumptionStore::assume(const ExprPtr& expr) {
         if (symbol == nullptr) {
             throw_invalid_form("Assumption predicates only support symbol arguments.");
         }
-        auto& facts = symbol_facts_[symbol->name];
-        assume_domain_fact(facts, func->head);
+        assume_domain_fact(mutable_symbol_facts(symbol->name), func->head);
         return;
     }
 
-    if (func->head == "Equal" || func->head == "NotEqual" ||
-        func->head == "Less" || func->head == "LessEqual" ||
-        func->head == "Greater" || func->head == "GreaterEqual") {
+    if (is_comparison_head(func->head)) {
         assume_comparison(*func);
         return;
     }
@@ -685,81 +1176,43 @@ std::optional<bool> AssumptionStore::evaluate_predicate(
             exact_numeric.has_value()) {
             return exact_numeric;
         }
-
-        if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
-            if (const auto* facts = find_symbol_facts(symbol->name); facts != nullptr) {
-                return evaluate_domain_predicate_from_facts(predicate_name, *facts);
-            }
-        }
-
-        return std::nullopt;
-    }
-
-    if (const auto relation = compare_numeric_to_zero(expr); relation.has_value()) {
-        if (predicate_name == "Positive") {
-            return *relation > 0;
-        }
-        if (predicate_name == "Negative") {
-            return *relation < 0;
-        }
-        if (predicate_name == "NonNegative") {
-            return *relation >= 0;
-        }
-        if (predicate_name == "NonPositive") {
-            return *relation <= 0;
-        }
-        if (predicate_name == "ZeroQ") {
-            return *relation == 0;
-        }
-        if (predicate_name == "NonZeroQ") {
-            return *relation != 0;
-        }
+        return evaluate_domain_predicate_from_facts(predicate_name, derive_facts(expr));
     }
 
-    if (const auto derived_signs = derive_sign_mask(expr, *this); derived_signs.has_value()) {
-        return evaluate_sign_predicate_from_mask(predicate_name, *derived_signs);
+    const auto facts = derive_facts(expr);
+    if (facts.unknown()) {
+        return std::nullopt;
     }
-
-    return std::nullopt;
+    return evaluate_sign_predicate_from_mask(predicate_name, facts.signs);
 }
 
 std::optional<bool> AssumptionStore::evaluate_comparison(
     const std::string& head,
     const ExprPtr& left,
     const ExprPtr& right) const {
-    if (left == nullptr || right == nullptr) {
+    if (left == nullptr || right == nullptr || !is_comparison_head(head)) {
         return std::nullopt;
     }
 
-    if (exact_true_forms_.contains(to_string(make_expr<FunctionCall>(head, std::vector<ExprPtr>{left, right})))) {
+    // Hashing the probe walks both sides; the summaries usually rule it out
+    // first.
+    const auto left_summary = expr_summary(left);
+    const auto right_summary = expr_summary(right);
+    const auto probe_names = name_bloom_bit(head) | left_summary.symbols | left_summary.heads |
+        right_summary.symbols | right_summary.heads;
+    if ((probe_names & ~exact_form_names_) == 0 &&
+        exact_true_forms_.contains(make_expr<FunctionCall>(head, std::vector<ExprPtr>{left, right}))) {
         return true;
     }
 
-    if (is_zero_literal(right)) {
-        if (const auto signs = derive_sign_mask(left, *this); signs.has_value()) {
-            return evaluate_zero_comparison(head, *signs);
-        }
-    }
-    if (is_zero_literal(left)) {
-        if (const auto signs = derive_sign_mask(right, *this); signs.has_value()) {
-            if (head == "Greater") {
-                return evaluate_zero_comparison("Less", *signs);
-            }
-            if (head == "GreaterEqual") {
-                return evaluate_zero_comparison("LessEqual", *signs);
-            }
-            if (head == "Less") {
-                return evaluate_zero_comparison("Greater", *signs);
-            }
-            if (head == "LessEqual") {
-                return evaluate_zero_comparison("GreaterEqual", *signs);
-            }
-            if (head == "Equal" || head == "NotEqual") {
-                return evaluate_zero_comparison(head, *signs);
-            }
-        }
+    // Compare through the sign of left - right so bounds such as x > 3 also
+    // answer x > 0 or x + 1 > 2.
+    const auto left_facts = derive_facts(left);
+    const auto right_facts = derive_facts(right);
+    if (left_facts.unknown() || right_facts.unknown()) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    return evaluate_zero_comparison(head, add_facts(left_facts, negate_facts(right_facts)).signs);
 }
 
 const SymbolAssumptionFacts* AssumptionStore::find_symbol_facts(std::string_view symbol_name) const {
@@ -767,6 +1220,51 @@ const SymbolAssumptionFacts* AssumptionStore::find_symbol_facts(std::string_view
     return it == symbol_facts_.end() ? nullptr : &it->second;
 }
 
+DerivedAssumptionFacts AssumptionStore::derive_facts(const ExprPtr& expr) const {
+    if (expr == nullptr) {
+        return {};
+    }
+
+    // Literals and bare symbols are cheaper to derive than to hash.
+    if (!std::holds_alternative<FunctionCall>(*expr)) {
+        return derive_expr_facts(expr, *this);
+    }
+
+    if (auto it = identity_cache_.find(expr.get()); it != identity_cache_.end()) {
+        ++derivation_cache_hits_;
+        return it->second.second;
+    }
+
+    if (identity_cache_.size() >= kDerivationCacheLimit) {
+        identity_cache_.clear();
+    }
+
+    if (auto it = structural_cache_.find(expr); it != structural_cache_.end()) {
+        ++derivation_cache_hits_;
+        identity_cache_.emplace(expr.get(), std::make_pair(expr, it->second));
+        return it->second;
+    }
+
+    if (structural_cache_.size() >= kDerivationCacheLimit) {
+        structural_cache_.clear();
+    }
+
+    // Compound subterms are derived through this function as well, so a
+    // subterm shared with an earlier query is a cache hit, not a rewalk.
+    const auto facts = derive_expr_facts(expr, *this);
+    structural_cache_.emplace(expr, facts);
+    identity_cache_.emplace(expr.get(), std::make_pair(expr, facts));
+    return facts;
+}
+
+std::size_t AssumptionStore::cached_derivation_count() const {
+    return structural_cache_.size();
+}
+
+std::size_t AssumptionStore::derivation_cache_hits() const {
+    return derivation_cache_hits_;
+}
+
 ExprPtr refine_expr_with_assumptions(const ExprPtr& expr, const AssumptionStore& assumptions) {
     if (expr == nullptr) {
         return nullptr;
@@ -0,0 +1,269 @@
+#include "kernel/CounterRandom.hpp"
+
+#include "kernel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+
+namespace aleph3::kernel {
+
+namespace {
+
+constexpr std::uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr std::uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr std::uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr std::uint32_t kPhiloxW1 = 0xBB67AE85;
+constexpr int kPhiloxRounds = 10;
+
+// Blocks computed side by side. Narrower batches get fully unrolled into
+// scalar code before the vectorizer sees the lane loop.
+constexpr std::size_t kLanes = 64;
+
+// Draws generated into a stack buffer before they are transformed.
+constexpr std::size_t kPieceDraws = 2 * kLanes * 4;
+
+// Draws per work item when a fill is split across threads.
+constexpr std::size_t kChunkDraws = std::size_t{1} << 16;
+
+constexpr double kUnitScale = 0x1.0p-53;
+
+std::uint32_t low_word(std::uint64_t value) noexcept {
+    return static_cast<std::uint32_t>(value);
+}
+
+std::uint32_t high_word(std::uint64_t value) noexcept {
+    return static_cast<std::uint32_t>(value >> 32);
+}
+
+struct StreamWords {
+    PhiloxKey key;
+    std::uint32_t stream_low;
+    std::uint32_t stream_high;
+};
+
+// Bits of draws [first, first + count) into out, kLanes blocks at a time.
+void generate_bits(const StreamWords& words, std::uint64_t first, std::size_t count, std::uint64_t* out) noexcept {
+    std::uint64_t block = first / 2;
+    std::size_t skip = first % 2;
+    std::size_t written = 0;
+    while (written < count) {
+        std::uint32_t c0[kLanes];
+        std::uint32_t c1[kLanes];
+        std::uint32_t c2[kLanes];
+        std::uint32_t c3[kLanes];
+        for (std::size_t lane = 0; lane < kLanes; ++lane) {
+            c0[lane] = low_word(block + lane);
+            c1[lane] = high_word(block + lane);
+            c2[lane] = words.stream_low;
+            c3[lane] = words.stream_high;
+        }
+        std::uint32_t k0 = words.key[0];
+        std::uint32_t k1 = words.key[1];
+        for (int round = 0; round < kPhiloxRounds; ++round) {
+            // Separate high and low products keep every statement a 32-bit
+            // lane operation the vectorizer accepts.
+            for (std::size_t lane = 0; lane < kLanes; ++lane) {
+                const std::uint32_t a = c0[lane];
+                const std::uint32_t b = c2[lane];
+                const std::uint32_t high0 = high_word(static_cast<std::uint64_t>(kPhiloxM0) * a);
+                const std::uint32_t high1 = high_word(static_cast<std::uint64_t>(kPhiloxM1) * b);
+                c0[lane] = high1 ^ c1[lane] ^ k0;
+                c1[lane] = kPhiloxM1 * b;
+                c2[lane] = high0 ^ c3[lane] ^ k1;
+                c3[lane] = kPhiloxM0 * a;
+            }
+            k0 += kPhiloxW0;
+            k1 += kPhiloxW1;
+        }
+        for (std::size_t lane = 0; lane < kLanes && written < count; ++lane) {
+            const std::uint64_t pair[2] = {
+                (static_cast<std::uint64_t>(c0[lane]) << 32) | c1[lane],
+                (static_cast<std::uint64_t>(c2[lane]) << 32) | c3[lane]};
+            for (std::size_t half = skip; half < 2 && written < count; ++half) {
+                out[written++] = pair[half];
+            }
+            skip = 0;
+        }
+        block += kLanes;
+    }
+}
+
+// Calls fill_piece(first_draw, out) over pieces of at most kPieceDraws
+// outputs, on up to thread_count threads.
+template <typename PieceFiller>
+void fill_in_pieces(std::span<double> out, std::uint64_t first, std::size_t thread_count, const PieceFiller& fill_piece) {
+    auto fill_range = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t offset = begin; offset < end; offset += kPieceDraws) {
+            const auto length = std::min(kPieceDraws, end - offset);
+            fill_piece(first + offset, out.subspan(offset, length));
+        }
+    };
+
+    const std::size_t chunk_count = (out.size() + kChunkDraws - 1) / kChunkDraws;
+    if (chunk_count <= 1 || thread_count == 1) {
+        fill_range(0, out.size());
+        return;
+    }
+    run_work_stealing(chunk_count, thread_count, [&](std::size_t chunk) {
+        const auto begin = chunk * kChunkDraws;
+        fill_range(begin, std::min(begin + kChunkDraws, out.size()));
+    });
+}
+
+}  // namespace
+
+PhiloxCounter philox4x32(PhiloxCounter counter, PhiloxKey key) noexcept {
+    for (int round = 0; round < kPhiloxRounds; ++round) {
+        const std::uint64_t p0 = static_cast<std::uint64_t>(kPhiloxM0) * counter[0];
+        const std::uint64_t p1 = static_cast<std::uint64_t>(kPhiloxM1) * counter[2];
+        counter = {
+            high_word(p1) ^ counter[1] ^ key[0],
+            low_word(p1),
+            high_word(p0) ^ counter[3] ^ key[1],
+            low_word(p0)};
+        key[0] += kPhiloxW0;
+        key[1] += kPhiloxW1;
+    }
+    return counter;
+}
+
+std::uint64_t entropy_random_seed() {
+    std::random_device device;
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint64_t stream) noexcept
+    : key_{low_word(seed), high_word(seed)},
+      stream_low_(low_word(stream)),
+      stream_high_(high_word(stream)) {}
+
+std::uint64_t RandomStream::bits(std::uint64_t index) const noexcept {
+    const std::uint64_t block = index / 2;
+    const auto words = philox4x32({low_word(block), high_word(block), stream_low_, stream_high_}, key_);
+    return index % 2 == 0
+        ? (static_cast<std::uint64_t>(words[0]) << 32) | words[1]
+        : (static_cast<std::uint64_t>(words[2]) << 32) | words[3];
+}
+
+void RandomStream::fill_uniform(std::span<double> out, std::uint64_t first, std::size_t thread_count) const {
+    const StreamWords words{key_, stream_low_, stream_high_};
+    fill_in_pieces(out, first, thread_count, [&](std::uint64_t draw, std::span<double> piece) {
+        std::uint64_t bits[kPieceDraws];
+        generate_bits(words, draw, piece.size(), bits);
+        for (std::size_t i = 0; i < piece.size(); ++i) {
+            piece[i] = static_cast<double>(bits[i] >> 11) * kUnitScale;
+        }
+    });
+}
+
+void RandomStream::fill_normal(std::span<double> out, std::uint64_t first, std::size_t thread_count) const {
+    const StreamWords words{key_, stream_low_, stream_high_};
+    fill_in_pieces(out, first, thread_count, [&](std::uint64_t draw, std::span<double> piece) {
+        // Widen to whole pairs so each output sees both halves of its block.
+        const std::uint64_t pair_begin = draw & ~std::uint64_t{1};
+        const std::uint64_t pair_end = (draw + piece.size() + 1) & ~std::uint64_t{1};
+        std::uint64_t bits[kPieceDraws + 2];
+        generate_bits(words, pair_begin, static_cast<std::size_t>(pair_end - pair_begin), bits);
+        for (std::size_t i = 0; i < piece.size(); ++i) {
+            const std::uint64_t index = draw + i;
+            const std::size_t pair = static_cast<std::size_t>((index & ~std::uint64_t{1}) - pair_begin);
+            // u1 in (0, 1] keeps the logarithm finite.
+            const double u1 = static_cast<double>((bits[pair] >> 11) + 1) * kUnitScale;
+            const double u2 = static_cast<double>(bits[pair + 1] >> 11) * kUnitScale;
+            const double radius = std::sqrt(-2.0 * std::log(u1));
+            const double angle = 2.0 * std::numbers::pi * u2;
+            piece[i] = radius * (index % 2 == 0 ? std::cos(angle) : std::sin(angle));
+        }
+    });
+}
+
+void RandomStream::fill_integers(
+    std::span<double> out,
+    std::int64_t low,
+    std::uint64_t width,
+    std::uint64_t first,
+    std::size_t thread_count) const {
+    const StreamWords words{key_, stream_low_, stream_high_};
+    fill_in_pieces(out, first, thread_count, [&](std::uint64_t draw, std::span<double> piece) {
+        std::uint64_t bits[kPieceDraws];
+        generate_bits(words, draw, piece.size(), bits);
+        for (std::size_t i = 0; i < piece.size(); ++i) {
+            const auto offset = static_cast<std::uint64_t>((static_cast<unsigned __int128>(bits[i]) * width) >> 64);
+            piece[i] = static_cast<double>(static_cast<std::int64_t>(static_cast<std::uint64_t>(low) + offset));
+        }
+    });
+}
+
+const char* invalid_distribution_reason(const Distribution& distribution) noexcept {
+    if (!std::isfinite(distribution.first) || !std::isfinite(distribution.second)) {
+        return "requires finite parameters";
+    }
+    switch (distribution.kind) {
+        case DistributionKind::uniform:
+            return distribution.first <= distribution.second ? nullptr : "requires min <= max";
+        case DistributionKind::discrete_uniform:
+            if (std::floor(distribution.first) != distribution.first ||
+                std::floor(distribution.second) != distribution.second) {
+                return "requires integer bounds";
+            }
+            // Past 2^53 the bounds and the draws are no longer exact doubles.
+            // Within it the width, at most 2^54 + 1, always fits in uint64.
+            if (std::abs(distribution.first) > 0x1p53 || std::abs(distribution.second) > 0x1p53) {
+                return "requires bounds within 2^53 in magnitude";
+            }
+            return distribution.first <= distribution.second ? nullptr : "requires min <= max";
+        case DistributionKind::normal:
+        case DistributionKind::log_normal:
+            return distribution.second > 0.0 ? nullptr : "requires a positive standard deviation";
+        case DistributionKind::exponential:
+            return distribution.first > 0.0 ? nullptr : "requires a positive rate";
+    }
+    return "is not a supported distribution";
+}
+
+void fill_distribution(
+    const RandomStream& stream,
+    const Distribution& distribution,
+    std::span<double> out,
+    std::uint64_t first,
+    std::size_t thread_count) {
+    const double a = distribution.first;
+    const double b = distribution.second;
+    switch (distribution.kind) {
+        case DistributionKind::uniform:
+            stream.fill_uniform(out, first, thread_count);
+            for (auto& value : out) {
+                value = a + (b - a) * value;
+            }
+            return;
+        case DistributionKind::discrete_uniform: {
+            // b - a may round as a double; the width is taken in integers.
+            const auto low = static_cast<std::int64_t>(a);
+            const auto width = static_cast<std::uint64_t>(static_cast<std::int64_t>(b) - low) + 1;
+            stream.fill_integers(out, low, width, first, thread_count);
+            return;
+        }
+        case DistributionKind::normal:
+            stream.fill_normal(out, first, thread_count);
+            for (auto& value : out) {
+                value = a + b * value;
+            }
+            return;
+        case DistributionKind::log_normal:
+            stream.fill_normal(out, first, thread_count);
+            for (auto& value : out) {
+                value = std::exp(a + b * value);
+            }
+            return;
+        case DistributionKind::exponential:
+            stream.fill_uniform(out, first, thread_count);
+            for (auto& value : out) {
+                value = -std::log1p(-value) / a;
+            }
+            return;
+    }
+}
+
+}  // namespace aleph3::kernel
@@ -0,0 +1,129 @@
+#include "kernel/ExprReclaimer.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace aleph3::kernel {
+
+namespace {
+
+void push_parts(const Expr& expr, std::vector<const Expr*>& pending) {
+    if (const auto* call = std::get_if<FunctionCall>(&expr)) {
+        for (const auto& arg : call->args) {
+            pending.push_back(arg.get());
+        }
+    } else if (const auto* list = std::get_if<List>(&expr)) {
+        for (const auto& element : list->elements) {
+            pending.push_back(element.get());
+        }
+    } else if (const auto* rule = std::get_if<Rule>(&expr)) {
+        pending.push_back(rule->lhs.get());
+        pending.push_back(rule->rhs.get());
+    } else if (const auto* assoc = std::get_if<Association>(&expr)) {
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            pending.push_back(key.get());
+            pending.push_back(value.get());
+        });
+    }
+}
+
+// Whether the tree has at least `limit` nodes, counting shared parts once per
+// use. Stops as soon as it knows, so it costs at most about `limit` steps.
+bool has_at_least_nodes(const ExprPtr& root, std::size_t limit) {
+    std::vector<const Expr*> pending{root.get()};
+    std::size_t seen = 0;
+    while (!pending.empty()) {
+        const auto* expr = pending.back();
+        pending.pop_back();
+        if (expr == nullptr) {
+            continue;
+        }
+        if (++seen >= limit) {
+            return true;
+        }
+        if (pending.size() >= limit - seen) {
+            return true;
+        }
+        push_parts(*expr, pending);
+    }
+    return false;
+}
+
+}  // namespace
+
+ExprReclaimer::ExprReclaimer(std::size_t min_nodes)
+    : min_nodes_(std::max<std::size_t>(min_nodes, 1)) {}
+
+ExprReclaimer::~ExprReclaimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    queued_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool ExprReclaimer::retire(ExprPtr tree) {
+    if (!expr_refcount_is_atomic || tree == nullptr || tree.use_count() != 1 ||
+        !has_at_least_nodes(tree, min_nodes_)) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        if (!worker_.joinable()) {
+            worker_ = std::thread([this] { run(); });
+        }
+        queue_.emplace_back(std::move(tree), Clock::now());
+        ++metrics_.trees_queued;
+        metrics_.queue_depth = queue_.size() + in_flight_;
+        metrics_.max_queue_depth = std::max(metrics_.max_queue_depth, metrics_.queue_depth);
+    }
+    queued_.notify_one();
+    return true;
+}
+
+void ExprReclaimer::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drained_.wait(lock, [this] { return queue_.empty() && in_flight_ == 0; });
+}
+
+ReclamationMetrics ExprReclaimer::metrics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metrics_;
+}
+
+void ExprReclaimer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return;
+        }
+        auto [tree, queued_at] = std::move(queue_.front());
+        queue_.pop_front();
+        ++in_flight_;
+        lock.unlock();
+
+        tree.reset();
+        const std::chrono::duration<double, std::milli> latency = Clock::now() - queued_at;
+
+        lock.lock();
+        --in_flight_;
+        metrics_.queue_depth = queue_.size() + in_flight_;
+        ++metrics_.trees_freed;
+        metrics_.mean_latency_ms += (latency.count() - metrics_.mean_latency_ms) /
+            static_cast<double>(metrics_.trees_freed);
+        metrics_.max_latency_ms = std::max(metrics_.max_latency_ms, latency.count());
+        if (queue_.empty() && in_flight_ == 0) {
+            drained_.notify_all();
+        }
+    }
+}
+
+}  // namespace aleph3::kernel
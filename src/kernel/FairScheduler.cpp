@@ -0,0 +1,127 @@
+#include "kernel/FairScheduler.hpp"
+
+#include "kernel/EvaluationContext.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace aleph3::kernel {
+
+namespace {
+
+// True when `left` is owed a slot before `right`.
+template <typename Waiter>
+bool owed_before(const Waiter& left, const Waiter& right) {
+    if (left.priority != right.priority) {
+        return left.priority < right.priority;
+    }
+    if (left.tenant->virtual_time != right.tenant->virtual_time) {
+        return left.tenant->virtual_time < right.tenant->virtual_time;
+    }
+    return left.arrival < right.arrival;
+}
+
+}  // namespace
+
+FairScheduler::FairScheduler(std::size_t slots, std::size_t slice_steps)
+    : slots_(std::max<std::size_t>(slots, 1)), slice_steps_(slice_steps) {}
+
+void FairScheduler::set_tenant_weight(const std::string& tenant, double weight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tenants_[tenant].weight = weight;
+}
+
+FairScheduler::RunStats FairScheduler::run(
+    const std::string& tenant_name,
+    PriorityClass priority,
+    const std::function<void()>& work) {
+    RunStats stats;
+    Waiter waiter;
+    waiter.priority = priority;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& tenant = tenants_[tenant_name];
+    tenant.virtual_time = std::max(tenant.virtual_time, virtual_clock_);
+    waiter.tenant = &tenant;
+    waiter.arrival = next_arrival_++;
+    acquire(lock, waiter, stats);
+    lock.unlock();
+
+    std::size_t charged = 0;
+    StepSlice slice;
+    slice.length = slice_steps_;
+    slice.yield = [&] {
+        std::unique_lock<std::mutex> slice_lock(mutex_);
+        charge(tenant, slice.steps - charged);
+        charged = slice.steps;
+        if (waiting_.empty()) {
+            return;
+        }
+        --running_;
+        if (acquire(slice_lock, waiter, stats)) {
+            ++stats.yields;
+            ++yields_;
+        }
+    };
+
+    std::exception_ptr failure;
+    {
+        ScopedStepSlice scope(slice);
+        try {
+            work();
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    }
+
+    lock.lock();
+    charge(tenant, slice.steps - charged);
+    --running_;
+    ++completed_;
+    dispatch();
+    lock.unlock();
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+    return stats;
+}
+
+FairScheduler::Load FairScheduler::load() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {running_, waiting_.size(), completed_, yields_};
+}
+
+bool FairScheduler::acquire(std::unique_lock<std::mutex>& lock, Waiter& waiter, RunStats& stats) {
+    waiter.granted = false;
+    waiting_.push_back(&waiter);
+    dispatch();
+    if (waiter.granted) {
+        return false;
+    }
+
+    const auto queued_at = Clock::now();
+    waiter.wake.wait(lock, [&] { return waiter.granted; });
+    stats.queue_delay += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - queued_at);
+    return true;
+}
+
+void FairScheduler::charge(Tenant& tenant, std::size_t steps) {
+    tenant.virtual_time += static_cast<double>(steps) / tenant.weight;
+}
+
+void FairScheduler::dispatch() {
+    while (running_ < slots_ && !waiting_.empty()) {
+        const auto best = std::min_element(waiting_.begin(), waiting_.end(), [](const Waiter* left, const Waiter* right) {
+            return owed_before(*left, *right);
+        });
+        Waiter* next = *best;
+        waiting_.erase(best);
+        ++running_;
+        virtual_clock_ = std::max(virtual_clock_, next->tenant->virtual_time);
+        next->granted = true;
+        next->wake.notify_one();
+    }
+}
+
+}  // namespace aleph3::kernel
@@ -0,0 +1,89 @@
+#include "kernel/FunctionMemo.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace aleph3::kernel {
+
+namespace {
+
+ExprPtr make_argument_key(const std::vector<ExprPtr>& arguments) {
+    return make_expr<List>(arguments);
+}
+
+}  // namespace
+
+ExprPtr FunctionMemoTable::lookup(const ExprPtr& arguments, MemoEvictionPolicy eviction) {
+    auto it = index_.find(arguments);
+    if (it == index_.end()) {
+        return nullptr;
+    }
+    if (eviction == MemoEvictionPolicy::least_recently_used) {
+        order_.splice(order_.end(), order_, it->second);
+    }
+    return it->second->value;
+}
+
+void FunctionMemoTable::store(ExprPtr arguments, ExprPtr value, const MemoPolicy& policy) {
+    if (policy.max_entries_per_function == 0) {
+        return;
+    }
+
+    if (auto it = index_.find(arguments); it != index_.end()) {
+        it->second->value = std::move(value);
+        if (policy.eviction == MemoEvictionPolicy::least_recently_used) {
+            order_.splice(order_.end(), order_, it->second);
+        }
+        return;
+    }
+
+    if (index_.size() >= policy.max_entries_per_function) {
+        if (policy.eviction == MemoEvictionPolicy::clear_when_full) {
+            clear();
+        } else {
+            index_.erase(order_.front().arguments);
+            order_.pop_front();
+        }
+    }
+
+    order_.push_back(Entry{arguments, std::move(value)});
+    index_.emplace(std::move(arguments), std::prev(order_.end()));
+}
+
+void FunctionMemoTable::clear() {
+    index_.clear();
+    order_.clear();
+}
+
+ExprPtr FunctionMemoStore::lookup(const std::string& name, const std::vector<ExprPtr>& arguments) {
+    auto it = tables_.find(name);
+    if (it == tables_.end()) {
+        return nullptr;
+    }
+    return it->second.lookup(make_argument_key(arguments), policy_.eviction);
+}
+
+void FunctionMemoStore::store(const std::string& name, const std::vector<ExprPtr>& arguments, ExprPtr value) {
+    tables_[name].store(make_argument_key(arguments), std::move(value), policy_);
+}
+
+void FunctionMemoStore::clear(const std::string& name) {
+    tables_.erase(name);
+}
+
+void FunctionMemoStore::clear() {
+    tables_.clear();
+}
+
+std::size_t FunctionMemoStore::entry_count(const std::string& name) const {
+    auto it = tables_.find(name);
+    return it == tables_.end() ? 0 : it->second.size();
+}
+
+void FunctionMemoStore::set_policy(MemoPolicy policy) {
+    policy_ = policy;
+    // Shrinking the bound or switching policy invalidates the eviction order.
+    tables_.clear();
+}
+
+}  // namespace aleph3::kernel
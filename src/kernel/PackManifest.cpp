@@ -0,0 +1,64 @@
+#include "kernel/PackManifest.hpp"
+
+#include <utility>
+
+namespace aleph3::kernel {
+
+LazyPack::LazyPack(PackManifest manifest)
+    : manifest_(std::move(manifest)) {}
+
+ExprPtr LazyPack::dispatch(std::size_t symbol_index, const FunctionCall& call, EvaluationContext& ctx) {
+    if (!loaded()) {
+        std::call_once(load_once_, [this] { load(); });
+    }
+    return handlers_[symbol_index](call, ctx);
+}
+
+std::chrono::nanoseconds LazyPack::load_duration() const noexcept {
+    return loaded() ? load_duration_ : std::chrono::nanoseconds{0};
+}
+
+void LazyPack::load() {
+    if (!manifest_.load) {
+        throw_internal_inconsistency("Pack '" + manifest_.package_name + "' has no loader.");
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    FunctionRegistry scratch;
+    manifest_.load(scratch);
+
+    std::vector<SymbolicFunctionHandler> handlers;
+    handlers.reserve(manifest_.symbols.size());
+    for (const auto& symbol : manifest_.symbols) {
+        const auto* handler = scratch.find_symbolic_function(symbol.name);
+        if (handler == nullptr) {
+            throw_internal_inconsistency(
+                "Pack '" + manifest_.package_name + "' did not register manifest symbol '" + symbol.name + "'.");
+        }
+        handlers.push_back(*handler);
+    }
+
+    handlers_ = std::move(handlers);
+    load_duration_ = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    loaded_.store(true, std::memory_order_release);
+}
+
+std::shared_ptr<LazyPack> register_lazy_pack(FunctionRegistry& registry, PackManifest manifest) {
+    auto pack = std::make_shared<LazyPack>(std::move(manifest));
+    const auto& symbols = pack->manifest().symbols;
+    for (std::size_t index = 0; index < symbols.size(); ++index) {
+        const auto& symbol = symbols[index];
+        registry.register_pack_function(
+            pack->manifest().package_name,
+            symbol.name,
+            [pack, index](const FunctionCall& call, EvaluationContext& ctx) {
+                return pack->dispatch(index, call, ctx);
+            },
+            symbol.documentation,
+            symbol.rewrite_safe,
+            symbol.attributes);
+    }
+    return pack;
+}
+
+}  // namespace aleph3::kernel
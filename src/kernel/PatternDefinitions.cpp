@@ -0,0 +1,147 @@
+#include "kernel/PatternDefinitions.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace aleph3::kernel {
+
+namespace {
+
+enum class ArgumentPatternKind {
+    blank = 0,
+    compound = 1,
+    literal = 2
+};
+
+ArgumentPatternKind classify_argument_pattern(const ExprPtr& pattern) {
+    if (!contains_pattern_variable(pattern)) {
+        return ArgumentPatternKind::literal;
+    }
+    if (std::holds_alternative<FunctionCall>(*pattern)) {
+        return ArgumentPatternKind::compound;
+    }
+    return ArgumentPatternKind::blank;
+}
+
+std::vector<ArgumentPatternKind> specificity_of(const PatternDefinition& definition) {
+    std::vector<ArgumentPatternKind> kinds;
+    kinds.reserve(definition.arguments.size());
+    for (const auto& argument : definition.arguments) {
+        kinds.push_back(classify_argument_pattern(argument));
+    }
+    return kinds;
+}
+
+bool same_arguments(const std::vector<ExprPtr>& left, const std::vector<ExprPtr>& right) {
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (std::size_t index = 0; index < left.size(); ++index) {
+        if (!structurally_equal(left[index], right[index])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void PatternDefinitionSet::add(PatternDefinition definition) {
+    // A definition with the same argument list always lands in the same
+    // bucket, so only that bucket is searched for one to replace.
+    auto& bucket = bucket_for(definition.arguments);
+    for (const auto position : bucket) {
+        if (same_arguments(definitions_[position].arguments, definition.arguments)) {
+            definitions_[position] = std::move(definition);
+            return;
+        }
+    }
+
+    // Behind every equally or more specific definition, so ties keep the
+    // order they were added in.
+    const auto specificity = specificity_of(definition);
+    const auto position = definitions_.size();
+    definitions_.push_back(std::move(definition));
+    const auto insert_at = std::partition_point(bucket.begin(), bucket.end(), [&](std::size_t candidate) {
+        return specificity_of(definitions_[candidate]) >= specificity;
+    });
+    bucket.insert(insert_at, position);
+}
+
+std::vector<std::size_t>& PatternDefinitionSet::bucket_for(const std::vector<ExprPtr>& arguments) {
+    auto& arity_index = index_[arguments.size()];
+    if (arguments.empty()) {
+        return arity_index.blanks;
+    }
+
+    const auto& first = arguments.front();
+    switch (classify_argument_pattern(first)) {
+        case ArgumentPatternKind::literal:
+            return arity_index.literals[first];
+        case ArgumentPatternKind::compound:
+            return arity_index.heads[std::get<FunctionCall>(*first).head];
+        case ArgumentPatternKind::blank:
+            break;
+    }
+    return arity_index.blanks;
+}
+
+template <typename Visitor>
+bool PatternDefinitionSet::visit_candidates(const std::vector<ExprPtr>& arguments, Visitor&& visitor) const {
+    auto arity = index_.find(arguments.size());
+    if (arity == index_.end()) {
+        return false;
+    }
+
+    auto visit_all = [&](const std::vector<std::size_t>& positions) {
+        for (const auto position : positions) {
+            if (visitor(definitions_[position])) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // Literal, then compound, then blank first arguments, each bucket in
+    // specificity order, so the first match is the most specific one.
+    if (!arguments.empty()) {
+        const auto& first = arguments.front();
+        if (auto it = arity->second.literals.find(first); it != arity->second.literals.end()) {
+            if (visit_all(it->second)) {
+                return true;
+            }
+        }
+        if (const auto* call = std::get_if<FunctionCall>(&*first)) {
+            if (auto it = arity->second.heads.find(call->head); it != arity->second.heads.end()) {
+                if (visit_all(it->second)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return visit_all(arity->second.blanks);
+}
+
+std::optional<PatternDefinitionMatch> PatternDefinitionSet::match(const std::vector<ExprPtr>& arguments) const {
+    std::optional<PatternDefinitionMatch> result;
+    visit_candidates(arguments, [&](const PatternDefinition& definition) {
+        PatternBindingMap bindings;
+        if (!match_pattern_arguments(definition.arguments, arguments, bindings)) {
+            return false;
+        }
+        result = PatternDefinitionMatch{&definition, std::move(bindings)};
+        return true;
+    });
+    return result;
+}
+
+std::size_t PatternDefinitionSet::candidate_count(const std::vector<ExprPtr>& arguments) const {
+    std::size_t count = 0;
+    visit_candidates(arguments, [&](const PatternDefinition&) {
+        ++count;
+        return false;
+    });
+    return count;
+}
+
+}  // namespace aleph3::kernel
@@ -2,11 +2,15 @@
 
 #include "kernel/EvaluationContext.hpp"
 #include "kernel/FunctionRegistry.hpp"
+#include "expr/ExprSummary.hpp"
 #include "expr/ExprUtils.hpp"
+#include "expr/RationalAccumulator.hpp"
 #include "normalizer/Normalizer.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <functional>
 #include <limits>
 #include <map>
 #include <unordered_map>
@@ -24,8 +28,13 @@ bool is_integral(double value) {
     return std::floor(value) == value;
 }
 
+// Integral and within int64, so the cast to int64_t is defined.
+bool is_int64_integral(double value) {
+    return is_integral(value) && value >= -0x1p63 && value < 0x1p63;
+}
+
 ExprPtr clone_expr(const ExprPtr& expr) {
-    return expr == nullptr ? nullptr : std::make_shared<Expr>(*expr);
+    return expr == nullptr ? nullptr : make_expr_node(*expr);
 }
 
 void ensure_symbol_metadata(
@@ -100,64 +109,62 @@ void sync_registered_head_rewrite_metadata(
         std::move(provider));
 }
 
+// Exact coefficients accumulate unreduced and are reduced once, in to_expr.
+// A sum that no longer fits in int64 continues as a double.
 struct ScalarCoefficient {
     bool exact = true;
-    int64_t numerator = 0;
-    int64_t denominator = 1;
+    RationalAccumulator sum;
     double approximate = 0.0;
 
     void add_number(double value) {
-        if (exact && is_integral(value)) {
-            auto [nn, dd] = normalize_rational(
-                numerator + static_cast<int64_t>(value) * denominator,
-                denominator);
-            numerator = nn;
-            denominator = dd;
+        if (exact && is_int64_integral(value) && sum.add_integer(static_cast<int64_t>(value))) {
             return;
         }
 
         if (exact) {
-            approximate = static_cast<double>(numerator) / denominator;
+            approximate = sum.approximate();
             exact = false;
         }
         approximate += value;
     }
 
     void add_rational(int64_t num, int64_t den) {
-        if (exact) {
-            auto [nn, dd] = normalize_rational(
-                numerator * den + num * denominator,
-                denominator * den);
-            numerator = nn;
-            denominator = dd;
+        if (exact && sum.add(num, den)) {
             return;
         }
+
+        if (exact) {
+            approximate = sum.approximate();
+            exact = false;
+        }
         approximate += static_cast<double>(num) / den;
     }
 
     void add(const ScalarCoefficient& other) {
         if (other.exact) {
-            add_rational(other.numerator, other.denominator);
+            auto [num, den] = other.sum.reduced();
+            add_rational(num, den);
             return;
         }
         add_number(other.approximate);
     }
 
     [[nodiscard]] bool is_zero() const {
-        return exact ? numerator == 0 : approximate == 0.0;
+        return exact ? sum.is_zero() : approximate == 0.0;
     }
 
     [[nodiscard]] bool is_one() const {
         if (!exact) {
             return approximate == 1.0;
         }
-        return numerator == denominator;
+        return sum.is_one();
     }
 
     [[nodiscard]] ExprPtr to_expr() const {
         if (!exact) {
             return make_expr<Number>(approximate);
         }
+        auto [numerator, denominator] = sum.reduced();
         if (denominator == 1) {
             return make_expr<Number>(static_cast<double>(numerator));
         }
@@ -188,8 +195,11 @@ ExprPtr build_plus_bucket_expr(
     bool& changed) {
     double numeric_result = 0.0;
     bool has_rational_result = false;
-    int64_t rational_num = 0;
-    int64_t rational_den = 1;
+    // Rationals are summed unreduced and reduced once below. A sum that
+    // overflows int64 is folded into the numeric result instead, which
+    // makes the whole sum inexact.
+    bool inexact = false;
+    RationalAccumulator rational_sum;
     std::vector<ExprPtr> symbolic_terms;
 
     for (const auto& arg : args) {
@@ -204,17 +214,11 @@ ExprPtr build_plus_bucket_expr(
         }
         if (std::holds_alternative<Rational>(*arg)) {
             const auto& rational = std::get<Rational>(*arg);
-            if (!has_rational_result) {
-                rational_num = rational.numerator;
-                rational_den = rational.denominator;
-                has_rational_result = true;
-            } else {
-                auto [nn, dd] = normalize_rational(
-                    rational_num * rational.denominator + rational.numerator * rational_den,
-                    rational_den * rational.denominator);
-                rational_num = nn;
-                rational_den = dd;
+            if (!rational_sum.add(rational.numerator, rational.denominator)) {
+                numeric_result += static_cast<double>(rational.numerator) / rational.denominator;
+                inexact = true;
             }
+            has_rational_result = true;
             continue;
         }
         symbolic_terms.push_back(arg);
@@ -224,26 +228,23 @@ ExprPtr build_plus_bucket_expr(
     rebuilt_terms.reserve(symbolic_terms.size() + 1);
     rebuilt_terms.insert(rebuilt_terms.end(), symbolic_terms.begin(), symbolic_terms.end());
 
-    if (has_rational_result) {
-        if (is_integral(numeric_result)) {
-            auto [nn, dd] = normalize_rational(
-                rational_num + static_cast<int64_t>(numeric_result) * rational_den,
-                rational_den);
-            if (nn != 0) {
-                rebuilt_terms.push_back(
-                    dd == 1 ? make_expr<Number>(static_cast<double>(nn))
-                            : make_expr<Rational>(nn, dd));
-            } else {
-                changed = true;
-            }
+    RationalAccumulator combined_sum = rational_sum;
+    if (has_rational_result && !inexact && is_int64_integral(numeric_result) &&
+        combined_sum.add_integer(static_cast<int64_t>(numeric_result))) {
+        auto [nn, dd] = combined_sum.reduced();
+        if (nn != 0) {
+            rebuilt_terms.push_back(
+                dd == 1 ? make_expr<Number>(static_cast<double>(nn))
+                        : make_expr<Rational>(nn, dd));
         } else {
-            const double rational_value = static_cast<double>(rational_num) / rational_den;
-            const double combined = rational_value + numeric_result;
-            if (combined != 0.0) {
-                rebuilt_terms.push_back(make_expr<Number>(combined));
-            } else {
-                changed = true;
-            }
+            changed = true;
+        }
+    } else if (has_rational_result) {
+        const double combined = rational_sum.approximate() + numeric_result;
+        if (combined != 0.0) {
+            rebuilt_terms.push_back(make_expr<Number>(combined));
+        } else {
+            changed = true;
         }
     } else if (numeric_result != 0.0) {
         rebuilt_terms.push_back(make_expr<Number>(numeric_result));
@@ -398,8 +399,7 @@ bool extract_supported_monomial_term(
     ExprPtr basis;
     if (extract_supported_symbolic_basis(expr, basis)) {
         term.basis = basis;
-        term.coefficient.numerator = 1;
-        term.coefficient.denominator = 1;
+        term.coefficient.sum = RationalAccumulator(1, 1);
         return true;
     }
 
@@ -511,6 +511,20 @@ bool structurally_equal_impl(const Expr& left, const Expr& right) {
                        structurally_equal(lhs.rhs, rhs.rhs);
             } else if constexpr (std::is_same_v<T, List>) {
                 return structurally_equal_list(lhs.elements, rhs.elements);
+            } else if constexpr (std::is_same_v<T, Association>) {
+                // Order matters, as it does for lists.
+                if (lhs.map.size() != rhs.map.size()) {
+                    return false;
+                }
+                const auto left_entries = lhs.map.entries();
+                const auto right_entries = rhs.map.entries();
+                for (std::size_t index = 0; index < left_entries.size(); ++index) {
+                    if (!structurally_equal(left_entries[index].first, right_entries[index].first) ||
+                        !structurally_equal(left_entries[index].second, right_entries[index].second)) {
+                        return false;
+                    }
+                }
+                return true;
             } else if constexpr (std::is_same_v<T, Infinity> ||
                                  std::is_same_v<T, ComplexInfinity> ||
                                  std::is_same_v<T, Indeterminate>) {
@@ -536,6 +550,272 @@ bool structurally_equal_list(
     return true;
 }
 
+std::size_t combine_hash(std::size_t seed, std::size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+std::size_t hash_double(double value) {
+    // Keep -0.0 and 0.0 together because structural equality compares with ==.
+    return std::hash<double>{}(value == 0.0 ? 0.0 : value);
+}
+
+std::size_t structural_hash_list(std::size_t seed, const std::vector<ExprPtr>& items) {
+    seed = combine_hash(seed, items.size());
+    for (const auto& item : items) {
+        seed = combine_hash(seed, structural_hash(item));
+    }
+    return seed;
+}
+
+std::size_t structural_hash_impl(const Expr& expr) {
+    const std::size_t seed = expr.index();
+    return std::visit(
+        [&](const auto& node) -> std::size_t {
+            using T = std::decay_t<decltype(node)>;
+
+            if constexpr (std::is_same_v<T, Symbol>) {
+                return combine_hash(seed, std::hash<std::string>{}(node.name));
+            } else if constexpr (std::is_same_v<T, Number>) {
+                return combine_hash(seed, hash_double(node.value));
+            } else if constexpr (std::is_same_v<T, Complex>) {
+                return combine_hash(combine_hash(seed, hash_double(node.real)), hash_double(node.imag));
+            } else if constexpr (std::is_same_v<T, Rational>) {
+                return combine_hash(
+                    combine_hash(seed, std::hash<int64_t>{}(node.numerator)),
+                    std::hash<int64_t>{}(node.denominator));
+            } else if constexpr (std::is_same_v<T, Boolean>) {
+                return combine_hash(seed, node.value ? 1u : 0u);
+            } else if constexpr (std::is_same_v<T, String>) {
+                return combine_hash(seed, std::hash<std::string>{}(node.value));
+            } else if constexpr (std::is_same_v<T, FunctionCall>) {
+                return structural_hash_list(
+                    combine_hash(seed, std::hash<std::string>{}(node.head)),
+                    node.args);
+            } else if constexpr (std::is_same_v<T, FunctionDefinition>) {
+                std::size_t hash = combine_hash(seed, std::hash<std::string>{}(node.name));
+                hash = combine_hash(hash, node.delayed ? 1u : 0u);
+                for (const auto& param : node.params) {
+                    hash = combine_hash(hash, std::hash<std::string>{}(param.name));
+                    hash = combine_hash(hash, structural_hash(param.default_value));
+                }
+                return combine_hash(hash, structural_hash(node.body));
+            } else if constexpr (std::is_same_v<T, Assignment>) {
+                return combine_hash(
+                    combine_hash(seed, std::hash<std::string>{}(node.name)),
+                    structural_hash(node.value));
+            } else if constexpr (std::is_same_v<T, Rule>) {
+                return combine_hash(
+                    combine_hash(seed, structural_hash(node.lhs)),
+                    structural_hash(node.rhs));
+            } else if constexpr (std::is_same_v<T, List>) {
+                return structural_hash_list(seed, node.elements);
+            } else if constexpr (std::is_same_v<T, Association>) {
+                std::size_t hash = seed;
+                node.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    hash = combine_hash(combine_hash(hash, structural_hash(key)), structural_hash(value));
+                });
+                return hash;
+            } else {
+                return seed;
+            }
+        },
+        expr);
+}
+
+// Canonical-order classes, in order.
+enum class CanonicalClass { number, string, atom, compound };
+
+CanonicalClass canonical_class(const Expr& expr) {
+    if (std::holds_alternative<Number>(expr) ||
+        std::holds_alternative<Rational>(expr) ||
+        std::holds_alternative<Complex>(expr)) {
+        return CanonicalClass::number;
+    }
+    if (std::holds_alternative<String>(expr)) {
+        return CanonicalClass::string;
+    }
+    if (std::holds_alternative<Symbol>(expr) ||
+        std::holds_alternative<Boolean>(expr) ||
+        std::holds_alternative<Infinity>(expr) ||
+        std::holds_alternative<ComplexInfinity>(expr) ||
+        std::holds_alternative<Indeterminate>(expr)) {
+        return CanonicalClass::atom;
+    }
+    return CanonicalClass::compound;
+}
+
+template <typename T>
+int three_way(const T& left, const T& right) {
+    return left < right ? -1 : (right < left ? 1 : 0);
+}
+
+// Orders by value, with -0 equal to 0 and NaNs last.
+int compare_doubles(double left, double right) {
+    const bool left_nan = std::isnan(left);
+    const bool right_nan = std::isnan(right);
+    if (left_nan || right_nan) {
+        return three_way(left_nan, right_nan);
+    }
+    return three_way(left, right);
+}
+
+int compare_numbers(const Expr& left, const Expr& right) {
+    if (const auto* a = std::get_if<Rational>(&left)) {
+        if (const auto* b = std::get_if<Rational>(&right)) {
+            const auto [left_numerator, left_denominator] = normalize_rational(a->numerator, a->denominator);
+            const auto [right_numerator, right_denominator] = normalize_rational(b->numerator, b->denominator);
+            if (const int order = three_way(
+                    static_cast<__int128>(left_numerator) * right_denominator,
+                    static_cast<__int128>(right_numerator) * left_denominator);
+                order != 0) {
+                return order;
+            }
+            // Unreduced forms of one value stay apart, as they do structurally.
+            return three_way(std::pair{a->numerator, a->denominator}, std::pair{b->numerator, b->denominator});
+        }
+    }
+    auto parts = [](const Expr& expr) -> std::pair<double, double> {
+        if (const auto* number = std::get_if<Number>(&expr)) {
+            return {number->value, 0.0};
+        }
+        if (const auto* rational = std::get_if<Rational>(&expr)) {
+            return {static_cast<double>(rational->numerator) / static_cast<double>(rational->denominator), 0.0};
+        }
+        const auto& complex = std::get<Complex>(expr);
+        return {complex.real, complex.imag};
+    };
+    const auto [left_real, left_imag] = parts(left);
+    const auto [right_real, right_imag] = parts(right);
+    if (const int order = compare_doubles(left_real, right_real); order != 0) {
+        return order;
+    }
+    if (const int order = compare_doubles(left_imag, right_imag); order != 0) {
+        return order;
+    }
+    // Equal values of different kinds, such as 1/2 and 0.5.
+    return three_way(left.index(), right.index());
+}
+
+std::string canonical_atom_name(const Expr& expr) {
+    if (const auto* symbol = std::get_if<Symbol>(&expr)) {
+        return symbol->name;
+    }
+    if (const auto* boolean = std::get_if<Boolean>(&expr)) {
+        return boolean->value ? "True" : "False";
+    }
+    if (std::holds_alternative<Infinity>(expr)) {
+        return "Infinity";
+    }
+    if (std::holds_alternative<ComplexInfinity>(expr)) {
+        return "ComplexInfinity";
+    }
+    return "Indeterminate";
+}
+
+// The head and parts a compound expression is ordered by.
+std::pair<std::string, std::vector<ExprPtr>> canonical_parts(const Expr& expr) {
+    return std::visit(
+        [](const auto& node) -> std::pair<std::string, std::vector<ExprPtr>> {
+            using T = std::decay_t<decltype(node)>;
+
+            if constexpr (std::is_same_v<T, FunctionCall>) {
+                return {node.head, node.args};
+            } else if constexpr (std::is_same_v<T, List>) {
+                return {"List", node.elements};
+            } else if constexpr (std::is_same_v<T, Rule>) {
+                return {"Rule", {node.lhs, node.rhs}};
+            } else if constexpr (std::is_same_v<T, Association>) {
+                std::vector<ExprPtr> parts;
+                parts.reserve(2 * node.map.size());
+                node.map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+                    parts.push_back(key);
+                    parts.push_back(value);
+                });
+                return {"Association", std::move(parts)};
+            } else if constexpr (std::is_same_v<T, Assignment>) {
+                return {"Set", {make_expr<Symbol>(node.name), node.value}};
+            } else if constexpr (std::is_same_v<T, FunctionDefinition>) {
+                std::vector<ExprPtr> parts{make_expr<Symbol>(node.name), node.body};
+                for (const auto& param : node.params) {
+                    parts.push_back(make_expr<Symbol>(param.name));
+                    parts.push_back(param.default_value ? param.default_value : make_expr<Symbol>("Null"));
+                }
+                return {"FunctionDefinition", std::move(parts)};
+            } else {
+                return {{}, {}};
+            }
+        },
+        expr);
+}
+
+int canonical_compare_impl(const Expr& left, const Expr& right) {
+    const auto left_class = canonical_class(left);
+    const auto right_class = canonical_class(right);
+    if (left_class != right_class) {
+        return three_way(left_class, right_class);
+    }
+
+    switch (left_class) {
+        case CanonicalClass::number:
+            return compare_numbers(left, right);
+        case CanonicalClass::string:
+            return three_way(std::get<String>(left).value.str(), std::get<String>(right).value.str());
+        case CanonicalClass::atom:
+            if (const int order = three_way(canonical_atom_name(left), canonical_atom_name(right)); order != 0) {
+                return order;
+            }
+            return three_way(left.index(), right.index());
+        case CanonicalClass::compound:
+            break;
+    }
+
+    auto compare_parts = [&](const std::string& left_head,
+                             const std::vector<ExprPtr>& left_parts,
+                             const std::string& right_head,
+                             const std::vector<ExprPtr>& right_parts) {
+        if (const int order = three_way(left_head, right_head); order != 0) {
+            return order;
+        }
+        if (const int order = three_way(left_parts.size(), right_parts.size()); order != 0) {
+            return order;
+        }
+        for (std::size_t index = 0; index < left_parts.size(); ++index) {
+            if (const int order = canonical_compare(left_parts[index], right_parts[index]); order != 0) {
+                return order;
+            }
+        }
+        return three_way(left.index(), right.index());
+    };
+
+    // Calls and lists, by far the most common, are compared in place.
+    static const std::string list_head = "List";
+    auto direct_parts = [](const Expr& expr) -> std::pair<const std::string*, const std::vector<ExprPtr>*> {
+        if (const auto* call = std::get_if<FunctionCall>(&expr)) {
+            return {&call->head, &call->args};
+        }
+        if (const auto* list = std::get_if<List>(&expr)) {
+            return {&list_head, &list->elements};
+        }
+        return {nullptr, nullptr};
+    };
+    const auto [left_direct_head, left_direct_parts] = direct_parts(left);
+    const auto [right_direct_head, right_direct_parts] = direct_parts(right);
+    if (left_direct_head != nullptr && right_direct_head != nullptr) {
+        return compare_parts(*left_direct_head, *left_direct_parts, *right_direct_head, *right_direct_parts);
+    }
+
+    const auto [left_head, left_parts] = canonical_parts(left);
+    const auto [right_head, right_parts] = canonical_parts(right);
+    if (const int order = compare_parts(left_head, left_parts, right_head, right_parts); order != 0) {
+        return order;
+    }
+    // Equal parts do not make definitions with different flags equal.
+    if (const auto* definition = std::get_if<FunctionDefinition>(&left)) {
+        return three_way(definition->delayed, std::get<FunctionDefinition>(right).delayed);
+    }
+    return 0;
+}
+
 bool match_list(
     const std::vector<ExprPtr>& pattern,
     const std::vector<ExprPtr>& expr,
@@ -614,6 +894,20 @@ bool match_pattern(
                        match_pattern(lhs.rhs, rhs.rhs, bindings);
             } else if constexpr (std::is_same_v<T, List>) {
                 return match_list(lhs.elements, rhs.elements, bindings);
+            } else if constexpr (std::is_same_v<T, Association>) {
+                // Keys match literally; values may hold patterns.
+                if (lhs.map.size() != rhs.map.size()) {
+                    return false;
+                }
+                const auto pattern_entries = lhs.map.entries();
+                const auto expr_entries = rhs.map.entries();
+                for (std::size_t index = 0; index < pattern_entries.size(); ++index) {
+                    if (!structurally_equal(pattern_entries[index].first, expr_entries[index].first) ||
+                        !match_pattern(pattern_entries[index].second, expr_entries[index].second, bindings)) {
+                        return false;
+                    }
+                }
+                return true;
             } else if constexpr (std::is_same_v<T, Infinity> ||
                                  std::is_same_v<T, ComplexInfinity> ||
                                  std::is_same_v<T, Indeterminate>) {
@@ -665,7 +959,7 @@ ExprPtr substitute_pattern_bindings(const ExprPtr& expr, const PatternBindings&
                 for (const auto& element : node.elements) {
                     elements.push_back(substitute_pattern_bindings(element, bindings));
                 }
-                return std::make_shared<Expr>(List{elements});
+                return make_expr_node(List{elements});
             } else if constexpr (std::is_same_v<T, Rule>) {
                 return make_expr<Rule>(
                     substitute_pattern_bindings(node.lhs, bindings),
@@ -743,7 +1037,7 @@ RewriteResult rewrite_once_impl(const ExprPtr& expr, const Rule& rule) {
                     return RewriteResult{expr, false, 0};
                 }
                 RewriteResult result;
-                result.expr = std::make_shared<Expr>(List{rewritten_elements});
+                result.expr = make_expr_node(List{rewritten_elements});
                 result.changed = true;
                 result.rewrites_applied = rewrites_applied;
                 return result;
@@ -827,11 +1121,85 @@ bool structurally_equal(const ExprPtr& left, const ExprPtr& right) {
     return structurally_equal_impl(*left, *right);
 }
 
+std::size_t structural_hash(const ExprPtr& expr) {
+    if (expr == nullptr) {
+        return 0;
+    }
+    return structural_hash_impl(*expr);
+}
+
+int canonical_compare(const ExprPtr& left, const ExprPtr& right) {
+    if (left == right) {
+        return 0;
+    }
+    if (left == nullptr || right == nullptr) {
+        return left == nullptr ? -1 : 1;
+    }
+    return canonical_compare_impl(*left, *right);
+}
+
 bool matches_pattern(const ExprPtr& pattern, const ExprPtr& expr) {
     PatternBindings bindings;
     return match_pattern(pattern, expr, bindings);
 }
 
+bool match_pattern_arguments(
+    const std::vector<ExprPtr>& patterns,
+    const std::vector<ExprPtr>& exprs,
+    PatternBindingMap& bindings) {
+    return match_list(patterns, exprs, bindings);
+}
+
+bool contains_pattern_variable(const ExprPtr& expr) {
+    if (expr == nullptr || !expr_summary(expr).has_symbols) {
+        return false;
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        return is_pattern_symbol_name(symbol->name);
+    }
+    if (const auto* func = std::get_if<FunctionCall>(&*expr)) {
+        for (const auto& arg : func->args) {
+            if (contains_pattern_variable(arg)) {
+                return true;
+            }
+        }
+    }
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        for (const auto& element : list->elements) {
+            if (contains_pattern_variable(element)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void collect_pattern_variable_names(const ExprPtr& expr, std::vector<std::string>& names) {
+    if (expr == nullptr) {
+        return;
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        if (is_pattern_symbol_name(symbol->name)) {
+            auto name = pattern_binding_name(symbol->name);
+            if (!name.empty() && std::find(names.begin(), names.end(), name) == names.end()) {
+                names.push_back(std::move(name));
+            }
+        }
+        return;
+    }
+    if (const auto* func = std::get_if<FunctionCall>(&*expr)) {
+        for (const auto& arg : func->args) {
+            collect_pattern_variable_names(arg, names);
+        }
+        return;
+    }
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        for (const auto& element : list->elements) {
+            collect_pattern_variable_names(element, names);
+        }
+    }
+}
+
 RewriteResult rewrite_once(const ExprPtr& expr, const Rule& rule) {
     auto result = rewrite_once_impl(expr, rule);
     if (result.expr == nullptr) {
@@ -0,0 +1,153 @@
+#include "kernel/StringReplacement.hpp"
+
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+namespace aleph3::kernel {
+
+namespace {
+
+// Distinct rule lists kept compiled at once; the cache is dropped wholesale
+// when full, as MemoEvictionPolicy::clear_when_full does.
+constexpr std::size_t max_cached_replacers = 64;
+
+struct RuleListHash {
+    std::size_t operator()(const std::vector<StringReplacementRule>& rules) const noexcept {
+        std::size_t seed = rules.size();
+        std::hash<std::string> hash;
+        for (const auto& rule : rules) {
+            seed ^= hash(rule.pattern) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+            seed ^= hash(rule.replacement) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+}  // namespace
+
+StringReplacer::StringReplacer(std::vector<StringReplacementRule> rules)
+    : rules_(std::move(rules)) {
+    // Trie of all patterns, state 0 being the root.
+    transitions_.assign(alphabet_size, no_rule);
+    terminal_rule_.push_back(no_rule);
+    for (std::size_t index = 0; index < rules_.size(); ++index) {
+        const auto& pattern = rules_[index].pattern;
+        if (pattern.empty()) {
+            continue;
+        }
+        std::int32_t state = 0;
+        for (const auto byte : pattern) {
+            auto& slot = transitions_[static_cast<std::size_t>(state) * alphabet_size + static_cast<unsigned char>(byte)];
+            if (slot == no_rule) {
+                slot = static_cast<std::int32_t>(terminal_rule_.size());
+                terminal_rule_.push_back(no_rule);
+                transitions_.resize(transitions_.size() + alphabet_size, no_rule);
+            }
+            state = slot;
+        }
+        if (terminal_rule_[state] == no_rule) {
+            terminal_rule_[state] = static_cast<std::int32_t>(index);
+        }
+    }
+
+    // Breadth-first pass: fill missing transitions from the failure state and
+    // link each state to the nearest suffix state that ends a pattern.
+    std::vector<std::int32_t> failure(terminal_rule_.size(), 0);
+    output_link_.assign(terminal_rule_.size(), -1);
+    std::queue<std::int32_t> pending;
+    for (std::size_t byte = 0; byte < alphabet_size; ++byte) {
+        auto& slot = transitions_[byte];
+        if (slot == no_rule) {
+            slot = 0;
+        } else {
+            pending.push(slot);
+        }
+    }
+    while (!pending.empty()) {
+        const auto state = pending.front();
+        pending.pop();
+        const auto fallback = failure[state];
+        output_link_[state] = terminal_rule_[fallback] != no_rule ? fallback : output_link_[fallback];
+        for (std::size_t byte = 0; byte < alphabet_size; ++byte) {
+            auto& slot = transitions_[static_cast<std::size_t>(state) * alphabet_size + byte];
+            const auto fallback_next = transitions_[static_cast<std::size_t>(fallback) * alphabet_size + byte];
+            if (slot == no_rule) {
+                slot = fallback_next;
+            } else {
+                failure[slot] = fallback_next;
+                pending.push(slot);
+            }
+        }
+    }
+}
+
+std::string StringReplacer::apply(std::string_view input) const {
+    // First pass: for every start position, the lowest-index rule matching
+    // there. Each reported match is visited once.
+    std::vector<std::int32_t> rule_at(input.size(), no_rule);
+    std::int32_t state = 0;
+    for (std::size_t position = 0; position < input.size(); ++position) {
+        state = next_state(state, static_cast<unsigned char>(input[position]));
+        for (auto match = terminal_rule_[state] != no_rule ? state : output_link_[state]; match != -1;
+             match = output_link_[match]) {
+            const auto rule = terminal_rule_[match];
+            const auto start = position + 1 - rules_[rule].pattern.size();
+            if (rule_at[start] == no_rule || rule < rule_at[start]) {
+                rule_at[start] = rule;
+            }
+        }
+    }
+
+    // Second pass: choose non-overlapping matches left to right and size the
+    // output exactly before building it.
+    std::vector<std::pair<std::size_t, std::int32_t>> chosen;
+    std::size_t output_size = 0;
+    for (std::size_t position = 0; position < input.size();) {
+        if (const auto rule = rule_at[position]; rule != no_rule) {
+            chosen.emplace_back(position, rule);
+            output_size += rules_[rule].replacement.size();
+            position += rules_[rule].pattern.size();
+        } else {
+            ++output_size;
+            ++position;
+        }
+    }
+
+    std::string output;
+    output.reserve(output_size);
+    std::size_t copied = 0;
+    for (const auto& [position, rule] : chosen) {
+        output.append(input.substr(copied, position - copied));
+        output.append(rules_[rule].replacement);
+        copied = position + rules_[rule].pattern.size();
+    }
+    output.append(input.substr(copied));
+    return output;
+}
+
+std::shared_ptr<const StringReplacer> cached_string_replacer(const std::vector<StringReplacementRule>& rules) {
+    static std::mutex mutex;
+    static std::unordered_map<std::vector<StringReplacementRule>, std::shared_ptr<const StringReplacer>, RuleListHash>
+        cache;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto it = cache.find(rules); it != cache.end()) {
+            return it->second;
+        }
+    }
+
+    // Compile outside the lock; a racing caller may compile the same list,
+    // and the first one stored wins.
+    auto replacer = std::make_shared<const StringReplacer>(rules);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (cache.size() >= max_cached_replacers) {
+        cache.clear();
+    }
+    return cache.try_emplace(rules, std::move(replacer)).first->second;
+}
+
+}  // namespace aleph3::kernel
@@ -3,12 +3,20 @@
 #include "evaluator/BuiltInFunctions.hpp"
 #include "evaluator/Evaluator.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
+#include "evaluator/EvaluatorSemantics.hpp"
+#include "expr/ExprSummary.hpp"
 #include "kernel/Diagnostics.hpp"
 #include "kernel/EvaluationContext.hpp"
+#include "kernel/Rewrite.hpp"
+#include "normalizer/Normalizer.hpp"
 
+#include <algorithm>
+#include <charconv>
 #include <cmath>
 #include <optional>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
 namespace aleph3::kernel {
@@ -34,7 +42,7 @@ std::optional<Value> expr_to_sdk_value(const ExprPtr& expr) {
         return Value(boolean->value);
     }
     if (const auto* string = std::get_if<String>(&*expr)) {
-        return Value(string->value);
+        return Value(string->value.str());
     }
     if (const auto* list = std::get_if<List>(&*expr)) {
         Value::List values;
@@ -48,6 +56,24 @@ std::optional<Value> expr_to_sdk_value(const ExprPtr& expr) {
         }
         return Value(std::move(values));
     }
+    if (const auto* assoc = std::get_if<Association>(&*expr)) {
+        Value::Association entries;
+        entries.reserve(assoc->map.size());
+        bool convertible = true;
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            auto converted_key = convertible ? expr_to_sdk_value(key) : std::nullopt;
+            auto converted_value = converted_key ? expr_to_sdk_value(value) : std::nullopt;
+            if (!converted_value) {
+                convertible = false;
+                return;
+            }
+            entries.emplace_back(std::move(*converted_key), std::move(*converted_value));
+        });
+        if (!convertible) {
+            return std::nullopt;
+        }
+        return Value(std::move(entries));
+    }
 
     return std::nullopt;
 }
@@ -68,21 +94,393 @@ ExprPtr sdk_value_to_expr(const Value& value) {
         for (const auto& element : *list) {
             elements.push_back(sdk_value_to_expr(element));
         }
-        return std::make_shared<Expr>(List{elements});
+        return make_expr_node(List{elements});
+    }
+    if (const auto* association = value.as_association()) {
+        // Straight into the kernel's hash table; no rule list in between.
+        std::vector<std::pair<ExprPtr, ExprPtr>> entries;
+        entries.reserve(association->size());
+        for (const auto& [key, entry] : *association) {
+            entries.emplace_back(sdk_value_to_expr(key), sdk_value_to_expr(entry));
+        }
+        return make_expr<Association>(AssociationMap::from_entries(entries));
     }
     return make_expr<Indeterminate>();
 }
 
+// Identifiers cannot contain `$`, so slots never collide with variables.
+std::string slot_symbol(std::size_t index) {
+    return "$" + std::to_string(index + 1);
+}
+
+// The variable a symbol of the formula reads.
+const std::string& variable_name(const std::string& symbol, std::span<const std::string> slots) {
+    if (slots.empty() || symbol.size() < 2 || symbol.front() != '$') {
+        return symbol;
+    }
+    std::size_t slot = 0;
+    const auto [end, error] = std::from_chars(symbol.data() + 1, symbol.data() + symbol.size(), slot);
+    if (error != std::errc{} || end != symbol.data() + symbol.size() || slot == 0 || slot > slots.size()) {
+        return symbol;
+    }
+    return slots[slot - 1];
+}
+
 void seed_kernel_symbols(
     EvaluationContext& ctx,
     const Bindings& constants,
-    const Bindings& bindings) {
-    for (const auto& [name, value] : constants) {
-        ctx.symbol_values.set(name, sdk_value_to_expr(value));
+    const Bindings& bindings,
+    std::span<const std::string> slots = {}) {
+    if (slots.empty()) {
+        for (const auto& [name, value] : constants) {
+            ctx.symbol_values.set(name, sdk_value_to_expr(value));
+        }
+        for (const auto& [name, value] : bindings) {
+            ctx.symbol_values.set(name, sdk_value_to_expr(value));
+        }
+        return;
+    }
+
+    for (std::size_t index = 0; index < slots.size(); ++index) {
+        const auto& name = slots[index];
+        ExprPtr value;
+        if (const auto binding = bindings.find(name); binding != bindings.end()) {
+            value = sdk_value_to_expr(binding->second);
+        } else if (const auto constant = constants.find(name); constant != constants.end()) {
+            value = sdk_value_to_expr(constant->second);
+        } else {
+            // Reading the slot then reports the missing variable by name.
+            value = make_expr<Symbol>(name);
+        }
+        ctx.symbol_values.set(slot_symbol(index), std::move(value));
+    }
+}
+
+bool is_numeric_symbol(const std::string& name, const EvaluationContext& ctx) {
+    const ExprPtr* value = ctx.symbol_values.lookup(name);
+    return value != nullptr && std::holds_alternative<Number>(**value);
+}
+
+// True when every call in the formula is a listable numeric builtin and every
+// symbol is a sampled column or a numeric binding, so binding the columns as
+// lists evaluates all rows in one pass.
+bool is_columnar_formula(
+    const ExprPtr& expr,
+    const std::unordered_set<std::string>& columns,
+    const EvaluationContext& ctx,
+    const HostFunctionRegistry& host_functions) {
+    if (std::holds_alternative<Number>(*expr) || std::holds_alternative<Rational>(*expr)) {
+        return true;
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        return columns.contains(symbol->name) || is_numeric_symbol(symbol->name, ctx);
+    }
+    const auto* call = std::get_if<FunctionCall>(&*expr);
+    if (call == nullptr || host_functions.contains(call->head) ||
+        !is_listable_function(call->head) || !is_numeric_function(call->head)) {
+        return false;
+    }
+    for (const auto& arg : call->args) {
+        if (!is_columnar_formula(arg, columns, ctx, host_functions)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<double> finite_result(const ExprPtr& expr) {
+    auto value = expr_to_sdk_value(expr);
+    const auto* number = value ? value->as_number() : nullptr;
+    if (number == nullptr || !std::isfinite(*number)) {
+        return std::nullopt;
+    }
+    return *number;
+}
+
+// All rows at once, in a lenient context so the fused listable path applies;
+// nullopt whenever that fails or the result is not a finite number per row,
+// so the strict row path decides what went wrong.
+std::optional<std::vector<double>> evaluate_columns(
+    const ExprPtr& kernel_expr,
+    const TrustedSubsetSampleColumns& samples,
+    EvaluationContext& ctx) {
+    const std::size_t rows = samples.size();
+    try {
+        for (std::size_t column = 0; column < samples.columns.size(); ++column) {
+            std::vector<ExprPtr> elements;
+            elements.reserve(rows);
+            for (const double value : samples.columns[column]) {
+                elements.push_back(make_expr<Number>(value));
+            }
+            ctx.symbol_values.set(samples.variables[column], make_expr_node(List{std::move(elements)}));
+        }
+
+        const auto result = evaluate(kernel_expr, ctx);
+        if (const auto scalar = finite_result(result)) {
+            return std::vector<double>(rows, *scalar);
+        }
+        const auto* list = std::get_if<List>(&*result);
+        if (list == nullptr || list->elements.size() != rows) {
+            return std::nullopt;
+        }
+        std::vector<double> values;
+        values.reserve(rows);
+        for (const auto& element : list->elements) {
+            const auto value = finite_result(element);
+            if (!value) {
+                return std::nullopt;
+            }
+            values.push_back(*value);
+        }
+        return values;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+// Strict evaluation of rows [batch.values.size(), end), stopping at the first
+// failure.
+void evaluate_rows(
+    const ExprPtr& kernel_expr,
+    const TrustedSubsetSampleColumns& samples,
+    std::size_t end,
+    EvaluationContext& ctx,
+    TrustedSubsetBatchResult& batch) {
+    for (std::size_t row = batch.values.size(); row < end; ++row) {
+        try {
+            ctx.reset_runtime_step_counter();
+            for (std::size_t column = 0; column < samples.columns.size(); ++column) {
+                ctx.symbol_values.set(samples.variables[column], make_expr<Number>(samples.columns[column][row]));
+            }
+            const auto result = evaluate(kernel_expr, ctx);
+            auto value = expr_to_sdk_value(result);
+            const auto* number = value ? value->as_number() : nullptr;
+            if (number == nullptr) {
+                batch.error = make_runtime_error(ErrorCode::type_mismatch, "Formula did not evaluate to a number.");
+                return;
+            }
+            batch.values.push_back(*number);
+        } catch (const RuntimeFailure& failure) {
+            batch.error = failure.error();
+            return;
+        } catch (const EvaluatorError& error) {
+            batch.error = make_runtime_error(error.code(), error.what());
+            return;
+        } catch (const std::runtime_error& error) {
+            batch.error = make_runtime_error(ErrorCode::internal_inconsistency, error.what());
+            return;
+        }
+    }
+}
+
+// Numbers, booleans, strings, and lists and associations of them: what a
+// specialized formula may hold in place of the work that produced it.
+bool is_value(const ExprPtr& expr) {
+    if (std::holds_alternative<Number>(*expr) || std::holds_alternative<Rational>(*expr) ||
+        std::holds_alternative<Boolean>(*expr) || std::holds_alternative<String>(*expr)) {
+        return true;
+    }
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        return std::all_of(list->elements.begin(), list->elements.end(), is_value);
     }
-    for (const auto& [name, value] : bindings) {
-        ctx.symbol_values.set(name, sdk_value_to_expr(value));
+    if (const auto* assoc = std::get_if<Association>(&*expr)) {
+        bool values = true;
+        assoc->map.for_each([&](const ExprPtr& key, const ExprPtr& value) {
+            values = values && is_value(key) && is_value(value);
+        });
+        return values;
     }
+    return false;
+}
+
+class FormulaSpecializer {
+public:
+    FormulaSpecializer(
+        const Bindings& fixed_bindings,
+        const Bindings& constants,
+        const HostFunctionRegistry& host_functions,
+        const FunctionRegistry& function_registry,
+        const Policy& policy,
+        std::span<const std::string> slots)
+        : fixed_bindings_(fixed_bindings),
+          constants_(constants),
+          host_functions_(host_functions),
+          slots_(slots),
+          ctx_(fixed_bindings, constants, host_functions, policy, function_registry) {
+        ctx_.enable_runtime_strict_semantics(true);
+    }
+
+    ExprPtr specialize(const ExprPtr& expr) {
+        if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+            return fixed_value(symbol->name).value_or(expr);
+        }
+        if (const auto* list = std::get_if<List>(&*expr)) {
+            auto elements = list->elements;
+            return specialize_parts(elements, 0) ? make_expr_node(List{std::move(elements)}) : expr;
+        }
+        const auto* call = std::get_if<FunctionCall>(&*expr);
+        if (call == nullptr) {
+            return expr;
+        }
+
+        auto args = call->args;
+        bool changed = false;
+        std::size_t first = 0;
+        if (call->head == "If" && args.size() == 3) {
+            args[0] = specialize(args[0]);
+            if (const auto* selected = std::get_if<Boolean>(&*args[0])) {
+                return specialize(args[selected->value ? 1 : 2]);
+            }
+            changed = args[0] != call->args[0];
+            first = 1;
+        }
+        changed = specialize_parts(args, first) || changed;
+        return fold(changed ? make_expr<FunctionCall>(call->head, args) : expr, args);
+    }
+
+private:
+    std::optional<ExprPtr> fixed_value(const std::string& symbol) const {
+        const auto& name = variable_name(symbol, slots_);
+        // Bindings shadow constants, as when evaluating.
+        if (const auto binding = fixed_bindings_.find(name); binding != fixed_bindings_.end()) {
+            return sdk_value_to_expr(binding->second);
+        }
+        if (const auto constant = constants_.find(name); constant != constants_.end()) {
+            return sdk_value_to_expr(constant->second);
+        }
+        return std::nullopt;
+    }
+
+    // Specializes parts[first..]; true when any of them changed.
+    bool specialize_parts(std::vector<ExprPtr>& parts, std::size_t first) {
+        bool changed = false;
+        for (std::size_t index = first; index < parts.size(); ++index) {
+            auto specialized = specialize(parts[index]);
+            changed = changed || specialized != parts[index];
+            parts[index] = std::move(specialized);
+        }
+        return changed;
+    }
+
+    ExprPtr fold(const ExprPtr& call, const std::vector<ExprPtr>& args) {
+        const auto& head = std::get<FunctionCall>(*call).head;
+        const auto* host = FunctionRegistry::find_host_function(host_functions_, head);
+        if ((host != nullptr && host->purity != HostFunctionPurity::pure) ||
+            !std::all_of(args.begin(), args.end(), is_value)) {
+            return call;
+        }
+        try {
+            ctx_.reset_runtime_step_counter();
+            auto result = evaluate(call, ctx_);
+            return is_value(result) ? result : call;
+        } catch (const std::exception&) {
+            return call;
+        }
+    }
+
+    const Bindings& fixed_bindings_;
+    const Bindings& constants_;
+    const HostFunctionRegistry& host_functions_;
+    std::span<const std::string> slots_;
+    EvaluationContext ctx_;
+};
+
+void collect_formula_variables(
+    const ExprPtr& expr,
+    const Bindings& constants,
+    std::span<const std::string> slots,
+    std::vector<std::string>& names) {
+    if (!expr_summary(expr).has_symbols) {
+        return;
+    }
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        const auto& name = variable_name(symbol->name, slots);
+        if (!constants.contains(name)) {
+            names.push_back(name);
+        }
+    } else if (const auto* call = std::get_if<FunctionCall>(&*expr)) {
+        for (const auto& arg : call->args) {
+            collect_formula_variables(arg, constants, slots, names);
+        }
+    } else if (const auto* list = std::get_if<List>(&*expr)) {
+        for (const auto& element : list->elements) {
+            collect_formula_variables(element, constants, slots, names);
+        }
+    }
+}
+
+// An operand and its shape: the operand with every variable replaced by one
+// placeholder, which is what Plus and Times operands are sorted by.
+struct ShapedExpr {
+    ExprPtr expr;
+    ExprPtr shape;
+};
+
+ShapedExpr sort_orderless_operands(const ExprPtr& expr) {
+    if (std::holds_alternative<Symbol>(*expr)) {
+        return {expr, make_expr<Symbol>("$")};
+    }
+    std::vector<ShapedExpr> parts;
+    const auto* call = std::get_if<FunctionCall>(&*expr);
+    const auto* list = std::get_if<List>(&*expr);
+    if (call == nullptr && list == nullptr) {
+        return {expr, expr};
+    }
+    for (const auto& part : call != nullptr ? call->args : list->elements) {
+        parts.push_back(sort_orderless_operands(part));
+    }
+
+    if (call != nullptr && is_orderless_function(call->head) &&
+        (call->head == "Plus" || call->head == "Times")) {
+        const bool plus = call->head == "Plus";
+        // Stable, so operands of the same shape keep their order and the
+        // slots then number them the same way in every formula.
+        std::stable_sort(parts.begin(), parts.end(), [plus](const ShapedExpr& left, const ShapedExpr& right) {
+            return plus ? detail::canonical_plus_term_less(left.shape, right.shape)
+                        : detail::canonical_times_factor_less(left.shape, right.shape);
+        });
+    }
+
+    std::vector<ExprPtr> exprs;
+    std::vector<ExprPtr> shapes;
+    for (auto& part : parts) {
+        exprs.push_back(std::move(part.expr));
+        shapes.push_back(std::move(part.shape));
+    }
+    if (list != nullptr) {
+        return {make_expr_node(List{std::move(exprs)}), make_expr_node(List{std::move(shapes)})};
+    }
+    return {make_expr<FunctionCall>(call->head, exprs), make_expr<FunctionCall>(call->head, shapes)};
+}
+
+ExprPtr assign_slots(
+    const ExprPtr& expr,
+    std::unordered_map<std::string, std::size_t>& slot_of,
+    std::vector<std::string>& slots) {
+    if (const auto* symbol = std::get_if<Symbol>(&*expr)) {
+        const auto [slot, added] = slot_of.try_emplace(symbol->name, slots.size());
+        if (added) {
+            slots.push_back(symbol->name);
+        }
+        return make_expr<Symbol>(slot_symbol(slot->second));
+    }
+    if (const auto* call = std::get_if<FunctionCall>(&*expr)) {
+        std::vector<ExprPtr> args;
+        args.reserve(call->args.size());
+        for (const auto& arg : call->args) {
+            args.push_back(assign_slots(arg, slot_of, slots));
+        }
+        return make_expr<FunctionCall>(call->head, args);
+    }
+    if (const auto* list = std::get_if<List>(&*expr)) {
+        std::vector<ExprPtr> elements;
+        elements.reserve(list->elements.size());
+        for (const auto& element : list->elements) {
+            elements.push_back(assign_slots(element, slot_of, slots));
+        }
+        return make_expr_node(List{std::move(elements)});
+    }
+    return expr;
 }
 
 }  // namespace
@@ -98,13 +496,25 @@ StagedTrustedSubsetFormula stage_trusted_subset_formula(const ir::NodePtr& root)
     return staged;
 }
 
+CanonicalTrustedSubsetFormula canonicalize_trusted_subset_formula(const ExprPtr& kernel_expr) {
+    CanonicalTrustedSubsetFormula canonical;
+    if (kernel_expr == nullptr) {
+        return canonical;
+    }
+    std::unordered_map<std::string, std::size_t> slot_of;
+    canonical.body = assign_slots(sort_orderless_operands(kernel_expr).expr, slot_of, canonical.slots);
+    return canonical;
+}
+
 EvaluationResult evaluate_trusted_subset_formula(
     const ExprPtr& kernel_expr,
     const Bindings& bindings,
     const Bindings& constants,
     const HostFunctionRegistry& host_functions,
     const FunctionRegistry& function_registry,
-    const Policy& policy) {
+    const Policy& policy,
+    ExprReclaimer* reclaimer,
+    std::span<const std::string> slots) {
     if (kernel_expr == nullptr) {
         EvaluationResult result;
         result.error = make_runtime_error(
@@ -117,10 +527,13 @@ EvaluationResult evaluate_trusted_subset_formula(
         EvaluationContext ctx(bindings, constants, host_functions, policy, function_registry);
         ctx.enable_runtime_strict_semantics(true);
         ctx.reset_runtime_step_counter();
-        seed_kernel_symbols(ctx, constants, bindings);
+        seed_kernel_symbols(ctx, constants, bindings, slots);
 
         auto result_expr = evaluate(kernel_expr, ctx);
         auto value = expr_to_sdk_value(result_expr);
+        if (reclaimer != nullptr) {
+            reclaimer->retire(std::move(result_expr));
+        }
         if (value.has_value()) {
             EvaluationResult result;
             result.value = std::move(*value);
@@ -158,4 +571,87 @@ EvaluationResult evaluate_trusted_subset_formula(
         policy);
 }
 
+TrustedSubsetBatchResult evaluate_trusted_subset_batch(
+    const ExprPtr& kernel_expr,
+    const TrustedSubsetSampleColumns& samples,
+    const Bindings& bindings,
+    const Bindings& constants,
+    const HostFunctionRegistry& host_functions,
+    const FunctionRegistry& function_registry,
+    const Policy& policy,
+    std::span<const std::string> slots) {
+    TrustedSubsetBatchResult batch;
+    if (kernel_expr == nullptr) {
+        batch.error = make_runtime_error(
+            ErrorCode::internal_inconsistency,
+            "Compiled formula is missing its lowered kernel expression.");
+        return batch;
+    }
+
+    // Work happens only in forked worker contexts, which never stamp the
+    // shared formula nodes, so concurrent batches do not interfere.
+    EvaluationContext root(bindings, constants, host_functions, policy, function_registry);
+    seed_kernel_symbols(root, constants, bindings, slots);
+    auto lenient = root.fork_parallel_worker();
+    root.enable_runtime_strict_semantics(true);
+    auto ctx = root.fork_parallel_worker();
+    batch.values.reserve(samples.size());
+
+    // Columns are bound to the slots of the variables they sample.
+    auto sampled = samples;
+    for (auto& variable : sampled.variables) {
+        const auto slot = std::find(slots.begin(), slots.end(), variable);
+        if (slot != slots.end()) {
+            variable = slot_symbol(static_cast<std::size_t>(slot - slots.begin()));
+        }
+    }
+
+    const std::unordered_set<std::string> columns(sampled.variables.begin(), sampled.variables.end());
+    if (samples.size() > 1 && is_columnar_formula(kernel_expr, columns, root, host_functions)) {
+        // The lenient pass neither counts steps nor applies the strict
+        // checks. The step count of such a formula follows its shape, not the
+        // sampled values, so one strict row stands in for the budget; any row
+        // the strict checks would reject is not a finite number in the pass.
+        evaluate_rows(kernel_expr, sampled, 1, ctx, batch);
+        if (batch.error) {
+            return batch;
+        }
+        if (auto values = evaluate_columns(kernel_expr, sampled, lenient)) {
+            batch.values = std::move(*values);
+            return batch;
+        }
+    }
+
+    evaluate_rows(kernel_expr, sampled, samples.size(), ctx, batch);
+    return batch;
+}
+
+ExprPtr specialize_trusted_subset_formula(
+    const ExprPtr& kernel_expr,
+    const Bindings& fixed_bindings,
+    const Bindings& constants,
+    const HostFunctionRegistry& host_functions,
+    const FunctionRegistry& function_registry,
+    const Policy& policy,
+    std::span<const std::string> slots) {
+    if (kernel_expr == nullptr) {
+        return kernel_expr;
+    }
+    FormulaSpecializer specializer(fixed_bindings, constants, host_functions, function_registry, policy, slots);
+    return specializer.specialize(kernel_expr);
+}
+
+std::vector<std::string> trusted_subset_formula_variables(
+    const ExprPtr& kernel_expr,
+    const Bindings& constants,
+    std::span<const std::string> slots) {
+    std::vector<std::string> names;
+    if (kernel_expr != nullptr) {
+        collect_formula_variables(kernel_expr, constants, slots, names);
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
 }  // namespace aleph3::kernel
@@ -0,0 +1,124 @@
+#include "kernel/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace aleph3::kernel {
+
+namespace {
+
+// Enough chunks per thread that an unlucky share can be rebalanced, few
+// enough that the deque locks stay cold.
+constexpr std::size_t chunks_per_thread = 8;
+
+struct TaskRange {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+class WorkQueue {
+public:
+    void push(TaskRange range) {
+        ranges_.push_back(range);
+    }
+
+    std::optional<TaskRange> pop_back() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ranges_.empty()) {
+            return std::nullopt;
+        }
+        auto range = ranges_.back();
+        ranges_.pop_back();
+        return range;
+    }
+
+    std::optional<TaskRange> steal_front() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ranges_.empty()) {
+            return std::nullopt;
+        }
+        auto range = ranges_.front();
+        ranges_.pop_front();
+        return range;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<TaskRange> ranges_;
+};
+
+}  // namespace
+
+std::size_t hardware_thread_count() noexcept {
+    const auto count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+void run_work_stealing(
+    std::size_t task_count,
+    std::size_t thread_count,
+    const std::function<void(std::size_t)>& task) {
+    if (thread_count == 0) {
+        thread_count = hardware_thread_count();
+    }
+    thread_count = std::min(thread_count, task_count);
+    if (thread_count <= 1) {
+        for (std::size_t index = 0; index < task_count; ++index) {
+            task(index);
+        }
+        return;
+    }
+
+    const auto chunk_count = std::min(task_count, thread_count * chunks_per_thread);
+    const auto chunk_size = (task_count + chunk_count - 1) / chunk_count;
+    std::vector<WorkQueue> queues(thread_count);
+    for (std::size_t chunk = 0, begin = 0; begin < task_count; ++chunk, begin += chunk_size) {
+        const auto owner = chunk * thread_count / chunk_count;
+        queues[owner].push(TaskRange{begin, std::min(begin + chunk_size, task_count)});
+    }
+
+    std::vector<std::exception_ptr> failures(thread_count);
+    auto work = [&](std::size_t self) {
+        try {
+            // Nothing is enqueued once workers start, so a full sweep that
+            // finds every queue empty means this worker is done.
+            while (true) {
+                auto range = queues[self].pop_back();
+                for (std::size_t offset = 1; !range && offset < thread_count; ++offset) {
+                    range = queues[(self + offset) % thread_count].steal_front();
+                }
+                if (!range) {
+                    return;
+                }
+                for (auto index = range->begin; index < range->end; ++index) {
+                    task(index);
+                }
+            }
+        } catch (...) {
+            failures[self] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (std::size_t worker = 1; worker < thread_count; ++worker) {
+        threads.emplace_back(work, worker);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+}
+
+}  // namespace aleph3::kernel
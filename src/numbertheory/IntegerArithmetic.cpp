@@ -0,0 +1,239 @@
+#include "numbertheory/IntegerArithmetic.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace aleph3 {
+
+namespace {
+
+using u128 = unsigned __int128;
+
+// Bases that make Miller-Rabin deterministic for every 64-bit input.
+constexpr uint64_t kMillerRabinBases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+constexpr uint64_t kSmallPrimes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+// Odd trial divisors up to this bound are removed before Pollard-Brent.
+constexpr uint64_t kTrialDivisionBound = 1 << 10;
+
+// Steps between gcds in Brent's cycle search.
+constexpr uint64_t kBrentBatch = 128;
+
+uint64_t absolute_difference(uint64_t left, uint64_t right) noexcept {
+    return left > right ? left - right : right - left;
+}
+
+bool miller_rabin_witness(const MontgomeryModulus& mont, uint64_t base, uint64_t odd_part, unsigned twos) {
+    const uint64_t n = mont.modulus();
+    const uint64_t minus_one = mont.to_montgomery(n - 1);
+    uint64_t x = mont.power(mont.to_montgomery(base), odd_part);
+    if (x == mont.one() || x == minus_one) {
+        return false;
+    }
+    for (unsigned i = 1; i < twos; ++i) {
+        x = mont.multiply(x, x);
+        if (x == minus_one) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A nontrivial factor of an odd composite n.
+uint64_t pollard_brent(uint64_t n) {
+    const MontgomeryModulus mont(n);
+    for (uint64_t c = 1;; ++c) {
+        const uint64_t increment = mont.to_montgomery(c);
+        auto step = [&](uint64_t x) { return mont.add(mont.multiply(x, x), increment); };
+
+        uint64_t y = mont.to_montgomery(2);
+        uint64_t x = y;
+        uint64_t saved = y;
+        uint64_t product = mont.one();
+        uint64_t divisor = 1;
+        for (uint64_t run = 1; divisor == 1; run *= 2) {
+            x = y;
+            for (uint64_t i = 0; i < run; ++i) {
+                y = step(y);
+            }
+            for (uint64_t done = 0; done < run && divisor == 1; done += kBrentBatch) {
+                saved = y;
+                const auto batch = std::min(kBrentBatch, run - done);
+                for (uint64_t i = 0; i < batch; ++i) {
+                    y = step(y);
+                    product = mont.multiply(product, absolute_difference(x, y));
+                }
+                // Montgomery form scales by R, which is coprime to n.
+                divisor = integer_gcd(product, n);
+            }
+        }
+
+        if (divisor == n) {
+            // The batch overshot; replay it one step at a time.
+            do {
+                saved = step(saved);
+                divisor = integer_gcd(absolute_difference(x, saved), n);
+            } while (divisor == 1);
+        }
+        if (divisor != n) {
+            return divisor;
+        }
+    }
+}
+
+void factor_odd(uint64_t n, std::map<uint64_t, unsigned>& factors) {
+    if (n == 1) {
+        return;
+    }
+    if (is_prime(n)) {
+        ++factors[n];
+        return;
+    }
+    const uint64_t divisor = pollard_brent(n);
+    factor_odd(divisor, factors);
+    factor_odd(n / divisor, factors);
+}
+
+}  // namespace
+
+MontgomeryModulus::MontgomeryModulus(uint64_t modulus)
+    : modulus_(modulus) {
+    if (modulus % 2 == 0 || modulus < 3) {
+        throw std::invalid_argument("Montgomery modulus must be odd and greater than 1");
+    }
+    // Newton iteration doubles the correct low bits each step: 3, 6, ..., 96.
+    uint64_t inverse = modulus;
+    for (int i = 0; i < 5; ++i) {
+        inverse *= 2 - modulus * inverse;
+    }
+    inverse_ = inverse;
+    one_ = static_cast<uint64_t>((static_cast<u128>(1) << 64) % modulus);
+    r_squared_ = static_cast<uint64_t>(static_cast<u128>(one_) * one_ % modulus);
+}
+
+uint64_t MontgomeryModulus::power(uint64_t base, uint64_t exponent) const noexcept {
+    uint64_t result = one_;
+    while (exponent != 0) {
+        if (exponent & 1) {
+            result = multiply(result, base);
+        }
+        base = multiply(base, base);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+uint64_t integer_gcd(uint64_t left, uint64_t right) noexcept {
+    if (left == 0 || right == 0) {
+        return left | right;
+    }
+    // The subtraction and the next shift count come from one difference, so
+    // each step has no data-dependent branch.
+    int left_zeros = __builtin_ctzll(left);
+    const int right_zeros = __builtin_ctzll(right);
+    const int shift = std::min(left_zeros, right_zeros);
+    right >>= right_zeros;
+    while (left != 0) {
+        left >>= left_zeros;
+        const uint64_t difference = left > right ? left - right : right - left;
+        // right - left has the same trailing zeros as |right - left|; the top
+        // bit keeps ctz defined once the difference reaches zero.
+        left_zeros = __builtin_ctzll((right - left) | (uint64_t{1} << 63));
+        right = std::min(left, right);
+        left = difference;
+    }
+    return right << shift;
+}
+
+uint64_t power_mod(uint64_t base, uint64_t exponent, uint64_t modulus) {
+    if (modulus == 0) {
+        throw std::invalid_argument("power_mod modulus must be nonzero");
+    }
+    if (modulus == 1) {
+        return 0;
+    }
+    if (modulus % 2 == 1) {
+        const MontgomeryModulus mont(modulus);
+        return mont.from_montgomery(mont.power(mont.to_montgomery(base), exponent));
+    }
+
+    uint64_t result = 1;
+    base %= modulus;
+    while (exponent != 0) {
+        if (exponent & 1) {
+            result = static_cast<uint64_t>(static_cast<u128>(result) * base % modulus);
+        }
+        base = static_cast<uint64_t>(static_cast<u128>(base) * base % modulus);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+bool inverse_mod(uint64_t value, uint64_t modulus, uint64_t& inverse) noexcept {
+    // Extended Euclid; the Bezout coefficients stay within +-modulus.
+    __int128 coefficient = 0;
+    __int128 next_coefficient = 1;
+    uint64_t remainder = modulus;
+    uint64_t next_remainder = value % modulus;
+    while (next_remainder != 0) {
+        const uint64_t quotient = remainder / next_remainder;
+        coefficient = std::exchange(next_coefficient, coefficient - static_cast<__int128>(quotient) * next_coefficient);
+        remainder = std::exchange(next_remainder, remainder - quotient * next_remainder);
+    }
+    if (remainder != 1) {
+        return false;
+    }
+    inverse = static_cast<uint64_t>(coefficient < 0 ? coefficient + modulus : coefficient);
+    return true;
+}
+
+bool is_prime(uint64_t value) noexcept {
+    if (value < 2) {
+        return false;
+    }
+    for (const auto prime : kSmallPrimes) {
+        if (value % prime == 0) {
+            return value == prime;
+        }
+    }
+    if (value < 37 * 37) {
+        return true;
+    }
+
+    uint64_t odd_part = value - 1;
+    const auto twos = static_cast<unsigned>(__builtin_ctzll(odd_part));
+    odd_part >>= twos;
+    const MontgomeryModulus mont(value);
+    for (const auto base : kMillerRabinBases) {
+        const uint64_t reduced = base % value;
+        if (reduced != 0 && miller_rabin_witness(mont, reduced, odd_part, twos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::pair<uint64_t, unsigned>> factor_integer(uint64_t value) {
+    std::map<uint64_t, unsigned> factors;
+    if (value < 2) {
+        return {};
+    }
+
+    if (const auto twos = static_cast<unsigned>(__builtin_ctzll(value)); twos != 0) {
+        factors[2] = twos;
+        value >>= twos;
+    }
+    for (uint64_t divisor = 3; divisor < kTrialDivisionBound && divisor * divisor <= value; divisor += 2) {
+        while (value % divisor == 0) {
+            ++factors[divisor];
+            value /= divisor;
+        }
+    }
+    factor_odd(value, factors);
+    return {factors.begin(), factors.end()};
+}
+
+}  // namespace aleph3
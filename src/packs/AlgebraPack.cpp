@@ -3,10 +3,15 @@
 #include "algebra/PolyUtils.hpp"
 #include "evaluator/Evaluator.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
+#include "expr/ExprSummary.hpp"
+#include "numbertheory/IntegerArithmetic.hpp"
+#include "packs/NumberTheoryPack.hpp"
 
 #include <algorithm>
 #include <functional>
 #include <set>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace aleph3::packs {
@@ -67,7 +72,7 @@ std::vector<std::string> extract_variables(const ExprPtr& expr) {
 std::vector<std::string> infer_variables(const ExprPtr& expr) {
     std::set<std::string> vars;
     std::function<void(const ExprPtr&)> visit = [&](const ExprPtr& current) {
-        if (!current) {
+        if (!current || !expr_summary(current).has_symbols) {
             return;
         }
         if (auto sym = std::get_if<Symbol>(&(*current))) {
@@ -117,10 +122,21 @@ ExprPtr evaluate_gcd(const FunctionCall& func, EvaluationContext& ctx) {
     if (func.args.size() != 2 && func.args.size() != 3) {
         throw_invalid_arity_between("GCD", 2, 3);
     }
-    const auto variables = func.args.size() == 3
-        ? extract_variables(func.args[2])
-        : infer_variables(func.args[0], func.args[1]);
-    return gcd_polynomial(func.args[0], func.args[1], variables, ctx);
+    if (func.args.size() == 3) {
+        return gcd_polynomial(func.args[0], func.args[1], extract_variables(func.args[2]), ctx);
+    }
+    // The two-argument form evaluates its operands once and hands the values
+    // to whichever path applies. Two exact integers take the number-theory
+    // pack's binary GCD rather than a round trip through polynomial conversion.
+    const auto left = evaluate(func.args[0], ctx);
+    const auto right = evaluate(func.args[1], ctx);
+    const auto left_integer = integer_argument(left);
+    const auto right_integer = integer_argument(right);
+    if (left_integer && right_integer) {
+        return make_expr<Number>(static_cast<double>(
+            integer_gcd(left_integer->magnitude, right_integer->magnitude)));
+    }
+    return gcd_polynomial(left, right, infer_variables(left, right), ctx);
 }
 
 ExprPtr evaluate_polynomial_quotient(const FunctionCall& func, EvaluationContext& ctx) {
@@ -134,39 +150,43 @@ ExprPtr evaluate_polynomial_quotient(const FunctionCall& func, EvaluationContext
     return make_expr<List>(std::vector<ExprPtr>{result.first, result.second});
 }
 
+struct AlgebraPackSymbol {
+    std::string_view name;
+    std::string_view documentation;
+    ExprPtr (*handler)(const FunctionCall&, EvaluationContext&);
+};
+
+constexpr AlgebraPackSymbol kPackSymbols[] = {
+    {"Expand", "Expand products and powers in the current polynomial subset.", evaluate_expand},
+    {"Factor", "Factor supported polynomial expressions over the current exact subset.", evaluate_factor},
+    {"Collect", "Collect polynomial terms by one explicit variable selector.", evaluate_collect},
+    {"GCD", "Compute polynomial GCD for the current supported selector forms.", evaluate_gcd},
+    {"PolynomialQuotient",
+     "Return polynomial quotient and remainder for the current supported subset.",
+     evaluate_polynomial_quotient},
+};
+
 }  // namespace
 
 void register_algebra_pack(kernel::FunctionRegistry& registry) {
-    registry.register_pack_function(
-        std::string(kPackageName),
-        "Expand",
-        evaluate_expand,
-        "Expand products and powers in the current polynomial subset.",
-        true);
-    registry.register_pack_function(
-        std::string(kPackageName),
-        "Factor",
-        evaluate_factor,
-        "Factor supported polynomial expressions over the current exact subset.",
-        true);
-    registry.register_pack_function(
-        std::string(kPackageName),
-        "Collect",
-        evaluate_collect,
-        "Collect polynomial terms by one explicit variable selector.",
-        true);
-    registry.register_pack_function(
-        std::string(kPackageName),
-        "GCD",
-        evaluate_gcd,
-        "Compute polynomial GCD for the current supported selector forms.",
-        true);
-    registry.register_pack_function(
-        std::string(kPackageName),
-        "PolynomialQuotient",
-        evaluate_polynomial_quotient,
-        "Return polynomial quotient and remainder for the current supported subset.",
-        true);
+    for (const auto& symbol : kPackSymbols) {
+        registry.register_pack_function(
+            std::string(kPackageName),
+            std::string(symbol.name),
+            symbol.handler,
+            std::string(symbol.documentation),
+            true);
+    }
+}
+
+kernel::PackManifest algebra_pack_manifest() {
+    kernel::PackManifest manifest;
+    manifest.package_name = std::string(kPackageName);
+    for (const auto& symbol : kPackSymbols) {
+        manifest.symbols.push_back({std::string(symbol.name), std::string(symbol.documentation), true, {}});
+    }
+    manifest.load = register_algebra_pack;
+    return manifest;
 }
 
 }  // namespace aleph3::packs
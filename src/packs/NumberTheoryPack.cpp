@@ -0,0 +1,217 @@
+#include "packs/NumberTheoryPack.hpp"
+
+#include "evaluator/Evaluator.hpp"
+#include "evaluator/EvaluatorErrors.hpp"
+#include "numbertheory/IntegerArithmetic.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aleph3::packs {
+
+namespace {
+
+constexpr std::string_view kPackageName = "core-number-theory";
+
+// Integers up to 2^53 convert to double exactly.
+constexpr uint64_t kExactDoubleLimit = uint64_t{1} << 53;
+
+std::vector<ExprPtr> evaluate_arguments(const FunctionCall& func, EvaluationContext& ctx) {
+    std::vector<ExprPtr> args;
+    args.reserve(func.args.size());
+    for (const auto& arg : func.args) {
+        args.push_back(evaluate(arg, ctx));
+    }
+    return args;
+}
+
+// Threads a listable call over List arguments, broadcasting scalars; lists
+// must share one length. Returns nullptr when no argument is a List.
+ExprPtr thread_over_lists(const std::string& head, const std::vector<ExprPtr>& args, EvaluationContext& ctx) {
+    const List* shape = nullptr;
+    for (const auto& arg : args) {
+        if (const auto* list = std::get_if<List>(&*arg)) {
+            if (shape != nullptr && list->elements.size() != shape->elements.size()) {
+                throw_domain_violation(head + " requires list arguments of equal length");
+            }
+            shape = list;
+        }
+    }
+    if (shape == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<ExprPtr> results;
+    results.reserve(shape->elements.size());
+    for (std::size_t i = 0; i < shape->elements.size(); ++i) {
+        std::vector<ExprPtr> element_args;
+        element_args.reserve(args.size());
+        for (const auto& arg : args) {
+            const auto* list = std::get_if<List>(&*arg);
+            element_args.push_back(list != nullptr ? list->elements[i] : arg);
+        }
+        results.push_back(evaluate(make_expr<FunctionCall>(head, std::move(element_args)), ctx));
+    }
+    return make_expr<List>(std::move(results));
+}
+
+ExprPtr make_factor_list(const std::vector<std::pair<double, double>>& factors) {
+    std::vector<ExprPtr> rows;
+    rows.reserve(factors.size());
+    for (const auto& [base, exponent] : factors) {
+        rows.push_back(make_expr<List>(std::vector<ExprPtr>{make_expr<Number>(base), make_expr<Number>(exponent)}));
+    }
+    return make_expr<List>(std::move(rows));
+}
+
+ExprPtr evaluate_power_mod(const FunctionCall& func, EvaluationContext& ctx) {
+    if (func.args.size() != 3) {
+        throw_invalid_arity_exact("PowerMod", 3);
+    }
+    auto args = evaluate_arguments(func, ctx);
+    if (auto threaded = thread_over_lists("PowerMod", args, ctx)) {
+        return threaded;
+    }
+    const auto base = integer_argument(args[0]);
+    const auto exponent = integer_argument(args[1]);
+    const auto modulus = integer_argument(args[2]);
+    if (!base || !exponent || !modulus) {
+        return make_expr<FunctionCall>("PowerMod", std::move(args));
+    }
+    if (modulus->magnitude == 0) {
+        throw_domain_violation("PowerMod modulus must be nonzero");
+    }
+    if (modulus->magnitude > kExactDoubleLimit) {
+        throw_domain_violation("PowerMod modulus must be at most 2^53 so the result is exact");
+    }
+
+    const uint64_t m = modulus->magnitude;
+    uint64_t reduced_base = base->magnitude % m;
+    if (base->negative && reduced_base != 0) {
+        reduced_base = m - reduced_base;
+    }
+    if (exponent->negative && !inverse_mod(reduced_base, m, reduced_base)) {
+        throw_domain_violation("PowerMod base is not invertible modulo the modulus");
+    }
+
+    const uint64_t result = power_mod(reduced_base, exponent->magnitude, m);
+    // As in Mod, a negative modulus gives a result in (m, 0].
+    if (modulus->negative && result != 0) {
+        return make_expr<Number>(static_cast<double>(result) - static_cast<double>(m));
+    }
+    return make_expr<Number>(static_cast<double>(result));
+}
+
+ExprPtr evaluate_prime_q(const FunctionCall& func, EvaluationContext& ctx) {
+    if (func.args.size() != 1) {
+        throw_invalid_arity_exact("PrimeQ", 1);
+    }
+    auto args = evaluate_arguments(func, ctx);
+    if (auto threaded = thread_over_lists("PrimeQ", args, ctx)) {
+        return threaded;
+    }
+    const auto value = integer_argument(args[0]);
+    return make_expr<Boolean>(value.has_value() && is_prime(value->magnitude));
+}
+
+ExprPtr evaluate_factor_integer(const FunctionCall& func, EvaluationContext& ctx) {
+    if (func.args.size() != 1) {
+        throw_invalid_arity_exact("FactorInteger", 1);
+    }
+    auto args = evaluate_arguments(func, ctx);
+    if (auto threaded = thread_over_lists("FactorInteger", args, ctx)) {
+        return threaded;
+    }
+    const auto& arg = args[0];
+
+    bool negative = false;
+    uint64_t numerator = 0;
+    uint64_t denominator = 1;
+    if (const auto value = integer_argument(arg)) {
+        negative = value->negative;
+        numerator = value->magnitude;
+    } else if (const auto* rational = std::get_if<Rational>(&*arg)) {
+        negative = (rational->numerator < 0) != (rational->denominator < 0);
+        numerator = static_cast<uint64_t>(std::llabs(rational->numerator));
+        denominator = static_cast<uint64_t>(std::llabs(rational->denominator));
+    } else {
+        return make_expr<FunctionCall>("FactorInteger", std::vector<ExprPtr>{arg});
+    }
+
+    if (numerator == 0) {
+        return make_factor_list({{0.0, 1.0}});
+    }
+    if (numerator == 1 && denominator == 1) {
+        return make_factor_list({{negative ? -1.0 : 1.0, 1.0}});
+    }
+
+    std::vector<std::pair<double, double>> factors;
+    if (negative) {
+        factors.emplace_back(-1.0, 1.0);
+    }
+    for (const auto& [prime, exponent] : factor_integer(numerator)) {
+        factors.emplace_back(static_cast<double>(prime), static_cast<double>(exponent));
+    }
+    for (const auto& [prime, exponent] : factor_integer(denominator)) {
+        factors.emplace_back(static_cast<double>(prime), -static_cast<double>(exponent));
+    }
+    std::sort(factors.begin() + (negative ? 1 : 0), factors.end());
+    return make_factor_list(factors);
+}
+
+struct NumberTheoryPackSymbol {
+    std::string_view name;
+    std::string_view documentation;
+    ExprPtr (*handler)(const FunctionCall&, EvaluationContext&);
+};
+
+constexpr NumberTheoryPackSymbol kPackSymbols[] = {
+    {"PowerMod", "Compute a^b mod m for exact integers, inverting a when b is negative.", evaluate_power_mod},
+    {"PrimeQ", "Test an exact integer for primality; deterministic below 2^64.", evaluate_prime_q},
+    {"FactorInteger", "Factor an exact integer or rational into {prime, exponent} pairs.", evaluate_factor_integer},
+};
+
+}  // namespace
+
+std::optional<IntegerArgument> integer_argument(const ExprPtr& expr) {
+    const auto* number = std::get_if<Number>(&*expr);
+    if (number == nullptr || !std::isfinite(number->value) || std::floor(number->value) != number->value) {
+        return std::nullopt;
+    }
+    const double magnitude = std::fabs(number->value);
+    if (magnitude >= 18446744073709551616.0) {
+        return std::nullopt;
+    }
+    return IntegerArgument{number->value < 0.0, static_cast<uint64_t>(magnitude)};
+}
+
+void register_number_theory_pack(kernel::FunctionRegistry& registry) {
+    for (const auto& symbol : kPackSymbols) {
+        registry.register_pack_function(
+            std::string(kPackageName),
+            std::string(symbol.name),
+            symbol.handler,
+            std::string(symbol.documentation),
+            true,
+            {symbols::SymbolAttribute::listable});
+    }
+}
+
+kernel::PackManifest number_theory_pack_manifest() {
+    kernel::PackManifest manifest;
+    manifest.package_name = std::string(kPackageName);
+    for (const auto& symbol : kPackSymbols) {
+        manifest.symbols.push_back({
+            std::string(symbol.name),
+            std::string(symbol.documentation),
+            true,
+            {symbols::SymbolAttribute::listable}});
+    }
+    manifest.load = register_number_theory_pack;
+    return manifest;
+}
+
+}  // namespace aleph3::packs
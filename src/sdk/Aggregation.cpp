@@ -0,0 +1,119 @@
+#include "sdk/Aggregation.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace aleph3 {
+
+namespace {
+
+// One string per distinct key; the type tag keeps 1, True and "1" apart.
+std::string canonical_key(const Value& key) {
+    if (key.is_null()) {
+        return "_";
+    }
+    if (const auto* number = key.as_number()) {
+        char buffer[32];
+        const double value = *number == 0.0 ? 0.0 : *number;
+        const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+        return "n" + std::string(buffer, end);
+    }
+    if (const auto* boolean = key.as_boolean()) {
+        return *boolean ? "bT" : "bF";
+    }
+    return "s" + *key.as_string();
+}
+
+bool same_options(const AggregationOptions& left, const AggregationOptions& right) noexcept {
+    return left.distinct_count == right.distinct_count &&
+        left.quantiles == right.quantiles &&
+        left.distinct_precision == right.distinct_precision &&
+        left.quantile_accuracy == right.quantile_accuracy &&
+        left.top_k == right.top_k;
+}
+
+}  // namespace
+
+AggregationSink::AggregationSink(AggregationOptions options)
+    : options_(options) {
+    // Fail on bad options here rather than at the first value.
+    if (options_.distinct_count) {
+        (void)DistinctCounter(options_.distinct_precision);
+    }
+    if (options_.quantiles) {
+        (void)QuantileSketch(options_.quantile_accuracy);
+    }
+}
+
+bool AggregationSink::is_valid_key(const Value& key) noexcept {
+    if (const auto* number = key.as_number()) {
+        return !std::isnan(*number);
+    }
+    return !key.is_list() && !key.is_association();
+}
+
+GroupAggregate& AggregationSink::group_for(const Value& key, const std::string& canonical) {
+    const auto [it, inserted] = index_.try_emplace(canonical, groups_.size());
+    if (inserted) {
+        GroupAggregate group;
+        group.key = key;
+        if (options_.distinct_count) {
+            group.distinct.emplace(options_.distinct_precision);
+        }
+        if (options_.quantiles) {
+            group.quantiles.emplace(options_.quantile_accuracy);
+        }
+        if (options_.top_k > 0) {
+            group.top.emplace(options_.top_k);
+        }
+        groups_.push_back(std::move(group));
+    }
+    return groups_[it->second];
+}
+
+void AggregationSink::add(const Value& key, double value) {
+    if (!is_valid_key(key)) {
+        throw std::invalid_argument("Aggregation keys must be numbers, booleans, or strings.");
+    }
+    auto& group = group_for(key, canonical_key(key));
+    group.moments.add(value);
+    if (group.distinct) {
+        group.distinct->add(value);
+    }
+    if (group.quantiles) {
+        group.quantiles->add(value);
+    }
+    if (group.top) {
+        group.top->add(value);
+    }
+}
+
+void AggregationSink::merge(const AggregationSink& other) {
+    if (!same_options(options_, other.options_)) {
+        throw std::invalid_argument("Aggregation sinks must share their options to merge.");
+    }
+    for (const auto& source : other.groups_) {
+        auto& group = group_for(source.key, canonical_key(source.key));
+        group.moments.merge(source.moments);
+        if (group.distinct) {
+            group.distinct->merge(*source.distinct);
+        }
+        if (group.quantiles) {
+            group.quantiles->merge(*source.quantiles);
+        }
+        if (group.top) {
+            group.top->merge(*source.top);
+        }
+    }
+}
+
+const GroupAggregate* AggregationSink::find(const Value& key) const {
+    if (!is_valid_key(key)) {
+        return nullptr;
+    }
+    const auto it = index_.find(canonical_key(key));
+    return it == index_.end() ? nullptr : &groups_[it->second];
+}
+
+}  // namespace aleph3
@@ -2,17 +2,27 @@
 
 #include "frontend/Parser.hpp"
 #include "ir/Node.hpp"
+#include "kernel/CounterRandom.hpp"
 #include "kernel/Diagnostics.hpp"
+#include "kernel/ExprReclaimer.hpp"
+#include "kernel/FairScheduler.hpp"
 #include "kernel/FunctionRegistry.hpp"
+#include "kernel/Rewrite.hpp"
 #include "kernel/TrustedSubsetBridge.hpp"
+#include "kernel/WorkStealingPool.hpp"
 #include "semantics/Validator.hpp"
 
+#include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <cmath>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 namespace aleph3 {
 
@@ -42,6 +52,36 @@ RuntimeError make_runtime_error(std::string code, std::string message) {
     return error;
 }
 
+// Samples per unit of simulation work; each unit is summarized on its own and
+// the summaries are merged in order.
+constexpr std::size_t kSimulationChunkSamples = 4096;
+
+// FNV-1a, so a variable's stream follows its name rather than its position
+// among the sampled variables.
+std::uint64_t variable_stream(std::string_view name) noexcept {
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char ch : name) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 0x100000001B3ULL;
+    }
+    return kernel::derive_random_stream(0, hash);
+}
+
+// Rows per unit of aggregation work.
+constexpr std::size_t kAggregationChunkRows = 256;
+
+struct AggregationChunk {
+    std::optional<AggregationSink> sink;
+    std::size_t rows_aggregated = 0;
+    std::optional<RuntimeError> error;
+};
+
+struct SimulationChunk {
+    std::optional<SimulationSummary> summary;
+    std::optional<RuntimeError> error;
+    std::size_t failed_offset = 0;
+};
+
 std::size_t required_parameter_count(const HostFunctionSpec& spec) noexcept {
     std::size_t required = 0;
     for (const auto& parameter : spec.parameters) {
@@ -89,22 +129,66 @@ FrontendPassResult parse_and_validate(
 
 namespace sdk_detail {
 struct CompiledFormulaData {
+    // Canonical body, shared with every formula of the same canonical form.
     ExprPtr kernel_expr;
+    // slots[i] is the variable that slot $(i+1) of the body reads.
+    std::vector<std::string> slots;
     Policy policy;
     Bindings constants;
     std::string source;
 };
 }  // namespace sdk_detail
 
+std::vector<std::string> CompiledFormula::variables() const {
+    return state_ ? kernel::trusted_subset_formula_variables(state_->kernel_expr, state_->constants, state_->slots)
+                  : std::vector<std::string>{};
+}
+
+std::uint64_t CompiledFormula::fingerprint() const {
+    return state_ ? static_cast<std::uint64_t>(kernel::structural_hash(state_->kernel_expr)) : 0;
+}
+
+bool CompiledFormula::shares_body_with(const CompiledFormula& other) const noexcept {
+    return state_ && other.state_ && state_->kernel_expr == other.state_->kernel_expr;
+}
+
 struct Engine::State {
     explicit State(EngineOptions engine_options)
         : options(std::move(engine_options)),
-          function_registry(kernel::create_default_function_registry()) {}
+          function_registry(kernel::create_default_function_registry()),
+          scheduler(
+              options.scheduling.concurrency == 0 ? kernel::hardware_thread_count() : options.scheduling.concurrency,
+              options.scheduling.slice_steps) {
+        if (options.background_reclamation) {
+            reclaimer = std::make_unique<kernel::ExprReclaimer>();
+        }
+    }
 
     EngineOptions options;
     kernel::FunctionRegistry function_registry;
+    std::unique_ptr<kernel::ExprReclaimer> reclaimer;
+    kernel::FairScheduler scheduler;
+    // Queueing delays of completed scheduled evaluations, in milliseconds.
+    RunningMoments queue_delays;
+    QuantileSketch queue_delay_quantiles;
+    std::mutex queue_delay_mutex;
     std::unordered_map<std::string, HostFunctionSpec> host_functions;
+    // Canonical bodies of the formulas compiled so far. Bodies only this set
+    // still holds are dropped whenever it doubles in size.
+    std::unordered_set<ExprPtr, kernel::StructuralExprHash, kernel::StructuralExprEqual> bodies;
+    std::size_t next_body_sweep = 64;
     mutable std::mutex mutex;
+
+    ExprPtr share_body(ExprPtr body) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto [cached, added] = bodies.insert(std::move(body));
+        ExprPtr shared = *cached;
+        if (added && bodies.size() >= next_body_sweep) {
+            std::erase_if(bodies, [](const ExprPtr& entry) { return entry.use_count() == 1; });
+            next_body_sweep = std::max<std::size_t>(64, 2 * bodies.size());
+        }
+        return shared;
+    }
 };
 
 Engine::Engine(EngineOptions options) : state_(std::make_shared<State>(std::move(options))) {}
@@ -168,8 +252,10 @@ CompileResult Engine::compile(
         return result;
     }
 
+    auto canonical = kernel::canonicalize_trusted_subset_formula(staged_formula.kernel_expr);
     auto state = std::make_shared<sdk_detail::CompiledFormulaData>();
-    state->kernel_expr = staged_formula.kernel_expr;
+    state->kernel_expr = state_->share_body(std::move(canonical.body));
+    state->slots = std::move(canonical.slots);
     state->policy = policy;
     state->constants = schema.constant_values();
     if (state_->options.retain_source_text) {
@@ -227,7 +313,270 @@ EvaluationResult Engine::evaluate(
         formula.state_->constants,
         host_functions,
         state_->function_registry,
-        formula.state_->policy);
+        formula.state_->policy,
+        state_->reclaimer.get(),
+        formula.state_->slots);
+}
+
+CompiledFormula Engine::specialize(
+    const CompiledFormula& formula,
+    const Bindings& fixed_bindings) const {
+    if (formula.empty()) {
+        return {};
+    }
+
+    std::unordered_map<std::string, HostFunctionSpec> host_functions;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        host_functions = state_->host_functions;
+    }
+
+    auto state = std::make_shared<sdk_detail::CompiledFormulaData>(*formula.state_);
+    state->kernel_expr = kernel::specialize_trusted_subset_formula(
+        formula.state_->kernel_expr,
+        fixed_bindings,
+        formula.state_->constants,
+        host_functions,
+        state_->function_registry,
+        formula.state_->policy,
+        formula.state_->slots);
+    return CompiledFormula(std::move(state));
+}
+
+EvaluationResult Engine::evaluate_scheduled(
+    const CompiledFormula& formula,
+    const Bindings& bindings,
+    const ScheduledEvaluationOptions& options) const {
+    EvaluationResult result;
+    const auto stats = state_->scheduler.run(options.tenant, options.priority, [&] {
+        result = evaluate(formula, bindings);
+    });
+
+    const std::chrono::duration<double, std::milli> delay = stats.queue_delay;
+    std::lock_guard<std::mutex> lock(state_->queue_delay_mutex);
+    state_->queue_delays.add(delay.count());
+    state_->queue_delay_quantiles.add(delay.count());
+    return result;
+}
+
+void Engine::set_tenant_weight(const std::string& tenant, double weight) {
+    if (!(weight > 0.0) || !std::isfinite(weight)) {
+        throw std::invalid_argument("Tenant weight must be positive and finite.");
+    }
+    state_->scheduler.set_tenant_weight(tenant, weight);
+}
+
+SchedulerMetrics Engine::scheduler_metrics() const {
+    const auto load = state_->scheduler.load();
+    SchedulerMetrics metrics;
+    metrics.running = load.running;
+    metrics.waiting = load.waiting;
+    metrics.completed = load.completed;
+    metrics.yields = load.yields;
+
+    std::lock_guard<std::mutex> lock(state_->queue_delay_mutex);
+    if (state_->queue_delays.count() > 0) {
+        metrics.mean_queue_delay_ms = state_->queue_delays.mean();
+        metrics.p99_queue_delay_ms = state_->queue_delay_quantiles.quantile(0.99);
+        metrics.max_queue_delay_ms = state_->queue_delays.max();
+    }
+    return metrics;
+}
+
+ReclamationMetrics Engine::reclamation_metrics() const {
+    return state_->reclaimer ? state_->reclaimer->metrics() : ReclamationMetrics{};
+}
+
+AggregationReport Engine::evaluate_into(
+    AggregationSink& sink,
+    const CompiledFormula& formula,
+    std::span<const Bindings> rows,
+    const AggregationEvaluationOptions& options) const {
+    AggregationReport report;
+    if (formula.empty() || (options.group_by && options.group_by->empty())) {
+        report.error = make_runtime_error(
+            "sdk.formula.empty",
+            "Cannot aggregate an empty compiled formula.");
+        report.failed_row = 0;
+        return report;
+    }
+
+    std::unordered_map<std::string, HostFunctionSpec> host_functions;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        host_functions = state_->host_functions;
+    }
+    const auto evaluate_row = [&](const CompiledFormula& row_formula, const Bindings& bindings) {
+        return kernel::evaluate_trusted_subset_formula(
+            row_formula.state_->kernel_expr,
+            bindings,
+            row_formula.state_->constants,
+            host_functions,
+            state_->function_registry,
+            row_formula.state_->policy,
+            nullptr,
+            row_formula.state_->slots);
+    };
+
+    const std::size_t chunk_count = (rows.size() + kAggregationChunkRows - 1) / kAggregationChunkRows;
+    std::vector<AggregationChunk> chunks(chunk_count);
+    const auto run_chunk = [&](std::size_t chunk_index) {
+        auto& chunk = chunks[chunk_index];
+        chunk.sink.emplace(sink.options());
+        const std::size_t begin = chunk_index * kAggregationChunkRows;
+        const std::size_t end = std::min(begin + kAggregationChunkRows, rows.size());
+        for (std::size_t row = begin; row < end; ++row) {
+            auto value = evaluate_row(formula, rows[row]);
+            if (value.error) {
+                chunk.error = std::move(value.error);
+                return;
+            }
+            const double* number = value.value ? value.value->as_number() : nullptr;
+            if (number == nullptr) {
+                chunk.error = make_runtime_error(
+                    "sdk.aggregation.non_numeric",
+                    "Aggregated formulas must evaluate to numbers.");
+                return;
+            }
+
+            Value key;
+            if (options.group_by) {
+                auto group = evaluate_row(*options.group_by, rows[row]);
+                if (group.error) {
+                    chunk.error = std::move(group.error);
+                    return;
+                }
+                if (!group.value || !AggregationSink::is_valid_key(*group.value)) {
+                    chunk.error = make_runtime_error(
+                        "sdk.aggregation.invalid_key",
+                        "Group keys must evaluate to numbers, booleans, or strings.");
+                    return;
+                }
+                key = std::move(*group.value);
+            }
+            chunk.sink->add(key, *number);
+            ++chunk.rows_aggregated;
+        }
+    };
+
+    const std::size_t thread_count = expr_refcount_is_atomic ? options.thread_count : 1;
+    kernel::run_work_stealing(chunk_count, thread_count, run_chunk);
+
+    for (std::size_t index = 0; index < chunk_count; ++index) {
+        auto& chunk = chunks[index];
+        sink.merge(*chunk.sink);
+        report.rows_aggregated += chunk.rows_aggregated;
+        if (chunk.error) {
+            report.error = std::move(chunk.error);
+            report.failed_row = report.rows_aggregated;
+            return report;
+        }
+    }
+    return report;
+}
+
+SimulationResult Engine::simulate(
+    const CompiledFormula& formula,
+    const Distributions& distributions,
+    std::size_t n_samples,
+    std::uint64_t seed,
+    const SimulationOptions& options) const {
+    SimulationResult result;
+    if (formula.empty()) {
+        result.error = make_runtime_error(
+            "sdk.formula.empty",
+            "Cannot simulate an empty compiled formula.");
+        return result;
+    }
+    if (!(options.quantile_accuracy > 0.0 && options.quantile_accuracy < 1.0)) {
+        result.error = make_runtime_error(
+            "sdk.simulation.invalid_accuracy",
+            "Quantile accuracy must be between 0 and 1.");
+        return result;
+    }
+
+    struct SampledVariable {
+        std::string name;
+        Distribution distribution;
+        kernel::RandomStream stream;
+    };
+    std::vector<SampledVariable> variables;
+    variables.reserve(distributions.size());
+    for (const auto& [name, distribution] : distributions) {
+        if (const char* reason = kernel::invalid_distribution_reason(distribution)) {
+            result.error = make_runtime_error(
+                "sdk.simulation.invalid_distribution",
+                "Distribution of '" + name + "' " + reason + ".");
+            return result;
+        }
+        variables.push_back({name, distribution, kernel::RandomStream(seed, variable_stream(name))});
+    }
+    std::sort(variables.begin(), variables.end(), [](const auto& left, const auto& right) {
+        return left.name < right.name;
+    });
+
+    std::unordered_map<std::string, HostFunctionSpec> host_functions;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        host_functions = state_->host_functions;
+    }
+
+    const std::size_t chunk_count = (n_samples + kSimulationChunkSamples - 1) / kSimulationChunkSamples;
+    std::vector<SimulationChunk> chunks(chunk_count);
+    const auto run_chunk = [&](std::size_t chunk_index) {
+        const std::size_t begin = chunk_index * kSimulationChunkSamples;
+        const std::size_t length = std::min(kSimulationChunkSamples, n_samples - begin);
+
+        std::vector<std::vector<double>> draws(variables.size(), std::vector<double>(length));
+        kernel::TrustedSubsetSampleColumns samples;
+        for (std::size_t index = 0; index < variables.size(); ++index) {
+            const auto& variable = variables[index];
+            kernel::fill_distribution(variable.stream, variable.distribution, draws[index], begin);
+            samples.variables.push_back(variable.name);
+            samples.columns.emplace_back(draws[index]);
+        }
+
+        auto batch = kernel::evaluate_trusted_subset_batch(
+            formula.state_->kernel_expr,
+            samples,
+            options.bindings,
+            formula.state_->constants,
+            host_functions,
+            state_->function_registry,
+            formula.state_->policy,
+            formula.state_->slots);
+
+        auto& chunk = chunks[chunk_index];
+        if (batch.error) {
+            chunk.error = std::move(batch.error);
+            chunk.failed_offset = batch.values.size();
+            return;
+        }
+        SimulationSummary summary{{}, QuantileSketch(options.quantile_accuracy)};
+        for (const double value : batch.values) {
+            summary.moments.add(value);
+            summary.quantiles.add(value);
+        }
+        chunk.summary = std::move(summary);
+    };
+
+    // Expressions shared across threads need atomic reference counts.
+    const std::size_t thread_count = expr_refcount_is_atomic ? options.thread_count : 1;
+    kernel::run_work_stealing(chunk_count, thread_count, run_chunk);
+
+    SimulationSummary total{{}, QuantileSketch(options.quantile_accuracy)};
+    for (std::size_t index = 0; index < chunk_count; ++index) {
+        auto& chunk = chunks[index];
+        if (chunk.error) {
+            result.error = std::move(chunk.error);
+            result.failed_sample = index * kSimulationChunkSamples + chunk.failed_offset;
+            return result;
+        }
+        total.moments.merge(chunk.summary->moments);
+        total.quantiles.merge(chunk.summary->quantiles);
+    }
+    result.summary = std::move(total);
+    return result;
 }
 
 }  // namespace aleph3
@@ -0,0 +1,256 @@
+#include "sdk/Statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace aleph3 {
+
+namespace {
+
+// Magnitudes below this count as zero; the bucket keys stay in int range.
+constexpr double kSmallestBucketedMagnitude = 1e-300;
+
+
+// Neumaier's compensated addition of value into (sum, compensation).
+void add_compensated(double& sum, double& compensation, double value) noexcept {
+    const double total = sum + value;
+    if (std::fabs(sum) >= std::fabs(value)) {
+        compensation += (sum - total) + value;
+    } else {
+        compensation += (value - total) + sum;
+    }
+    sum = total;
+}
+
+// splitmix64 finalizer.
+std::uint64_t mix_bits(std::uint64_t z) noexcept {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}  // namespace
+
+void RunningMoments::add(double value) noexcept {
+    ++count_;
+    add_compensated(sum_, sum_compensation_, value);
+    const double delta = value - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    sum_squared_deviations_ += delta * (value - mean_);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+}
+
+void RunningMoments::merge(const RunningMoments& other) noexcept {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        *this = other;
+        return;
+    }
+    const auto left = static_cast<double>(count_);
+    const auto right = static_cast<double>(other.count_);
+    const double total = left + right;
+    const double delta = other.mean_ - mean_;
+    mean_ += delta * right / total;
+    sum_squared_deviations_ += other.sum_squared_deviations_ + delta * delta * left * right / total;
+    count_ += other.count_;
+    add_compensated(sum_, sum_compensation_, other.sum_);
+    add_compensated(sum_, sum_compensation_, other.sum_compensation_);
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+double RunningMoments::variance() const noexcept {
+    return count_ < 2 ? 0.0 : sum_squared_deviations_ / static_cast<double>(count_ - 1);
+}
+
+QuantileSketch::QuantileSketch(double relative_accuracy)
+    : relative_accuracy_(relative_accuracy) {
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) {
+        throw std::invalid_argument("Quantile sketch accuracy must be between 0 and 1.");
+    }
+    gamma_ = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    log_gamma_ = std::log(gamma_);
+}
+
+int QuantileSketch::bucket_key(double magnitude) const {
+    return static_cast<int>(std::ceil(std::log(magnitude) / log_gamma_));
+}
+
+double QuantileSketch::bucket_value(int key) const {
+    // Midpoint, in relative terms, of (gamma^(key-1), gamma^key].
+    return 2.0 * std::pow(gamma_, key) / (gamma_ + 1.0);
+}
+
+void QuantileSketch::add(double value) {
+    if (std::isnan(value)) {
+        throw std::invalid_argument("Quantile sketch values must not be NaN.");
+    }
+    ++count_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    const double magnitude = std::fabs(value);
+    if (magnitude < kSmallestBucketedMagnitude) {
+        ++zero_count_;
+    } else if (value > 0.0) {
+        ++positive_[bucket_key(magnitude)];
+    } else {
+        ++negative_[bucket_key(magnitude)];
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.relative_accuracy_ != relative_accuracy_) {
+        throw std::invalid_argument("Quantile sketches must share one accuracy to merge.");
+    }
+    count_ += other.count_;
+    zero_count_ += other.zero_count_;
+    for (const auto& [key, count] : other.positive_) {
+        positive_[key] += count;
+    }
+    for (const auto& [key, count] : other.negative_) {
+        negative_[key] += count;
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (count_ == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(count_ - 1));
+    if (rank == 0) {
+        return min_;
+    }
+    if (rank == count_ - 1) {
+        return max_;
+    }
+
+    // Ascending value order: negative buckets from the largest magnitude
+    // down, then zeros, then positive buckets from the smallest magnitude up.
+    std::uint64_t seen = 0;
+    double estimate = 0.0;
+    bool found = false;
+    for (auto it = negative_.rbegin(); it != negative_.rend() && !found; ++it) {
+        seen += it->second;
+        if (seen > rank) {
+            estimate = -bucket_value(it->first);
+            found = true;
+        }
+    }
+    if (!found) {
+        seen += zero_count_;
+        found = seen > rank;
+    }
+    for (auto it = positive_.begin(); it != positive_.end() && !found; ++it) {
+        seen += it->second;
+        if (seen > rank) {
+            estimate = bucket_value(it->first);
+            found = true;
+        }
+    }
+    return std::clamp(estimate, min_, max_);
+}
+
+DistinctCounter::DistinctCounter(unsigned precision)
+    : precision_(precision) {
+    if (precision < 4 || precision > 16) {
+        throw std::invalid_argument("Distinct counter precision must be between 4 and 16.");
+    }
+    registers_.assign(std::size_t{1} << precision, 0);
+}
+
+void DistinctCounter::add(double value) noexcept {
+    // +0 and -0 are one value.
+    add_hash(mix_bits(std::bit_cast<std::uint64_t>(value == 0.0 ? 0.0 : value) + 0x9E3779B97F4A7C15ULL));
+}
+
+void DistinctCounter::add_hash(std::uint64_t hash) noexcept {
+    const auto index = static_cast<std::size_t>(hash >> (64 - precision_));
+    // Leading zeros of the remaining bits, plus one; a sentinel bit caps it.
+    const std::uint64_t rest = (hash << precision_) | (std::uint64_t{1} << (precision_ - 1));
+    const auto rank = static_cast<std::uint8_t>(std::countl_zero(rest) + 1);
+    registers_[index] = std::max(registers_[index], rank);
+}
+
+void DistinctCounter::merge(const DistinctCounter& other) {
+    if (other.precision_ != precision_) {
+        throw std::invalid_argument("Distinct counters must share one precision to merge.");
+    }
+    for (std::size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+double DistinctCounter::estimate() const noexcept {
+    const auto m = static_cast<double>(registers_.size());
+    double harmonic = 0.0;
+    std::size_t zeros = 0;
+    for (const auto value : registers_) {
+        harmonic += std::ldexp(1.0, -static_cast<int>(value));
+        zeros += value == 0 ? 1 : 0;
+    }
+    const double alpha = registers_.size() == 16 ? 0.673
+        : registers_.size() == 32               ? 0.697
+        : registers_.size() == 64               ? 0.709
+                                                : 0.7213 / (1.0 + 1.079 / m);
+    const double raw = alpha * m * m / harmonic;
+    // Linear counting is more accurate while many registers are still empty.
+    if (raw <= 2.5 * m && zeros != 0) {
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return raw;
+}
+
+TopValues::TopValues(std::size_t capacity)
+    : capacity_(capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Top values must keep at least one value.");
+    }
+    heap_.reserve(capacity);
+}
+
+void TopValues::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    // +0 and -0 are one value.
+    if (value == 0.0) {
+        value = 0.0;
+    }
+    if (heap_.size() < capacity_) {
+        heap_.push_back(value);
+        std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+        return;
+    }
+    if (value <= heap_.front()) {
+        return;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+    heap_.back() = value;
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+}
+
+void TopValues::merge(const TopValues& other) {
+    if (other.capacity_ != capacity_) {
+        throw std::invalid_argument("Top values must share one capacity to merge.");
+    }
+    for (const double value : other.heap_) {
+        add(value);
+    }
+}
+
+std::vector<double> TopValues::values() const {
+    auto sorted = heap_;
+    std::sort(sorted.begin(), sorted.end(), std::greater<>{});
+    return sorted;
+}
+
+}  // namespace aleph3
@@ -24,6 +24,7 @@ enum class InferredType {
     boolean,
     string,
     list,
+    association,
     invalid
 };
 
@@ -36,13 +37,26 @@ Diagnostic make_error(std::string code, std::string message, SourceSpan span) {
     return diagnostic;
 }
 
+// Optional built-ins whose first argument is an association and whose
+// remaining arguments may be of any type.
+bool is_keyed_builtin(std::string_view name) noexcept {
+    return name == "Lookup" || name == "KeyExistsQ";
+}
+
 bool is_optional_builtin(std::string_view name) noexcept {
     return name == "Min" || name == "Max" || name == "Abs" ||
            name == "Clamp" || name == "Floor" || name == "Ceil" ||
-           name == "Ceiling" || name == "Round" || name == "Sqrt";
+           name == "Ceiling" || name == "Round" || name == "Sqrt" ||
+           is_keyed_builtin(name);
 }
 
 FunctionArity optional_builtin_arity(std::string_view name) noexcept {
+    if (name == "Lookup") {
+        return FunctionArity{2, 3};
+    }
+    if (name == "KeyExistsQ") {
+        return FunctionArity::exact(2);
+    }
     if (name == "Abs" || name == "Floor" || name == "Ceil" ||
         name == "Ceiling" || name == "Round" || name == "Sqrt") {
         return FunctionArity::exact(1);
@@ -94,6 +108,8 @@ std::string type_name(InferredType type) {
             return "string";
         case InferredType::list:
             return "list";
+        case InferredType::association:
+            return "association";
         case InferredType::invalid:
             return "invalid";
     }
@@ -112,6 +128,8 @@ InferredType inferred_type_from_value_type(ValueType type) noexcept {
             return InferredType::string;
         case ValueType::list:
             return InferredType::list;
+        case ValueType::association:
+            return InferredType::association;
     }
     return InferredType::unknown;
 }
@@ -129,14 +147,16 @@ bool matches_expected_type(InferredType actual, ValueType expected) noexcept {
 bool is_known_non_numeric(InferredType type) noexcept {
     return type == InferredType::boolean ||
            type == InferredType::string ||
-           type == InferredType::list;
+           type == InferredType::list ||
+           type == InferredType::association;
 }
 
 bool is_known_concrete_type(InferredType type) noexcept {
     return type == InferredType::number ||
            type == InferredType::boolean ||
            type == InferredType::string ||
-           type == InferredType::list;
+           type == InferredType::list ||
+           type == InferredType::association;
 }
 
 bool branch_types_are_incompatible(InferredType left, InferredType right) noexcept {
@@ -151,6 +171,9 @@ std::optional<InferredType> optional_builtin_return_type(std::string_view name)
         name == "Ceiling" || name == "Round" || name == "Sqrt") {
         return InferredType::number;
     }
+    if (name == "KeyExistsQ") {
+        return InferredType::boolean;
+    }
     return std::nullopt;
 }
 
@@ -409,6 +432,9 @@ private:
                 if (constant->second.is_list()) {
                     return InferredType::list;
                 }
+                if (constant->second.is_association()) {
+                    return InferredType::association;
+                }
                 return InferredType::any;
             }
 
@@ -577,6 +603,19 @@ private:
                 argument_types.push_back(validate_node(argument, depth + 1, traversal, diagnostics));
             }
 
+            if (optional_builtin && policy_.enable_optional_builtins() && is_keyed_builtin(call->callee)) {
+                if (!argument_types.empty() &&
+                    is_known_concrete_type(argument_types.front()) &&
+                    argument_types.front() != InferredType::association) {
+                    diagnostics.push_back(make_error(
+                        "semantics.validator.invalid_argument_type",
+                        "Optional built-in `" + call->callee + "` expects argument 1 to be `association`, but found `" +
+                            type_name(argument_types.front()) + "`.",
+                        call->arguments.front() != nullptr ? call->arguments.front()->span : node->span));
+                }
+                return optional_builtin_return_type(call->callee).value_or(InferredType::any);
+            }
+
             if (optional_builtin && policy_.enable_optional_builtins()) {
                 for (std::size_t index = 0; index < argument_types.size(); ++index) {
                     if (is_known_non_numeric(argument_types[index])) {
@@ -274,6 +274,9 @@ ValueType infer_value_type(const Value& value) noexcept {
     if (value.is_list()) {
         return ValueType::list;
     }
+    if (value.is_association()) {
+        return ValueType::association;
+    }
     return ValueType::any;
 }
 
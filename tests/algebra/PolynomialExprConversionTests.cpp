@@ -124,6 +124,25 @@ TEST_CASE("exact polynomial_to_expr emits a shared canonical order", "[algebra][
     REQUIRE(simplify_string(exact_polynomial_to_expr(ordered)) == "x^2 + x * y * 3/2 - 1/2");
 }
 
+TEST_CASE("exact polynomial products reduce coefficients once per monomial", "[algebra][exact]") {
+    // (x/2 + 1/3) * (x/3 - 1/2) = x^2/6 - 5x/36 - 1/6
+    ExactPolynomial left({{Monomial{{"x", 1}}, coeff(1, 2)}, {Monomial{}, coeff(1, 3)}});
+    ExactPolynomial right({{Monomial{{"x", 1}}, coeff(1, 3)}, {Monomial{}, coeff(-1, 2)}});
+    const auto product = left * right;
+    REQUIRE(product.terms.at(Monomial{{"x", 2}}) == coeff(1, 6));
+    REQUIRE(product.terms.at(Monomial{{"x", 1}}) == coeff(-5, 36));
+    REQUIRE(product.terms.at(Monomial{}) == coeff(-1, 6));
+
+    // Denominators whose unreduced product overflows int64 still combine exactly.
+    const int64_t big = int64_t{1} << 40;
+    ExactPolynomial wide({{Monomial{{"x", 1}}, coeff(1, big)}, {Monomial{}, coeff(1, big)}});
+    const int64_t odd = (int64_t{1} << 30) + 1;
+    ExactPolynomial scale({{Monomial{}, coeff(big, odd)}});
+    const auto scaled = wide * scale;
+    REQUIRE(scaled.terms.at(Monomial{{"x", 1}}) == coeff(1, odd));
+    REQUIRE(scaled.terms.at(Monomial{}) == coeff(1, odd));
+}
+
 TEST_CASE("low-level polynomial helpers preserve supported normal forms", "[algebra][conversion]") {
     const auto poly = expr_to_polynomial(parse_expression("x^2 + 2*x + 1"), {"x"});
 
@@ -62,6 +62,17 @@ TEST_CASE("Polynomial GCD supports an explicit variable selector", "[algebra][fu
 
     const auto inferred_gcd_result = evaluate_source("GCD[x^2 - 1, x - 1]", ctx);
     REQUIRE(simplify_string(inferred_gcd_result) == "x - 1");
+
+    // Operands are evaluated once, whichever path computes the GCD.
+    evaluate_source("n = 0", ctx);
+    const auto counted_factor = make_expr<FunctionCall>("Times", std::vector<ExprPtr>{
+        make_expr<Assignment>("n", parse_expression("n + 1")),
+        parse_expression("x - 1")});
+    const auto counted_gcd_result = evaluate(
+        make_expr<FunctionCall>("GCD", std::vector<ExprPtr>{parse_expression("x^2 - 1"), counted_factor}),
+        ctx);
+    REQUIRE(simplify_string(counted_gcd_result) == "x - 1");
+    REQUIRE(std::get<Number>(*ctx.variables.at("n")).value == 1.0);
 }
 
 TEST_CASE("Polynomial quotient returns quotient and remainder", "[algebra][functions]") {
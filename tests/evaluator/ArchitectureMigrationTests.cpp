@@ -3,11 +3,14 @@
 #include "evaluator/EvaluationContext.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
 #include "evaluator/Evaluator.hpp"
+#include "kernel/CounterRandom.hpp"
 #include "kernel/Diagnostics.hpp"
+#include "kernel/ExprReclaimer.hpp"
 #include "kernel/EvaluationContext.hpp"
 #include "kernel/FunctionRegistry.hpp"
 #include "kernel/Lowering.hpp"
 #include "kernel/Rewrite.hpp"
+#include "kernel/StringReplacement.hpp"
 #include "kernel/TrustedSubsetBridge.hpp"
 #include "normalizer/Normalizer.hpp"
 #include "packs/AlgebraPack.hpp"
@@ -18,6 +21,9 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
+#include <vector>
+
 using namespace aleph3;
 
 TEST_CASE("EvaluationContext exposes symbol tables through compatibility aliases", "[architecture][symbols]") {
@@ -134,7 +140,266 @@ TEST_CASE("Assumption store derives sign facts for simple arithmetic forms", "[a
                 make_expr<Number>(0.0),
                 parse_expression("-x")) == std::optional<bool>(false));
     REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("x + 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("x + z")) ==
+            std::nullopt);
+}
+
+TEST_CASE("Assumption store propagates interval bounds through arithmetic", "[architecture][assumptions]") {
+    EvaluationContext ctx;
+    ctx.assumptions.assume(parse_expression("x > 3"));
+    ctx.assumptions.assume(parse_expression("y <= -1"));
+    ctx.assumptions.assume(parse_expression("IntegerQ[n]"));
+    ctx.assumptions.assume(parse_expression("n > 0"));
+
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Greater",
+                make_expr<Symbol>("x"),
+                make_expr<Number>(0.0)) == std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Greater",
+                make_expr<Symbol>("x"),
+                make_expr<Number>(2.0)) == std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Less",
+                make_expr<Symbol>("x"),
+                make_expr<Number>(3.0)) == std::optional<bool>(false));
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Greater",
+                make_expr<Symbol>("x"),
+                make_expr<Number>(5.0)) == std::nullopt);
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Greater",
+                make_expr<Symbol>("x"),
+                make_expr<Symbol>("y")) == std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("x - 3")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Negative", parse_expression("x * y")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Negative", parse_expression("y / x")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("y^2 - 1")) ==
+            std::nullopt);
+    REQUIRE(ctx.assumptions.evaluate_predicate("NonNegative", parse_expression("y^2 - 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("NonNegative", parse_expression("n - 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("IntegerQ", parse_expression("n + 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_predicate("RealQ", parse_expression("x + y")) ==
+            std::optional<bool>(true));
+}
+
+TEST_CASE("Assumption store caches derivations until new facts arrive", "[architecture][assumptions]") {
+    EvaluationContext ctx;
+    ctx.assumptions.assume(parse_expression("x > 0"));
+
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("x + 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.cached_derivation_count() == 1);
+
+    // A structurally equal tree reuses the cached derivation.
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("x + 1")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.cached_derivation_count() == 1);
+
+    REQUIRE(ctx.assumptions.evaluate_predicate("Negative", parse_expression("x - 5")) ==
             std::nullopt);
+    ctx.assumptions.assume(parse_expression("x < 4"));
+    REQUIRE(ctx.assumptions.cached_derivation_count() == 0);
+    REQUIRE(ctx.assumptions.evaluate_predicate("Negative", parse_expression("x - 5")) ==
+            std::optional<bool>(true));
+}
+
+TEST_CASE("Assumption store reuses cached facts for shared subterms", "[architecture][assumptions]") {
+    EvaluationContext ctx;
+    ctx.assumptions.assume(parse_expression("x > 0"));
+
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("Sqrt[x + 1] + (x + 2)^2")) ==
+            std::optional<bool>(true));
+    const auto cached = ctx.assumptions.cached_derivation_count();
+    const auto hits = ctx.assumptions.derivation_cache_hits();
+    REQUIRE(cached >= 5);
+
+    // A new parent over the same subterms derives only itself.
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", parse_expression("Sqrt[x + 1] * (x + 2)^2")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.cached_derivation_count() == cached + 1);
+    REQUIRE(ctx.assumptions.derivation_cache_hits() == hits + 2);
+}
+
+TEST_CASE("Assumption frames restore the enclosing facts on pop", "[architecture][assumptions]") {
+    EvaluationContext ctx;
+    ctx.assumptions.assume(parse_expression("x >= 0"));
+
+    ctx.assumptions.push_frame();
+    ctx.assumptions.assume(parse_expression("x != 0"));
+    ctx.assumptions.assume(parse_expression("y < x"));
+    ctx.assumptions.assume(parse_expression("flag"));
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", make_expr<Symbol>("x")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Less",
+                make_expr<Symbol>("y"),
+                make_expr<Symbol>("x")) == std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.frame_depth() == 1);
+    ctx.assumptions.pop_frame();
+
+    REQUIRE(ctx.assumptions.frame_depth() == 0);
+    REQUIRE(ctx.assumptions.evaluate_predicate("Positive", make_expr<Symbol>("x")) == std::nullopt);
+    REQUIRE(ctx.assumptions.evaluate_predicate("NonNegative", make_expr<Symbol>("x")) ==
+            std::optional<bool>(true));
+    REQUIRE(ctx.assumptions.evaluate_comparison(
+                "Less",
+                make_expr<Symbol>("y"),
+                make_expr<Symbol>("x")) == std::nullopt);
+    REQUIRE(ctx.assumptions.find_symbol_facts("y") == nullptr);
+    REQUIRE(ctx.assumptions.find_boolean_value("flag") == std::nullopt);
+}
+
+TEST_CASE("Expression handles share one counted node", "[architecture][expr]") {
+    auto node = make_expr<Symbol>("x");
+    REQUIRE(node.use_count() == 1);
+
+    auto copy = node;
+    REQUIRE(copy == node);
+    REQUIRE(node.use_count() == 2);
+
+    auto moved = std::move(copy);
+    REQUIRE(copy == nullptr);
+    REQUIRE(node.use_count() == 2);
+
+    moved.reset();
+    REQUIRE_FALSE(moved);
+    REQUIRE(node.use_count() == 1);
+    REQUIRE(std::get<Symbol>(*node).name == "x");
+
+    // Structurally equal nodes are still distinct handles.
+    REQUIRE(make_expr<Symbol>("x") != node);
+}
+
+TEST_CASE("Deep expression trees are freed without deep recursion", "[architecture][expr]") {
+    // Far deeper than a recursive release could go on a default stack.
+    ExprPtr chain = make_expr<Symbol>("x");
+    for (int level = 0; level < 1000000; ++level) {
+        if (level % 2 == 0) {
+            chain = make_expr<FunctionCall>("f", std::vector<ExprPtr>{chain, make_expr<Number>(level)});
+        } else {
+            chain = make_expr<List>(std::vector<ExprPtr>{chain});
+        }
+    }
+    const auto shared_leaf = make_expr<Symbol>("y");
+    chain = make_expr<Rule>(chain, shared_leaf);
+    chain.reset();
+    REQUIRE(shared_leaf.use_count() == 1);
+}
+
+TEST_CASE("Expression reclaimer frees large dead trees in the background", "[architecture][expr]") {
+    kernel::ExprReclaimer reclaimer(64);
+
+    std::vector<ExprPtr> elements;
+    for (int index = 0; index < 100; ++index) {
+        elements.push_back(make_expr<Number>(index));
+    }
+    const auto shared = make_expr<List>(elements);
+    auto large = make_expr<FunctionCall>("f", std::vector<ExprPtr>{shared});
+    auto small = make_expr<FunctionCall>("f", std::vector<ExprPtr>{make_expr<Number>(1)});
+
+    // Only the last handle to a large enough tree is queued.
+    REQUIRE_FALSE(reclaimer.retire(small));
+    auto kept = large;
+    REQUIRE_FALSE(reclaimer.retire(kept));
+    kept.reset();
+    REQUIRE(reclaimer.retire(std::move(large)) == expr_refcount_is_atomic);
+    reclaimer.drain();
+
+    const auto metrics = reclaimer.metrics();
+    REQUIRE(metrics.trees_queued == (expr_refcount_is_atomic ? 1 : 0));
+    REQUIRE(metrics.trees_freed == metrics.trees_queued);
+    REQUIRE(metrics.queue_depth == 0);
+    REQUIRE(metrics.max_queue_depth == metrics.trees_queued);
+    // The queued tree shared its list with `shared`, which is left intact.
+    REQUIRE(shared.use_count() == 1);
+    REQUIRE(std::get<List>(*shared).elements.size() == 100);
+}
+
+TEST_CASE("Shared strings join short parts flat and long parts as ropes", "[architecture][expr][string]") {
+    SharedString small = SharedString::concat("ab", "cd");
+    REQUIRE_FALSE(small.is_rope());
+    REQUIRE(small == "abcd");
+
+    const std::string block(SharedString::flat_join_limit, 'x');
+    SharedString rope = SharedString::concat(block, "tail");
+    REQUIRE(rope.is_rope());
+    REQUIRE(rope.size() == block.size() + 4);
+    REQUIRE(rope.str() == block + "tail");
+
+    // Appending a few bytes at a time, as StringJoin does for `s = s <> "..."`,
+    // keeps the rope shallow enough to flatten and to free.
+    SharedString grown;
+    std::string expected;
+    for (int i = 0; i < 50000; ++i) {
+        grown = SharedString::join({grown, "token-"});
+        expected += "token-";
+    }
+    REQUIRE(grown.is_rope());
+    REQUIRE(grown == expected);
+    REQUIRE_FALSE(grown.is_rope());
+
+    SharedString joined = SharedString::join({"a", rope, "b", ""});
+    REQUIRE(joined.str() == "a" + block + "tailb");
+
+    SharedString copy = joined;
+    REQUIRE(copy.shares_storage_with(joined));
+}
+
+TEST_CASE("Evaluated nodes are reused until a value, definition, or assumption changes", "[architecture][stamps]") {
+    EvaluationContext ctx;
+    auto sum = evaluate(parse_expression("x + 1"), ctx);
+    auto list = evaluate(parse_expression("{x, 2 x}"), ctx);
+    auto positive = evaluate(parse_expression("Positive[x]"), ctx);
+    REQUIRE(evaluate(sum, ctx) == sum);
+    REQUIRE(evaluate(list, ctx) == list);
+    REQUIRE(evaluate(positive, ctx) == positive);
+
+    // Another root context has its own bindings and never trusts the stamp.
+    EvaluationContext other;
+    REQUIRE(evaluate(sum, other) != sum);
+
+    // A rebuilt copy of an evaluated node starts unstamped.
+    auto copy = make_expr_node(*sum);
+    REQUIRE(evaluate(copy, ctx) != copy);
+
+    ctx.assumptions.assume(parse_expression("x > 0"));
+    REQUIRE(std::get<Boolean>(*evaluate(positive, ctx)).value);
+
+    evaluate(parse_expression("x = 2"), ctx);
+    auto updated = evaluate(sum, ctx);
+    REQUIRE(std::get<Number>(*updated).value == 3.0);
+
+    evaluate(parse_expression("g[y_] := y"), ctx);
+    auto call = evaluate(parse_expression("h[1]"), ctx);
+    REQUIRE(evaluate(call, ctx) == call);
+    evaluate(parse_expression("h[n_] := n + 1"), ctx);
+    REQUIRE(std::get<Number>(*evaluate(call, ctx)).value == 2.0);
+}
+
+TEST_CASE("Evaluation stamps survive user function calls and unrelated contexts", "[architecture][stamps]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("k[y_] := {y, z}"), ctx);
+
+    // Applying k copies the context; that alone is not a write.
+    auto applied = evaluate(parse_expression("k[a]"), ctx);
+    REQUIRE(std::holds_alternative<List>(*applied));
+    REQUIRE(evaluate(applied, ctx) == applied);
+
+    EvaluationContext unrelated;
+    EvaluationContext copy = ctx;
+    REQUIRE(evaluate(applied, ctx) == applied);
+    REQUIRE(evaluate(applied, copy) == applied);
+
+    evaluate(parse_expression("z = 3"), unrelated);
+    REQUIRE(evaluate(applied, ctx) != applied);
 }
 
 TEST_CASE("Built-in symbolic surface is registered through the pack registry", "[architecture][packs]") {
@@ -329,6 +594,34 @@ TEST_CASE("Fresh default registries copy the same bootstrap surface but remain i
     REQUIRE(right.find_symbolic_function_spec("Expand") != nullptr);
 }
 
+TEST_CASE("Default registries are overlays on one frozen built-in registry", "[architecture][kernel][registry]") {
+    auto overlay = kernel::create_default_function_registry();
+    REQUIRE(overlay.base() == kernel::shared_default_function_registry());
+    REQUIRE(overlay.local_registration_count() == 0);
+    REQUIRE(overlay.find_symbolic_function_spec("StringJoin") ==
+        kernel::default_function_registry().find_symbolic_function_spec("StringJoin"));
+
+    const auto base_plus_rewrites = kernel::default_function_registry().find_head_rewrites("Plus")->size();
+    overlay.register_head_rewrite(
+        "Plus",
+        "overlay-only",
+        [](const FunctionCall&, EvaluationContext&) -> std::optional<ExprPtr> { return std::nullopt; },
+        100);
+    overlay.register_function(
+        "StringJoin",
+        [](const FunctionCall&, EvaluationContext&) -> ExprPtr { return make_expr<String>("shadowed"); });
+
+    // The overlay's Plus list extends the inherited one; the base is untouched.
+    REQUIRE(overlay.find_head_rewrites("Plus")->size() == base_plus_rewrites + 1);
+    REQUIRE(overlay.find_head_rewrites("Plus")->back().rewrite_name == "overlay-only");
+    REQUIRE(kernel::default_function_registry().find_head_rewrites("Plus")->size() == base_plus_rewrites);
+
+    EvaluationContext overlay_ctx(overlay);
+    REQUIRE(std::get<String>(*evaluate(parse_expression("StringJoin[\"a\", \"b\"]"), overlay_ctx)).value == "shadowed");
+    EvaluationContext default_ctx(kernel::default_function_registry());
+    REQUIRE(std::get<String>(*evaluate(parse_expression("StringJoin[\"a\", \"b\"]"), default_ctx)).value == "ab");
+}
+
 TEST_CASE("Evaluation context resolves builtins from its active registry", "[architecture][kernel][registry]") {
     kernel::FunctionRegistry empty_registry;
     EvaluationContext empty_ctx(empty_registry);
@@ -1347,3 +1640,55 @@ TEST_CASE("Kernel evaluator can execute registered host functions through the sh
     REQUIRE(std::holds_alternative<Number>(*result));
     REQUIRE(std::get<Number>(*result).value == 8.0);
 }
+
+TEST_CASE("Kernel string replacer compiles each rule list once", "[architecture][kernel][string]") {
+    const std::vector<kernel::StringReplacementRule> rules{{"he", "HE"}, {"she", "SHE"}, {"hers", "HERS"}, {"s", "_"}};
+    kernel::StringReplacer replacer(rules);
+    // "ushers": "she" starts at 1, "he"/"hers" at 2; the match at 1 wins and
+    // consumes "she", leaving "rs" where only "s" matches.
+    REQUIRE(replacer.apply("ushers") == "uSHEr_");
+    REQUIRE(replacer.apply("") == "");
+    REQUIRE(replacer.apply("xyz") == "xyz");
+
+    auto cached = kernel::cached_string_replacer(rules);
+    REQUIRE(kernel::cached_string_replacer(rules) == cached);
+    REQUIRE(cached->apply("hers") == "HEr_");
+    REQUIRE(kernel::cached_string_replacer({{"s", "_"}}) != cached);
+}
+
+TEST_CASE("Kernel random streams address every draw by counter", "[architecture][kernel][random]") {
+    // Philox4x32-10 known-answer vectors from the Random123 distribution.
+    REQUIRE(kernel::philox4x32({0, 0, 0, 0}, {0, 0}) ==
+            kernel::PhiloxCounter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    REQUIRE(kernel::philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+            kernel::PhiloxCounter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+
+    const kernel::RandomStream stream(42, 7);
+    std::vector<double> all(300000);
+    stream.fill_uniform(all, 0, 1);
+    for (std::size_t i : {std::size_t{0}, std::size_t{1}, std::size_t{12345}, all.size() - 1}) {
+        REQUIRE(all[i] == static_cast<double>(stream.bits(i) >> 11) * 0x1.0p-53);
+    }
+
+    // An odd-offset slice and a multi-threaded fill see the same draws.
+    std::vector<double> slice(1001);
+    stream.fill_uniform(slice, 99999, 1);
+    REQUIRE(std::equal(slice.begin(), slice.end(), all.begin() + 99999));
+    std::vector<double> threaded(all.size());
+    stream.fill_uniform(threaded, 0, 4);
+    REQUIRE(threaded == all);
+
+    std::vector<double> normals(4096);
+    std::vector<double> normal_slice(11);
+    stream.fill_normal(normals, 0, 1);
+    stream.fill_normal(normal_slice, 301, 1);
+    REQUIRE(std::equal(normal_slice.begin(), normal_slice.end(), normals.begin() + 301));
+
+    std::vector<double> dice(10000);
+    stream.fill_integers(dice, -3, 7, 0, 1);
+    REQUIRE(*std::min_element(dice.begin(), dice.end()) == -3.0);
+    REQUIRE(*std::max_element(dice.begin(), dice.end()) == 3.0);
+
+    REQUIRE(kernel::RandomStream(42, 8).bits(0) != stream.bits(0));
+    REQUIRE(kernel::RandomStream(43, 7).bits(0) != stream.bits(0));
+}
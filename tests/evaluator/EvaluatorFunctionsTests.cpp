@@ -2,13 +2,19 @@
 #include "evaluator/Evaluator.hpp"
 #include "evaluator/EvaluatorErrors.hpp"
 #include "expr/Expr.hpp"
+#include "expr/ExprSummary.hpp"
 #include "Constants.hpp"
 #include "evaluator/EvaluationContext.hpp"
 #include "transforms/Transforms.hpp"
+#include "kernel/Rewrite.hpp"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <span>
 #include <stdexcept>
+#include <string>
 
 using namespace aleph3;
 
@@ -232,6 +238,170 @@ TEST_CASE("Evaluator resolves default arguments at call time", "[evaluator][func
     REQUIRE(std::get<Number>(*second).value == 13.0);
 }
 
+TEST_CASE("Memoize attribute caches user-defined function results", "[evaluator][functions][memoize]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("fib[n_] := If[n < 2, n, fib[n - 1] + fib[n - 2]]"), ctx);
+    evaluate(parse_expression("SetAttributes[fib, Memoize]"), ctx);
+
+    // Exponential without the cache; linear with it.
+    auto result = evaluate(parse_expression("fib[70]"), ctx);
+    REQUIRE(get_number_value(result) == 190392490709135.0);
+    REQUIRE(ctx.function_memo().entry_count("fib") == 71);
+
+    // Structurally equal arguments hit the same entry.
+    result = evaluate(parse_expression("fib[35 + 35]"), ctx);
+    REQUIRE(get_number_value(result) == 190392490709135.0);
+    REQUIRE(ctx.function_memo().entry_count("fib") == 71);
+
+    // Redefining the function drops stale values.
+    evaluate(parse_expression("fib[n_] := n"), ctx);
+    REQUIRE(ctx.function_memo().entry_count("fib") == 0);
+    REQUIRE(get_number_value(evaluate(parse_expression("fib[70]"), ctx)) == 70.0);
+
+    evaluate(parse_expression("ClearAttributes[fib, Memoize]"), ctx);
+    evaluate(parse_expression("fib[3]"), ctx);
+    REQUIRE(ctx.function_memo().entry_count("fib") == 0);
+
+    REQUIRE_THROWS_WITH(
+        evaluate(parse_expression("SetAttributes[fib, Orderless]"), ctx),
+        "SetAttributes currently supports only the Memoize attribute");
+}
+
+TEST_CASE("Memoize bypasses the cache inside assumption scopes", "[evaluator][functions][memoize]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("g[n_] := Refine[Sqrt[y^2]]"), ctx);
+    evaluate(parse_expression("SetAttributes[g, Memoize]"), ctx);
+
+    REQUIRE(to_string(evaluate(parse_expression("Assuming[y > 0, g[1]]"), ctx)) == "y");
+    REQUIRE(ctx.function_memo().entry_count("g") == 0);
+
+    const auto unscoped = to_string(evaluate(parse_expression("Refine[Sqrt[y^2]]"), ctx));
+    REQUIRE(unscoped != "y");
+    REQUIRE(to_string(evaluate(parse_expression("g[1]"), ctx)) == unscoped);
+    REQUIRE(ctx.function_memo().entry_count("g") == 1);
+
+    // An entry stored outside the scope is not served inside it either.
+    REQUIRE(to_string(evaluate(parse_expression("Assuming[y > 0, g[1]]"), ctx)) == "y");
+}
+
+TEST_CASE("Memo caches honor the eviction policy configured on the context", "[evaluator][functions][memoize]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("sq[x_] := x^2"), ctx);
+    evaluate(parse_expression("SetAttributes[sq, {Memoize}]"), ctx);
+
+    SECTION("least recently used keeps recently hit entries") {
+        ctx.set_memo_policy({2, kernel::MemoEvictionPolicy::least_recently_used});
+        evaluate(parse_expression("sq[1]"), ctx);
+        evaluate(parse_expression("sq[2]"), ctx);
+        evaluate(parse_expression("sq[1]"), ctx);
+        evaluate(parse_expression("sq[3]"), ctx);
+
+        REQUIRE(ctx.function_memo().entry_count("sq") == 2);
+        REQUIRE(ctx.function_memo().lookup("sq", {make_expr<Number>(1)}) != nullptr);
+        REQUIRE(ctx.function_memo().lookup("sq", {make_expr<Number>(2)}) == nullptr);
+    }
+
+    SECTION("first in first out ignores hits") {
+        ctx.set_memo_policy({2, kernel::MemoEvictionPolicy::first_in_first_out});
+        evaluate(parse_expression("sq[1]"), ctx);
+        evaluate(parse_expression("sq[2]"), ctx);
+        evaluate(parse_expression("sq[1]"), ctx);
+        evaluate(parse_expression("sq[3]"), ctx);
+
+        REQUIRE(ctx.function_memo().entry_count("sq") == 2);
+        REQUIRE(ctx.function_memo().lookup("sq", {make_expr<Number>(1)}) == nullptr);
+        REQUIRE(ctx.function_memo().lookup("sq", {make_expr<Number>(2)}) != nullptr);
+    }
+
+    SECTION("clear when full restarts the cache") {
+        ctx.set_memo_policy({2, kernel::MemoEvictionPolicy::clear_when_full});
+        evaluate(parse_expression("sq[1]"), ctx);
+        evaluate(parse_expression("sq[2]"), ctx);
+        evaluate(parse_expression("sq[3]"), ctx);
+
+        REQUIRE(ctx.function_memo().entry_count("sq") == 1);
+        REQUIRE(ctx.function_memo().lookup("sq", {make_expr<Number>(3)}) != nullptr);
+    }
+}
+
+TEST_CASE("Pattern definitions coexist for one head and dispatch by specificity", "[evaluator][functions][patterns]") {
+    EvaluationContext ctx;
+
+    SECTION("literal base case alongside a general definition") {
+        evaluate(parse_expression("fact[0] := 1"), ctx);
+        evaluate(parse_expression("fact[n_] := n * fact[n - 1]"), ctx);
+        REQUIRE(get_number_value(evaluate(parse_expression("fact[10]"), ctx)) == 3628800.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("fact[0]"), ctx)) == 1.0);
+    }
+
+    SECTION("literal before compound before blank regardless of definition order") {
+        evaluate(parse_expression("h[x_, y_] := 3"), ctx);
+        evaluate(parse_expression("h[g[x_], y_] := x + y"), ctx);
+        evaluate(parse_expression("h[g[1], y_] := 1"), ctx);
+
+        REQUIRE(get_number_value(evaluate(parse_expression("h[g[1], 5]"), ctx)) == 1.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("h[g[2], 5]"), ctx)) == 7.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("h[k[2], 5]"), ctx)) == 3.0);
+    }
+
+    SECTION("an identical left-hand side replaces the earlier definition") {
+        evaluate(parse_expression("r[1] := 10"), ctx);
+        evaluate(parse_expression("r[1] := 20"), ctx);
+        REQUIRE(get_number_value(evaluate(parse_expression("r[1]"), ctx)) == 20.0);
+        REQUIRE(ctx.pattern_definitions.lookup("r")->definitions().size() == 1);
+    }
+
+    SECTION("immediate definitions evaluate the right-hand side once") {
+        evaluate(parse_expression("c = 2"), ctx);
+        auto value = evaluate(parse_expression("s[0] = c + 1"), ctx);
+        REQUIRE(get_number_value(value) == 3.0);
+        evaluate(parse_expression("c = 100"), ctx);
+        REQUIRE(get_number_value(evaluate(parse_expression("s[0]"), ctx)) == 3.0);
+    }
+
+    SECTION("calls that match no definition stay unevaluated") {
+        evaluate(parse_expression("u[0] := 1"), ctx);
+        auto result = evaluate(parse_expression("u[1 + 1]"), ctx);
+        REQUIRE(to_string(result) == "u[2]");
+    }
+
+    SECTION("the index only offers definitions that can match") {
+        for (int i = 0; i < 50; ++i) {
+            evaluate(parse_expression("t[" + std::to_string(i) + "] := " + std::to_string(i * i)), ctx);
+        }
+        evaluate(parse_expression("t[g[x_]] := x"), ctx);
+        evaluate(parse_expression("t[n_] := -1"), ctx);
+
+        // t[n_] is the plain definition and lives outside the pattern set.
+        const auto* set = ctx.pattern_definitions.lookup("t");
+        REQUIRE(set->definitions().size() == 51);
+        REQUIRE(set->candidate_count({make_expr<Number>(7)}) == 1);
+        REQUIRE(set->candidate_count({make_fcall("g", {make_expr<Number>(7)})}) == 1);
+        REQUIRE(set->candidate_count({make_expr<Number>(70)}) == 0);
+        REQUIRE(set->candidate_count({make_expr<Number>(7), make_expr<Number>(1)}) == 0);
+        REQUIRE(get_number_value(evaluate(parse_expression("t[7]"), ctx)) == 49.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("t[g[7]]"), ctx)) == 7.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("t[70]"), ctx)) == -1.0);
+    }
+
+    SECTION("a later, more specific definition goes ahead of its bucket") {
+        evaluate(parse_expression("q[g[x_], y_] := 1"), ctx);
+        evaluate(parse_expression("q[g[x_], 0] := 2"), ctx);
+        evaluate(parse_expression("q[g[x_], z_] := 3"), ctx);
+        REQUIRE(get_number_value(evaluate(parse_expression("q[g[5], 0]"), ctx)) == 2.0);
+        REQUIRE(get_number_value(evaluate(parse_expression("q[g[5], 4]"), ctx)) == 1.0);
+        REQUIRE(ctx.pattern_definitions.lookup("q")->definitions().size() == 3);
+    }
+
+    SECTION("memoized pattern definitions share the function cache") {
+        evaluate(parse_expression("fib[0] := 0"), ctx);
+        evaluate(parse_expression("fib[1] := 1"), ctx);
+        evaluate(parse_expression("fib[n_] := fib[n - 1] + fib[n - 2]"), ctx);
+        evaluate(parse_expression("SetAttributes[fib, Memoize]"), ctx);
+        REQUIRE(get_number_value(evaluate(parse_expression("fib[70]"), ctx)) == 190392490709135.0);
+    }
+}
+
 void check_builtin_eval(const std::string& expr_str, double expected, double tol = 1e-12) {
     EvaluationContext ctx;
     try {
@@ -603,3 +773,391 @@ TEST_CASE("Evaluator behaviour for nested function calls", "[evaluator][function
         validate_evaluator_result(tc.expr_str, tc.expected);
     }
 }
+
+TEST_CASE("Parallel builtins give the same results and errors for any thread count", "[evaluator][functions][parallel]") {
+    for (const std::size_t threads : {1, 2, 4}) {
+        EvaluationContext ctx;
+        ctx.set_parallel_thread_count(threads);
+        evaluate(parse_expression("sq[x_] := x^2"), ctx);
+        evaluate(parse_expression("bad[x_] := If[x == 2, StringLength[x], If[x == 3, StringJoin[x], x]]"), ctx);
+
+        auto mapped = evaluate(parse_expression("ParallelMap[sq, {1, 2, 3, 4, 5}]"), ctx);
+        REQUIRE(to_string(mapped) == "{1, 4, 9, 16, 25}");
+
+        auto table = evaluate(parse_expression("ParallelTable[sq[i] + 1, {i, 0, 10, 5}]"), ctx);
+        REQUIRE(to_string(table) == "{1, 26, 101}");
+        // The iterator binding stays inside the workers.
+        REQUIRE(to_string(evaluate(parse_expression("i"), ctx)) == "i");
+
+        auto sum = evaluate(parse_expression("ParallelSum[sq[k], {k, 100}]"), ctx);
+        REQUIRE(get_number_value(sum) == 338350.0);
+        auto symbolic = evaluate(parse_expression("ParallelSum[y^k, {k, 2}]"), ctx);
+        REQUIRE(to_string(symbolic) == to_string(evaluate(parse_expression("y + y^2"), ctx)));
+
+        // Items 2 and 3 both fail; the lower index is reported.
+        REQUIRE_THROWS_WITH(
+            evaluate(parse_expression("ParallelMap[bad, {1, 2, 3, 4}]"), ctx),
+            "StringLength expects a string argument");
+    }
+}
+
+TEST_CASE("Parallel builtins charge worker steps to the caller's budget", "[evaluator][functions][parallel]") {
+    Bindings bindings;
+    Bindings constants;
+    kernel::HostFunctionRegistry host_functions;
+    Policy policy = Policy::default_policy();
+    policy.budget().max_evaluation_steps = 100000;
+
+    std::size_t sequential_steps = 0;
+    for (const std::size_t threads : {1, 4}) {
+        EvaluationContext ctx(bindings, constants, host_functions, policy);
+        ctx.set_parallel_thread_count(threads);
+        ctx.enable_runtime_strict_semantics(true);
+        ctx.reset_runtime_step_counter();
+
+        evaluate(parse_expression("ParallelTable[i^2 + 1, {i, 50}]"), ctx);
+        if (threads == 1) {
+            sequential_steps = ctx.evaluation_steps_used();
+            REQUIRE(sequential_steps > 50);
+        } else {
+            REQUIRE(ctx.evaluation_steps_used() == sequential_steps);
+        }
+    }
+
+    policy.budget().max_evaluation_steps = 20;
+    EvaluationContext ctx(bindings, constants, host_functions, policy);
+    ctx.set_parallel_thread_count(4);
+    ctx.enable_runtime_strict_semantics(true);
+    ctx.reset_runtime_step_counter();
+    REQUIRE_THROWS_AS(evaluate(parse_expression("ParallelTable[i^2 + 1, {i, 50}]"), ctx), kernel::RuntimeFailure);
+
+    // Each item fits in the budget on its own, but the workers spend one
+    // budget between them, so the call stops long before every item is done.
+    std::atomic<std::size_t> completed{0};
+    HostFunctionSpec item_done;
+    item_done.name = "ItemDone";
+    item_done.arity = FunctionArity::exact(1);
+    item_done.callback = [&completed](std::span<const Value> arguments) {
+        completed.fetch_add(1);
+        EvaluationResult result;
+        result.value = arguments[0];
+        return result;
+    };
+    kernel::FunctionRegistry::register_host_function(host_functions, item_done);
+
+    policy.budget().max_evaluation_steps = 100000;
+    EvaluationContext measure(bindings, constants, host_functions, policy);
+    measure.enable_runtime_strict_semantics(true);
+    measure.reset_runtime_step_counter();
+    evaluate(parse_expression("ParallelTable[ItemDone[ParallelSum[k^2, {k, 100}]], {i, 1}]"), measure);
+    const auto item_steps = measure.evaluation_steps_used();
+
+    constexpr std::size_t item_count = 64;
+    policy.budget().max_evaluation_steps = 4 * item_steps;
+    EvaluationContext shared(bindings, constants, host_functions, policy);
+    shared.set_parallel_thread_count(4);
+    shared.enable_runtime_strict_semantics(true);
+    shared.reset_runtime_step_counter();
+    completed = 0;
+    try {
+        evaluate(parse_expression("ParallelTable[ItemDone[ParallelSum[k^2, {k, 100}]], {i, 64}]"), shared);
+        FAIL("ParallelTable should exceed the step budget");
+    } catch (const kernel::RuntimeFailure& failure) {
+        REQUIRE(failure.error().code == "runtime.step_budget_exhausted");
+    }
+    REQUIRE(completed.load() < item_count);
+}
+
+TEST_CASE("Random builtins replay from a seed and respect their ranges", "[evaluator][functions][random]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("SeedRandom[42]"), ctx);
+    const auto first = to_string(evaluate(parse_expression("{RandomReal[], RandomInteger[{1, 6}, 5], RandomVariate[NormalDistribution[], 3]}"), ctx));
+    const auto second = to_string(evaluate(parse_expression("RandomReal[]"), ctx));
+    evaluate(parse_expression("SeedRandom[42]"), ctx);
+    REQUIRE(to_string(evaluate(parse_expression("{RandomReal[], RandomInteger[{1, 6}, 5], RandomVariate[NormalDistribution[], 3]}"), ctx)) == first);
+    REQUIRE(to_string(evaluate(parse_expression("RandomReal[]"), ctx)) == second);
+    evaluate(parse_expression("SeedRandom[43]"), ctx);
+    REQUIRE(to_string(evaluate(parse_expression("{RandomReal[], RandomInteger[{1, 6}, 5], RandomVariate[NormalDistribution[], 3]}"), ctx)) != first);
+
+    auto reals = evaluate(parse_expression("RandomReal[{-2, 3}, {4, 250}]"), ctx);
+    const auto& rows = std::get<List>(*reals).elements;
+    REQUIRE(rows.size() == 4);
+    for (const auto& row : rows) {
+        const auto& values = std::get<List>(*row).elements;
+        REQUIRE(values.size() == 250);
+        for (const auto& value : values) {
+            REQUIRE(get_number_value(value) >= -2.0);
+            REQUIRE(get_number_value(value) < 3.0);
+        }
+    }
+
+    auto dice = evaluate(parse_expression("RandomInteger[6, 1000]"), ctx);
+    for (const auto& value : std::get<List>(*dice).elements) {
+        const auto face = get_number_value(value);
+        REQUIRE(face == std::floor(face));
+        REQUIRE(face >= 0.0);
+        REQUIRE(face <= 6.0);
+    }
+
+    auto normals = evaluate(parse_expression("RandomVariate[NormalDistribution[3, 2], 20000]"), ctx);
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    for (const auto& value : std::get<List>(*normals).elements) {
+        sum += get_number_value(value);
+        sum_squares += get_number_value(value) * get_number_value(value);
+    }
+    const double mean = sum / 20000.0;
+    REQUIRE(std::abs(mean - 3.0) < 0.1);
+    REQUIRE(std::abs(std::sqrt(sum_squares / 20000.0 - mean * mean) - 2.0) < 0.1);
+
+    REQUIRE(to_string(evaluate(parse_expression("RandomReal[x]"), ctx)) == "RandomReal[x]");
+    REQUIRE(to_string(evaluate(parse_expression("RandomVariate[NormalDistribution[m, 1]]"), ctx)) ==
+            "RandomVariate[NormalDistribution[m, 1]]");
+    REQUIRE_THROWS(evaluate(parse_expression("RandomVariate[NormalDistribution[0, -1]]"), ctx));
+    REQUIRE_THROWS(evaluate(parse_expression("RandomInteger[{5, 1}]"), ctx));
+    // Bounds past 2^53 are not exact doubles, and this span overflows int64.
+    REQUIRE_THROWS(evaluate(parse_expression("RandomInteger[{-10^19, 10^19}]"), ctx));
+    REQUIRE_THROWS(evaluate(parse_expression("RandomInteger[2^60]"), ctx));
+    const auto widest = evaluate(parse_expression("RandomInteger[{-2^53, 2^53}, 100]"), ctx);
+    for (const auto& value : std::get<List>(*widest).elements) {
+        REQUIRE(std::abs(get_number_value(value)) <= 9007199254740992.0);
+    }
+    REQUIRE_THROWS(evaluate(parse_expression("RandomReal[1, -3]"), ctx));
+}
+
+TEST_CASE("Random builtins give the same values for any thread count", "[evaluator][functions][random][parallel]") {
+    std::string expected;
+    for (const std::size_t threads : {1, 2, 4}) {
+        EvaluationContext ctx;
+        ctx.set_parallel_thread_count(threads);
+        evaluate(parse_expression("SeedRandom[7]"), ctx);
+        const auto table = to_string(evaluate(parse_expression("ParallelTable[RandomReal[], {i, 6}]"), ctx));
+        // Large enough to be filled in several chunks.
+        const auto bulk = to_string(evaluate(parse_expression("RandomReal[1, 200000]"), ctx));
+        const auto after = to_string(evaluate(parse_expression("RandomInteger[1000]"), ctx));
+        const auto all = table + bulk + after;
+        if (threads == 1) {
+            expected = all;
+        } else {
+            REQUIRE(all == expected);
+        }
+    }
+}
+
+TEST_CASE("Random builtins take their seed from the policy", "[evaluator][functions][random]") {
+    Bindings bindings;
+    Bindings constants;
+    kernel::HostFunctionRegistry host_functions;
+    Policy policy = Policy::default_policy();
+    policy.set_random_seed(2024);
+
+    EvaluationContext first(bindings, constants, host_functions, policy);
+    EvaluationContext second(bindings, constants, host_functions, policy);
+    REQUIRE(to_string(evaluate(parse_expression("RandomReal[1, 5]"), first)) ==
+            to_string(evaluate(parse_expression("RandomReal[1, 5]"), second)));
+}
+
+TEST_CASE("Association builtins look up, update and list entries in insertion order", "[evaluator][functions][association]") {
+    EvaluationContext ctx;
+    auto eval = [&](const std::string& input) {
+        return to_string(evaluate(parse_expression(input), ctx));
+    };
+
+    evaluate(parse_expression("a = Association[x -> 1, {y -> 2, z -> 1 + 2}]"), ctx);
+    REQUIRE(eval("a") == "<|x -> 1, y -> 2, z -> 3|>");
+    REQUIRE(eval("Lookup[a, y]") == "2");
+    REQUIRE(eval("Lookup[a, w]") == "Missing[\"KeyAbsent\", w]");
+    REQUIRE(eval("Lookup[a, w, 0]") == "0");
+    REQUIRE(eval("KeyExistsQ[a, z]") == "True");
+    REQUIRE(eval("Keys[a]") == "{x, y, z}");
+    REQUIRE(eval("Values[a]") == "{1, 2, 3}");
+    REQUIRE(eval("Normal[a]") == "{x -> 1, y -> 2, z -> 3}");
+    REQUIRE(eval("Length[a]") == "3");
+
+    // Replacing keeps the position; re-adding a dropped key puts it last.
+    REQUIRE(eval("Append[a, x -> 10]") == "<|x -> 10, y -> 2, z -> 3|>");
+    REQUIRE(eval("Append[KeyDrop[a, x], x -> 10]") == "<|y -> 2, z -> 3, x -> 10|>");
+    REQUIRE(eval("KeyDrop[a, {x, z}]") == "<|y -> 2|>");
+    REQUIRE(eval("a") == "<|x -> 1, y -> 2, z -> 3|>");
+
+    // Keys compare by structure, not by identity.
+    REQUIRE(eval("Lookup[Association[f[1, {2}] -> \"hit\"], f[1, {2}]]") == "\"hit\"");
+    REQUIRE(eval("Association[p -> 1, p -> 2]") == "<|p -> 2|>");
+    REQUIRE_THROWS(evaluate(parse_expression("Lookup[{x -> 1}, x]"), ctx));
+}
+
+TEST_CASE("Association updates share storage and leave earlier versions intact", "[evaluator][functions][association]") {
+    auto number = [](double value) { return make_expr<Number>(value); };
+
+    std::vector<AssociationMap> versions{AssociationMap{}};
+    std::vector<std::vector<std::pair<double, double>>> expected{{}};
+    // Enough updates to go through several overlay compactions.
+    for (int step = 0; step < 400; ++step) {
+        const double key = static_cast<double>((step * 37) % 97);
+        auto entries = expected.back();
+        const auto found = std::find_if(entries.begin(), entries.end(), [&](const auto& entry) {
+            return entry.first == key;
+        });
+        if (step % 3 == 2) {
+            versions.push_back(versions.back().erase(number(key)));
+            if (found != entries.end()) {
+                entries.erase(found);
+            }
+        } else {
+            versions.push_back(versions.back().insert(number(key), number(step)));
+            if (found != entries.end()) {
+                found->second = step;
+            } else {
+                entries.emplace_back(key, step);
+            }
+        }
+        expected.push_back(std::move(entries));
+    }
+
+    for (std::size_t version = 0; version < versions.size(); ++version) {
+        const auto actual = versions[version].entries();
+        REQUIRE(actual.size() == expected[version].size());
+        REQUIRE(versions[version].size() == expected[version].size());
+        for (std::size_t index = 0; index < actual.size(); ++index) {
+            REQUIRE(get_number_value(actual[index].first) == expected[version][index].first);
+            REQUIRE(get_number_value(actual[index].second) == expected[version][index].second);
+            const auto* found = versions[version].find(actual[index].first);
+            REQUIRE(found != nullptr);
+            REQUIRE(get_number_value(*found) == expected[version][index].second);
+        }
+    }
+    REQUIRE(versions.back().find(number(1000.0)) == nullptr);
+}
+
+TEST_CASE("Sort, Union and the grouping builtins use one canonical order", "[evaluator][functions][sets]") {
+    EvaluationContext ctx;
+    auto eval = [&](const std::string& input) {
+        return to_string(evaluate(parse_expression(input), ctx));
+    };
+
+    REQUIRE(eval("Sort[{3, \"b\", x, 1/2, f[1], \"a\", 0.25, y, {1}}]") ==
+            "{0.25, 1/2, 3, \"a\", \"b\", x, y, {1}, f[1]}");
+    REQUIRE(eval("Ordering[{c, a, b}]") == "{2, 3, 1}");
+    REQUIRE(eval("Union[{c, a, c}, {b, a}, {}]") == "{a, b, c}");
+    REQUIRE(eval("Union[]") == "{}");
+    REQUIRE(eval("DeleteDuplicates[{b, a, b, f[x], f[x], \"a\"}]") == "{b, a, f[x], \"a\"}");
+    REQUIRE(eval("Tally[{\"a\", \"b\", \"a\"}]") == "{{\"a\", 2}, {\"b\", 1}}");
+
+    evaluate(parse_expression("size[n_] := If[n > 2, big, small]"), ctx);
+    REQUIRE(eval("GatherBy[{3, 1, 4, 1, 5}, size]") == "{{3, 4, 5}, {1, 1}}");
+    REQUIRE(eval("CountsBy[{3, 1, 4, 1, 5}, size]") == "<|big -> 3, small -> 2|>");
+    REQUIRE_THROWS(evaluate(parse_expression("Sort[x]"), ctx));
+}
+
+TEST_CASE("Sort fast paths agree with the canonical order", "[evaluator][functions][sets]") {
+    EvaluationContext ctx;
+    ctx.set_parallel_thread_count(4);
+    evaluate(parse_expression("SeedRandom[11]"), ctx);
+
+    // Long enough for the radix path; integers repeat, so stability shows.
+    auto values = std::get<List>(*evaluate(parse_expression("RandomInteger[{-50, 50}, 3000]"), ctx)).elements;
+    const auto reals = std::get<List>(*evaluate(parse_expression("RandomReal[{-1, 1}, 3000]"), ctx)).elements;
+    values.insert(values.end(), reals.begin(), reals.end());
+    const auto numbers = make_expr<List>(values);
+    const auto sorted = evaluate(make_expr<FunctionCall>("Sort", std::vector<ExprPtr>{numbers}), ctx);
+    const auto ordering = evaluate(make_expr<FunctionCall>("Ordering", std::vector<ExprPtr>{numbers}), ctx);
+    const auto& sorted_values = std::get<List>(*sorted).elements;
+    const auto& positions = std::get<List>(*ordering).elements;
+    REQUIRE(sorted_values.size() == values.size());
+    for (std::size_t index = 1; index < sorted_values.size(); ++index) {
+        REQUIRE(kernel::canonical_compare(sorted_values[index - 1], sorted_values[index]) <= 0);
+        if (kernel::canonical_compare(sorted_values[index - 1], sorted_values[index]) == 0) {
+            REQUIRE(get_number_value(positions[index - 1]) < get_number_value(positions[index]));
+        }
+    }
+
+    // Long enough to be sorted in parallel chunks.
+    std::vector<ExprPtr> strings;
+    for (int index = 0; index < 40000; ++index) {
+        strings.push_back(make_expr<String>("s" + std::to_string((index * 7919) % 10007)));
+    }
+    const auto string_list = make_expr<List>(strings);
+    std::string expected;
+    for (const std::size_t threads : {1, 4}) {
+        ctx.set_parallel_thread_count(threads);
+        const auto result = to_string(evaluate(make_expr<FunctionCall>("Ordering", std::vector<ExprPtr>{string_list}), ctx));
+        if (threads == 1) {
+            expected = result;
+        } else {
+            REQUIRE(result == expected);
+        }
+    }
+}
+
+TEST_CASE("Set builtins respect the policy's list limit under strict semantics", "[evaluator][functions][sets]") {
+    Bindings bindings;
+    Bindings constants;
+    kernel::HostFunctionRegistry host_functions;
+    Policy policy = Policy::default_policy();
+    policy.budget().max_list_elements = 4;
+
+    EvaluationContext ctx(bindings, constants, host_functions, policy);
+    ctx.enable_runtime_strict_semantics(true);
+    REQUIRE(to_string(evaluate(parse_expression("Union[{3, 1}, {2, 1}]"), ctx)) == "{1, 2, 3}");
+    REQUIRE_THROWS_AS(evaluate(parse_expression("Union[{3, 1, 4}, {2, 1}]"), ctx), kernel::RuntimeFailure);
+    REQUIRE_THROWS_AS(evaluate(parse_expression("Sort[{5, 4, 3, 2, 1}]"), ctx), kernel::RuntimeFailure);
+}
+
+TEST_CASE("FreeQ, Variables, LeafCount and Depth read the structure of an expression", "[evaluator][functions][structure]") {
+    EvaluationContext ctx;
+    auto eval = [&](const std::string& input) {
+        return to_string(evaluate(parse_expression(input), ctx));
+    };
+
+    REQUIRE(eval("FreeQ[f[x, g[y]], y]") == "False");
+    REQUIRE(eval("FreeQ[f[x, g[y]], z]") == "True");
+    REQUIRE(eval("FreeQ[f[x, g[y]], g]") == "False");
+    REQUIRE(eval("FreeQ[f[x, g[y]], g[y]]") == "False");
+    REQUIRE(eval("FreeQ[f[x, g[y]], g[x]]") == "True");
+    REQUIRE(eval("FreeQ[f[x, g[y]], g[u_]]") == "False");
+    REQUIRE(eval("FreeQ[f[x, {1, h[2]}], h[u_]]") == "False");
+    REQUIRE(eval("FreeQ[f[x, {1, 2}], h[u_]]") == "True");
+    REQUIRE(eval("FreeQ[{1, 2}, List]") == "False");
+    REQUIRE(eval("FreeQ[Association[a -> f[b]], b]") == "False");
+
+    REQUIRE(eval("Variables[f[y, Pi x, {z, 1}] + x]") == "{x, y, z}");
+    REQUIRE(eval("Variables[{1, 2.5, \"s\"}]") == "{}");
+
+    REQUIRE(eval("LeafCount[x]") == "1");
+    REQUIRE(eval("LeafCount[f[x, g[y, 2]]]") == "5");
+    REQUIRE(eval("LeafCount[{1/2, a -> b}]") == "7");
+    REQUIRE(eval("Depth[x]") == "1");
+    REQUIRE(eval("Depth[f[]]") == "1");
+    REQUIRE(eval("Depth[f[x, g[y, {1}]]]") == "4");
+    REQUIRE(eval("Depth[1/2]") == "1");
+    REQUIRE_THROWS(evaluate(parse_expression("FreeQ[x]"), ctx));
+}
+
+TEST_CASE("Expression summaries are cached per node and reset on copies", "[evaluator][functions][structure]") {
+    const auto leaf = make_expr<FunctionCall>("g", std::vector<ExprPtr>{make_expr<Symbol>("y"), make_expr<Number>(0.5)});
+    std::vector<ExprPtr> args;
+    for (int index = 0; index < 64; ++index) {
+        args.push_back(index % 2 == 0 ? leaf : make_expr<Number>(index));
+    }
+    const auto tree = make_expr<FunctionCall>("f", args);
+
+    const auto summary = expr_summary(tree);
+    REQUIRE(summary.leaf_count == 1 + 32 * 3 + 32);
+    REQUIRE(summary.depth == 3);
+    REQUIRE(summary.has_symbols);
+    REQUIRE(summary.has_fractional_number);
+    REQUIRE(may_contain_name(summary, "y"));
+    REQUIRE(may_contain_name(summary, "g"));
+    REQUIRE(std::get<FunctionCall>(*tree).summary.shape.load() != 0);
+    REQUIRE(expr_summary(tree).symbols == summary.symbols);
+
+    // A copy may be given other parts, so it is summarized afresh.
+    auto copy = std::get<FunctionCall>(*tree);
+    REQUIRE(copy.summary.shape.load() == 0);
+    copy.args.assign(3, make_expr<Number>(1));
+    const auto rebuilt = expr_summary(make_expr_node(std::move(copy)));
+    REQUIRE(rebuilt.leaf_count == 4);
+    REQUIRE_FALSE(rebuilt.has_symbols);
+    REQUIRE_FALSE(rebuilt.has_fractional_number);
+    REQUIRE_FALSE(rebuilt.has_non_numeric_leaf);
+}
@@ -3,6 +3,7 @@
 #include "parser/Parser.hpp"
 #include "evaluator/Evaluator.hpp"
 #include "expr/Expr.hpp"
+#include "expr/RationalAccumulator.hpp"
 
 using namespace aleph3;
 
@@ -326,3 +327,55 @@ TEST_CASE("Evaluator: Rational comparison operators", "[evaluator][rational][com
     }
 }
 
+
+TEST_CASE("RationalAccumulator reduces only when read or on overflow", "[evaluator][rational]") {
+    RationalAccumulator harmonic;
+    for (int64_t k = 1; k <= 20; ++k) {
+        REQUIRE(harmonic.add(1, k));
+    }
+    REQUIRE(harmonic.reduced() == std::pair<int64_t, int64_t>{55835135, 15519504});
+
+    // Terms over a divisor of the running denominator keep it unchanged.
+    RationalAccumulator thirds(1, 6);
+    REQUIRE(thirds.add(1, 3));
+    REQUIRE(thirds.add(-1, 2));
+    REQUIRE(thirds.is_zero());
+
+    // Unreduced growth that would overflow is retried over the lcm.
+    const int64_t big = int64_t{1} << 40;
+    RationalAccumulator wide(1, big);
+    REQUIRE(wide.add(1, big * 2));
+    REQUIRE(wide.add(1, big * 4));
+    REQUIRE(wide.reduced() == std::pair<int64_t, int64_t>{7, big * 4});
+
+    // A sum that cannot fit is refused and leaves the accumulator unchanged.
+    RationalAccumulator coprime(1, 1000000007);
+    REQUIRE_FALSE(coprime.add(1, 998244353LL * 999999937LL));
+    REQUIRE(coprime.reduced() == std::pair<int64_t, int64_t>{1, 1000000007});
+}
+
+TEST_CASE("Evaluator: Plus sums many rational terms exactly", "[evaluator][rational]") {
+    EvaluationContext ctx;
+    std::string input = "1/1";
+    for (int k = 2; k <= 20; ++k) {
+        input += " + 1/" + std::to_string(k);
+    }
+    auto result = evaluate(parse_expression(input), ctx);
+    REQUIRE(std::holds_alternative<Rational>(*result));
+    CHECK(std::get<Rational>(*result).numerator == 55835135);
+    CHECK(std::get<Rational>(*result).denominator == 15519504);
+}
+
+TEST_CASE("Evaluator: Plus stays inexact once a rational sum overflows", "[evaluator][rational]") {
+    EvaluationContext ctx;
+    // The second term cannot join the first over int64, so it is added as a
+    // double; the integral-looking numeric part must not be recombined with
+    // the exact part as if nothing had been lost.
+    auto sum = make_fcall("Plus", {
+        make_expr<Rational>(1, 1000000007),
+        make_expr<Rational>(1, 998244353LL * 999999937LL),
+        make_expr<Number>(3.0)});
+    auto result = evaluate(sum, ctx);
+    REQUIRE(std::holds_alternative<Number>(*result));
+    CHECK(get_number_value(result) == Catch::Approx(3.0 + 1.0 / 1000000007));
+}
@@ -686,6 +686,48 @@ TEST_CASE("Evaluator numeric-function listability preserves edge-case fallback e
     REQUIRE(to_string(sqrt_elements[2]) == "Sqrt[-1]");
 }
 
+TEST_CASE("Evaluator fuses chains of listable numeric builtins without changing results", "[evaluator][semantics][numeric][listable]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("x = {1, 2.5, -3, 4}"), ctx);
+    evaluate(parse_expression("y = {0.5, 6, 7, -8}"), ctx);
+
+    // The fused chain matches composing the same operators one at a time.
+    const auto fused = evaluate(parse_expression("Sqrt[x^2 + y^2] * Exp[-x] - ArcTan[y, x]"), ctx);
+    evaluate(parse_expression("a = x^2"), ctx);
+    evaluate(parse_expression("b = y^2"), ctx);
+    evaluate(parse_expression("c = Sqrt[a + b]"), ctx);
+    evaluate(parse_expression("d = Exp[-x]"), ctx);
+    const auto stepwise = evaluate(parse_expression("c * d - ArcTan[y, x]"), ctx);
+
+    REQUIRE(std::holds_alternative<List>(*fused));
+    const auto& fused_elements = std::get<List>(*fused).elements;
+    const auto& stepwise_elements = std::get<List>(*stepwise).elements;
+    REQUIRE(fused_elements.size() == 4);
+    for (size_t i = 0; i < fused_elements.size(); ++i) {
+        REQUIRE(get_number_value(fused_elements[i]) == get_number_value(stepwise_elements[i]));
+    }
+
+    // Flat heads with several list operands fold left element by element.
+    const auto chained = evaluate(parse_expression("3 * x * x + y + 1"), ctx);
+    REQUIRE(std::holds_alternative<List>(*chained));
+    const auto& chained_elements = std::get<List>(*chained).elements;
+    const double xs[] = {1, 2.5, -3, 4};
+    const double ys[] = {0.5, 6, 7, -8};
+    REQUIRE(chained_elements.size() == 4);
+    for (size_t i = 0; i < chained_elements.size(); ++i) {
+        REQUIRE(get_number_value(chained_elements[i]) == 3 * xs[i] * xs[i] + ys[i] + 1);
+    }
+
+    // Elements outside the real domain keep their symbolic fallback.
+    REQUIRE(to_string(evaluate(parse_expression("Sqrt[x - 2] + 1"), ctx)) == "{(Sqrt[-1]) + 1, 1.707107, (Sqrt[-5]) + 1, 2.414214}");
+    // Symbolic operands are threaded by the regular path.
+    REQUIRE(to_string(evaluate(parse_expression("Sin[x] + z"), ctx)) ==
+            to_string(evaluate(parse_expression("{Sin[1] + z, Sin[2.5] + z, Sin[-3] + z, Sin[4] + z}"), ctx)));
+    REQUIRE_THROWS_WITH(
+        evaluate(parse_expression("x + {1, 2}"), ctx),
+        "List sizes must match for elementwise operation");
+}
+
 TEST_CASE("Evaluator semantics registry drives structural and registry-backed symbolic dispatch", "[evaluator][semantics][dispatch]") {
     EvaluationContext ctx;
 
@@ -978,6 +1020,26 @@ TEST_CASE("Evaluator handles StringJoin", "[evaluator][string]") {
     REQUIRE(std::get<String>(*result).value == "Hello");
 }
 
+TEST_CASE("Evaluator shares string storage across steps", "[evaluator][string]") {
+    EvaluationContext ctx;
+    std::string expected;
+    evaluate(parse_expression("s = \"\""), ctx);
+    for (int i = 0; i < 400; ++i) {
+        evaluate(parse_expression("s = s <> \"ab\u00e9\""), ctx);
+        expected += "ab\u00e9";
+    }
+
+    auto value = evaluate(parse_expression("s"), ctx);
+    const auto& text = std::get<String>(*value).value;
+    REQUIRE(text.is_rope());
+    REQUIRE(std::get<Number>(*evaluate(parse_expression("StringLength[s]"), ctx)).value ==
+            static_cast<double>(expected.size()));
+    REQUIRE(text == expected);
+
+    // Re-evaluating a string shares its buffer instead of copying it.
+    REQUIRE(std::get<String>(*evaluate(value, ctx)).value.shares_storage_with(text));
+}
+
 TEST_CASE("Evaluator handles StringLength", "[evaluator][string]") {
     EvaluationContext ctx;
 
@@ -1022,6 +1084,30 @@ TEST_CASE("Evaluator handles StringReplace", "[evaluator][string]") {
     REQUIRE(std::get<String>(*result).value == "Hello");
 }
 
+TEST_CASE("Evaluator handles StringReplace with a list of rules", "[evaluator][string]") {
+    EvaluationContext ctx;
+    auto replace = [&ctx](const std::string& input) {
+        return std::get<String>(*evaluate(parse_expression(input), ctx)).value;
+    };
+
+    // Every rule applies in the same pass; replacements are never rescanned.
+    REQUIRE(replace("StringReplace[\"abcabc\", {\"a\" -> \"b\", \"b\" -> \"a\"}]") == "bacbac");
+
+    // At one position the earlier rule wins, even when a later one is longer.
+    REQUIRE(replace("StringReplace[\"abc\", {\"ab\" -> \"X\", \"abc\" -> \"Y\"}]") == "Xc");
+    REQUIRE(replace("StringReplace[\"abc\", {\"abc\" -> \"Y\", \"ab\" -> \"X\"}]") == "Y");
+
+    // Matches are taken left to right and do not overlap.
+    REQUIRE(replace("StringReplace[\"aaaa\", \"aa\" -> \"b\"]") == "bb");
+    REQUIRE(replace("StringReplace[\"abcd\", {\"bc\" -> \"X\", \"ab\" -> \"Y\"}]") == "Ycd");
+
+    // Empty patterns never match.
+    REQUIRE(replace("StringReplace[\"abc\", {\"\" -> \"X\", \"b\" -> \"\"}]") == "ac");
+
+    // A list holding a non-string rule leaves the string unchanged.
+    REQUIRE(replace("StringReplace[\"abc\", {\"a\" -> \"b\", x -> \"c\"}]") == "abc");
+}
+
 TEST_CASE("Evaluator handles StringTake", "[evaluator][string]") {
     EvaluationContext ctx;
 
@@ -1101,6 +1187,48 @@ TEST_CASE("Evaluator applies rewrite budget to ReplaceRepeated", "[evaluator][re
     REQUIRE_THROWS_AS(evaluate(expr, ctx), kernel::RuntimeFailure);
 }
 
+TEST_CASE("Evaluator rolls back assignments made inside Assuming and Refine", "[evaluator][assumptions]") {
+    EvaluationContext ctx;
+    evaluate(parse_expression("y = 1"), ctx);
+
+    auto body = make_fcall("List", {
+        make_expr<Assignment>("y", make_expr<Number>(2)),
+        make_expr<Assignment>("z", make_expr<Number>(3)),
+        parse_expression("y + z")});
+    auto result = evaluate(make_fcall("Assuming", {parse_expression("x > 0"), body}), ctx);
+    REQUIRE(std::get<Number>(*std::get<List>(*result).elements[2]).value == 5.0);
+    REQUIRE(std::get<Number>(*evaluate(parse_expression("y"), ctx)).value == 1.0);
+    REQUIRE(to_string(evaluate(parse_expression("z"), ctx)) == "z");
+
+    body = make_fcall("List", {
+        make_fcall("SetDelayed", {parse_expression("g[t_]"), parse_expression("t + 1")}),
+        parse_expression("g[1]")});
+    result = evaluate(make_fcall("Refine", {body, parse_expression("x > 0")}), ctx);
+    REQUIRE(to_string(result) == "{Null, 2}");
+    REQUIRE(to_string(evaluate(parse_expression("g[1]"), ctx)) == "g[1]");
+
+    // Memoized results computed from a scoped definition are dropped with it,
+    // and attributes set inside the scope do not outlive it.
+    evaluate(parse_expression("f[x_] := x"), ctx);
+    evaluate(parse_expression("SetAttributes[f, Memoize]"), ctx);
+    REQUIRE(std::get<Number>(*evaluate(parse_expression("f[1]"), ctx)).value == 1.0);
+    body = make_fcall("List", {
+        make_fcall("SetDelayed", {parse_expression("f[x_]"), parse_expression("2 x")}),
+        parse_expression("f[1]"),
+        parse_expression("SetAttributes[h, Memoize]")});
+    result = evaluate(make_fcall("Assuming", {parse_expression("x > 0"), body}), ctx);
+    REQUIRE(std::get<Number>(*std::get<List>(*result).elements[1]).value == 2.0);
+    REQUIRE(std::get<Number>(*evaluate(parse_expression("f[1]"), ctx)).value == 1.0);
+    REQUIRE_FALSE(ctx.symbol_metadata.has_attribute("h", symbols::SymbolAttribute::memoize));
+
+    // An error inside the scope still rolls its assignments back.
+    body = make_fcall("List", {
+        make_expr<Assignment>("y", make_expr<Number>(5)),
+        parse_expression("Assuming[Positive[x + 1], x]")});
+    REQUIRE_THROWS(evaluate(make_fcall("Assuming", {parse_expression("x > 0"), body}), ctx));
+    REQUIRE(std::get<Number>(*evaluate(parse_expression("y"), ctx)).value == 1.0);
+}
+
 TEST_CASE("Evaluator scopes assumptions through Assuming and Refine", "[evaluator][assumptions]") {
     EvaluationContext ctx;
 
@@ -1157,6 +1285,32 @@ TEST_CASE("Evaluator resolves boolean and comparison facts from assumptions", "[
     REQUIRE_FALSE(std::get<Boolean>(*result).value);
 }
 
+TEST_CASE("Evaluator scopes assumptions to the enclosing Assuming or Refine", "[evaluator][assumptions]") {
+    EvaluationContext ctx;
+
+    auto expr = parse_expression("Assuming[x > 0, Assuming[x < 2, {x > 0, x < 2}]]");
+    auto result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "{True, True}");
+
+    expr = parse_expression("Assuming[x > 0, {Assuming[x < 2, x < 3], x < 3}]");
+    result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "{True, x < 3}");
+
+    expr = parse_expression("Refine[Positive[x], x > 0]");
+    result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "True");
+
+    expr = parse_expression("Positive[x]");
+    result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "Positive[x]");
+    REQUIRE(ctx.assumptions.frame_depth() == 0);
+
+    expr = parse_expression("Assuming[x > 0, Assuming[Positive[x + 1], x]]");
+    REQUIRE_THROWS(evaluate(expr, ctx));
+    REQUIRE(ctx.assumptions.frame_depth() == 0);
+    REQUIRE(ctx.assumptions.find_symbol_facts("x") == nullptr);
+}
+
 TEST_CASE("Evaluator resolves explicit sign predicates from assumptions", "[evaluator][assumptions]") {
     EvaluationContext ctx;
 
@@ -1239,6 +1393,10 @@ TEST_CASE("Evaluator resolves explicit symbol domain predicates from assumptions
 
     expr = parse_expression("Refine[RealQ[x], x > 3]");
     result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "True");
+
+    expr = parse_expression("Refine[RealQ[x], x > y]");
+    result = evaluate(expr, ctx);
     REQUIRE(to_string(result) == "RealQ[x]");
 }
 
@@ -1275,7 +1433,11 @@ TEST_CASE("Evaluator derives sign facts for simple arithmetic forms", "[evaluato
 
     expr = parse_expression("Refine[Positive[x + 1], x > 0]");
     result = evaluate(expr, ctx);
-    REQUIRE(to_string(result) == "Positive[x + 1]");
+    REQUIRE(to_string(result) == "True");
+
+    expr = parse_expression("Refine[Positive[x + y], x > 0]");
+    result = evaluate(expr, ctx);
+    REQUIRE(to_string(result) == "Positive[x + y]");
 }
 
 TEST_CASE("Evaluator rejects unsupported assumption forms explicitly", "[evaluator][assumptions]") {
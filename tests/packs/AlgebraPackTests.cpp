@@ -2,11 +2,14 @@
 #include "evaluator/Evaluator.hpp"
 #include "expr/Expr.hpp"
 #include "parser/Parser.hpp"
+#include "kernel/PackManifest.hpp"
 #include "packs/AlgebraPack.hpp"
 #include "transforms/Transforms.hpp"
 
 #include <catch2/catch_test_macros.hpp>
 
+#include <atomic>
+
 using namespace aleph3;
 
 namespace {
@@ -80,3 +83,47 @@ TEST_CASE("Default registry exposes algebra through the pack path", "[packs][alg
     REQUIRE(expand->metadata.source == kernel::RegistrationSource::pack);
     REQUIRE(expand->metadata.owning_package == "core-algebra");
 }
+
+TEST_CASE("Algebra pack manifest registers metadata and loads handlers on first use", "[packs][algebra][lazy]") {
+    kernel::FunctionRegistry registry;
+    auto pack = kernel::register_lazy_pack(registry, packs::algebra_pack_manifest());
+
+    for (const auto* name : {"Expand", "Factor", "Collect", "GCD", "PolynomialQuotient"}) {
+        const auto* spec = registry.find_symbolic_function_spec(name);
+        REQUIRE(spec != nullptr);
+        REQUIRE(spec->metadata.source == kernel::RegistrationSource::pack);
+        REQUIRE(spec->metadata.owning_package == "core-algebra");
+        REQUIRE(spec->metadata.rewrite_safe);
+    }
+    REQUIRE_FALSE(pack->loaded());
+
+    EvaluationContext ctx(registry);
+    REQUIRE(simplify_string(evaluate_source("Expand[(x + 1) * (x + 2)]", ctx)) == "x^2 + 3 * x + 2");
+    REQUIRE(pack->loaded());
+    REQUIRE(pack->load_duration().count() > 0);
+    REQUIRE(to_string(evaluate_source("PolynomialQuotient[x^2 - 1, x - 1, x]", ctx)) == "{x + 1, 0}");
+}
+
+TEST_CASE("Lazy packs load once even when first dispatched from several workers", "[packs][lazy][parallel]") {
+    std::atomic<int> loads{0};
+    kernel::PackManifest manifest;
+    manifest.package_name = "test-pack";
+    manifest.symbols.push_back({"Twice", "Double a number.", false, {}});
+    manifest.load = [&loads](kernel::FunctionRegistry& registry) {
+        ++loads;
+        registry.register_pack_function("test-pack", "Twice", [](const FunctionCall& call, EvaluationContext& ctx) {
+            return make_expr<Number>(2.0 * std::get<Number>(*evaluate(call.args[0], ctx)).value);
+        });
+    };
+
+    auto registry = kernel::create_default_function_registry();
+    auto pack = kernel::register_lazy_pack(registry, std::move(manifest));
+    REQUIRE(loads == 0);
+
+    EvaluationContext ctx(registry);
+    ctx.set_parallel_thread_count(4);
+    REQUIRE(to_string(evaluate_source("ParallelMap[Twice, {1, 2, 3, 4, 5, 6, 7, 8}]", ctx)) ==
+        "{2, 4, 6, 8, 10, 12, 14, 16}");
+    REQUIRE(loads == 1);
+    REQUIRE(pack->loaded());
+}
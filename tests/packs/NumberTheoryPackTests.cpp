@@ -0,0 +1,111 @@
+#include "evaluator/EvaluationContext.hpp"
+#include "evaluator/Evaluator.hpp"
+#include "expr/Expr.hpp"
+#include "numbertheory/IntegerArithmetic.hpp"
+#include "packs/NumberTheoryPack.hpp"
+#include "parser/Parser.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace aleph3;
+
+namespace {
+
+ExprPtr evaluate_source(std::string_view source, EvaluationContext& ctx) {
+    return evaluate(parse_expression(std::string(source)), ctx);
+}
+
+double number_value(std::string_view source, EvaluationContext& ctx) {
+    return std::get<Number>(*evaluate_source(source, ctx)).value;
+}
+
+bool boolean_value(std::string_view source, EvaluationContext& ctx) {
+    return std::get<Boolean>(*evaluate_source(source, ctx)).value;
+}
+
+}  // namespace
+
+TEST_CASE("Number theory pack registers listable pack-owned symbols", "[packs][numbertheory]") {
+    kernel::FunctionRegistry registry;
+    packs::register_number_theory_pack(registry);
+
+    for (const auto* name : {"PowerMod", "PrimeQ", "FactorInteger"}) {
+        const auto* spec = registry.find_symbolic_function_spec(name);
+        REQUIRE(spec != nullptr);
+        REQUIRE(spec->metadata.source == kernel::RegistrationSource::pack);
+        REQUIRE(spec->metadata.owning_package == "core-number-theory");
+    }
+}
+
+TEST_CASE("Number theory functions evaluate on exact integers", "[packs][numbertheory]") {
+    EvaluationContext ctx;
+
+    REQUIRE(number_value("GCD[12345678, 87654321]", ctx) == 9.0);
+    REQUIRE(number_value("GCD[-12, 18]", ctx) == 6.0);
+    REQUIRE(number_value("GCD[0, 7]", ctx) == 7.0);
+
+    REQUIRE(number_value("PowerMod[2, 10, 1000]", ctx) == 24.0);
+    REQUIRE(number_value("PowerMod[-2, 3, 5]", ctx) == 2.0);
+    REQUIRE(number_value("PowerMod[3, -1, 7]", ctx) == 5.0);
+    REQUIRE(number_value("PowerMod[2, 3, -5]", ctx) == -2.0);
+    REQUIRE(number_value("PowerMod[123456789, 987654321, 1000000007]", ctx) == 652541198.0);
+    REQUIRE_THROWS(evaluate_source("PowerMod[2, -1, 4]", ctx));
+    REQUIRE_THROWS(evaluate_source("PowerMod[2, 3, 0]", ctx));
+    REQUIRE(std::holds_alternative<FunctionCall>(*evaluate_source("PowerMod[x, 2, 5]", ctx)));
+
+    REQUIRE(boolean_value("PrimeQ[2]", ctx));
+    REQUIRE(boolean_value("PrimeQ[-7]", ctx));
+    REQUIRE(boolean_value("PrimeQ[1000000007]", ctx));
+    REQUIRE_FALSE(boolean_value("PrimeQ[1]", ctx));
+    REQUIRE_FALSE(boolean_value("PrimeQ[561]", ctx));
+    REQUIRE_FALSE(boolean_value("PrimeQ[7.5]", ctx));
+    REQUIRE_FALSE(boolean_value("PrimeQ[x]", ctx));
+
+    const auto primes = evaluate_source("PrimeQ[{2, 4, 13}]", ctx);
+    const auto& flags = std::get<List>(*primes).elements;
+    REQUIRE(flags.size() == 3);
+    REQUIRE(std::get<Boolean>(*flags[0]).value);
+    REQUIRE_FALSE(std::get<Boolean>(*flags[1]).value);
+    REQUIRE(std::get<Boolean>(*flags[2]).value);
+    REQUIRE(to_string(evaluate_source("PowerMod[2, {3, 4, 5}, 7]", ctx)) == "{1, 2, 4}");
+
+    REQUIRE(to_string(evaluate_source("FactorInteger[-360]", ctx)) == "{{-1, 1}, {2, 3}, {3, 2}, {5, 1}}");
+    REQUIRE(to_string(evaluate_source("FactorInteger[600851475143]", ctx)) ==
+            "{{71, 1}, {839, 1}, {1471, 1}, {6857, 1}}");
+    REQUIRE(to_string(evaluate_source("FactorInteger[9/20]", ctx)) == "{{2, -2}, {3, 2}, {5, -1}}");
+    REQUIRE(to_string(evaluate_source("FactorInteger[1]", ctx)) == "{{1, 1}}");
+}
+
+TEST_CASE("Integer arithmetic is exact across the full 64-bit range", "[packs][numbertheory]") {
+    REQUIRE(integer_gcd(0, 0) == 0);
+    REQUIRE(integer_gcd(uint64_t{1} << 63, uint64_t{3} << 40) == uint64_t{1} << 40);
+    REQUIRE(integer_gcd(18446744073709551557ULL, 18446744073709551533ULL) == 1);
+
+    // Checked against direct 128-bit multiplication.
+    const uint64_t modulus = 18446744073709551557ULL;
+    uint64_t expected = 1;
+    for (int i = 0; i < 1000; ++i) {
+        expected = static_cast<uint64_t>(static_cast<unsigned __int128>(expected) * 0xdeadbeefcafeULL % modulus);
+    }
+    REQUIRE(power_mod(0xdeadbeefcafeULL, 1000, modulus) == expected);
+    REQUIRE(power_mod(3, 1000, uint64_t{1} << 62) ==
+            power_mod(3, 500, uint64_t{1} << 62) * power_mod(3, 500, uint64_t{1} << 62) % (uint64_t{1} << 62));
+
+    uint64_t inverse = 0;
+    REQUIRE(inverse_mod(0xdeadbeefcafeULL, modulus, inverse));
+    REQUIRE(static_cast<uint64_t>(static_cast<unsigned __int128>(inverse) * 0xdeadbeefcafeULL % modulus) == 1);
+    REQUIRE_FALSE(inverse_mod(6, 9, inverse));
+
+    REQUIRE(is_prime(18446744073709551557ULL));
+    REQUIRE(is_prime((uint64_t{1} << 61) - 1));
+    REQUIRE_FALSE(is_prime(3215031751ULL));           // strong pseudoprime to bases 2, 3, 5, 7
+    REQUIRE_FALSE(is_prime(3825123056546413051ULL));  // strong pseudoprime to bases up to 23
+    REQUIRE_FALSE(is_prime(18446744073709551615ULL));
+
+    using Factors = std::vector<std::pair<uint64_t, unsigned>>;
+    REQUIRE(factor_integer(4294967291ULL * 4294967279ULL) == Factors{{4294967279ULL, 1}, {4294967291ULL, 1}});
+    REQUIRE(factor_integer(18446744073709551615ULL) ==
+            Factors{{3, 1}, {5, 1}, {17, 1}, {257, 1}, {641, 1}, {65537, 1}, {6700417, 1}});
+    REQUIRE(factor_integer(uint64_t{1} << 63) == Factors{{2, 63}});
+    REQUIRE(factor_integer(1).empty());
+}
@@ -10,12 +10,14 @@
 #include "kernel/TrustedSubsetBridge.hpp"
 #include "semantics/Validator.hpp"
 
+#include <chrono>
 #include <cmath>
 #include <catch2/catch_test_macros.hpp>
 #include <limits>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -42,7 +44,7 @@ std::optional<Value> expr_to_sdk_value(const ExprPtr& expr) {
         return Value(boolean->value);
     }
     if (const auto* string = std::get_if<String>(&*expr)) {
-        return Value(string->value);
+        return Value(string->value.str());
     }
     if (const auto* list = std::get_if<List>(&*expr)) {
         Value::List values;
@@ -76,7 +78,7 @@ ExprPtr sdk_value_to_expr(const Value& value) {
         for (const auto& element : *list) {
             elements.push_back(sdk_value_to_expr(element));
         }
-        return std::make_shared<Expr>(List{elements});
+        return make_expr_node(List{elements});
     }
     return make_expr<Indeterminate>();
 }
@@ -475,6 +477,42 @@ TEST_CASE("Engine compile and evaluate SDK numeric built-ins behind policy gatin
     REQUIRE(*ceiling_result.value->as_number() == -3.0);
 }
 
+TEST_CASE("Engine looks up keys in association-valued bindings and constants", "[sdk][engine]") {
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"prices", ValueType::association, true});
+    schema.allow_variable({"symbol", ValueType::string, true});
+    schema.allow_constant(ConstantSchema{
+        "rates",
+        Value(Value::Association{{Value("USD"), Value(1.0)}, {Value("EUR"), Value(1.25)}})});
+    Policy policy = Policy::default_policy();
+    policy.set_enable_optional_builtins(true);
+
+    const auto compiled = engine.compile(
+        "If[KeyExistsQ[prices, symbol], Lookup[prices, symbol] * Lookup[rates, \"EUR\"], Lookup[rates, \"GBP\", -1]]",
+        schema,
+        policy);
+    REQUIRE(compiled.ok());
+
+    Value::Association table;
+    for (int index = 0; index < 1000; ++index) {
+        table.emplace_back(Value("S" + std::to_string(index)), Value(static_cast<double>(index)));
+    }
+    Bindings bindings{{"prices", Value(std::move(table))}, {"symbol", Value("S400")}};
+    const auto hit = engine.evaluate(*compiled.formula, bindings);
+    REQUIRE(hit.ok());
+    REQUIRE(*hit.value->as_number() == 500.0);
+
+    bindings["symbol"] = Value("missing");
+    const auto miss = engine.evaluate(*compiled.formula, bindings);
+    REQUIRE(miss.ok());
+    REQUIRE(*miss.value->as_number() == -1.0);
+
+    const auto wrong_type = engine.compile("Lookup[symbol, 1]", schema, policy);
+    REQUIRE_FALSE(wrong_type.ok());
+    REQUIRE(wrong_type.diagnostics.front().code == "semantics.validator.invalid_argument_type");
+}
+
 TEST_CASE("Engine reports SDK numeric built-in contract violations", "[sdk][engine]") {
     Engine engine;
     Schema schema;
@@ -877,3 +915,455 @@ TEST_CASE("Engine evaluate matches direct kernel evaluation for step-budget exha
     REQUIRE_FALSE(sdk_result.ok());
     REQUIRE(sdk_result.error->code == "runtime.step_budget_exhausted");
 }
+
+TEST_CASE("Engine simulate summarizes sampled formula values", "[sdk][engine][simulation]") {
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_variable({"y", ValueType::number, true});
+    schema.allow_variable({"k", ValueType::number, true});
+
+    const auto compile_result = engine.compile("k * x + 2 * y", schema);
+    REQUIRE(compile_result.ok());
+
+    const Distributions distributions{
+        {"x", Distribution::uniform(0.0, 1.0)},
+        {"y", Distribution::normal(1.0, 2.0)}};
+    SimulationOptions options;
+    options.bindings = {{"k", Value(3.0)}};
+
+    constexpr std::size_t samples = 20000;
+    const auto result = engine.simulate(*compile_result.formula, distributions, samples, 42, options);
+    REQUIRE(result.ok());
+    const auto& summary = *result.summary;
+    REQUIRE(summary.moments.count() == samples);
+    REQUIRE(summary.quantiles.count() == samples);
+
+    // 3x + 2y has mean 1.5 + 2 and variance 9/12 + 16.
+    REQUIRE(std::fabs(summary.moments.mean() - 3.5) < 0.1);
+    REQUIRE(std::fabs(summary.moments.variance() - 16.75) < 0.6);
+    REQUIRE(std::fabs(summary.quantiles.quantile(0.5) - 3.5) < 0.15);
+    REQUIRE(summary.quantiles.quantile(0.0) == summary.moments.min());
+    REQUIRE(summary.quantiles.quantile(1.0) == summary.moments.max());
+
+    // Same seed, same summary, whatever the thread count.
+    for (const std::size_t thread_count : {std::size_t{1}, std::size_t{2}, std::size_t{4}}) {
+        options.thread_count = thread_count;
+        const auto again = engine.simulate(*compile_result.formula, distributions, samples, 42, options);
+        REQUIRE(again.ok());
+        REQUIRE(again.summary->moments.mean() == summary.moments.mean());
+        REQUIRE(again.summary->moments.variance() == summary.moments.variance());
+        REQUIRE(again.summary->quantiles.quantile(0.9) == summary.quantiles.quantile(0.9));
+    }
+
+    const auto reseeded = engine.simulate(*compile_result.formula, distributions, samples, 43, options);
+    REQUIRE(reseeded.ok());
+    REQUIRE(reseeded.summary->moments.mean() != summary.moments.mean());
+}
+
+TEST_CASE("Engine simulate matches row-by-row evaluation when formulas call host functions", "[sdk][engine][simulation]") {
+    Engine engine;
+    HostFunctionSpec twice;
+    twice.name = "Twice";
+    twice.arity = FunctionArity::exact(1);
+    twice.parameters = {{"value", ValueType::number, true}};
+    twice.return_type = ValueType::number;
+    twice.callback = [](std::span<const Value> args) {
+        EvaluationResult result;
+        result.value = Value(2.0 * *args[0].as_number());
+        return result;
+    };
+    engine.register_function(twice);
+
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_function({"Twice", FunctionArity::exact(1), {ValueType::number}, ValueType::number, true});
+
+    const auto columnar = engine.compile("x * x + 2 * x", schema);
+    const auto per_row = engine.compile("x * x + Twice[x]", schema);
+    REQUIRE(columnar.ok());
+    REQUIRE(per_row.ok());
+
+    const Distributions distributions{{"x", Distribution::exponential(0.5)}};
+    const auto expected = engine.simulate(*columnar.formula, distributions, 5000, 7);
+    const auto actual = engine.simulate(*per_row.formula, distributions, 5000, 7);
+    REQUIRE(expected.ok());
+    REQUIRE(actual.ok());
+    REQUIRE(std::fabs(actual.summary->moments.mean() - expected.summary->moments.mean()) < 1e-9);
+    REQUIRE(actual.summary->moments.max() == expected.summary->moments.max());
+    REQUIRE(actual.summary->quantiles.quantile(0.25) == expected.summary->quantiles.quantile(0.25));
+}
+
+TEST_CASE("Engine simulate reports the first failing sample and invalid distributions", "[sdk][engine][simulation]") {
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"n", ValueType::number, true});
+
+    const auto compile_result = engine.compile("1 / n", schema);
+    REQUIRE(compile_result.ok());
+
+    // n is 0 for some early sample; 5000 draws span two chunks.
+    const auto result = engine.simulate(
+        *compile_result.formula, {{"n", Distribution::discrete_uniform(0, 3)}}, 5000, 1);
+    REQUIRE_FALSE(result.ok());
+    REQUIRE(result.error.has_value());
+    REQUIRE(result.error->code == "runtime.division_by_zero");
+    REQUIRE(result.failed_sample.has_value());
+
+    const auto failed = *result.failed_sample;
+    const auto prefix = engine.simulate(
+        *compile_result.formula, {{"n", Distribution::discrete_uniform(0, 3)}}, failed, 1);
+    REQUIRE(prefix.ok());
+    REQUIRE(prefix.summary->moments.count() == failed);
+
+    const auto invalid = engine.simulate(
+        *compile_result.formula, {{"n", Distribution::exponential(-1.0)}}, 10, 1);
+    REQUIRE_FALSE(invalid.ok());
+    REQUIRE(invalid.error->code == "sdk.simulation.invalid_distribution");
+}
+
+TEST_CASE("Engine evaluate_into aggregates rows by group without per-row results", "[sdk][engine][aggregation]") {
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"price", ValueType::number, true});
+    schema.allow_variable({"quantity", ValueType::number, true});
+    schema.allow_variable({"region", ValueType::string, true});
+
+    const auto revenue = engine.compile("price * quantity", schema);
+    const auto region = engine.compile("region", schema);
+    REQUIRE(revenue.ok());
+    REQUIRE(region.ok());
+
+    std::vector<Bindings> rows;
+    for (int i = 0; i < 1000; ++i) {
+        rows.push_back({
+            {"price", Value(static_cast<double>(i % 7))},
+            {"quantity", Value(2.0)},
+            {"region", Value(i % 3 == 0 ? "north" : "south")}});
+    }
+
+    AggregationEvaluationOptions options;
+    options.group_by = *region.formula;
+    AggregationSink reference;
+    options.thread_count = 1;
+    const auto report = engine.evaluate_into(reference, *revenue.formula, rows, options);
+    REQUIRE(report.ok());
+    REQUIRE(report.rows_aggregated == 1000);
+
+    REQUIRE(reference.groups().size() == 2);
+    REQUIRE(*reference.groups()[0].key.as_string() == "north");
+    double north_sum = 0.0;
+    for (int i = 0; i < 1000; i += 3) {
+        north_sum += 2.0 * (i % 7);
+    }
+    const auto* north = reference.find(Value("north"));
+    REQUIRE(north != nullptr);
+    REQUIRE(north->moments.count() == 334);
+    REQUIRE(north->moments.sum() == north_sum);
+    REQUIRE(north->moments.max() == 12.0);
+    REQUIRE(std::fabs(north->distinct->estimate() - 7.0) < 0.5);
+    REQUIRE(north->quantiles->quantile(0.0) == 0.0);
+
+    for (const std::size_t thread_count : {std::size_t{2}, std::size_t{4}}) {
+        AggregationSink parallel;
+        options.thread_count = thread_count;
+        REQUIRE(engine.evaluate_into(parallel, *revenue.formula, rows, options).ok());
+        REQUIRE(parallel.groups().size() == 2);
+        for (std::size_t g = 0; g < 2; ++g) {
+            REQUIRE(*parallel.groups()[g].key.as_string() == *reference.groups()[g].key.as_string());
+            REQUIRE(parallel.groups()[g].moments.sum() == reference.groups()[g].moments.sum());
+            REQUIRE(parallel.groups()[g].moments.variance() == reference.groups()[g].moments.variance());
+        }
+    }
+
+    // Two batches of one stream land in the same sink.
+    AggregationSink streamed;
+    REQUIRE(engine.evaluate_into(streamed, *revenue.formula, std::span(rows).first(400), options).ok());
+    REQUIRE(engine.evaluate_into(streamed, *revenue.formula, std::span(rows).subspan(400), options).ok());
+    REQUIRE(streamed.find(Value("north"))->moments.count() == 334);
+    REQUIRE(streamed.find(Value("north"))->moments.sum() == north_sum);
+
+    // Without a key formula every row joins one group.
+    AggregationSink total;
+    REQUIRE(engine.evaluate_into(total, *revenue.formula, rows).ok());
+    REQUIRE(total.groups().size() == 1);
+    REQUIRE(total.groups().front().key.is_null());
+    REQUIRE(total.groups().front().moments.count() == 1000);
+}
+
+TEST_CASE("Engine evaluate_into stops at the first failing row", "[sdk][engine][aggregation]") {
+    Engine engine;
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+
+    const auto inverse = engine.compile("1 / x", schema);
+    const auto comparison = engine.compile("x > 1", schema);
+    REQUIRE(inverse.ok());
+    REQUIRE(comparison.ok());
+
+    std::vector<Bindings> rows;
+    for (int i = 0; i < 600; ++i) {
+        rows.push_back({{"x", Value(i == 300 ? 0.0 : 1.0 + i)}});
+    }
+
+    AggregationSink sink;
+    const auto report = engine.evaluate_into(sink, *inverse.formula, rows);
+    REQUIRE_FALSE(report.ok());
+    REQUIRE(report.error->code == "runtime.division_by_zero");
+    REQUIRE(report.failed_row == std::optional<std::size_t>{300});
+    REQUIRE(report.rows_aggregated == 300);
+    REQUIRE(sink.groups().front().moments.count() == 300);
+
+    AggregationSink booleans;
+    const auto non_numeric = engine.evaluate_into(booleans, *comparison.formula, std::span(rows).first(5));
+    REQUIRE(non_numeric.error->code == "sdk.aggregation.non_numeric");
+    REQUIRE(non_numeric.failed_row == std::optional<std::size_t>{0});
+}
+
+TEST_CASE("Engine hands large results to background reclamation when enabled", "[sdk][engine][reclamation]") {
+    HostFunctionSpec numbers;
+    numbers.name = "Numbers";
+    numbers.arity = FunctionArity::exact(0);
+    numbers.return_type = ValueType::list;
+    numbers.callback = [](std::span<const Value>) {
+        Value::List values;
+        for (int index = 0; index < 5000; ++index) {
+            values.emplace_back(static_cast<double>(index));
+        }
+        EvaluationResult result;
+        result.value = Value(std::move(values));
+        return result;
+    };
+    Schema schema;
+    schema.allow_function({"Numbers", FunctionArity::exact(0), {}, ValueType::list, true});
+
+    Engine plain;
+    plain.register_function(numbers);
+    const auto plain_formula = plain.compile("Numbers[]", schema);
+    REQUIRE(plain_formula.ok());
+    REQUIRE(plain.evaluate(*plain_formula.formula, {}).ok());
+    REQUIRE(plain.reclamation_metrics().trees_queued == 0);
+
+    EngineOptions options;
+    options.background_reclamation = true;
+    Engine engine(options);
+    engine.register_function(numbers);
+    const auto compiled = engine.compile("Numbers[]", schema);
+    REQUIRE(compiled.ok());
+    for (int run = 0; run < 3; ++run) {
+        const auto result = engine.evaluate(*compiled.formula, {});
+        REQUIRE(result.ok());
+        REQUIRE(result.value->as_list()->size() == 5000);
+    }
+
+    if (expr_refcount_is_atomic) {
+        REQUIRE(engine.reclamation_metrics().trees_queued == 3);
+        for (int wait = 0; wait < 2000 && engine.reclamation_metrics().trees_freed < 3; ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const auto metrics = engine.reclamation_metrics();
+        REQUIRE(metrics.trees_freed == 3);
+        REQUIRE(metrics.queue_depth == 0);
+        REQUIRE(metrics.max_queue_depth >= 1);
+    }
+}
+
+TEST_CASE("Engine specialize folds fixed bindings into a smaller residual formula", "[sdk][engine][specialize]") {
+    Engine engine;
+    int scale_calls = 0;
+    int noise_calls = 0;
+
+    HostFunctionSpec scale;
+    scale.name = "Scale";
+    scale.arity = FunctionArity::exact(1);
+    scale.parameters = {{"value", ValueType::number, true}};
+    scale.return_type = ValueType::number;
+    scale.callback = [&](std::span<const Value> args) {
+        ++scale_calls;
+        EvaluationResult result;
+        result.value = Value(10.0 * *args[0].as_number());
+        return result;
+    };
+    engine.register_function(scale);
+
+    HostFunctionSpec noise = scale;
+    noise.name = "Noise";
+    noise.purity = HostFunctionPurity::impure;
+    noise.callback = [&](std::span<const Value> args) {
+        ++noise_calls;
+        EvaluationResult result;
+        result.value = Value(*args[0].as_number() + 0.5);
+        return result;
+    };
+    engine.register_function(noise);
+
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_variable({"k", ValueType::number, true});
+    schema.allow_variable({"mode", ValueType::number, true});
+    schema.allow_variable({"d", ValueType::number, true});
+    schema.allow_function({"Scale", FunctionArity::exact(1), {ValueType::number}, ValueType::number, true});
+    schema.allow_function({"Noise", FunctionArity::exact(1), {ValueType::number}, ValueType::number, true});
+
+    const auto compiled = engine.compile("If[mode > 0, Scale[k] * x + Noise[k], x - k]", schema);
+    REQUIRE(compiled.ok());
+    REQUIRE(compiled.formula->variables() == std::vector<std::string>{"k", "mode", "x"});
+
+    const Bindings fixed{{"mode", Value(1.0)}, {"k", Value(2.0)}};
+    const auto residual = engine.specialize(*compiled.formula, fixed);
+    REQUIRE_FALSE(residual.empty());
+    REQUIRE(residual.variables() == std::vector<std::string>{"x"});
+    REQUIRE(scale_calls == 1);
+    REQUIRE(noise_calls == 0);
+
+    for (const double x : {-1.5, 0.0, 3.0}) {
+        auto all = fixed;
+        all["x"] = Value(x);
+        const auto expected = engine.evaluate(*compiled.formula, all);
+        const auto actual = engine.evaluate(residual, {{"x", Value(x)}});
+        REQUIRE(expected.ok());
+        REQUIRE(actual.ok());
+        REQUIRE(*actual.value->as_number() == *expected.value->as_number());
+    }
+    // Pure calls were done once; impure ones still run per evaluation.
+    REQUIRE(scale_calls == 4);
+    REQUIRE(noise_calls == 6);
+
+    const auto other_branch = engine.specialize(*compiled.formula, {{"mode", Value(0.0)}});
+    REQUIRE(other_branch.variables() == std::vector<std::string>{"k", "x"});
+    const auto subtracted = engine.evaluate(other_branch, {{"x", Value(5.0)}, {"k", Value(2.0)}});
+    REQUIRE(subtracted.ok());
+    REQUIRE(*subtracted.value->as_number() == 3.0);
+
+    // Failures stay in the residual and surface when it is evaluated.
+    const auto divided = engine.compile("x + k / d", schema);
+    REQUIRE(divided.ok());
+    const auto failing = engine.specialize(*divided.formula, {{"k", Value(1.0)}, {"d", Value(0.0)}});
+    REQUIRE(failing.variables() == std::vector<std::string>{"x"});
+    const auto expected_failure = engine.evaluate(
+        *divided.formula,
+        {{"x", Value(1.0)}, {"k", Value(1.0)}, {"d", Value(0.0)}});
+    const auto actual_failure = engine.evaluate(failing, {{"x", Value(1.0)}});
+    REQUIRE_FALSE(expected_failure.ok());
+    REQUIRE(actual_failure.error.has_value() == expected_failure.error.has_value());
+    REQUIRE(actual_failure.value.has_value() == expected_failure.value.has_value());
+    if (expected_failure.error) {
+        REQUIRE(actual_failure.error->code == expected_failure.error->code);
+    }
+
+    REQUIRE(engine.specialize(CompiledFormula{}, fixed).empty());
+}
+
+TEST_CASE("Engine compile shares one body between formulas of the same canonical form", "[sdk][engine][canonical]") {
+    Engine engine;
+    Schema schema;
+    for (const char* name : {"a", "b", "x", "y", "rate"}) {
+        schema.allow_variable({name, ValueType::number, true});
+    }
+    schema.allow_constant({"Offset", Value(4.0)});
+
+    const auto first = engine.compile("a * 2 + b - Offset", schema);
+    const auto renamed = engine.compile("y + x * 2 - Offset", schema);
+    const auto different = engine.compile("a * 2 - b - Offset", schema);
+    REQUIRE(first.ok());
+    REQUIRE(renamed.ok());
+    REQUIRE(different.ok());
+
+    REQUIRE(first.formula->fingerprint() == renamed.formula->fingerprint());
+    REQUIRE(first.formula->shares_body_with(*renamed.formula));
+    REQUIRE_FALSE(first.formula->shares_body_with(*different.formula));
+    REQUIRE(first.formula->variables() == std::vector<std::string>{"a", "b"});
+    REQUIRE(renamed.formula->variables() == std::vector<std::string>{"x", "y"});
+
+    const auto first_result = engine.evaluate(*first.formula, {{"a", Value(3.0)}, {"b", Value(10.0)}});
+    const auto renamed_result = engine.evaluate(*renamed.formula, {{"x", Value(3.0)}, {"y", Value(10.0)}});
+    REQUIRE(first_result.ok());
+    REQUIRE(renamed_result.ok());
+    REQUIRE(*first_result.value->as_number() == 12.0);
+    REQUIRE(*renamed_result.value->as_number() == 12.0);
+
+    // Errors still name the formula's own variables.
+    const auto missing = engine.evaluate(*renamed.formula, {{"x", Value(3.0)}});
+    REQUIRE_FALSE(missing.ok());
+    REQUIRE(missing.error->code == "runtime.unknown_binding");
+    REQUIRE(missing.error->message.find("`y`") != std::string::npos);
+
+    // Simulation binds sampled columns to the right slots.
+    SimulationOptions options;
+    options.bindings = {{"x", Value(3.0)}};
+    const auto sampled = engine.simulate(*renamed.formula, {{"y", Distribution::uniform(10.0, 11.0)}}, 64, 1, options);
+    REQUIRE(sampled.ok());
+    REQUIRE(sampled.summary->moments.min() >= 12.0);
+    REQUIRE(sampled.summary->moments.max() <= 13.0);
+
+    const auto other_engine = Engine().compile("b + 2 * a - Offset", schema);
+    REQUIRE(other_engine.ok());
+    REQUIRE(other_engine.formula->fingerprint() == first.formula->fingerprint());
+    REQUIRE_FALSE(other_engine.formula->shares_body_with(*first.formula));
+}
+
+TEST_CASE("Engine evaluate_scheduled lets a short evaluation overtake a long one", "[sdk][engine][scheduler]") {
+    EngineOptions options;
+    options.scheduling.concurrency = 1;
+    options.scheduling.slice_steps = 64;
+    Engine engine(options);
+
+    // Holds the long evaluation until the short one is queued behind it.
+    HostFunctionSpec queued;
+    queued.name = "Queued";
+    queued.arity = FunctionArity::exact(0);
+    queued.return_type = ValueType::boolean;
+    queued.callback = [&engine](std::span<const Value>) {
+        for (int wait = 0; wait < 5000 && engine.scheduler_metrics().waiting == 0; ++wait) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EvaluationResult result;
+        result.value = Value(true);
+        return result;
+    };
+    engine.register_function(queued);
+
+    Schema schema;
+    schema.allow_variable({"x", ValueType::number, true});
+    schema.allow_function({"Queued", FunctionArity::exact(0), {}, ValueType::boolean, true});
+
+    std::string sum = "x";
+    for (int term = 1; term < 400; ++term) {
+        sum += " + x";
+    }
+    Policy policy = Policy::default_policy();
+    policy.budget().max_ast_depth = 1024;
+    policy.budget().max_node_count = 4096;
+    const auto long_formula = engine.compile("If[Queued[], " + sum + ", 0]", schema, policy);
+    const auto short_formula = engine.compile("x * 2", schema);
+    REQUIRE(long_formula.ok());
+    REQUIRE(short_formula.ok());
+
+    EvaluationResult long_result;
+    std::thread long_thread([&] {
+        long_result = engine.evaluate_scheduled(*long_formula.formula, {{"x", Value(1.0)}}, {"reports"});
+    });
+    for (int wait = 0; wait < 5000 && engine.scheduler_metrics().running == 0; ++wait) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    const auto short_result = engine.evaluate_scheduled(
+        *short_formula.formula,
+        {{"x", Value(2.0)}},
+        {"dashboard", PriorityClass::interactive});
+    long_thread.join();
+
+    REQUIRE(short_result.ok());
+    REQUIRE(*short_result.value->as_number() == 4.0);
+    REQUIRE(long_result.ok());
+    REQUIRE(*long_result.value->as_number() == 400.0);
+    const auto metrics = engine.scheduler_metrics();
+    REQUIRE(metrics.completed == 2);
+    REQUIRE(metrics.running == 0);
+    REQUIRE(metrics.waiting == 0);
+    REQUIRE(metrics.yields >= 1);
+    REQUIRE(metrics.max_queue_delay_ms > 0.0);
+
+    REQUIRE_THROWS_AS(engine.set_tenant_weight("reports", 0.0), std::invalid_argument);
+    REQUIRE_NOTHROW(engine.set_tenant_weight("reports", 0.5));
+}
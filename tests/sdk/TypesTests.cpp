@@ -1,8 +1,12 @@
+#include "sdk/Aggregation.hpp"
 #include "sdk/Policy.hpp"
 #include "sdk/Schema.hpp"
 #include "sdk/Types.hpp"
 
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
 
 using namespace aleph3;
 
@@ -27,6 +31,13 @@ TEST_CASE("Value exposes typed accessors for supported public runtime values", "
     REQUIRE(list.is_list());
     REQUIRE(list.as_list() != nullptr);
     REQUIRE(list.as_list()->size() == 2);
+
+    Value association(Value::Association{{Value("a"), Value(1.0)}, {Value(2.0), Value(true)}});
+    REQUIRE(association.is_association());
+    REQUIRE_FALSE(association.is_list());
+    REQUIRE(association.as_association() != nullptr);
+    REQUIRE(association.as_association()->size() == 2);
+    REQUIRE(*association.as_association()->front().first.as_string() == "a");
 }
 
 TEST_CASE("Schema tracks allowed variables, functions, and constants", "[sdk][schema]") {
@@ -66,3 +77,145 @@ TEST_CASE("Policy profiles keep the SDK boundary deterministic", "[sdk][policy]"
     REQUIRE_FALSE(strict_policy.enable_optional_builtins());
     REQUIRE_FALSE(strict_policy.allow_assignments());
 }
+
+TEST_CASE("Streaming summaries merge into the summary of the whole stream", "[sdk][types][statistics]") {
+    RunningMoments whole;
+    RunningMoments left;
+    RunningMoments right;
+    QuantileSketch whole_sketch;
+    QuantileSketch left_sketch;
+    QuantileSketch right_sketch;
+    for (int i = 1; i <= 1000; ++i) {
+        const double value = i % 2 == 0 ? static_cast<double>(i) : -0.5 * i;
+        whole.add(value);
+        whole_sketch.add(value);
+        (i <= 300 ? left : right).add(value);
+        (i <= 300 ? left_sketch : right_sketch).add(value);
+    }
+    left.merge(right);
+    left_sketch.merge(right_sketch);
+
+    REQUIRE(left.count() == 1000);
+    REQUIRE(std::fabs(left.mean() - whole.mean()) < 1e-9);
+    REQUIRE(std::fabs(left.variance() - whole.variance()) < 1e-6 * whole.variance());
+    REQUIRE(left.min() == -499.5);
+    REQUIRE(left.max() == 1000.0);
+    REQUIRE(left_sketch.count() == 1000);
+    for (const double q : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+        REQUIRE(left_sketch.quantile(q) == whole_sketch.quantile(q));
+    }
+
+    // 500 negatives -499.5..-0.5, then the evens 2..1000; rank 749 is 500.
+    REQUIRE(whole_sketch.quantile(0.0) == -499.5);
+    REQUIRE(whole_sketch.quantile(1.0) == 1000.0);
+    const double upper_quartile = whole_sketch.quantile(0.75);
+    REQUIRE(std::fabs(upper_quartile - 500.0) <= 0.02 * 500.0 + 2.0);
+
+    REQUIRE_THROWS_AS(QuantileSketch(0.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(left_sketch.merge(QuantileSketch(0.05)), std::invalid_argument);
+}
+
+TEST_CASE("Distinct counters estimate cardinality and merge order-independently", "[sdk][types][statistics]") {
+    DistinctCounter all;
+    DistinctCounter evens;
+    DistinctCounter odds;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        for (int i = 0; i < 20000; ++i) {
+            all.add(i * 0.5);
+            (i % 2 == 0 ? evens : odds).add(i * 0.5);
+        }
+    }
+    all.add(-0.0);
+
+    REQUIRE(std::fabs(all.estimate() - 20000.0) < 0.05 * 20000.0);
+    DistinctCounter merged = odds;
+    merged.merge(evens);
+    REQUIRE(merged.estimate() == all.estimate());
+
+    DistinctCounter few;
+    for (int i = 0; i < 10; ++i) {
+        few.add(static_cast<double>(i % 5));
+    }
+    REQUIRE(std::fabs(few.estimate() - 5.0) < 0.5);
+
+    REQUIRE_THROWS_AS(DistinctCounter(3), std::invalid_argument);
+    REQUIRE_THROWS_AS(merged.merge(DistinctCounter(10)), std::invalid_argument);
+}
+
+TEST_CASE("Top values keep the largest values and merge order-independently", "[sdk][types][statistics]") {
+    TopValues all(5);
+    TopValues low(5);
+    TopValues high(5);
+    for (int i = 0; i < 1000; ++i) {
+        const double value = static_cast<double>((i * 7919) % 1000);
+        all.add(value);
+        (i % 3 == 0 ? low : high).add(value);
+    }
+    all.add(std::nan(""));
+    REQUIRE(all.values() == std::vector<double>{999.0, 998.0, 997.0, 996.0, 995.0});
+
+    TopValues forward = low;
+    forward.merge(high);
+    TopValues backward = high;
+    backward.merge(low);
+    REQUIRE(forward.values() == all.values());
+    REQUIRE(backward.values() == all.values());
+
+    TopValues few(3);
+    few.add(2.0);
+    few.add(-1.0);
+    REQUIRE(few.values() == std::vector<double>{2.0, -1.0});
+
+    REQUIRE_THROWS_AS(TopValues(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(few.merge(TopValues(4)), std::invalid_argument);
+}
+
+TEST_CASE("Aggregation sinks group values and merge partial sinks", "[sdk][types][aggregation]") {
+    AggregationSink whole;
+    AggregationSink first;
+    AggregationSink second;
+    const Value keys[] = {Value("a"), Value(1.0), Value(true), Value("1")};
+    for (int i = 0; i < 400; ++i) {
+        const auto& key = keys[i % 4];
+        whole.add(key, i);
+        (i < 150 ? first : second).add(key, i);
+    }
+    first.merge(second);
+
+    REQUIRE(first.groups().size() == 4);
+    for (std::size_t g = 0; g < 4; ++g) {
+        const auto& merged = first.groups()[g];
+        const auto& expected = whole.groups()[g];
+        REQUIRE(merged.moments.count() == 100);
+        REQUIRE(merged.moments.sum() == expected.moments.sum());
+        REQUIRE(merged.moments.min() == expected.moments.min());
+        REQUIRE(merged.quantiles->quantile(0.5) == expected.quantiles->quantile(0.5));
+        REQUIRE(merged.distinct->estimate() == expected.distinct->estimate());
+    }
+
+    const auto* numeric = first.find(Value(1.0));
+    REQUIRE(numeric != nullptr);
+    // 1, 5, ..., 397.
+    REQUIRE(numeric->moments.sum() == 19900.0);
+    REQUIRE(first.find(Value("missing")) == nullptr);
+
+    REQUIRE_THROWS_AS(first.add(Value(Value::List{}), 1.0), std::invalid_argument);
+    AggregationOptions plain;
+    plain.quantiles = false;
+    REQUIRE_THROWS_AS(first.merge(AggregationSink(plain)), std::invalid_argument);
+    REQUIRE_FALSE(first.groups()[0].top.has_value());
+
+    AggregationOptions ranked;
+    ranked.top_k = 3;
+    AggregationSink ranked_first(ranked);
+    AggregationSink ranked_second(ranked);
+    for (int i = 0; i < 400; ++i) {
+        (i < 150 ? ranked_first : ranked_second).add(keys[i % 4], i);
+    }
+    ranked_first.merge(ranked_second);
+    const auto* strings = ranked_first.find(Value("a"));
+    REQUIRE(strings != nullptr);
+    // 0, 4, ..., 396.
+    REQUIRE(strings->top->values() == std::vector<double>{396.0, 392.0, 388.0});
+    REQUIRE_THROWS_AS(ranked_first.merge(first), std::invalid_argument);
+}